@@ -30,11 +30,14 @@ function headerAndContentsMenu(pageName, relativePath) {
                                 { "level": 2, "label": "SingleCellView", "link": "user/plugins/simulation/SingleCellView.html", "subMenuItem": true },
                                 { "level": 1, "label": "Solver", "subMenuHeader": true },
                                 { "level": 2, "label": "CVODESolver", "link": "user/plugins/solver/CVODESolver.html", "subMenuItem": true },
+                                { "level": 2, "label": "DormandPrinceSolver", "link": "user/plugins/solver/DormandPrinceSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "ForwardEulerSolver", "link": "user/plugins/solver/ForwardEulerSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "FourthOrderRungeKuttaSolver", "link": "user/plugins/solver/FourthOrderRungeKuttaSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "HeunSolver", "link": "user/plugins/solver/HeunSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "IDASolver", "link": "user/plugins/solver/IDASolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "KINSOLSolver", "link": "user/plugins/solver/KINSOLSolver.html", "subMenuItem": true },
+                                { "level": 2, "label": "MultiRateSolver", "link": "user/plugins/solver/MultiRateSolver.html", "subMenuItem": true },
+                                { "level": 2, "label": "RushLarsenSolver", "link": "user/plugins/solver/RushLarsenSolver.html", "subMenuItem": true },
                                 { "level": 2, "label": "SecondOrderRungeKuttaSolver", "link": "user/plugins/solver/SecondOrderRungeKuttaSolver.html", "subMenuItem": true },
                                 { "level": 1, "label": "Tools", "subMenuHeader": true },
                                 { "level": 2, "label": "CellMLTools", "link": "user/plugins/tools/CellMLTools.html", "subMenuItem": true },
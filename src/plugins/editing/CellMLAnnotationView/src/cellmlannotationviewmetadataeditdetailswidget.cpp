@@ -26,6 +26,7 @@ limitations under the License.
 #include "cellmlannotationviewmetadataeditdetailswidget.h"
 #include "cellmlannotationviewmetadataviewdetailswidget.h"
 #include "cellmlannotationviewmetadatanormalviewdetailswidget.h"
+#include "cellmlannotationviewtermlookupcache.h"
 #include "cellmlannotationviewwidget.h"
 #include "cellmlfilerdftriple.h"
 #include "corecliutils.h"
@@ -56,9 +57,6 @@ limitations under the License.
 #include <QLineEdit>
 #include <QLocale>
 #include <QMenu>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QScrollArea>
@@ -158,6 +156,7 @@ CellmlAnnotationViewMetadataEditDetailsWidget::CellmlAnnotationViewMetadataEditD
     mAddTermButton(0),
     mTerm(QString()),
     mTerms(QStringList()),
+    mPendingTerm(QString()),
     mItemsCount(0),
     mLookUpTerm(false),
     mErrorMessage(QString()),
@@ -172,21 +171,14 @@ CellmlAnnotationViewMetadataEditDetailsWidget::CellmlAnnotationViewMetadataEditD
     mItemInformationSha1s(QStringList()),
     mItemInformationSha1(QString()),
     mLink(QString()),
-    mTextContent(QString()),
-    mNetworkReply(0)
+    mTextContent(QString())
 {
-    // Create a network access manager so that we can then retrieve a list of
-    // ontological terms models from the PMR
+    // Make sure that we get told when a term has been looked up by our view
+    // widget's term look up cache, which we share with other instances of
+    // ourselves
 
-    mNetworkAccessManager = new QNetworkAccessManager(this);
-
-    // Make sure that we get told when the download of our Internet file is
-    // complete
-
-    connect(mNetworkAccessManager, SIGNAL(finished(QNetworkReply *)),
-            this, SLOT(termLookedUp(QNetworkReply *)));
-    connect(mNetworkAccessManager, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)),
-            this, SLOT(sslErrors(QNetworkReply *, const QList<QSslError> &)));
+    connect(mViewWidget->termLookUpCache(), SIGNAL(termLookedUp(const QString &, const QByteArray &, const QString &)),
+            this, SLOT(termLookedUp(const QString &, const QByteArray &, const QString &)));
 
     // Create and populate our context menu
 
@@ -931,10 +923,21 @@ void CellmlAnnotationViewMetadataEditDetailsWidget::termChanged(const QString &p
 
     updateGui(mElement, true);
 
+    // We are not waiting for any term anymore
+    // Note: the term we may have been waiting for will still end up in our term
+    //       look up cache...
+
+    mPendingTerm = QString();
+
     // Retrieve some ontological terms based on the given term, but only if the
     // term cannot be added directly and if it is not empty
 
     if (!isDirectTerm(pTerm) && !pTerm.isEmpty()) {
+        // Use the ontological terms we have in our cache, if possible
+
+        if (lookUpCachedTerm(pTerm))
+            return;
+
         // Add the term to our list of terms to look up
 
         mTerms << pTerm;
@@ -950,129 +953,169 @@ void CellmlAnnotationViewMetadataEditDetailsWidget::termChanged(const QString &p
 
 //==============================================================================
 
-static const auto Pmr2RicordoUrl = QStringLiteral("https://models.physiomeproject.org/pmr2_ricordo/miriam_terms/");
+bool CellmlAnnotationViewMetadataEditDetailsWidget::lookUpCachedTerm(const QString &pTerm)
+{
+    // Check whether the given term has already been looked up, in which case we
+    // use its ontological terms straightaway and forget about any term that
+    // was still to be looked up
 
-//==============================================================================
+    CellmlAnnotationViewTermLookUpCache *termLookUpCache = mViewWidget->termLookUpCache();
+    QByteArray data;
 
-void CellmlAnnotationViewMetadataEditDetailsWidget::lookUpTerm()
-{
-    // 'Cancel' the previous request, if any
+    if (termLookUpCache->cachedTerm(pTerm, data)) {
+        mTerms.clear();
+
+        mPendingTerm = pTerm;
 
-    if (mNetworkReply) {
-        mNetworkReply->close();
+        termLookedUp(pTerm, data, QString());
 
-        mNetworkReply = 0;
+        return true;
     }
 
-    // Now, retrieve some ontological terms, but only if we are connected to the
-    // Internet
+    // Otherwise, check whether a prefix of the given term has already been
+    // looked up, in which case we show those of its ontological terms that
+    // contain the given term while waiting for the given term to be looked up
+    // Note: the results of a prefix don't necessarily include all the results
+    //       of the given term, hence we still need to look it up...
 
-    if (Core::internetConnectionAvailable()) {
-        QString term = mTerms.first();
+    QString prefixTerm;
 
-        mTerms.removeFirst();
+    if (termLookUpCache->cachedPrefixTerm(pTerm, prefixTerm, data)) {
+        QString errorMessage;
+        CellmlAnnotationViewMetadataEditDetailsItems prefixItems = termItems(data, errorMessage);
+        CellmlAnnotationViewMetadataEditDetailsItems items = CellmlAnnotationViewMetadataEditDetailsItems();
 
-        if (mTerms.isEmpty())
-            mNetworkReply = mNetworkAccessManager->get(QNetworkRequest(Pmr2RicordoUrl+term));
-    } else {
-        termLookedUp();
+        foreach (const CellmlAnnotationViewMetadataEditDetailsItem &item, prefixItems) {
+            if (item.name().contains(pTerm, Qt::CaseInsensitive))
+                items << item;
+        }
+
+        if (!items.isEmpty()) {
+            mTerm = pTerm;
+            mItemsCount = items.count();
+
+            updateItemsGui(items, false);
+        }
     }
+
+    return false;
 }
 
 //==============================================================================
 
-void CellmlAnnotationViewMetadataEditDetailsWidget::termLookedUp(QNetworkReply *pNetworkReply)
+void CellmlAnnotationViewMetadataEditDetailsWidget::lookUpTerm()
 {
-    // Retrieve the list of terms, should there be a network reply
+    // Make sure that we still have a term to look up
+    // Note: we may not have one if a term was found in our cache in between...
 
-    CellmlAnnotationViewMetadataEditDetailsItems items = CellmlAnnotationViewMetadataEditDetailsItems();
-    QString errorMessage = QString();
-    bool internetConnectionAvailable = true;
+    if (mTerms.isEmpty())
+        return;
 
-    if (pNetworkReply) {
-        // Ignore the network reply if it got cancelled
+    // Only look up the most recent term
 
-        if (pNetworkReply->error() == QNetworkReply::OperationCanceledError) {
-            pNetworkReply->deleteLater();
+    QString term = mTerms.first();
 
-            return;
-        } else {
-            mNetworkReply = 0;
-        }
+    mTerms.removeFirst();
 
-        // Keep track of the term we have just looked up
+    if (!mTerms.isEmpty())
+        return;
 
-        mTerm = pNetworkReply->url().toString().remove(Pmr2RicordoUrl);
+    mPendingTerm = term;
 
-        // Retrieve the list of terms, should the network reply have no error
+    // Now, retrieve some ontological terms, but only if we are connected to the
+    // Internet
+    // Note: our term look up cache will coalesce our request with any identical
+    //       request that is still in flight...
 
-        if (pNetworkReply->error() == QNetworkReply::NoError) {
-            // Parse the JSON data
+    if (Core::internetConnectionAvailable())
+        mViewWidget->termLookUpCache()->lookUpTerm(term);
+    else
+        termLookedUp(term, QByteArray(), QString(), false);
+}
 
-            QJsonParseError jsonParseError;
-            QJsonDocument jsonDocument = QJsonDocument::fromJson(pNetworkReply->readAll(), &jsonParseError);
+//==============================================================================
 
-            if (jsonParseError.error == QJsonParseError::NoError) {
-                // Retrieve the list of terms
+CellmlAnnotationViewMetadataEditDetailsItems CellmlAnnotationViewMetadataEditDetailsWidget::termItems(const QByteArray &pData,
+                                                                                                      QString &pErrorMessage) const
+{
+    // Parse the given JSON data and retrieve the items it contains
 
-                QVariantMap termMap;
-                QString name;
-                QString resource;
-                QString id;
+    CellmlAnnotationViewMetadataEditDetailsItems res = CellmlAnnotationViewMetadataEditDetailsItems();
+    QJsonParseError jsonParseError;
+    QJsonDocument jsonDocument = QJsonDocument::fromJson(pData, &jsonParseError);
 
-                foreach (const QVariant &termsVariant, jsonDocument.object().toVariantMap()["results"].toList()) {
-                    termMap = termsVariant.toMap();
-                    name = termMap["name"].toString();
+    if (jsonParseError.error == QJsonParseError::NoError) {
+        // Retrieve the list of terms
 
-                    if (   !name.isEmpty()
-                        &&  CellMLSupport::CellmlFileRdfTriple::decodeTerm(termMap["identifiers_org_uri"].toString(), resource, id)) {
-                        // We have a name and we could decode the term, so add
-                        // the item to our list, should it not already be in it
+        QVariantMap termMap;
+        QString name;
+        QString resource;
+        QString id;
 
-                        CellmlAnnotationViewMetadataEditDetailsItem newItem = CellmlAnnotationViewMetadataEditDetailsItem(name, resource, id);
+        foreach (const QVariant &termsVariant, jsonDocument.object().toVariantMap()["results"].toList()) {
+            termMap = termsVariant.toMap();
+            name = termMap["name"].toString();
 
-                        if (!items.contains(newItem))
-                            items << newItem;
-                    }
-                }
-            } else {
-                errorMessage = jsonParseError.errorString();
+            if (   !name.isEmpty()
+                &&  CellMLSupport::CellmlFileRdfTriple::decodeTerm(termMap["identifiers_org_uri"].toString(), resource, id)) {
+                // We have a name and we could decode the term, so add the item
+                // to our list, should it not already be in it
+
+                CellmlAnnotationViewMetadataEditDetailsItem newItem = CellmlAnnotationViewMetadataEditDetailsItem(name, resource, id);
+
+                if (!res.contains(newItem))
+                    res << newItem;
             }
-        } else {
-            errorMessage = pNetworkReply->errorString();
         }
     } else {
-        internetConnectionAvailable = false;
+        pErrorMessage = jsonParseError.errorString();
     }
 
-    // Update our GUI with the results of the look up after having sorted them
-    // and kept track of it size
+    // Sort our items before returning them
 
-    std::sort(items.begin(), items.end());
+    std::sort(res.begin(), res.end());
 
-    mItemsCount = items.count();
+    return res;
+}
 
-    updateItemsGui(items, false, errorMessage, internetConnectionAvailable);
+//==============================================================================
 
-    // Update our GUI (incl. its enabled state)
+void CellmlAnnotationViewMetadataEditDetailsWidget::termLookedUp(const QString &pTerm,
+                                                                 const QByteArray &pData,
+                                                                 const QString &pErrorMessage,
+                                                                 const bool &pInternetConnectionAvailable)
+{
+    // Ignore the given term if it isn't the one we are waiting for (e.g. it was
+    // looked up by another instance of ourselves or we have moved on to
+    // another term since)
 
-    updateGui(mElement);
+    if (pTerm.compare(mPendingTerm))
+        return;
 
-    // Delete (later) the network reply
+    mPendingTerm = QString();
 
-    if (pNetworkReply)
-        pNetworkReply->deleteLater();
-}
+    // Keep track of the term we have just looked up
 
-//==============================================================================
+    mTerm = pTerm;
 
-void CellmlAnnotationViewMetadataEditDetailsWidget::sslErrors(QNetworkReply *pNetworkReply,
-                                                              const QList<QSslError> &pSslErrors)
-{
-    // Ignore the SSL errors since we trust the website and therefore its
-    // certificate (even if it is invalid, e.g. it has expired)
+    // Retrieve the list of terms, should there be no error
+
+    CellmlAnnotationViewMetadataEditDetailsItems items = CellmlAnnotationViewMetadataEditDetailsItems();
+    QString errorMessage = pErrorMessage;
+
+    if (pInternetConnectionAvailable && errorMessage.isEmpty())
+        items = termItems(pData, errorMessage);
 
-    pNetworkReply->ignoreSslErrors(pSslErrors);
+    // Update our GUI with the results of the look up after having kept track
+    // of its size
+
+    mItemsCount = items.count();
+
+    updateItemsGui(items, false, errorMessage, pInternetConnectionAvailable);
+
+    // Update our GUI (incl. its enabled state)
+
+    updateGui(mElement);
 }
 
 //==============================================================================
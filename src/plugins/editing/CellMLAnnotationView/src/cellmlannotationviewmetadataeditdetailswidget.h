@@ -31,7 +31,6 @@ limitations under the License.
 
 #include <QMap>
 #include <QModelIndex>
-#include <QSslError>
 #include <QStandardItem>
 #include <QStyledItemDelegate>
 #include <QStyleOptionViewItem>
@@ -42,8 +41,6 @@ class QComboBox;
 class QLabel;
 class QLineEdit;
 class QMenu;
-class QNetworkAccessManager;
-class QNetworkReply;
 class QPushButton;
 class QScrollArea;
 
@@ -124,8 +121,6 @@ private:
     CellmlAnnotationViewWidget *mViewWidget;
     CellmlAnnotationViewEditingWidget *mViewEditingWidget;
 
-    QNetworkAccessManager *mNetworkAccessManager;
-
     QLabel *mQualifierLabel;
     QComboBox *mQualifierValue;
     QPushButton *mLookUpQualifierButton;
@@ -136,6 +131,7 @@ private:
 
     QString mTerm;
     QStringList mTerms;
+    QString mPendingTerm;
 
     int mItemsCount;
 
@@ -173,8 +169,6 @@ private:
 
     QAction *mCopyAction;
 
-    QNetworkReply *mNetworkReply;
-
     void upudateOutputMessage(const bool &pLookUpTerm,
                               const QString &pErrorMessage,
                               const bool &pInternetConnectionAvailable,
@@ -191,6 +185,10 @@ private:
 
     bool isDirectTerm(const QString &pTerm) const;
 
+    CellmlAnnotationViewMetadataEditDetailsItems termItems(const QByteArray &pData,
+                                                           QString &pErrorMessage) const;
+    bool lookUpCachedTerm(const QString &pTerm);
+
 Q_SIGNALS:
     void qualifierLookUpRequested(const QString &pQualifier);
     void resourceLookUpRequested(const QString &pResource);
@@ -217,9 +215,9 @@ private Q_SLOTS:
     void lookUpTerm();
 
     void termChanged(const QString &pTerm);
-    void termLookedUp(QNetworkReply *pNetworkReply = 0);
-    void sslErrors(QNetworkReply *pNetworkReply,
-                   const QList<QSslError> &pSslErrors);
+    void termLookedUp(const QString &pTerm, const QByteArray &pData,
+                      const QString &pErrorMessage,
+                      const bool &pInternetConnectionAvailable = true);
 
     void addTerm();
 
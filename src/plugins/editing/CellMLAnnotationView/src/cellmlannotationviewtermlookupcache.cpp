@@ -0,0 +1,334 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Annotation view term look up cache
+//==============================================================================
+
+#include "cellmlannotationviewtermlookupcache.h"
+
+//==============================================================================
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QStandardPaths>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLAnnotationView {
+
+//==============================================================================
+
+static const quint32 CacheMagicNumber = 0x4f434c43;   // i.e. "OCLC"
+static const quint32 CacheVersion = 1;
+
+static const qint64 DefCachedTermTimeToLive = 7*24*60*60;   // i.e. 7 days
+static const int MaxNbOfCachedTerms = 10000;
+
+//==============================================================================
+
+CellmlAnnotationViewTermLookUpCache::CellmlAnnotationViewTermLookUpCache(QObject *pParent) :
+    QObject(pParent),
+    mUrl(DefTermLookUpUrl),
+    mTimeToLive(DefCachedTermTimeToLive),
+    mCachedTerms(QMap<QString, CachedTerm>()),
+    mModified(false),
+    mNetworkReplies(QMap<QString, QNetworkReply *>())
+{
+    // Create a network access manager so that we can look up terms
+
+    mNetworkAccessManager = new QNetworkAccessManager(this);
+
+    connect(mNetworkAccessManager, SIGNAL(finished(QNetworkReply *)),
+            this, SLOT(networkReplyFinished(QNetworkReply *)));
+    connect(mNetworkAccessManager, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)),
+            this, SLOT(sslErrors(QNetworkReply *, const QList<QSslError> &)));
+
+    // Retrieve the terms we previously looked up
+
+    mFileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"TermLookUps.dat";
+
+    loadCache();
+}
+
+//==============================================================================
+
+CellmlAnnotationViewTermLookUpCache::~CellmlAnnotationViewTermLookUpCache()
+{
+    // Keep track of the terms we have looked up since we last saved our cache,
+    // if any
+
+    if (mModified)
+        saveCache();
+}
+
+//==============================================================================
+
+QString CellmlAnnotationViewTermLookUpCache::url() const
+{
+    // Return the URL we use to look up terms
+
+    return mUrl;
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::setUrl(const QString &pUrl)
+{
+    // Set the URL we use to look up terms, replacing our cache with the one we
+    // may have saved for it, if it is a new one, since it is unlikely to give
+    // us the same results
+    // Note: this is mainly so that we can test things against a stand-in
+    //       server...
+
+    if (pUrl.isEmpty() || !pUrl.compare(mUrl))
+        return;
+
+    if (mModified)
+        saveCache();
+
+    mUrl = pUrl;
+
+    mCachedTerms.clear();
+
+    loadCache();
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::setTimeToLive(const qint64 &pTimeToLive)
+{
+    // Set the number of seconds for which a cached term remains fresh
+    // Note: this is only so that we can test the expiry of our cached terms...
+
+    mTimeToLive = pTimeToLive;
+}
+
+//==============================================================================
+
+bool CellmlAnnotationViewTermLookUpCache::isFresh(const CachedTerm &pCachedTerm) const
+{
+    // Return whether the given cached term is still fresh
+
+    return pCachedTerm.first.secsTo(QDateTime::currentDateTimeUtc()) < mTimeToLive;
+}
+
+//==============================================================================
+
+bool CellmlAnnotationViewTermLookUpCache::cachedTerm(const QString &pTerm,
+                                                     QByteArray &pData) const
+{
+    // Retrieve the data for the given term, if we have it and it is still
+    // fresh
+
+    QMap<QString, CachedTerm>::ConstIterator iter = mCachedTerms.constFind(pTerm);
+
+    if ((iter != mCachedTerms.constEnd()) && isFresh(iter.value())) {
+        pData = iter.value().second;
+
+        return true;
+    } else {
+        return false;
+    }
+}
+
+//==============================================================================
+
+bool CellmlAnnotationViewTermLookUpCache::cachedPrefixTerm(const QString &pTerm,
+                                                           QString &pPrefixTerm,
+                                                           QByteArray &pData) const
+{
+    // Retrieve the data for the longest (fresh) term we have that is a prefix
+    // of the given term, if any
+
+    for (int i = pTerm.size()-1; i > 0; --i) {
+        QString prefixTerm = pTerm.left(i);
+
+        if (cachedTerm(prefixTerm, pData)) {
+            pPrefixTerm = prefixTerm;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::lookUpTerm(const QString &pTerm)
+{
+    // Let people know straightaway about the given term, if we have it in our
+    // cache
+
+    QByteArray data;
+
+    if (cachedTerm(pTerm, data)) {
+        emit termLookedUp(pTerm, data, QString());
+
+        return;
+    }
+
+    // Look up the given term, unless it is already being looked up, in which
+    // case people will get told about it when that look up is done
+
+    if (!mNetworkReplies.contains(pTerm))
+        mNetworkReplies.insert(pTerm, mNetworkAccessManager->get(QNetworkRequest(mUrl+pTerm)));
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::networkReplyFinished(QNetworkReply *pNetworkReply)
+{
+    // Retrieve the term that was looked up and stop tracking its look up
+
+    QString term = mNetworkReplies.key(pNetworkReply);
+
+    mNetworkReplies.remove(term);
+
+    // Cache the data we got back, if any, and let people know about it
+
+    QByteArray data = QByteArray();
+    QString errorMessage = QString();
+
+    if (pNetworkReply->error() == QNetworkReply::NoError) {
+        data = pNetworkReply->readAll();
+
+        mCachedTerms.insert(term, CachedTerm(QDateTime::currentDateTimeUtc(), data));
+
+        mModified = true;
+    } else {
+        errorMessage = pNetworkReply->errorString();
+    }
+
+    emit termLookedUp(term, data, errorMessage);
+
+    // Save our cache once we are done with a batch of look ups, i.e. once we
+    // have no more terms to look up, so that we don't lose them if we were to
+    // crash, without saving it after every single look up
+
+    if (mModified && mNetworkReplies.isEmpty())
+        saveCache();
+
+    // Delete (later) the network reply
+
+    pNetworkReply->deleteLater();
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::sslErrors(QNetworkReply *pNetworkReply,
+                                                    const QList<QSslError> &pSslErrors)
+{
+    // Ignore the SSL errors since we trust the website and therefore its
+    // certificate (even if it is invalid, e.g. it has expired)
+
+    pNetworkReply->ignoreSslErrors(pSslErrors);
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::loadCache()
+{
+    // Load our cache, keeping only the terms that are still fresh
+
+    QFile file(mFileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    quint32 magicNumber;
+    quint32 version;
+
+    stream >> magicNumber >> version;
+
+    if ((magicNumber != CacheMagicNumber) || (version != CacheVersion))
+        return;
+
+    QString url;
+    QMap<QString, CachedTerm> cachedTerms;
+
+    stream >> url >> cachedTerms;
+
+    if ((stream.status() != QDataStream::Ok) || url.compare(mUrl))
+        return;
+
+    for (QMap<QString, CachedTerm>::ConstIterator iter = cachedTerms.constBegin(),
+                                                  iterEnd = cachedTerms.constEnd();
+         iter != iterEnd; ++iter) {
+        if (isFresh(iter.value()))
+            mCachedTerms.insert(iter.key(), iter.value());
+    }
+}
+
+//==============================================================================
+
+void CellmlAnnotationViewTermLookUpCache::saveCache()
+{
+    // Save our cache, keeping only the most recently looked up terms that are
+    // still fresh
+
+    QMultiMap<QDateTime, QString> terms = QMultiMap<QDateTime, QString>();
+
+    for (QMap<QString, CachedTerm>::ConstIterator iter = mCachedTerms.constBegin(),
+                                                  iterEnd = mCachedTerms.constEnd();
+         iter != iterEnd; ++iter) {
+        if (isFresh(iter.value()))
+            terms.insert(iter.value().first, iter.key());
+    }
+
+    QMap<QString, CachedTerm> cachedTerms = QMap<QString, CachedTerm>();
+    QMultiMap<QDateTime, QString>::ConstIterator iter = terms.constEnd();
+
+    while (   (iter != terms.constBegin())
+           && (cachedTerms.count() < MaxNbOfCachedTerms)) {
+        --iter;
+
+        cachedTerms.insert(iter.value(), mCachedTerms.value(iter.value()));
+    }
+
+    if (!QDir().mkpath(QFileInfo(mFileName).absolutePath()))
+        return;
+
+    QFile file(mFileName);
+
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+        return;
+
+    QDataStream stream(&file);
+
+    stream << CacheMagicNumber << CacheVersion << mUrl << cachedTerms;
+
+    mModified = false;
+}
+
+//==============================================================================
+
+}   // namespace CellMLAnnotationView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,106 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Annotation view term look up cache
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+#include <QSslError>
+
+//==============================================================================
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLAnnotationView {
+
+//==============================================================================
+
+static const auto DefTermLookUpUrl = QStringLiteral("https://models.physiomeproject.org/pmr2_ricordo/miriam_terms/");
+
+//==============================================================================
+
+class CellmlAnnotationViewTermLookUpCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CellmlAnnotationViewTermLookUpCache(QObject *pParent);
+    ~CellmlAnnotationViewTermLookUpCache();
+
+    QString url() const;
+    void setUrl(const QString &pUrl);
+
+    void setTimeToLive(const qint64 &pTimeToLive);
+
+    bool cachedTerm(const QString &pTerm, QByteArray &pData) const;
+    bool cachedPrefixTerm(const QString &pTerm, QString &pPrefixTerm,
+                          QByteArray &pData) const;
+
+    void lookUpTerm(const QString &pTerm);
+
+private:
+    typedef QPair<QDateTime, QByteArray> CachedTerm;
+
+    QNetworkAccessManager *mNetworkAccessManager;
+
+    QString mUrl;
+    QString mFileName;
+
+    qint64 mTimeToLive;
+
+    QMap<QString, CachedTerm> mCachedTerms;
+    bool mModified;
+
+    QMap<QString, QNetworkReply *> mNetworkReplies;
+
+    bool isFresh(const CachedTerm &pCachedTerm) const;
+
+    void loadCache();
+    void saveCache();
+
+Q_SIGNALS:
+    void termLookedUp(const QString &pTerm, const QByteArray &pData,
+                      const QString &pErrorMessage);
+
+private Q_SLOTS:
+    void networkReplyFinished(QNetworkReply *pNetworkReply);
+    void sslErrors(QNetworkReply *pNetworkReply,
+                   const QList<QSslError> &pSslErrors);
+};
+
+//==============================================================================
+
+}   // namespace CellMLAnnotationView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
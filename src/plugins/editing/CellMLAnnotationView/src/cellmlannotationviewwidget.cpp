@@ -24,6 +24,7 @@ limitations under the License.
 #include "cellmlannotationvieweditingwidget.h"
 #include "cellmlannotationviewmetadatadetailswidget.h"
 #include "cellmlannotationviewplugin.h"
+#include "cellmlannotationviewtermlookupcache.h"
 #include "cellmlannotationviewwidget.h"
 
 //==============================================================================
@@ -51,12 +52,17 @@ CellmlAnnotationViewWidget::CellmlAnnotationViewWidget(CellMLAnnotationViewPlugi
     mEditingWidgetSizes(QIntList()),
     mMetadataDetailsWidgetSizes(QIntList())
 {
+    // Create our term look up cache, which is shared by all our editing
+    // widgets
+
+    mTermLookUpCache = new CellmlAnnotationViewTermLookUpCache(this);
 }
 
 //==============================================================================
 
 static const auto SettingsCellmlAnnotationViewEditingWidgetSizes         = QStringLiteral("EditingWidgetSizes");
 static const auto SettingsCellmlAnnotationViewMetadataDetailsWidgetSizes = QStringLiteral("MetadataDetailsWidgetSizes");
+static const auto SettingsCellmlAnnotationViewTermLookUpUrl              = QStringLiteral("TermLookUpUrl");
 
 //==============================================================================
 
@@ -76,6 +82,11 @@ void CellmlAnnotationViewWidget::loadSettings(QSettings *pSettings)
 
     mEditingWidgetSizes = qVariantListToIntList(pSettings->value(SettingsCellmlAnnotationViewEditingWidgetSizes, defaultEditingWidgetSizes).toList());
     mMetadataDetailsWidgetSizes = qVariantListToIntList(pSettings->value(SettingsCellmlAnnotationViewMetadataDetailsWidgetSizes, defaultMetadataDetailsWidgetSizes).toList());
+
+    // Retrieve the URL to use to look up terms
+    // Note: this allows us to test term look ups against a stand-in server...
+
+    mTermLookUpCache->setUrl(pSettings->value(SettingsCellmlAnnotationViewTermLookUpUrl, DefTermLookUpUrl).toString());
 }
 
 //==============================================================================
@@ -86,6 +97,10 @@ void CellmlAnnotationViewWidget::saveSettings(QSettings *pSettings) const
 
     pSettings->setValue(SettingsCellmlAnnotationViewEditingWidgetSizes, qIntListToVariantList(mEditingWidgetSizes));
     pSettings->setValue(SettingsCellmlAnnotationViewMetadataDetailsWidgetSizes, qIntListToVariantList(mMetadataDetailsWidgetSizes));
+
+    // Keep track of the URL to use to look up terms
+
+    pSettings->setValue(SettingsCellmlAnnotationViewTermLookUpUrl, mTermLookUpCache->url());
 }
 
 //==============================================================================
@@ -237,6 +252,15 @@ CellmlAnnotationViewEditingWidget * CellmlAnnotationViewWidget::editingWidget(co
 
 //==============================================================================
 
+CellmlAnnotationViewTermLookUpCache * CellmlAnnotationViewWidget::termLookUpCache() const
+{
+    // Return our term look up cache
+
+    return mTermLookUpCache;
+}
+
+//==============================================================================
+
 QString CellmlAnnotationViewWidget::resourceUrl(const QString &pResource)
 {
     // Return the URL for the given resource
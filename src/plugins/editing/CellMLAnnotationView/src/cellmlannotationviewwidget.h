@@ -40,6 +40,7 @@ namespace CellMLAnnotationView {
 
 class CellmlAnnotationViewEditingWidget;
 class CellMLAnnotationViewPlugin;
+class CellmlAnnotationViewTermLookUpCache;
 
 //==============================================================================
 
@@ -67,6 +68,8 @@ public:
 
     CellmlAnnotationViewEditingWidget * editingWidget(const QString &pFileName) const;
 
+    CellmlAnnotationViewTermLookUpCache * termLookUpCache() const;
+
     static QString resourceUrl(const QString &pResource);
     static QString idUrl(const QString &pResource, const QString &pId);
 
@@ -79,6 +82,8 @@ private:
     QIntList mEditingWidgetSizes;
     QIntList mMetadataDetailsWidgetSizes;
 
+    CellmlAnnotationViewTermLookUpCache *mTermLookUpCache;
+
 private Q_SLOTS:
     void editingWidgetSplitterMoved(const QIntList &pSizes);
     void metadataDetailsWidgetSplitterMoved(const QIntList &pSizes);
@@ -0,0 +1,278 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Annotation view tests
+//==============================================================================
+
+#include "cellmlannotationviewtermlookupcache.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QTcpSocket>
+
+//==============================================================================
+
+static const auto TermsPath = QStringLiteral("/terms/");
+
+//==============================================================================
+
+static QByteArray termData(const QString &pTerm)
+{
+    // Return the data that our stand-in server returns for the given term
+
+    return QString("{\"term\": \"%1\"}").arg(pTerm).toUtf8();
+}
+
+//==============================================================================
+
+TermLookUpServer::TermLookUpServer(QObject *pParent) :
+    QTcpServer(pParent),
+    mRequestedTerms(QStringList())
+{
+    // Listen to local connections
+
+    connect(this, SIGNAL(newConnection()),
+            this, SLOT(acceptConnection()));
+
+    listen(QHostAddress::LocalHost);
+}
+
+//==============================================================================
+
+QString TermLookUpServer::url() const
+{
+    // Return the URL to use to look up terms using our server
+
+    return QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(TermsPath);
+}
+
+//==============================================================================
+
+QStringList TermLookUpServer::requestedTerms() const
+{
+    // Return the terms that we have been asked to look up
+
+    return mRequestedTerms;
+}
+
+//==============================================================================
+
+void TermLookUpServer::acceptConnection()
+{
+    // Reply to our new connection's request, once we have received it
+
+    while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+
+        connect(socket, SIGNAL(readyRead()),
+                this, SLOT(replyToRequest()));
+        connect(socket, SIGNAL(disconnected()),
+                socket, SLOT(deleteLater()));
+    }
+}
+
+//==============================================================================
+
+void TermLookUpServer::replyToRequest()
+{
+    // Make sure that we have received the whole request, i.e. its request line
+    // and its headers
+
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray request = socket->peek(socket->bytesAvailable());
+
+    if (!request.contains("\r\n\r\n"))
+        return;
+
+    socket->readAll();
+
+    // Retrieve the term from our request line, i.e. "GET /terms/<term> ...",
+    // keep track of it and reply with its data
+
+    QString path = QUrl::fromPercentEncoding(request.left(request.indexOf("\r\n")).split(' ').value(1));
+    QString term = path.mid(TermsPath.size());
+    QByteArray data = termData(term);
+
+    mRequestedTerms << term;
+
+    socket->write("HTTP/1.1 200 OK\r\n"
+                  "Content-Type: application/json\r\n"
+                  "Content-Length: "+QByteArray::number(data.size())+"\r\n"
+                  "Connection: close\r\n"
+                  "\r\n"+data);
+    socket->disconnectFromHost();
+}
+
+//==============================================================================
+
+static QByteArray lookUpTerm(OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache &pTermLookUpCache,
+                             const QString &pTerm)
+{
+    // Look up the given term and wait for its data
+
+    QSignalSpy termLookedUpSpy(&pTermLookUpCache, SIGNAL(termLookedUp(const QString &, const QByteArray &, const QString &)));
+
+    pTermLookUpCache.lookUpTerm(pTerm);
+
+    if (termLookedUpSpy.isEmpty() && !termLookedUpSpy.wait(10000))
+        return QByteArray();
+
+    return termLookedUpSpy.first().value(1).toByteArray();
+}
+
+//==============================================================================
+
+void Tests::initTestCase()
+{
+    // Make sure that we don't use (and therefore mess up) the user's cache
+
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+//==============================================================================
+
+void Tests::requestMergingTests()
+{
+    // Look up the same term twice in a row and check that it results in only
+    // one request to our server and in only one notification
+
+    TermLookUpServer server;
+    OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache termLookUpCache(0);
+    QSignalSpy termLookedUpSpy(&termLookUpCache, SIGNAL(termLookedUp(const QString &, const QByteArray &, const QString &)));
+
+    termLookUpCache.setUrl(server.url());
+
+    termLookUpCache.lookUpTerm("GO:0005886");
+    termLookUpCache.lookUpTerm("GO:0005886");
+
+    QVERIFY(termLookedUpSpy.wait(10000));
+    QCOMPARE(termLookedUpSpy.count(), 1);
+    QCOMPARE(termLookedUpSpy.first().value(0).toString(), QString("GO:0005886"));
+    QCOMPARE(termLookedUpSpy.first().value(1).toByteArray(), termData("GO:0005886"));
+    QCOMPARE(termLookedUpSpy.first().value(2).toString(), QString());
+    QCOMPARE(server.requestedTerms(), QStringList() << "GO:0005886");
+
+    // Looking up our term again should give us its cached data straightaway,
+    // i.e. without our server being involved
+
+    termLookUpCache.lookUpTerm("GO:0005886");
+
+    QCOMPARE(termLookedUpSpy.count(), 2);
+    QCOMPARE(termLookedUpSpy.last().value(1).toByteArray(), termData("GO:0005886"));
+    QCOMPARE(server.requestedTerms().count(), 1);
+}
+
+//==============================================================================
+
+void Tests::expiryTests()
+{
+    // Check that a cached term remains fresh for as long as it should
+
+    TermLookUpServer server;
+    OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache termLookUpCache(0);
+    QByteArray data;
+
+    termLookUpCache.setUrl(server.url());
+
+    QCOMPARE(lookUpTerm(termLookUpCache, "CHEBI:15377"), termData("CHEBI:15377"));
+    QCOMPARE(lookUpTerm(termLookUpCache, "CHEBI:15377"), termData("CHEBI:15377"));
+    QVERIFY(termLookUpCache.cachedTerm("CHEBI:15377", data));
+    QCOMPARE(server.requestedTerms().count(), 1);
+
+    // Once expired, our cached term should be looked up again
+
+    termLookUpCache.setTimeToLive(0);
+
+    QVERIFY(!termLookUpCache.cachedTerm("CHEBI:15377", data));
+    QCOMPARE(lookUpTerm(termLookUpCache, "CHEBI:15377"), termData("CHEBI:15377"));
+    QCOMPARE(server.requestedTerms().count(), 2);
+}
+
+//==============================================================================
+
+void Tests::prefixFallbackTests()
+{
+    // Check that we can retrieve the data of the longest cached term that is a
+    // prefix of a given term
+
+    TermLookUpServer server;
+    OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache termLookUpCache(0);
+    QString prefixTerm;
+    QByteArray data;
+
+    termLookUpCache.setUrl(server.url());
+
+    QCOMPARE(lookUpTerm(termLookUpCache, "GO:00"), termData("GO:00"));
+    QCOMPARE(lookUpTerm(termLookUpCache, "GO:0005"), termData("GO:0005"));
+
+    QVERIFY(!termLookUpCache.cachedTerm("GO:000588", data));
+    QVERIFY(termLookUpCache.cachedPrefixTerm("GO:000588", prefixTerm, data));
+    QCOMPARE(prefixTerm, QString("GO:0005"));
+    QCOMPARE(data, termData("GO:0005"));
+
+    QVERIFY(termLookUpCache.cachedPrefixTerm("GO:001", prefixTerm, data));
+    QCOMPARE(prefixTerm, QString("GO:00"));
+    QCOMPARE(data, termData("GO:00"));
+
+    QVERIFY(!termLookUpCache.cachedPrefixTerm("CHEBI:1", prefixTerm, data));
+
+    // Expired terms should not be used as a fallback
+
+    termLookUpCache.setTimeToLive(0);
+
+    QVERIFY(!termLookUpCache.cachedPrefixTerm("GO:000588", prefixTerm, data));
+}
+
+//==============================================================================
+
+void Tests::persistenceTests()
+{
+    // Check that our cache gets saved as soon as we are done with a batch of
+    // look ups, i.e. without having to wait for our cache to be deleted, and
+    // that it gets loaded back
+
+    TermLookUpServer server;
+    OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache termLookUpCache(0);
+    QByteArray data;
+
+    termLookUpCache.setUrl(server.url());
+
+    QCOMPARE(lookUpTerm(termLookUpCache, "FMA:9670"), termData("FMA:9670"));
+
+    OpenCOR::CellMLAnnotationView::CellmlAnnotationViewTermLookUpCache otherTermLookUpCache(0);
+
+    otherTermLookUpCache.setUrl(server.url());
+
+    QVERIFY(otherTermLookUpCache.cachedTerm("FMA:9670", data));
+    QCOMPARE(data, termData("FMA:9670"));
+    QCOMPARE(server.requestedTerms().count(), 1);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
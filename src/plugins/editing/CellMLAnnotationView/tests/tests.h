@@ -0,0 +1,69 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Annotation view tests
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QObject>
+#include <QStringList>
+#include <QTcpServer>
+
+//==============================================================================
+
+class TermLookUpServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit TermLookUpServer(QObject *pParent = 0);
+
+    QString url() const;
+
+    QStringList requestedTerms() const;
+
+private:
+    QStringList mRequestedTerms;
+
+private Q_SLOTS:
+    void acceptConnection();
+    void replyToRequest();
+};
+
+//==============================================================================
+
+class Tests : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void requestMergingTests();
+    void expiryTests();
+    void prefixFallbackTests();
+    void persistenceTests();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -137,8 +137,8 @@ private:
     QDomElement newMathematicalFunctionElement(const CellmlTextViewScanner::TokenType &pTokenType,
                                                const QList<QDomElement> &pArgumentElements);
 
-    CellmlTextViewScanner::TokenTypes rangeOfTokenTypes(const CellmlTextViewScanner::TokenType &pFromTokenType,
-                                                        const CellmlTextViewScanner::TokenType &pToTokenType);
+    static CellmlTextViewScanner::TokenTypes rangeOfTokenTypes(const CellmlTextViewScanner::TokenType &pFromTokenType,
+                                                               const CellmlTextViewScanner::TokenType &pToTokenType);
 
     bool tokenType(QDomNode &pDomNode, const QString &pExpectedString,
                    const CellmlTextViewScanner::TokenTypes &pTokenTypes);
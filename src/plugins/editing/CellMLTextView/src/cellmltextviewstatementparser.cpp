@@ -0,0 +1,154 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Text view statement parser
+//==============================================================================
+
+#include "cellmltextviewparser.h"
+#include "cellmltextviewstatementparser.h"
+#include "corecliutils.h"
+
+//==============================================================================
+
+#include <QThread>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLTextView {
+
+//==============================================================================
+
+CellmlTextViewStatementParser::CellmlTextViewStatementParser() :
+    mStopped(false),
+    mNewStatement(false),
+    mStatement(QString())
+{
+    // Create our thread
+
+    mThread = new QThread();
+
+    // Move ourselves to our thread
+
+    moveToThread(mThread);
+
+    // Create a few connections
+
+    connect(mThread, SIGNAL(started()),
+            this, SLOT(started()));
+
+    connect(mThread, SIGNAL(finished()),
+            mThread, SLOT(deleteLater()));
+    connect(mThread, SIGNAL(finished()),
+            this, SLOT(deleteLater()));
+
+    // Start our thread straightaway, so that it is ready to parse statements
+    // as soon as they come
+
+    mThread->start();
+}
+
+//==============================================================================
+
+void CellmlTextViewStatementParser::parse(const QString &pStatement)
+{
+    // Keep track of the given statement, replacing any statement that has not
+    // yet been parsed since we are only ever interested in the most recent one
+
+    mMutex.lock();
+        mNewStatement = true;
+        mStatement = pStatement;
+
+        mStatementCondition.wakeOne();
+    mMutex.unlock();
+}
+
+//==============================================================================
+
+void CellmlTextViewStatementParser::stop()
+{
+    // Ask our thread to stop
+
+    mMutex.lock();
+        mStopped = true;
+
+        mStatementCondition.wakeOne();
+    mMutex.unlock();
+
+    // Ask our thread to quit and wait for it to do so
+
+    mThread->quit();
+    mThread->wait();
+}
+
+//==============================================================================
+
+void CellmlTextViewStatementParser::started()
+{
+    // Parse our statements as they come
+    // Note: our parser and its DOM document are only ever used from within our
+    //       thread, so there is no need to protect them...
+
+    CellmlTextViewParser parser;
+
+    mMutex.lock();
+
+    while (!mStopped) {
+        if (mNewStatement) {
+            // Retrieve our statement and parse it
+
+            QString statement = mStatement;
+
+            mNewStatement = false;
+
+            mMutex.unlock();
+
+            QString contentMathml = QString();
+
+            if (parser.execute(statement)) {
+                contentMathml =  "<math xmlns=\"http://www.w3.org/1998/Math/MathML\">"
+                                +Core::cleanContentMathml(Core::serialiseDomDocument(parser.domDocument()))
+                                +"</math>";
+            }
+
+            // Let people know that our statement has been parsed
+            // Note: an empty Content MathML equation means that our statement
+            //       couldn't be parsed...
+
+            emit done(statement, contentMathml);
+
+            mMutex.lock();
+        } else {
+            // Wait for a new statement or for us to be asked to stop
+
+            mStatementCondition.wait(&mMutex);
+        }
+    }
+
+    mMutex.unlock();
+}
+
+//==============================================================================
+
+}   // namespace CellMLTextView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,79 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CellML Text view statement parser
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QWaitCondition>
+
+//==============================================================================
+
+class QThread;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLTextView {
+
+//==============================================================================
+
+class CellmlTextViewStatementParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CellmlTextViewStatementParser();
+
+    void parse(const QString &pStatement);
+
+    void stop();
+
+private:
+    QThread *mThread;
+
+    bool mStopped;
+
+    QMutex mMutex;
+    QWaitCondition mStatementCondition;
+
+    bool mNewStatement;
+    QString mStatement;
+
+Q_SIGNALS:
+    void done(const QString &pStatement, const QString &pContentMathml);
+
+private Q_SLOTS:
+    void started();
+};
+
+//==============================================================================
+
+}   // namespace CellMLTextView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -27,6 +27,7 @@ limitations under the License.
 #include "cellmltextviewconverter.h"
 #include "cellmltextviewlexer.h"
 #include "cellmltextviewparser.h"
+#include "cellmltextviewstatementparser.h"
 #include "cellmltextviewwidget.h"
 #include "corecliutils.h"
 #include "coreguiutils.h"
@@ -153,6 +154,15 @@ QDomDocument CellmlTextViewWidgetData::rdfNodes() const
 
 //==============================================================================
 
+static const int ViewerUpdateDelay = 100;
+
+// Maximum number of Content MathML equations that we keep track of, i.e. of
+// statements that we don't need to parse again
+
+static const int MaxNbOfContentMathmlEquations = 1000;
+
+//==============================================================================
+
 CellmlTextViewWidget::CellmlTextViewWidget(QWidget *pParent) :
     ViewWidget(pParent),
     mNeedLoadingSettings(true),
@@ -163,13 +173,48 @@ CellmlTextViewWidget::CellmlTextViewWidget(QWidget *pParent) :
     mParser(CellmlTextViewParser()),
     mEditorLists(QList<EditorWidget::EditorListWidget *>()),
     mPresentationMathmlEquations(QMap<QString, QString>()),
-    mContentMathmlEquation(QString())
+    mContentMathmlEquation(QString()),
+    mStatement(QString()),
+    mStatementKey(QString()),
+    mContentMathmlEquations(MaxNbOfContentMathmlEquations)
 {
     // Create our MathML converter and create a connection to retrieve the
     // result of its MathML conversions
 
     connect(&mMathmlConverter, SIGNAL(done(const QString &, const QString &)),
             this, SLOT(mathmlConversionDone(const QString &, const QString &)));
+
+    // Create a timer to update our viewer once the user has stopped typing or
+    // moving around for a wee bit
+    // Note: this avoids us having to look for, and possibly parse, a
+    //       statement for each and every key that gets pressed...
+
+    mViewerTimer = new QTimer(this);
+
+    mViewerTimer->setInterval(ViewerUpdateDelay);
+    mViewerTimer->setSingleShot(true);
+
+    connect(mViewerTimer, SIGNAL(timeout()),
+            this, SLOT(updateViewer()));
+
+    // Create our statement parser and create a connection to retrieve the
+    // result of its parsing
+
+    mStatementParser = new CellmlTextViewStatementParser();
+
+    connect(mStatementParser, SIGNAL(done(const QString &, const QString &)),
+            this, SLOT(statementParsed(const QString &, const QString &)));
+}
+
+//==============================================================================
+
+CellmlTextViewWidget::~CellmlTextViewWidget()
+{
+    // Stop our statement parser
+    // Note: we don't need to delete it since it will be done as part of its
+    //       thread being stopped...
+
+    mStatementParser->stop();
 }
 
 //==============================================================================
@@ -260,12 +305,13 @@ void CellmlTextViewWidget::initialize(const QString &pFileName,
 
             editingWidget->editor()->editor()->setLexer(new CellmlTextViewLexer(this));
 
-            // Update our viewer whenever necessary
+            // Update our viewer whenever necessary, albeit with a wee delay
+            // (see the constructor)
 
             connect(editingWidget->editor(), SIGNAL(textChanged()),
-                    this, SLOT(updateViewer()));
+                    mViewerTimer, SLOT(start()));
             connect(editingWidget->editor(), SIGNAL(cursorPositionChanged(const int &, const int &)),
-                    this, SLOT(updateViewer()));
+                    mViewerTimer, SLOT(start()));
         } else {
             // The conversion wasn't successful, so make the editor read-only
             // (since its contents is that of the file itself) and add a couple
@@ -340,6 +386,12 @@ void CellmlTextViewWidget::initialize(const QString &pFileName,
         // with the current file
 
         if (data->isValid()) {
+            // Note: our current statement key may be that of our 'old' editing
+            //       widget, so reset it to make sure that our viewer does get
+            //       updated...
+
+            mStatementKey = QString();
+
             updateViewer();
         } else {
             // Note: we use a single shot to give time to the setting up of the
@@ -976,9 +1028,11 @@ QString CellmlTextViewWidget::endOfPiecewiseStatement(int &pPosition) const
 
 //==============================================================================
 
-QString CellmlTextViewWidget::statement(const int &pPosition) const
+QString CellmlTextViewWidget::statement(const int &pPosition,
+                                        int &pStatementPosition) const
 {
-    // Retrieve the (partial) statement around the given position
+    // Retrieve the (partial) statement around the given position, as well as
+    // its position
 
     int fromPosition;
     int toPosition;
@@ -1031,18 +1085,52 @@ QString CellmlTextViewWidget::statement(const int &pPosition) const
 
         // Make sure that we are within our current statement
 
-        return ((pPosition >= fromPosition) && (pPosition < toPosition))?
-                   editor->textInRange(fromPosition, toPosition):
-                   QString();
+        if ((pPosition >= fromPosition) && (pPosition < toPosition)) {
+            pStatementPosition = fromPosition;
+
+            return editor->textInRange(fromPosition, toPosition);
+        } else {
+            pStatementPosition = -1;
+
+            return QString();
+        }
     } else {
         // Our current statement doesn't contain something that we can recognise
 
+        pStatementPosition = -1;
+
         return QString();
     }
 }
 
 //==============================================================================
 
+void CellmlTextViewWidget::updateContentMathmlEquation(const QString &pContentMathmlEquation)
+{
+    // Update our viewer using the given Content MathML equation, which is
+    // empty if our current statement couldn't be parsed
+
+    if (pContentMathmlEquation.isEmpty()) {
+        mContentMathmlEquation = QString();
+
+        mEditingWidget->mathmlViewer()->setError(true);
+    } else if (pContentMathmlEquation.compare(mContentMathmlEquation)) {
+        // It's a different equation from our previous one, so check whether we
+        // have already retrieved its Presentation MathML version
+
+        mContentMathmlEquation = pContentMathmlEquation;
+
+        QString presentationMathmlEquation = mPresentationMathmlEquations.value(pContentMathmlEquation);
+
+        if (!presentationMathmlEquation.isEmpty())
+            mEditingWidget->mathmlViewer()->setContents(presentationMathmlEquation);
+        else
+            mMathmlConverter.convert(pContentMathmlEquation);
+    }
+}
+
+//==============================================================================
+
 void CellmlTextViewWidget::updateViewer()
 {
     // Make sure that we still have an editing widget (i.e. it hasn't been
@@ -1053,51 +1141,74 @@ void CellmlTextViewWidget::updateViewer()
 
     // Retrieve the statement, if any, around our current position
 
-    QString currentStatement = statement(mEditingWidget->editor()->currentPosition());
+    int statementPosition;
+    QString currentStatement = statement(mEditingWidget->editor()->currentPosition(),
+                                         statementPosition);
+
+    // Check whether our statement is the one we have already dealt with, in
+    // which case there is nothing to be done
+    // Note: our key combines the hash of our statement with its position, so
+    //       that moving around within a statement or typing before or after it
+    //       doesn't result in any work...
+
+    QString statementSha1 = currentStatement.isEmpty()?
+                                QString():
+                                Core::sha1(currentStatement.toUtf8());
+    QString statementKey = QString("%1|%2").arg(statementPosition)
+                                           .arg(statementSha1);
+
+    if (!statementKey.compare(mStatementKey))
+        return;
+
+    mStatementKey = statementKey;
 
     // Update the contents of our viewer
 
     if (currentStatement.isEmpty()) {
         // There is no statement, so clear our viewer
 
+        mStatement = QString();
         mContentMathmlEquation = QString();
 
         mEditingWidget->mathmlViewer()->setContents(QString());
+    } else if (mContentMathmlEquations.contains(statementSha1)) {
+        // We have already parsed our statement, so reuse its Content MathML
+        // equation
+
+        mStatement = QString();
+
+        updateContentMathmlEquation(*mContentMathmlEquations.object(statementSha1));
     } else {
-        // There is a statement, so try to parse it
+        // We have never parsed our statement, so ask our statement parser to
+        // do it for us (in its own thread)
 
-        bool res = mParser.execute(currentStatement);
+        mStatement = currentStatement;
 
-        if (res) {
-            // The parsing was successful, so retrieve the Content MathML
-            // version of our statement and check whether it's the same as our
-            // previous one
+        mStatementParser->parse(currentStatement);
+    }
+}
 
-            QString contentMathmlEquation =  "<math xmlns=\"http://www.w3.org/1998/Math/MathML\">"
-                                            +Core::cleanContentMathml(Core::serialiseDomDocument(mParser.domDocument()))
-                                            +"</math>";
+//==============================================================================
 
-            if (contentMathmlEquation.compare(mContentMathmlEquation)) {
-                // It's a different one, so check whether we have already
-                // retrieved its Presentation MathML version
+void CellmlTextViewWidget::statementParsed(const QString &pStatement,
+                                           const QString &pContentMathml)
+{
+    // Keep track of the Content MathML equation for the given statement
+    // Note: our cache takes ownership of the equation and deletes the least
+    //       recently used equations once it is full...
 
-                mContentMathmlEquation = contentMathmlEquation;
+    mContentMathmlEquations.insert(Core::sha1(pStatement.toUtf8()), new QString(pContentMathml));
 
-                QString presentationMathmlEquation = mPresentationMathmlEquations.value(contentMathmlEquation);
+    // Update our viewer, but only if the given statement is still our current
+    // one and if we still have an editing widget (i.e. it hasn't been closed
+    // since the signal was emitted)
 
-                if (!presentationMathmlEquation.isEmpty())
-                    mEditingWidget->mathmlViewer()->setContents(presentationMathmlEquation);
-                else
-                    mMathmlConverter.convert(contentMathmlEquation);
-            }
-        } else {
-            // The parsing wasn't successful
+    if (!mEditingWidget || pStatement.compare(mStatement))
+        return;
 
-            mContentMathmlEquation = QString();
+    mStatement = QString();
 
-            mEditingWidget->mathmlViewer()->setError(true);
-        }
-    }
+    updateContentMathmlEquation(pContentMathml);
 }
 
 //==============================================================================
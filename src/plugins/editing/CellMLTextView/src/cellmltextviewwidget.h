@@ -33,10 +33,15 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QCache>
 #include <QMap>
 
 //==============================================================================
 
+class QTimer;
+
+//==============================================================================
+
 namespace OpenCOR {
 
 //==============================================================================
@@ -64,6 +69,10 @@ namespace CellMLTextView {
 
 //==============================================================================
 
+class CellmlTextViewStatementParser;
+
+//==============================================================================
+
 class CellmlTextViewWidgetData
 {
 public:
@@ -103,6 +112,7 @@ class CellmlTextViewWidget : public Core::ViewWidget
 
 public:
     explicit CellmlTextViewWidget(QWidget *pParent);
+    ~CellmlTextViewWidget();
 
     virtual void loadSettings(QSettings *pSettings);
     virtual void saveSettings(QSettings *pSettings) const;
@@ -150,6 +160,15 @@ private:
 
     QString mContentMathmlEquation;
 
+    QTimer *mViewerTimer;
+
+    CellmlTextViewStatementParser *mStatementParser;
+
+    QString mStatement;
+    QString mStatementKey;
+
+    QCache<QString, QString> mContentMathmlEquations;
+
     void commentOrUncommentLine(QScintillaSupport::QScintillaWidget *editor,
                                 const int &pLineNumber,
                                 const bool &pCommentLine);
@@ -160,13 +179,18 @@ private:
                              int &pToPosition) const;
     QString beginningOfPiecewiseStatement(int &pPosition) const;
     QString endOfPiecewiseStatement(int &pPosition) const;
-    QString statement(const int &pPosition) const;
+    QString statement(const int &pPosition, int &pStatementPosition) const;
+
+    void updateContentMathmlEquation(const QString &pContentMathmlEquation);
 
 private Q_SLOTS:
     void editorKeyPressed(QKeyEvent *pEvent, bool &pHandled);
 
     void updateViewer();
 
+    void statementParsed(const QString &pStatement,
+                         const QString &pContentMathml);
+
     void selectFirstItemInEditorList(EditorWidget::EditorListWidget *pEditorList = 0);
 
     void mathmlConversionDone(const QString &pContentMathml,
@@ -15,6 +15,10 @@
         <source>Analysis</source>
         <translation>Analyse</translation>
     </message>
+    <message>
+        <source>&lt;strong&gt;%1&lt;/strong&gt; is being downloaded...</source>
+        <translation>&lt;strong&gt;%1&lt;/strong&gt; est en cours de téléchargement...</translation>
+    </message>
     <message>
         <source>The &lt;strong&gt;%1&lt;/strong&gt; view does not support this type of file...</source>
         <translation>La vue &lt;strong&gt;%1&lt;/strong&gt; ne supporte pas ce type de fichier...</translation>
@@ -51,11 +51,15 @@ limitations under the License.
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
 #include <QRect>
 #include <QSettings>
 #include <QSizePolicy>
 #include <QStackedWidget>
 #include <QStatusBar>
+#include <QTimer>
 #include <QUrl>
 #include <QVariant>
 #include <QVBoxLayout>
@@ -147,6 +151,11 @@ CentralWidget::CentralWidget(QWidget *pParent) :
     mFileNames(QStringList()),
     mModes(QMap<ViewInterface::Mode, CentralWidgetMode *>()),
     mRemoteLocalFileNames(QMap<QString, QString>()),
+    mPendingFiles(QMap<QString, bool>()),
+    mNetworkAccessManager(0),
+    mDownloadedRemoteFiles(QMap<QString, QByteArray>()),
+    mRecentFileNamesOrUrls(QStringList()),
+    mFileNamesOrUrlsToPreload(QStringList()),
     mViews(QMap<QString, QWidget *>()),
     mDefaultViews(QStringList())
 {
@@ -328,11 +337,21 @@ CentralWidget::~CentralWidget()
 
 //==============================================================================
 
-static const auto SettingsFileNamesOrUrls      = QStringLiteral("FileNamesOrUrls");
-static const auto SettingsCurrentFileNameOrUrl = QStringLiteral("CurrentFileNameOrUrl");
-static const auto SettingsFileIsRemote         = QStringLiteral("FileIsRemote%1");
-static const auto SettingsFileMode             = QStringLiteral("FileMode%1");
-static const auto SettingsFileModeView         = QStringLiteral("FileModeView%1%2");
+static const auto SettingsFileNamesOrUrls       = QStringLiteral("FileNamesOrUrls");
+static const auto SettingsCurrentFileNameOrUrl  = QStringLiteral("CurrentFileNameOrUrl");
+static const auto SettingsRecentFileNamesOrUrls = QStringLiteral("RecentFileNamesOrUrls");
+static const auto SettingsNbOfPreloadedFiles    = QStringLiteral("NbOfPreloadedFiles");
+static const auto SettingsFileIsRemote          = QStringLiteral("FileIsRemote%1");
+static const auto SettingsFileMode              = QStringLiteral("FileMode%1");
+static const auto SettingsFileModeView          = QStringLiteral("FileModeView%1%2");
+
+//==============================================================================
+
+static const int DefaultNbOfPreloadedFiles = 2;
+
+//==============================================================================
+
+static const char *UrlProperty = "Url";
 
 //==============================================================================
 
@@ -377,31 +396,31 @@ void CentralWidget::loadSettings(QSettings *pSettings)
     emit atLeastOneFile(false);
     emit atLeastTwoFiles(false);
 
-    // Retrieve and open the files that were previously opened
+    // Retrieve the files that were previously opened and add them as pending
+    // files, i.e. files that will only get opened when their tab is first
+    // activated (or when they get preloaded), with remote files getting
+    // downloaded in the background in the meantime
+    // Note: we skip local files that don't exist anymore, as well as files
+    //       that are already opened (e.g. through the command line)...
 
     QStringList fileNamesOrUrls = pSettings->value(SettingsFileNamesOrUrls).toStringList();
 
     foreach (const QString &fileNameOrUrl, fileNamesOrUrls) {
-        if (pSettings->value(SettingsFileIsRemote.arg(fileNameOrUrl)).toBool())
-            openRemoteFile(fileNameOrUrl, false);
-        else
-            openFile(fileNameOrUrl);
+        if (pSettings->value(SettingsFileIsRemote.arg(fileNameOrUrl)).toBool()) {
+            if (!mRemoteLocalFileNames.contains(fileNameOrUrl))
+                addPendingFile(fileNameOrUrl, true);
+        } else if (QFile::exists(fileNameOrUrl)) {
+            QString nativeFileName = nativeCanonicalFileName(fileNameOrUrl);
+
+            if (!mFileNames.contains(nativeFileName))
+                addPendingFile(nativeFileName, false);
+        }
     }
 
-    // Make sure that our busy widget is hidden
-    // Note: indeed, if we opened some remote files, then it will have been
-    //       shown, but not hidden since this would normally be done by
-    //       updateGui() who can't do it since mState is set to Starting at this
-    //       stage...
-
-    hideBusyWidget();
-
     // Retrieve the selected modes and views of our different files
 
     foreach (const QString &fileName, mFileNames) {
-        QString fileNameOrUrl = fileManagerInstance->isRemote(fileName)?
-                                    fileManagerInstance->url(fileName):
-                                    fileName;
+        QString fileNameOrUrl = this->fileNameOrUrl(fileName);
         ViewInterface::Mode fileMode = ViewInterface::modeFromString(pSettings->value(SettingsFileMode.arg(fileNameOrUrl)).toString());
 
         if (fileMode != ViewInterface::UnknownMode)
@@ -427,16 +446,15 @@ void CentralWidget::loadSettings(QSettings *pSettings)
         mFileModeViewTabIndexes.insert(fileName, modeViewTabIndexes);
     }
 
-    // Select the previously selected file, if it still exists, by pretending to
-    // open it (which, in turn, will select the file)
+    // Select the previously selected file, if it still exists
 
     QString crtFileNameOrUrl = pSettings->value(SettingsCurrentFileNameOrUrl).toString();
     QString crtFileName = pSettings->value(SettingsFileIsRemote.arg(crtFileNameOrUrl)).toBool()?
-                              mRemoteLocalFileNames.value(crtFileNameOrUrl):
-                              crtFileNameOrUrl;
+                              crtFileNameOrUrl:
+                              nativeCanonicalFileName(crtFileNameOrUrl);
 
     if (mFileNames.contains(crtFileName)) {
-        openFile(crtFileName);
+        mFileTabs->setCurrentIndex(mFileNames.indexOf(crtFileName));
     } else {
         // The previously selected file doesn't exist anymore, so select the
         // first file (otherwise the last file will be selected)
@@ -444,6 +462,28 @@ void CentralWidget::loadSettings(QSettings *pSettings)
         mFileTabs->setCurrentIndex(0);
     }
 
+    // Retrieve our most recently activated files and determine which of them
+    // should be preloaded (the current file will get opened anyway)
+
+    foreach (const QString &fileNameOrUrl, pSettings->value(SettingsRecentFileNamesOrUrls).toStringList()) {
+        QString fileName = mPendingFiles.contains(fileNameOrUrl)?
+                               fileNameOrUrl:
+                               nativeCanonicalFileName(fileNameOrUrl);
+
+        if (mPendingFiles.contains(fileName))
+            mRecentFileNamesOrUrls << fileName;
+    }
+
+    int nbOfPreloadedFiles = pSettings->value(SettingsNbOfPreloadedFiles, DefaultNbOfPreloadedFiles).toInt();
+
+    foreach (const QString &fileName, mRecentFileNamesOrUrls) {
+        if (mFileNamesOrUrlsToPreload.count() >= nbOfPreloadedFiles)
+            break;
+
+        if (fileName.compare(currentFileName()))
+            mFileNamesOrUrlsToPreload << fileName;
+    }
+
     // Retrieve the seleted modes and views, in case there are no files
 
     if (mFileNames.isEmpty()) {
@@ -488,7 +528,8 @@ void CentralWidget::saveSettings(QSettings *pSettings) const
         }
     }
 
-    // Keep track of the files that are opened, skipping new files
+    // Keep track of the files that are opened (including those that are still
+    // pending), skipping new files
 
     FileManager *fileManagerInstance = FileManager::instance();
     QStringList fileNames = QStringList();
@@ -499,13 +540,11 @@ void CentralWidget::saveSettings(QSettings *pSettings) const
             // The file is not new, so keep track of it, as well as of whether
             // it's a remote file
 
-            bool fileIsRemote = fileManagerInstance->isRemote(fileName);
-
-            if (fileIsRemote)
-                fileNamesOrUrls << fileManagerInstance->url(fileName);
-            else
-                fileNamesOrUrls << fileName;
+            bool fileIsRemote = mPendingFiles.contains(fileName)?
+                                    mPendingFiles.value(fileName):
+                                    fileManagerInstance->isRemote(fileName);
 
+            fileNamesOrUrls << fileNameOrUrl(fileName);
             fileNames << fileName;
 
             pSettings->setValue(SettingsFileIsRemote.arg(fileNamesOrUrls.last()), fileIsRemote);
@@ -517,9 +556,7 @@ void CentralWidget::saveSettings(QSettings *pSettings) const
     // Keep track of the selected modes and views of our different files
 
     foreach (const QString &fileName, fileNames) {
-        QString fileNameOrUrl = fileManagerInstance->isRemote(fileName)?
-                                    fileManagerInstance->url(fileName):
-                                    fileName;
+        QString fileNameOrUrl = this->fileNameOrUrl(fileName);
 
         pSettings->setValue(SettingsFileMode.arg(fileNameOrUrl),
                             ViewInterface::modeAsString(mModeTabIndexModes.value(mFileModeTabIndexes.value(fileName))));
@@ -543,15 +580,19 @@ void CentralWidget::saveSettings(QSettings *pSettings) const
     if (fileNames.count()) {
         QString crtFileName = mFileNames[mFileTabs->currentIndex()];
 
-        if (fileNames.contains(crtFileName)) {
-            crtFileNameOrUrl = fileManagerInstance->isRemote(crtFileName)?
-                                   fileManagerInstance->url(crtFileName):
-                                   crtFileName;
-        }
+        if (fileNames.contains(crtFileName))
+            crtFileNameOrUrl = fileNameOrUrl(crtFileName);
     }
 
     pSettings->setValue(SettingsCurrentFileNameOrUrl, crtFileNameOrUrl);
 
+    // Keep track of our most recently activated files and of the number of
+    // them that should be preloaded the next time we use OpenCOR
+
+    pSettings->setValue(SettingsRecentFileNamesOrUrls, mRecentFileNamesOrUrls);
+    pSettings->setValue(SettingsNbOfPreloadedFiles,
+                        pSettings->value(SettingsNbOfPreloadedFiles, DefaultNbOfPreloadedFiles));
+
     // Keep track of the selected modes and views, should there be no files the
     // next time we use OpenCOR
 
@@ -591,7 +632,18 @@ void CentralWidget::settingsLoaded(const Plugins &pLoadedPlugins)
 
     mState = Idling;
 
+    // Retrieve the files that have already been opened, i.e. those that are
+    // not pending
+
+    QStringList openedFileNames = QStringList();
+
+    foreach (const QString &fileName, mFileNames) {
+        if (!mPendingFiles.contains(fileName))
+            openedFileNames << fileName;
+    }
+
     // Update the GUI
+    // Note: this will open the current file, if it is pending...
 
     updateGui();
 
@@ -602,9 +654,13 @@ void CentralWidget::settingsLoaded(const Plugins &pLoadedPlugins)
     //       instead...
 
     foreach (Plugin *plugin, mLoadedFileHandlingPlugins) {
-        foreach (const QString &fileName, mFileNames)
+        foreach (const QString &fileName, openedFileNames)
             qobject_cast<FileHandlingInterface *>(plugin->instance())->fileOpened(fileName);
     }
+
+    // Start preloading the files that should be preloaded
+
+    QTimer::singleShot(0, this, SLOT(preloadFiles()));
 }
 
 //==============================================================================
@@ -680,8 +736,26 @@ void CentralWidget::updateFileTab(const int &pIndex, const bool &pIconOnly)
     static const QIcon InternetIcon = QIcon(":/oxygen/categories/applications-internet.png");
     static const QIcon LockedIcon   = QIcon(":/oxygen/status/object-locked.png");
 
-    FileManager *fileManagerInstance = FileManager::instance();
+    // Use the file name or URL of a pending file, since it isn't managed yet
+
     QString fileName = mFileNames[pIndex];
+
+    if (mPendingFiles.contains(fileName)) {
+        bool fileIsRemote = mPendingFiles.value(fileName);
+
+        if (!pIconOnly) {
+            mFileTabs->setTabText(pIndex, fileIsRemote?
+                                              QUrl(fileName).fileName():
+                                              QFileInfo(fileName).fileName());
+            mFileTabs->setTabToolTip(pIndex, fileName);
+        }
+
+        mFileTabs->setTabIcon(pIndex, fileIsRemote?InternetIcon:NoIcon);
+
+        return;
+    }
+
+    FileManager *fileManagerInstance = FileManager::instance();
     bool fileIsRemote = fileManagerInstance->isRemote(fileName);
     QIcon tabIcon = QIcon();
 
@@ -768,23 +842,9 @@ void CentralWidget::openFile(const QString &pFileName, const File::Type &pType,
     if (!pUrl.isEmpty())
         mRemoteLocalFileNames.insert(pUrl, nativeFileName);
 
-    // Check whether the file is recognised and, if so, the default views that
-    // ought to be tried when opening it
-
-    foreach (Plugin *plugin, mLoadedFileTypePlugins) {
-        FileTypeInterface *fileTypeInterface = qobject_cast<FileTypeInterface *>(plugin->instance());
-
-        if (fileTypeInterface->isFile(nativeFileName)) {
-            mDefaultViews = fileTypeInterface->defaultViews();
-
-            break;
-        }
-    }
+    // Retrieve the default views that ought to be tried when opening the file
 
-    // If there are no views, then try the Raw Text view
-
-    if (mDefaultViews.isEmpty())
-        mDefaultViews << "RawTextView";
+    retrieveDefaultViews(nativeFileName);
 
     // Create a new tab, insert it just after the current tab, set the full name
     // of the file as the tool tip for the new tab, and make the new tab the
@@ -821,6 +881,253 @@ void CentralWidget::openFile(const QString &pFileName, const File::Type &pType,
 
 //==============================================================================
 
+QString CentralWidget::fileNameOrUrl(const QString &pFileName) const
+{
+    // Return the file name or URL of the given file, depending on whether it
+    // is a remote file
+    // Note: a pending file is already referenced by its file name or URL...
+
+    FileManager *fileManagerInstance = FileManager::instance();
+
+    if (!mPendingFiles.contains(pFileName) && fileManagerInstance->isRemote(pFileName))
+        return fileManagerInstance->url(pFileName);
+    else
+        return pFileName;
+}
+
+//==============================================================================
+
+void CentralWidget::retrieveDefaultViews(const QString &pFileName)
+{
+    // Check whether the file is recognised and, if so, the default views that
+    // ought to be tried when opening it
+
+    foreach (Plugin *plugin, mLoadedFileTypePlugins) {
+        FileTypeInterface *fileTypeInterface = qobject_cast<FileTypeInterface *>(plugin->instance());
+
+        if (fileTypeInterface->isFile(pFileName)) {
+            mDefaultViews = fileTypeInterface->defaultViews();
+
+            break;
+        }
+    }
+
+    // If there are no views, then try the Raw Text view
+
+    if (mDefaultViews.isEmpty())
+        mDefaultViews << "RawTextView";
+}
+
+//==============================================================================
+
+void CentralWidget::addPendingFile(const QString &pFileNameOrUrl,
+                                   const bool &pRemote)
+{
+    // Add a tab for the given file, which will only get opened when its tab
+    // gets first activated, and insert it just after the current tab (as is
+    // done in openFile())
+
+    int fileTabIndex = mFileTabs->currentIndex()+1;
+
+    mPendingFiles.insert(pFileNameOrUrl, pRemote);
+
+    mFileNames.insert(fileTabIndex, pFileNameOrUrl);
+    mFileTabs->insertTab(fileTabIndex, QString());
+
+    updateFileTab(fileTabIndex);
+
+    mFileTabs->setCurrentIndex(fileTabIndex);
+
+    // Start downloading the file in the background, if it is a remote one
+
+    if (pRemote)
+        downloadRemoteFile(pFileNameOrUrl, pFileNameOrUrl);
+}
+
+//==============================================================================
+
+void CentralWidget::downloadRemoteFile(const QString &pUrl,
+                                       const QString &pRealUrl)
+{
+    // Create our network access manager, if needed
+    // Note: it allows for several files to be downloaded at once...
+
+    if (!mNetworkAccessManager) {
+        mNetworkAccessManager = new QNetworkAccessManager(this);
+
+        connect(mNetworkAccessManager, SIGNAL(finished(QNetworkReply *)),
+                this, SLOT(remoteFileDownloaded(QNetworkReply *)));
+        connect(mNetworkAccessManager, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)),
+                this, SLOT(remoteFileSslErrors(QNetworkReply *, const QList<QSslError> &)));
+    }
+
+    // Download the given file, keeping track of the URL under which it was
+    // opened (since pRealUrl may be the result of a redirection)
+
+    QNetworkReply *networkReply = mNetworkAccessManager->get(QNetworkRequest(QUrl(pRealUrl)));
+
+    networkReply->setProperty(UrlProperty, pUrl);
+}
+
+//==============================================================================
+
+void CentralWidget::remoteFileDownloaded(QNetworkReply *pNetworkReply)
+{
+    // Delete (later) the network reply
+
+    pNetworkReply->deleteLater();
+
+    // Make sure that the downloaded file is still pending (it may, for
+    // example, have been closed in the meantime)
+
+    QString url = pNetworkReply->property(UrlProperty).toString();
+    int fileTabIndex = mFileNames.indexOf(url);
+
+    if ((fileTabIndex == -1) || !mPendingFiles.contains(url))
+        return;
+
+    // Check whether we were able to download the file, following any
+    // redirection
+
+    if (pNetworkReply->error() == QNetworkReply::NoError) {
+        QUrl redirectedUrl = pNetworkReply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl();
+
+        if (!redirectedUrl.isEmpty()) {
+            downloadRemoteFile(url, redirectedUrl.toString());
+
+            return;
+        }
+
+        mDownloadedRemoteFiles.insert(url, pNetworkReply->readAll());
+
+        // Open the file straightaway if it is the current file or if it is to
+        // be preloaded
+
+        if (fileTabIndex == mFileTabs->currentIndex()) {
+            updateGui();
+        } else if (mFileNamesOrUrlsToPreload.contains(url)) {
+            mFileNamesOrUrlsToPreload.removeOne(url);
+
+            loadPendingFile(fileTabIndex);
+        }
+    } else {
+        // We couldn't download the file, so close its tab
+        // Note: this mimics what we used to do, i.e. remote files that could
+        //       not be downloaded when starting OpenCOR were simply ignored...
+
+        closeFile(fileTabIndex, true);
+    }
+}
+
+//==============================================================================
+
+void CentralWidget::remoteFileSslErrors(QNetworkReply *pNetworkReply,
+                                        const QList<QSslError> &pSslErrors)
+{
+    // Ignore the SSL errors since we assume the user knows what s/he is doing
+
+    pNetworkReply->ignoreSslErrors(pSslErrors);
+}
+
+//==============================================================================
+
+bool CentralWidget::loadPendingFile(const int &pIndex)
+{
+    // Make sure that the given file is pending and, if it is a remote file,
+    // that it has been downloaded
+
+    QString fileNameOrUrl = mFileNames[pIndex];
+
+    if (!mPendingFiles.contains(fileNameOrUrl))
+        return false;
+
+    bool fileIsRemote = mPendingFiles.value(fileNameOrUrl);
+
+    if (fileIsRemote && !mDownloadedRemoteFiles.contains(fileNameOrUrl))
+        return false;
+
+    // Retrieve the file name to use, which, for a remote file, means creating
+    // a local copy of it
+
+    QString fileName = fileNameOrUrl;
+
+    if (fileIsRemote) {
+        fileName = temporaryFileName();
+
+        if (!writeFileContentsToFile(fileName, mDownloadedRemoteFiles.value(fileNameOrUrl)))
+            return false;
+
+        mDownloadedRemoteFiles.remove(fileNameOrUrl);
+    }
+
+    QString nativeFileName = nativeCanonicalFileName(fileName);
+
+    // The file is not pending anymore, so update our internals accordingly
+
+    mPendingFiles.remove(fileNameOrUrl);
+
+    mFileNames[pIndex] = nativeFileName;
+
+    if (mFileModeTabIndexes.contains(fileNameOrUrl)) {
+        mFileModeTabIndexes.insert(nativeFileName, mFileModeTabIndexes.value(fileNameOrUrl));
+        mFileModeTabIndexes.remove(fileNameOrUrl);
+    }
+
+    if (mFileModeViewTabIndexes.contains(fileNameOrUrl)) {
+        mFileModeViewTabIndexes.insert(nativeFileName, mFileModeViewTabIndexes.value(fileNameOrUrl));
+        mFileModeViewTabIndexes.remove(fileNameOrUrl);
+    }
+
+    if (fileIsRemote)
+        mRemoteLocalFileNames.insert(fileNameOrUrl, nativeFileName);
+
+    // Register the file with our file manager and update its tab
+    // Note: the default views of the file, if needed, will be retrieved by
+    //       updateGui() when the file gets activated...
+
+    FileManager::instance()->manage(nativeFileName,
+                                    fileIsRemote?File::Remote:File::Local,
+                                    fileIsRemote?fileNameOrUrl:QString());
+
+    updateFileTab(pIndex);
+
+    // Let our plugins know that our file has been opened
+
+    foreach (Plugin *plugin, mLoadedFileHandlingPlugins)
+        qobject_cast<FileHandlingInterface *>(plugin->instance())->fileOpened(nativeFileName);
+
+    return true;
+}
+
+//==============================================================================
+
+void CentralWidget::preloadFiles()
+{
+    // Preload the next file that should be preloaded, if any, and then give
+    // the GUI a chance to handle events before preloading the next one
+    // Note: a remote file that hasn't yet been downloaded will get preloaded
+    //       as soon as it is (see remoteFileDownloaded())...
+
+    foreach (const QString &fileNameOrUrl, mFileNamesOrUrlsToPreload) {
+        if (   mPendingFiles.value(fileNameOrUrl)
+            && !mDownloadedRemoteFiles.contains(fileNameOrUrl)) {
+            continue;
+        }
+
+        mFileNamesOrUrlsToPreload.removeOne(fileNameOrUrl);
+
+        int fileTabIndex = mFileNames.indexOf(fileNameOrUrl);
+
+        if ((fileTabIndex != -1) && loadPendingFile(fileTabIndex)) {
+            QTimer::singleShot(0, this, SLOT(preloadFiles()));
+
+            return;
+        }
+    }
+}
+
+//==============================================================================
+
 void CentralWidget::openFiles(const QStringList &pFileNames)
 {
     // Open the various files
@@ -867,6 +1174,15 @@ void CentralWidget::openRemoteFile(const QString &pUrl,
         return;
     }
 
+    // Check whether the remote file is pending (i.e. it is being restored from
+    // our settings) and if so select it
+
+    if (mPendingFiles.contains(fileNameOrUrl)) {
+        mFileTabs->setCurrentIndex(mFileNames.indexOf(fileNameOrUrl));
+
+        return;
+    }
+
     // Check whether the remote file is already opened and if so select it,
     // otherwise retrieve its contents
 
@@ -1335,15 +1651,30 @@ bool CentralWidget::closeFile(const int &pIndex, const bool &pForceClosing)
         mFileModeTabIndexes.remove(fileName);
         mFileModeViewTabIndexes.remove(fileName);
 
-        FileManager *fileManagerInstance = FileManager::instance();
-
-        if (fileManagerInstance->isRemote(fileName))
-            mRemoteLocalFileNames.remove(fileManagerInstance->url(fileName));
+        mRecentFileNamesOrUrls.removeOne(fileNameOrUrl(fileName));
 
         // Remove the file tab
 
         mFileTabs->removeTab(realIndex);
 
+        // Check whether the file is pending, in which case it has never been
+        // opened and there is therefore nothing more to do
+
+        if (mPendingFiles.contains(fileName)) {
+            mPendingFiles.remove(fileName);
+            mDownloadedRemoteFiles.remove(fileName);
+            mFileNamesOrUrlsToPreload.removeOne(fileName);
+
+            updateModifiedSettings();
+
+            return true;
+        }
+
+        FileManager *fileManagerInstance = FileManager::instance();
+
+        if (fileManagerInstance->isRemote(fileName))
+            mRemoteLocalFileNames.remove(fileManagerInstance->url(fileName));
+
         // Remove track of the views for the file
 
         for (int i = 0, iMax = mModeTabs->count(); i < iMax; ++i) {
@@ -1651,9 +1982,30 @@ void CentralWidget::updateGui()
 
     bool directCall = !changedFiles && !changedModes && !changedViews;
 
+    // Open the current file, if it is pending (i.e. it was restored from our
+    // settings, but it hasn't been opened yet), and keep track of it as being
+    // the most recently activated file
+    // Note: a remote file that is still being downloaded remains pending, in
+    //       which case we only let the user know about it (see below)...
+
+    int fileTabIndex = mFileTabs->currentIndex();
+
+    if (fileTabIndex != -1) {
+        loadPendingFile(fileTabIndex);
+
+        if (changedFiles || directCall) {
+            QString crtFileNameOrUrl = fileNameOrUrl(currentFileName());
+
+            mRecentFileNamesOrUrls.removeOne(crtFileNameOrUrl);
+            mRecentFileNamesOrUrls.prepend(crtFileNameOrUrl);
+        }
+    }
+
+    bool pendingFile = mPendingFiles.contains(currentFileName());
+
     // Set or keep track of the mode and view for the current file
 
-    QString fileName = currentFileName();
+    QString fileName = pendingFile?QString():currentFileName();
 
     if (!fileName.isEmpty()) {
         int fileModeTabIndex = mFileModeTabIndexes.value(fileName, -1);
@@ -1676,6 +2028,9 @@ void CentralWidget::updateGui()
 
             mode->viewTabs()->setCurrentIndex(modeViewTabIndexes.value(fileModeTabIndex));
         } else {
+            if ((fileModeTabIndex == -1) && mDefaultViews.isEmpty())
+                retrieveDefaultViews(fileName);
+
             foreach (const QString &defaultView, mDefaultViews) {
                 if (selectView(defaultView))
                     break;
@@ -1721,7 +2076,14 @@ void CentralWidget::updateGui()
     ViewInterface *viewInterface = viewPlugin?qobject_cast<ViewInterface *>(viewPlugin->instance()):0;
     QWidget *newView;
 
-    if (fileName.isEmpty()) {
+    if (pendingFile) {
+        // The current file is a remote file that is still being downloaded, so
+        // let the user know about it
+
+        newView = mNoViewMsg;
+
+        mNoViewMsg->setMessage(tr("<strong>%1</strong> is being downloaded...").arg(currentFileName()));
+    } else if (fileName.isEmpty()) {
         newView = mLogoView;
     } else {
         // There is a current file, so retrieve its view, showing our busy
@@ -2165,6 +2527,11 @@ void CentralWidget::fileRenamed(const QString &pOldFileName,
             mFileModeTabIndexes.remove(pOldFileName);
             mFileModeViewTabIndexes.remove(pOldFileName);
 
+            int recentFileIndex = mRecentFileNamesOrUrls.indexOf(pOldFileName);
+
+            if (recentFileIndex != -1)
+                mRecentFileNamesOrUrls[recentFileIndex] = pNewFileName;
+
             // Update the file tab
 
             mFileTabs->setTabText(i, QFileInfo(pNewFileName).fileName());
@@ -2221,6 +2588,12 @@ void CentralWidget::updateFileTabIcons()
     // Update all the file tab icons
 
     for (int i = 0, iMax = mFileTabs->count(); i < iMax; ++i) {
+        if (mPendingFiles.contains(mFileNames[i])) {
+            updateFileTab(i, true);
+
+            continue;
+        }
+
         QIcon tabIcon = qobject_cast<ViewInterface *>(viewPlugin(i)->instance())->fileTabIcon(mFileNames[i]);
 
         if (tabIcon.isNull())
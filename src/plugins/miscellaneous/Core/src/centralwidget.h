@@ -35,6 +35,7 @@ limitations under the License.
 
 #include <QDir>
 #include <QMap>
+#include <QSslError>
 #include <QTabBar>
 
 //==============================================================================
@@ -42,6 +43,8 @@ limitations under the License.
 class QDialog;
 class QLabel;
 class QLineEdit;
+class QNetworkAccessManager;
+class QNetworkReply;
 class QStackedWidget;
 
 //==============================================================================
@@ -173,6 +176,15 @@ private:
 
     QMap<QString, QString> mRemoteLocalFileNames;
 
+    QMap<QString, bool> mPendingFiles;
+
+    QNetworkAccessManager *mNetworkAccessManager;
+
+    QMap<QString, QByteArray> mDownloadedRemoteFiles;
+
+    QStringList mRecentFileNamesOrUrls;
+    QStringList mFileNamesOrUrlsToPreload;
+
     QMap<QString, QWidget *> mViews;
 
     QStringList mDefaultViews;
@@ -182,6 +194,15 @@ private:
 
     void updateNoViewMsg();
 
+    QString fileNameOrUrl(const QString &pFileName) const;
+
+    void retrieveDefaultViews(const QString &pFileName);
+
+    void addPendingFile(const QString &pFileNameOrUrl,
+                        const bool &pRemote);
+    void downloadRemoteFile(const QString &pUrl, const QString &pRealUrl);
+    bool loadPendingFile(const int &pIndex);
+
     bool saveFile(const int &pIndex, const bool &pNeedNewFileName = false);
 
     bool canCloseFile(const int &pIndex);
@@ -208,6 +229,12 @@ Q_SIGNALS:
 private Q_SLOTS:
     void updateGui();
 
+    void remoteFileDownloaded(QNetworkReply *pNetworkReply);
+    void remoteFileSslErrors(QNetworkReply *pNetworkReply,
+                             const QList<QSslError> &pSslErrors);
+
+    void preloadFiles();
+
     void openFile();
 
     void doOpenRemoteFile();
@@ -25,12 +25,19 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDateTime>
 #include <QFile>
 #include <QFileDevice>
 #include <QFileInfo>
 
 //==============================================================================
 
+#ifndef Q_OS_WIN
+    #include <sys/stat.h>
+#endif
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace Core {
 
@@ -85,6 +92,7 @@ bool File::setFileName(const QString &pFileName)
         mFileName = pFileName;
 
         mSha1 = sha1();
+        mMetadata = metadata();
         // Note: we will typically set our file name when we have been saved
         //       under a new name, meaning that our SHA-1 value may end up being
         //       different, hence we need to recompute it, just to be on the
@@ -98,33 +106,72 @@ bool File::setFileName(const QString &pFileName)
 
 //==============================================================================
 
-File::Status File::check()
+bool File::isUncheckable(Status &pStatus) const
 {
     // Always consider ourselves unchanged if we are a remote file
 
-    if (!mUrl.isEmpty())
-        return Unchanged;
+    if (!mUrl.isEmpty()) {
+        pStatus = Unchanged;
+
+        return true;
+    }
 
     // Check whether the file and/or one or several of its dependencies has been
     // modified
 
-    if (mModified)
-        return mDependenciesModified?AllModified:Modified;
-    else if (mDependenciesModified)
-        return DependenciesModified;
+    if (mModified) {
+        pStatus = mDependenciesModified?AllModified:Modified;
+
+        return true;
+    } else if (mDependenciesModified) {
+        pStatus = DependenciesModified;
+
+        return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+File::Status File::check()
+{
+    // Make sure that we can be checked
+
+    Status status;
+
+    if (isUncheckable(status))
+        return status;
 
     // Retrieve our 'new' SHA-1 value and that of our dependencies (if any), and
-    // check whether they are different from the one(s) we currently have
+    // check them against the one(s) we currently have
 
-    QString newSha1 = sha1();
     QStringList newDependenciesSha1 = QStringList();
 
     foreach (const QString &dependency, mDependencies)
         newDependenciesSha1 << sha1(dependency);
 
-    bool dependenciesChanged = !qSameStringLists(newDependenciesSha1, mDependenciesSha1);
+    return check(sha1(), newDependenciesSha1);
+}
+
+//==============================================================================
+
+File::Status File::check(const QString &pSha1,
+                         const QStringList &pDependenciesSha1) const
+{
+    // Make sure that we can be checked
+
+    Status status;
+
+    if (isUncheckable(status))
+        return status;
+
+    // Check whether the given SHA-1 values are different from the one(s) we
+    // currently have
+
+    bool dependenciesChanged = !qSameStringLists(pDependenciesSha1, mDependenciesSha1);
 
-    if (newSha1.isEmpty()) {
+    if (pSha1.isEmpty()) {
         // Our SHA-1 value is now empty, which means that either we have been
         // deleted or that we are unreadable (which, in effect, means that we
         // have been changed)
@@ -135,7 +182,7 @@ File::Status File::check()
         // different from our stored value, which means that we and/or one or
         // several of our dependencies has changed
 
-        return newSha1.compare(mSha1)?
+        return pSha1.compare(mSha1)?
                    dependenciesChanged?AllChanged:Changed:
                    dependenciesChanged?DependenciesChanged:Unchanged;
     }
@@ -143,6 +190,66 @@ File::Status File::check()
 
 //==============================================================================
 
+bool File::updateMetadata()
+{
+    // Retrieve our 'new' metadata and that of our dependencies (if any), keep
+    // track of it and return whether it is different from the one we had
+    // Note: our metadata is much cheaper to retrieve than our SHA-1 value, so
+    //       we only need to (re)compute our SHA-1 value and that of our
+    //       dependencies if our metadata has changed...
+
+    Status status;
+
+    if (isUncheckable(status))
+        return false;
+
+    QString newMetadata = metadata();
+    QStringList newDependenciesMetadata = QStringList();
+
+    foreach (const QString &dependency, mDependencies)
+        newDependenciesMetadata << metadata(dependency);
+
+    if (   newMetadata.compare(mMetadata)
+        || !qSameStringLists(newDependenciesMetadata, mDependenciesMetadata)) {
+        mMetadata = newMetadata;
+        mDependenciesMetadata = newDependenciesMetadata;
+
+        return true;
+    } else {
+        return false;
+    }
+}
+
+//==============================================================================
+
+QString File::metadata(const QString &pFileName) const
+{
+    // Retrieve the size, last modified time and, if possible, inode of the
+    // given file or ourselves (if no file is given), if it/we still exist/s
+    // Note: the inode allows us to detect a file that has been replaced by
+    //       another one with the same size and last modified time...
+
+    QString fileName = pFileName.isEmpty()?mFileName:pFileName;
+    QFileInfo fileInfo = QFileInfo(fileName);
+
+    if (!fileInfo.exists())
+        return QString();
+
+    QString res = QString("%1|%2").arg(QString::number(fileInfo.size()),
+                                       QString::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+
+#ifndef Q_OS_WIN
+    struct stat fileStat;
+
+    if (!stat(QFile::encodeName(fileName).constData(), &fileStat))
+        res += "|"+QString::number(qulonglong(fileStat.st_ino));
+#endif
+
+    return res;
+}
+
+//==============================================================================
+
 QString File::sha1(const QString &pFileName) const
 {
     // Compute the SHA-1 value for the given file or ourselves (if no file is
@@ -163,6 +270,7 @@ void File::reset(const bool &pResetDependencies)
     // Reset our modified state, new index and SHA-1 value
 
     mSha1 = sha1();
+    mMetadata = metadata();
 
     mNewIndex = 0;
 
@@ -171,6 +279,7 @@ void File::reset(const bool &pResetDependencies)
     if (pResetDependencies) {
         mDependencies.clear();
         mDependenciesSha1.clear();
+        mDependenciesMetadata.clear();
 
         mDependenciesModified = false;
     }
@@ -376,9 +485,12 @@ bool File::setDependencies(const QStringList &pDependencies)
         mDependencies = pDependencies;
 
         mDependenciesSha1.clear();
+        mDependenciesMetadata.clear();
 
-        foreach (const QString &dependency, pDependencies)
+        foreach (const QString &dependency, pDependencies) {
             mDependenciesSha1 << sha1(dependency);
+            mDependenciesMetadata << metadata(dependency);
+        }
 
         return true;
     } else {
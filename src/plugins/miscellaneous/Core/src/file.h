@@ -73,6 +73,10 @@ public:
     bool setFileName(const QString &pFileName);
 
     Status check();
+    Status check(const QString &pSha1,
+                 const QStringList &pDependenciesSha1) const;
+
+    bool updateMetadata();
 
     QString sha1(const QString &pFileName = QString()) const;
 
@@ -110,6 +114,7 @@ private:
     QString mFileName;
     QString mUrl;
     QString mSha1;
+    QString mMetadata;
 
     int mNewIndex;
 
@@ -117,8 +122,13 @@ private:
 
     QStringList mDependencies;
     QStringList mDependenciesSha1;
+    QStringList mDependenciesMetadata;
 
     bool mDependenciesModified;
+
+    bool isUncheckable(Status &pStatus) const;
+
+    QString metadata(const QString &pFileName = QString()) const;
 };
 
 //==============================================================================
@@ -0,0 +1,98 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// File checker
+//==============================================================================
+
+#include "corecliutils.h"
+#include "filechecker.h"
+
+//==============================================================================
+
+#include <QThread>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Core {
+
+//==============================================================================
+
+FileChecker::FileChecker()
+{
+    // Create our thread
+
+    mThread = new QThread();
+
+    // Move ourselves to our thread
+
+    moveToThread(mThread);
+
+    // Create a few connections
+
+    connect(mThread, SIGNAL(finished()),
+            mThread, SLOT(deleteLater()));
+    connect(mThread, SIGNAL(finished()),
+            this, SLOT(deleteLater()));
+
+    // Start our thread
+
+    mThread->start();
+}
+
+//==============================================================================
+
+void FileChecker::stop()
+{
+    // Stop our thread and wait for it to be done
+
+    mThread->quit();
+    mThread->wait();
+}
+
+//==============================================================================
+
+void FileChecker::check(const QString &pFileName,
+                        const QStringList &pFileNames)
+{
+    // Compute the SHA-1 value of the given files, if they still exist and can
+    // be opened, and let people know about them
+
+    QStringList sha1s = QStringList();
+
+    foreach (const QString &fileName, pFileNames) {
+        QByteArray fileContents;
+
+        if (readFileContentsFromFile(fileName, fileContents))
+            sha1s << sha1(fileContents);
+        else
+            sha1s << QString();
+    }
+
+    emit checked(pFileName, pFileNames, sha1s);
+}
+
+//==============================================================================
+
+}   // namespace Core
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
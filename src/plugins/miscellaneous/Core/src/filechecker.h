@@ -0,0 +1,68 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// File checker
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QObject>
+#include <QStringList>
+
+//==============================================================================
+
+class QThread;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Core {
+
+//==============================================================================
+
+class FileChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FileChecker();
+
+    void stop();
+
+private:
+    QThread *mThread;
+
+Q_SIGNALS:
+    void checked(const QString &pFileName, const QStringList &pFileNames,
+                 const QStringList &pSha1s);
+
+public Q_SLOTS:
+    void check(const QString &pFileName, const QStringList &pFileNames);
+};
+
+//==============================================================================
+
+}   // namespace Core
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -21,12 +21,17 @@ limitations under the License.
 //==============================================================================
 
 #include "corecliutils.h"
+#include "filechecker.h"
 #include "filemanager.h"
 
 //==============================================================================
 
 #include <QApplication>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSet>
 #include <QTimer>
 
 //==============================================================================
@@ -36,28 +41,64 @@ namespace Core {
 
 //==============================================================================
 
+static const int CheckFilesDelay = 100;
+
+//==============================================================================
+
 FileManager::FileManager() :
     mFiles(QMap<QString, File *>()),
+    mNbOfPendingChecks(QMap<QString, int>()),
     mFilesReadable(QMap<QString, bool>()),
     mFilesWritable(QMap<QString, bool>())
 {
-    // Create our timer
+    // Create our timer, which we use to check our files shortly after having
+    // been told that one or several of them may have changed
+    // Note: a file being saved by another application will typically result
+    //       in several notifications, hence we coalesce them...
 
     mTimer = new QTimer(this);
 
-    // A connection to handle the timing out of our timer
+    mTimer->setInterval(CheckFilesDelay);
+    mTimer->setSingleShot(true);
+
+    // Create our file system watcher, which gets notifications from the
+    // operating system whenever one of our files (or the directory of one of
+    // our files that has been deleted) changes
+
+    mFileSystemWatcher = new QFileSystemWatcher(this);
+
+    // Create our file checker, which computes SHA-1 values in its own thread
+
+    mFileChecker = new FileChecker();
+
+    // Some connections to handle the timing out of our timer, changes to our
+    // files, and the checking of our files
 
     connect(mTimer, SIGNAL(timeout()),
             this, SLOT(checkFiles()));
+
+    connect(mFileSystemWatcher, SIGNAL(fileChanged(const QString &)),
+            mTimer, SLOT(start()));
+    connect(mFileSystemWatcher, SIGNAL(directoryChanged(const QString &)),
+            mTimer, SLOT(start()));
+
+    connect(this, SIGNAL(checkRequested(const QString &, const QStringList &)),
+            mFileChecker, SLOT(check(const QString &, const QStringList &)));
+    connect(mFileChecker, SIGNAL(checked(const QString &, const QStringList &, const QStringList &)),
+            this, SLOT(fileChecked(const QString &, const QStringList &, const QStringList &)));
 }
 
 //==============================================================================
 
 FileManager::~FileManager()
 {
-    // Delete some internal objects
+    // Stop our file checker (which will get deleted as a result) and delete
+    // some internal objects
+
+    mFileChecker->stop();
 
     delete mTimer;
+    delete mFileSystemWatcher;
 
     // Remove all the managed files
 
@@ -96,8 +137,9 @@ FileManager::Status FileManager::manage(const QString &pFileName,
 
             mFiles.insert(nativeFileName, new File(nativeFileName, pType, pUrl));
 
-            if (!mTimer->isActive())
-                mTimer->start(1000);
+            updateWatchedPaths();
+
+            mTimer->start();
 
             emit fileManaged(nativeFileName);
 
@@ -124,8 +166,7 @@ FileManager::Status FileManager::unmanage(const QString &pFileName)
 
         delete nativeFile;
 
-        if (mFiles.isEmpty())
-            mTimer->stop();
+        updateWatchedPaths();
 
         emit fileUnmanaged(nativeFileName);
 
@@ -292,8 +333,11 @@ void FileManager::makeNew(const QString &pFileName)
     if (nativeFile) {
         QString fileName;
 
-        if (newFile(fileName))
+        if (newFile(fileName)) {
             nativeFile->makeNew(fileName);
+
+            updateWatchedPaths();
+        }
     }
 }
 
@@ -427,8 +471,8 @@ void FileManager::setDependencies(const QString &pFileName,
 
     File *nativeFile = file(nativeCanonicalFileName(pFileName));
 
-    if (nativeFile)
-        nativeFile->setDependencies(pDependencies);
+    if (nativeFile && nativeFile->setDependencies(pDependencies))
+        updateWatchedPaths();
 }
 
 //==============================================================================
@@ -516,6 +560,8 @@ FileManager::Status FileManager::rename(const QString &pOldFileName,
             mFiles.insert(newNativeFileName, mFiles.value(oldNativeFileName));
             mFiles.remove(oldNativeFileName);
 
+            updateWatchedPaths();
+
             emit fileRenamed(oldNativeFileName, newNativeFileName);
 
             return Renamed;
@@ -606,55 +652,152 @@ void FileManager::emitFilePermissionsChanged(const QString &pFileName)
 
 //==============================================================================
 
+void FileManager::updateWatchedPaths()
+{
+    // Determine the local files (and their dependencies) that we should watch
+    // or, if they don't exist (anymore), the directory in which they should be,
+    // so that we can tell when they get (re)created
+
+    QSet<QString> files = QSet<QString>();
+    QSet<QString> directories = QSet<QString>();
+
+    foreach (File *file, mFiles) {
+        if (file->isRemote())
+            continue;
+
+        foreach (const QString &fileName, QStringList() << file->fileName() << file->dependencies()) {
+            QFileInfo fileInfo = QFileInfo(fileName);
+
+            if (fileInfo.exists())
+                files << fileName;
+            else if (fileInfo.absoluteDir().exists())
+                directories << fileInfo.absolutePath();
+        }
+    }
+
+    // Update the files and directories watched by our file system watcher
+    // Note: a file that gets replaced rather than overwritten (as some editors
+    //       do when saving a file) stops being watched, hence we need to
+    //       compare against what is currently being watched...
+
+    QSet<QString> watchedFiles = mFileSystemWatcher->files().toSet();
+    QSet<QString> watchedDirectories = mFileSystemWatcher->directories().toSet();
+    QStringList oldPaths = (watchedFiles-files).toList()+(watchedDirectories-directories).toList();
+    QStringList newPaths = (files-watchedFiles).toList()+(directories-watchedDirectories).toList();
+
+    if (!oldPaths.isEmpty())
+        mFileSystemWatcher->removePaths(oldPaths);
+
+    if (!newPaths.isEmpty())
+        mFileSystemWatcher->addPaths(newPaths);
+}
+
+//==============================================================================
+
+void FileManager::checkPermissions(const QString &pFileName)
+{
+    // Check whether the permissions of the given file have changed
+
+    if (    (mFilesReadable.value(pFileName, false) != isReadable(pFileName))
+        ||  (mFilesWritable.value(pFileName, false) != isWritable(pFileName))
+        || !(   mFilesReadable.contains(pFileName)
+             && mFilesWritable.contains(pFileName))) {
+        emitFilePermissionsChanged(pFileName);
+    }
+}
+
+//==============================================================================
+
 void FileManager::checkFiles()
 {
-    // Check our various files, as well as their locked status, but only if they
-    // are not being ignored
+    // Make sure that we are watching all the files that we should be watching
+
+    updateWatchedPaths();
+
+    // Check our various files, but only compute their SHA-1 value (and that of
+    // their dependencies) if their metadata has changed, and do so using our
+    // file checker, so that we don't block the GUI thread
 
     foreach (File *file, mFiles) {
         QString fileName = file->fileName();
-        File::Status fileStatus = file->check();
-
-        switch (fileStatus) {
-        case File::Changed:
-        case File::DependenciesChanged:
-        case File::AllChanged:
-            // The file and/or one or several of its dependencies has changed,
-            // so let people know about it
-
-            emit fileChanged(fileName,
-                             (fileStatus == File::Changed) || (fileStatus == File::AllChanged),
-                             (fileStatus == File::DependenciesChanged) || (fileStatus == File::AllChanged));
-
-            break;
-        case File::Unchanged:
-            // The file has neither changed nor been deleted, so check whether
-            // its permissions have changed
-
-            if (    (mFilesReadable.value(fileName, false) != isReadable(fileName))
-                ||  (mFilesWritable.value(fileName, false) != isWritable(fileName))
-                || !(   mFilesReadable.contains(fileName)
-                     && mFilesWritable.contains(fileName))) {
-                emitFilePermissionsChanged(fileName);
-            }
-
-            break;
-        case File::Deleted:
-            // The file has been deleted, so let people know about it
 
-            emit fileDeleted(fileName);
+        if (file->updateMetadata()) {
+            mNbOfPendingChecks.insert(fileName, mNbOfPendingChecks.value(fileName)+1);
 
-            break;
-        default:
-            // Not a relevant status, so do nothing
+            emit checkRequested(fileName, QStringList() << fileName << file->dependencies());
+        } else {
+            // The file hasn't changed, so check whether its permissions have
+            // changed (something that doesn't affect a file's metadata)
 
-            ;
+            checkPermissions(fileName);
         }
     }
 }
 
 //==============================================================================
 
+void FileManager::fileChecked(const QString &pFileName,
+                              const QStringList &pFileNames,
+                              const QStringList &pSha1s)
+{
+    // Make sure that this is the latest check of the given file, that the file
+    // is still managed and that its dependencies haven't changed in the
+    // meantime
+
+    int nbOfPendingChecks = mNbOfPendingChecks.value(pFileName)-1;
+
+    if (nbOfPendingChecks > 0) {
+        mNbOfPendingChecks.insert(pFileName, nbOfPendingChecks);
+
+        return;
+    }
+
+    mNbOfPendingChecks.remove(pFileName);
+
+    File *nativeFile = file(pFileName);
+
+    if (!nativeFile || !qSameStringLists(pFileNames.mid(1), nativeFile->dependencies()))
+        return;
+
+    // Check the file using the SHA-1 values that were computed for it and its
+    // dependencies
+
+    File::Status fileStatus = nativeFile->check(pSha1s.first(), pSha1s.mid(1));
+
+    switch (fileStatus) {
+    case File::Changed:
+    case File::DependenciesChanged:
+    case File::AllChanged:
+        // The file and/or one or several of its dependencies has changed, so
+        // let people know about it
+
+        emit fileChanged(pFileName,
+                         (fileStatus == File::Changed) || (fileStatus == File::AllChanged),
+                         (fileStatus == File::DependenciesChanged) || (fileStatus == File::AllChanged));
+
+        break;
+    case File::Unchanged:
+        // The file has neither changed nor been deleted, so check whether its
+        // permissions have changed
+
+        checkPermissions(pFileName);
+
+        break;
+    case File::Deleted:
+        // The file has been deleted, so let people know about it
+
+        emit fileDeleted(pFileName);
+
+        break;
+    default:
+        // Not a relevant status, so do nothing
+
+        ;
+    }
+}
+
+//==============================================================================
+
 }   // namespace Core
 }   // namespace OpenCOR
 
@@ -34,6 +34,7 @@ limitations under the License.
 
 //==============================================================================
 
+class QFileSystemWatcher;
 class QTimer;
 
 //==============================================================================
@@ -43,6 +44,10 @@ namespace Core {
 
 //==============================================================================
 
+class FileChecker;
+
+//==============================================================================
+
 static const auto FileSystemMimeType = QStringLiteral("text/uri-list");
 
 //==============================================================================
@@ -149,13 +154,21 @@ private:
 
     QTimer *mTimer;
 
+    QFileSystemWatcher *mFileSystemWatcher;
+    FileChecker *mFileChecker;
+
     QMap<QString, File *> mFiles;
+    QMap<QString, int> mNbOfPendingChecks;
 
     QMap<QString, bool> mFilesReadable;
     QMap<QString, bool> mFilesWritable;
 
     bool newFile(QString &pFileName, const QByteArray &pContents = QByteArray());
 
+    void updateWatchedPaths();
+
+    void checkPermissions(const QString &pFileName);
+
 Q_SIGNALS:
     void fileManaged(const QString &pFileName);
     void fileUnmanaged(const QString &pFileName);
@@ -175,8 +188,13 @@ Q_SIGNALS:
 
     void fileSaved(const QString &pFileName);
 
+    void checkRequested(const QString &pFileName,
+                        const QStringList &pFileNames);
+
 private Q_SLOTS:
     void checkFiles();
+    void fileChecked(const QString &pFileName, const QStringList &pFileNames,
+                     const QStringList &pSha1s);
 };
 
 //==============================================================================
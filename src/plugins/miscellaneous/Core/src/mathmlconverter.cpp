@@ -26,11 +26,23 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QCache>
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace Core {
 
 //==============================================================================
 
+// Note: our cache of Presentation MathML equations is shared by all our MathML
+//       converters, and it is LRU-based with a cost that is the size of the
+//       Presentation MathML equation...
+
+static QCache<QString, QString> presentationMathmlEquations(4*1024*1024);
+
+//==============================================================================
+
 MathmlConverter::MathmlConverter()
 {
     // Create our XSL transformer and create a connection to retrieve the result
@@ -46,17 +58,28 @@ MathmlConverter::MathmlConverter()
 
 MathmlConverter::~MathmlConverter()
 {
-    // Stop our XSL transformer
-    // Note: we don't need to delete it since it will be done as part of its
-    //       thread being stopped...
+    // Stop and delete our XSL transformer
 
     mXslTransformer->stop();
+
+    delete mXslTransformer;
 }
 
 //==============================================================================
 
 void MathmlConverter::convert(const QString &pContentMathml)
 {
+    // Check whether we have already converted the given Content MathML, in
+    // which case we let people know about it straightaway
+
+    QString *presentationMathml = presentationMathmlEquations.object(pContentMathml);
+
+    if (presentationMathml) {
+        emit done(pContentMathml, *presentationMathml);
+
+        return;
+    }
+
     // Convert the given Content MathML to Presentation MathML through an XSL
     // transformation
 
@@ -71,9 +94,16 @@ void MathmlConverter::xslTransformationDone(const QString &pInput,
                                             const QString &pOutput)
 {
     // Let people know that our MathML conversion has been performed (after
-    // having cleaned up its output)
+    // having cleaned up its output and cached it, if it was successful)
+
+    QString presentationMathml = cleanPresentationMathml(pOutput);
+
+    if (!presentationMathml.isEmpty()) {
+        presentationMathmlEquations.insert(pInput, new QString(presentationMathml),
+                                           presentationMathml.size());
+    }
 
-    emit done(pInput, cleanPresentationMathml(pOutput));
+    emit done(pInput, presentationMathml);
 }
 
 //==============================================================================
@@ -25,7 +25,6 @@ limitations under the License.
 
 //==============================================================================
 
-#include <QMutex>
 #include <QThread>
 #include <QXmlQuery>
 
@@ -63,10 +62,8 @@ QString XslTransformerJob::xsl() const
 
 //==============================================================================
 
-XslTransformer::XslTransformer() :
-    mPaused(false),
-    mStopped(false),
-    mJobs(QList<XslTransformerJob>())
+XslTransformerWorker::XslTransformerWorker(XslTransformer *pXslTransformer) :
+    mXslTransformer(pXslTransformer)
 {
     // Create our thread
 
@@ -85,105 +82,157 @@ XslTransformer::XslTransformer() :
             mThread, SLOT(deleteLater()));
     connect(mThread, SIGNAL(finished()),
             this, SLOT(deleteLater()));
+
+    // Start our thread
+
+    mThread->start();
 }
 
 //==============================================================================
 
-void XslTransformer::transform(const QString &pInput, const QString &pXsl)
+void XslTransformerWorker::stop()
 {
-    // Add a new job to our list
-
-    mJobs << XslTransformerJob(pInput, pXsl);
+    // Ask our thread to quit and wait for it to do so
+    // Note: our XSL transformer will have already woken us up, if needed...
 
-    // Start/resume our thread, if needed
-
-    if (!mThread->isRunning()) {
-        mThread->start();
-    } else {
-        // Resume our thread, if needed
-
-        if (mPaused)
-            mPausedCondition.wakeOne();
-    }
+    mThread->quit();
+    mThread->wait();
 }
 
 //==============================================================================
 
-void XslTransformer::stop()
+void XslTransformerWorker::started()
 {
-    // Shutdown our thread, if needed
+    // Create our XML query object
+
+    QXmlQuery xmlQuery(QXmlQuery::XSLT20);
+    DummyMessageHandler dummyMessageHandler;
+
+    xmlQuery.setMessageHandler(&dummyMessageHandler);
 
-    if (mThread->isRunning()) {
-        // Ask our thread to stop
+    // Carry out jobs until our XSL transformer asks us to stop
+    // Note: all our jobs are likely to use the same XSL, so we only set our
+    //       query when it changes rather than have it parsed and compiled for
+    //       each job...
 
-        mStopped = true;
+    XslTransformerJob job = XslTransformerJob(QString(), QString());
+    QString xsl = QString();
+
+    while (mXslTransformer->nextJob(job)) {
+        // Customise our XML query object
+
+        xmlQuery.setFocus(job.input());
+
+        if (job.xsl().compare(xsl)) {
+            xsl = job.xsl();
 
-        // Resume our thread, if needed
+            xmlQuery.setQuery(xsl);
+        }
+
+        // Do the XSL transformation
 
-        if (mPaused)
-            mPausedCondition.wakeOne();
+        QString output;
 
-        // Ask our thread to quit and wait for it to do so
+        if (!xmlQuery.evaluateTo(&output))
+            output = QString();
 
-        mThread->quit();
-        mThread->wait();
+        // Let people know that an XSL transformation has been performed
+
+        emit done(job.input(), output);
     }
 }
 
 //==============================================================================
 
-void XslTransformer::started()
+XslTransformer::XslTransformer() :
+    mStopped(false),
+    mJobs(QList<XslTransformerJob>()),
+    mWorkers(QList<XslTransformerWorker *>()),
+    mNbOfIdleWorkers(0)
 {
-    // Create our XML query object
+}
 
-    QXmlQuery xmlQuery(QXmlQuery::XSLT20);
-    DummyMessageHandler dummyMessageHandler;
+//==============================================================================
 
-    xmlQuery.setMessageHandler(&dummyMessageHandler);
+void XslTransformer::transform(const QString &pInput, const QString &pXsl)
+{
+    // Add a new job to our list
 
-    // Do our XSL transformations
+    mJobsMutex.lock();
+        mJobs << XslTransformerJob(pInput, pXsl);
 
-    QMutex pausedMutex;
+        // Create a new worker, if all of our existing ones are busy and if we
+        // haven't yet reached our maximum number of workers
+        // Note: our workers are created lazily since most of the time only one
+        //       of them is needed...
 
-    while (!mStopped) {
-        // Carry out our different jobs
+        static const int MaxNbOfWorkers = qBound(1, QThread::idealThreadCount(), 4);
 
-        while (mJobs.count() && !mStopped) {
-            // Retrieve the first job in our list
+        if (   (mJobs.count() > mNbOfIdleWorkers)
+            && (mWorkers.count() < MaxNbOfWorkers)) {
+            XslTransformerWorker *worker = new XslTransformerWorker(this);
 
-            XslTransformerJob job = mJobs.first();
+            connect(worker, SIGNAL(done(const QString &, const QString &)),
+                    this, SIGNAL(done(const QString &, const QString &)));
 
-            mJobs.removeFirst();
+            mWorkers << worker;
+        }
 
-            // Customise our XML query object
+        // Wake up one of our idle workers, if any
 
-            xmlQuery.setFocus(job.input());
-            xmlQuery.setQuery(job.xsl());
+        mJobsCondition.wakeOne();
+    mJobsMutex.unlock();
+}
 
-            // Do the XSL transformation
+//==============================================================================
 
-            QString output;
+void XslTransformer::stop()
+{
+    // Ask our workers to stop
 
-            if (!xmlQuery.evaluateTo(&output))
-                output = QString();
+    mJobsMutex.lock();
+        mStopped = true;
 
-            // Let people know that an XSL transformation has been performed
+        mJobsCondition.wakeAll();
+    mJobsMutex.unlock();
 
-            emit done(job.input(), output);
-        }
+    // Wait for our workers to be done
+    // Note: we don't need to delete them since it will be done as part of
+    //       their thread being stopped...
 
-        // Pause ourselves, unless we have been asked to stop
+    foreach (XslTransformerWorker *worker, mWorkers)
+        worker->stop();
 
-        if (!mStopped) {
-            mPaused = true;
+    mWorkers.clear();
+}
+
+//==============================================================================
+
+bool XslTransformer::nextJob(XslTransformerJob &pJob)
+{
+    // Wait for a job to be available and retrieve it, unless we have been asked
+    // to stop, in which case we let our (calling) worker know that it should
+    // stop too
+    // Note: this method is called from within our workers' thread...
+
+    bool res = false;
 
-            pausedMutex.lock();
-                mPausedCondition.wait(&pausedMutex);
-            pausedMutex.unlock();
+    mJobsMutex.lock();
+        ++mNbOfIdleWorkers;
 
-            mPaused = false;
+        while (!mStopped && mJobs.isEmpty())
+            mJobsCondition.wait(&mJobsMutex);
+
+        --mNbOfIdleWorkers;
+
+        if (!mStopped) {
+            pJob = mJobs.takeFirst();
+
+            res = true;
         }
-    }
+    mJobsMutex.unlock();
+
+    return res;
 }
 
 //==============================================================================
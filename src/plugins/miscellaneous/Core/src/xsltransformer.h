@@ -29,12 +29,17 @@ limitations under the License.
 //==============================================================================
 
 #include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QString>
 #include <QWaitCondition>
 
 //==============================================================================
 
+class QThread;
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace Core {
 
@@ -59,6 +64,33 @@ private:
 
 //==============================================================================
 
+class XslTransformer;
+
+//==============================================================================
+
+class XslTransformerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XslTransformerWorker(XslTransformer *pXslTransformer);
+
+    void stop();
+
+private:
+    XslTransformer *mXslTransformer;
+
+    QThread *mThread;
+
+Q_SIGNALS:
+    void done(const QString &pInput, const QString &pOutput);
+
+private Q_SLOTS:
+    void started();
+};
+
+//==============================================================================
+
 class CORE_EXPORT XslTransformer : public QObject
 {
     Q_OBJECT
@@ -70,21 +102,21 @@ public:
 
     void stop();
 
-private:
-    QThread *mThread;
+    bool nextJob(XslTransformerJob &pJob);
 
-    bool mPaused;
+private:
     bool mStopped;
 
-    QWaitCondition mPausedCondition;
+    QMutex mJobsMutex;
+    QWaitCondition mJobsCondition;
 
     QList<XslTransformerJob> mJobs;
 
+    QList<XslTransformerWorker *> mWorkers;
+    int mNbOfIdleWorkers;
+
 Q_SIGNALS:
     void done(const QString &pInput, const QString &pOutput);
-
-private Q_SLOTS:
-    void started();
 };
 
 //==============================================================================
@@ -62,8 +62,12 @@
 <context>
     <name>OpenCOR::PMRWindow::PmrWindowWindow</name>
     <message>
-        <source>Select Empty Directory</source>
-        <translation>Sélectionner Répertoire Vide</translation>
+        <source>Select Empty Directory or Existing Clone</source>
+        <translation>Sélectionner Répertoire Vide ou Clone Existant</translation>
+    </message>
+    <message>
+        <source>Please choose an empty directory or an existing clone of the workspace.</source>
+        <translation>Veuillez choisir un répertoire vide ou un clone existant de l&apos;espace de travail.</translation>
     </message>
 </context>
 <context>
@@ -31,7 +31,6 @@ limitations under the License.
 #include <QDesktopServices>
 #include <QIODevice>
 #include <QMenu>
-#include <QRegularExpression>
 #include <QWebElement>
 #include <QWebFrame>
 
@@ -46,12 +45,12 @@ PmrWindowWidget::PmrWindowWidget(QWidget *pParent) :
     OpenCOR::WebViewerWidget::WebViewerWidget(pParent),
     Core::CommonWidget(),
     mExposureNames(QStringList()),
+    mExposureFilter(PMRSupport::PmrExposureFilter()),
     mExposureDisplayed(QBoolList()),
     mExposureUrlId(QMap<QString, int>()),
     mInitialized(false),
     mErrorMessage(QString()),
     mInternetConnectionAvailable(true),
-    mNumberOfFilteredExposures(0),
     mExposureUrl(QString())
 {
     // Create and populate our context menu
@@ -132,13 +131,13 @@ QString PmrWindowWidget::message() const
     QString res = QString();
 
     if (mInternetConnectionAvailable && mErrorMessage.isEmpty()) {
-        if (!mNumberOfFilteredExposures) {
+        if (!mExposureFilter.numberOfFilteredExposures()) {
             if (!mExposureNames.isEmpty())
                 res = tr("No exposure matches your criteria.");
-        } else if (mNumberOfFilteredExposures == 1) {
+        } else if (mExposureFilter.numberOfFilteredExposures() == 1) {
             res = tr("<strong>1</strong> exposure was found:");
         } else {
-            res = tr("<strong>%1</strong> exposures were found:").arg(mNumberOfFilteredExposures);
+            res = tr("<strong>%1</strong> exposures were found:").arg(mExposureFilter.numberOfFilteredExposures());
         }
     } else {
         res = tr("<strong>Error:</strong> ")+Core::formatMessage(mInternetConnectionAvailable?
@@ -168,18 +167,16 @@ void PmrWindowWidget::initialize(const PMRSupport::PmrExposures &pExposures,
     mInternetConnectionAvailable = pInternetConnectionAvailable;
 
     // Initialise our list of exposures
+    // Note: our exposures are all initially displayed, but they will be
+    //       filtered right after...
 
     QString exposures = QString();
-    QRegularExpression filterRegEx = QRegularExpression(pFilter, QRegularExpression::CaseInsensitiveOption);
-
-    mNumberOfFilteredExposures = 0;
 
     for (int i = 0, iMax = pExposures.count(); i < iMax; ++i) {
         QString exposureUrl = pExposures[i]->url();
         QString exposureName = pExposures[i]->name();
-        bool exposureDisplayed = exposureName.contains(filterRegEx);
 
-        exposures += "<tr id=\"exposure_"+QString::number(i)+"\" style=\"display: "+(exposureDisplayed?"table-row":"none")+";\">\n"
+        exposures += "<tr id=\"exposure_"+QString::number(i)+"\">\n"
                      "    <td class=\"exposure\">\n"
                      "        <table class=\"fullWidth\">\n"
                      "            <tbody>\n"
@@ -206,53 +203,71 @@ void PmrWindowWidget::initialize(const PMRSupport::PmrExposures &pExposures,
                      "</tr>\n";
 
         mExposureNames << exposureName;
-        mExposureDisplayed << exposureDisplayed;
+        mExposureDisplayed << true;
         mExposureUrlId.insert(exposureUrl, i);
-
-        mNumberOfFilteredExposures += exposureDisplayed;
     }
 
+    mExposureFilter.setExposureNames(mExposureNames);
+
     setHtml(mTemplate.arg(message(), exposures));
 
     mInitialized = true;
+
+    // Filter our list of exposures
+
+    filter(pFilter);
 }
 
 //==============================================================================
 
 void PmrWindowWidget::filter(const QString &pFilter)
 {
-    // Filter our list of exposures and remove any duplicates (they will be
-    // 'reintroduced' in the next step)
+    // Determine which exposures match the given filter
 
-    QStringList filteredExposureNames = mExposureNames.filter(QRegularExpression(pFilter, QRegularExpression::CaseInsensitiveOption));
+    QBoolList exposureDisplayed = mExposureFilter.filter(pFilter);
 
-    mNumberOfFilteredExposures = filteredExposureNames.count();
+    // Update our message and show/hide the relevant exposures, but only if
+    // something has changed
 
-    filteredExposureNames.removeDuplicates();
+    page()->mainFrame()->documentElement().findFirst("p[id=message]").setInnerXml(message());
 
-    // Update our message and show/hide the relevant exposures
+    if (exposureDisplayed != mExposureDisplayed) {
+        mExposureDisplayed = exposureDisplayed;
 
-    page()->mainFrame()->documentElement().findFirst("p[id=message]").setInnerXml(message());
+        updateExposuresDisplay();
+    }
+}
 
-    QWebElement trElement = page()->mainFrame()->documentElement().findFirst(QString("tbody[id=exposures]")).firstChild();
-    QWebElement ulElement;
+//==============================================================================
 
-    for (int i = 0, iMax = mExposureNames.count(); i < iMax; ++i) {
-        if (mExposureDisplayed[i] != filteredExposureNames.contains(mExposureNames[i])) {
-            QString displayValue = mExposureDisplayed[i]?"none":"table-row";
+void PmrWindowWidget::updateExposuresDisplay()
+{
+    // Show/hide our exposures by updating our filter style sheet rather than
+    // the style of each exposure, so that the page gets updated only once
+    // Note: we list the smallest of our displayed and hidden exposures...
 
-            trElement.setStyleProperty("display", displayValue);
+    QStringList displayedExposures = QStringList();
+    QStringList hiddenExposures = QStringList();
 
-            ulElement = trElement.firstChild().firstChild().nextSibling();
+    for (int i = 0, iMax = mExposureDisplayed.count(); i < iMax; ++i) {
+        if (mExposureDisplayed[i])
+            displayedExposures << "#exposures > #exposure_"+QString::number(i);
+        else
+            hiddenExposures << "#exposure_"+QString::number(i);
+    }
 
-            if (ulElement.hasClass("visible"))
-                ulElement.setStyleProperty("display", displayValue);
+    QString styleSheet = QString();
 
-            mExposureDisplayed[i] = !mExposureDisplayed[i];
-        }
+    if (hiddenExposures.count() > displayedExposures.count()) {
+        styleSheet = "#exposures > tr { display: none; }";
 
-        trElement = trElement.nextSibling();
+        if (!displayedExposures.isEmpty())
+            styleSheet += "\n"+displayedExposures.join(", ")+" { display: table-row; }";
+    } else if (!hiddenExposures.isEmpty()) {
+        styleSheet = hiddenExposures.join(", ")+" { display: none; }";
     }
+
+    page()->mainFrame()->documentElement().findFirst("style[id=filter]").setPlainText(styleSheet);
 }
 
 //==============================================================================
@@ -27,6 +27,7 @@ limitations under the License.
 #include "commonwidget.h"
 #include "corecliutils.h"
 #include "pmrexposure.h"
+#include "pmrexposurefilter.h"
 #include "webviewerwidget.h"
 
 //==============================================================================
@@ -65,6 +66,7 @@ private:
     QAction *mCopyAction;
 
     QStringList mExposureNames;
+    PMRSupport::PmrExposureFilter mExposureFilter;
     QBoolList mExposureDisplayed;
     QMap<QString, int> mExposureUrlId;
 
@@ -74,12 +76,12 @@ private:
     QString mErrorMessage;
     bool mInternetConnectionAvailable;
 
-    int mNumberOfFilteredExposures;
-
     QString mExposureUrl;
 
     QString message() const;
 
+    void updateExposuresDisplay();
+
 Q_SIGNALS:
     void cloneWorkspaceRequested(const QString &pUrl);
     void showExposureFilesRequested(const QString &pUrl);
@@ -37,6 +37,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDir>
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QTimer>
@@ -94,6 +95,8 @@ PmrWindowWindow::PmrWindowWindow(QWidget *pParent) :
 
     connect(mPmrWebService, SIGNAL(busy(const bool &)),
             this, SLOT(busy(const bool &)));
+    connect(mPmrWebService, SIGNAL(progress(const double &)),
+            this, SLOT(showProgress(const double &)));
 
     connect(mPmrWebService, SIGNAL(information(const QString &)),
             this, SLOT(showInformation(const QString &)));
@@ -179,6 +182,15 @@ void PmrWindowWindow::busy(const bool &pBusy)
 
 //==============================================================================
 
+void PmrWindowWindow::showProgress(const double &pProgress)
+{
+    // Show the given progress in our busy widget
+
+    setBusyWidgetProgress(pProgress);
+}
+
+//==============================================================================
+
 void PmrWindowWindow::showWarning(const QString &pMessage)
 {
     // Show the given message as a warning
@@ -249,12 +261,24 @@ void PmrWindowWindow::retrieveExposuresList(const bool &pVisible)
 
 void PmrWindowWindow::cloneWorkspace(const QString &pUrl)
 {
-    // Retrieve the name of an empty directory
+    // Retrieve the name of either an empty directory or a directory that
+    // already contains a clone of the workspace, in which case we will only
+    // fetch what is new in the workspace
 
-    QString dirName = Core::getExistingDirectory(tr("Select Empty Directory"),
-                                                 QString(), true);
+    QString caption = tr("Select Empty Directory or Existing Clone");
+    QString dirName = Core::getExistingDirectory(caption, QString(), false);
 
     if (!dirName.isEmpty()) {
+        QDir dir = QDir(dirName);
+
+        if (   dir.entryInfoList(QDir::NoDotAndDotDot|QDir::AllEntries).count()
+            && !dir.exists(".git")) {
+            QMessageBox::warning(Core::mainWindow(), caption,
+                                 tr("Please choose an empty directory or an existing clone of the workspace."));
+
+            return;
+        }
+
         // We have got a directory name where we can clone the workspace, so
         // request a clone of it
 
@@ -84,6 +84,7 @@ private Q_SLOTS:
     void on_refreshButton_clicked();
 
     void busy(const bool &pBusy);
+    void showProgress(const double &pProgress);
 
     void showWarning(const QString &pMessage);
     void showInformation(const QString &pMessage);
@@ -67,6 +67,14 @@
         <source>Unselect all the graphs</source>
         <translation>Déselectionner toutes les courbes</translation>
     </message>
+    <message>
+        <source>Search Parameter...</source>
+        <translation>Rechercher Paramètre...</translation>
+    </message>
+    <message>
+        <source>Search for a parameter by name</source>
+        <translation>Rechercher un paramètre par son nom</translation>
+    </message>
 </context>
 <context>
     <name>OpenCOR::SingleCellView::SingleCellViewInformationParametersWidget</name>
@@ -102,6 +110,10 @@
         <source>variable of integration</source>
         <translation>variable d&apos;intégration</translation>
     </message>
+    <message>
+        <source>Compute Sensitivities</source>
+        <translation>Calculer les Sensibilités</translation>
+    </message>
 </context>
 <context>
     <name>OpenCOR::SingleCellView::SingleCellViewInformationSimulationWidget</name>
@@ -117,6 +129,18 @@
         <source>Point interval</source>
         <translation>Interval de point</translation>
     </message>
+    <message>
+        <source>Checkpoint interval</source>
+        <translation>Interval de point de reprise</translation>
+    </message>
+    <message>
+        <source>Convergence period</source>
+        <translation>Période de convergence</translation>
+    </message>
+    <message>
+        <source>Convergence tolerance</source>
+        <translation>Tolérance de convergence</translation>
+    </message>
 </context>
 <context>
     <name>OpenCOR::SingleCellView::SingleCellViewInformationSolversWidget</name>
@@ -160,6 +184,17 @@
         <translation>Courbes</translation>
     </message>
 </context>
+<context>
+    <name>OpenCOR::SingleCellView::SingleCellViewParameterPickerWindow</name>
+    <message>
+        <source>Search Parameter</source>
+        <translation>Rechercher Paramètre</translation>
+    </message>
+    <message>
+        <source>Type the name of a parameter...</source>
+        <translation>Tapez le nom d&apos;un paramètre...</translation>
+    </message>
+</context>
 <context>
     <name>OpenCOR::SingleCellView::SingleCellViewPlugin</name>
     <message>
@@ -185,10 +220,25 @@
         <source>the ending point is smaller than the starting point, so the point interval should be smaller than zero</source>
         <translation>le point d&apos;arrivée est plus petit que le point de départ, donc l&apos;interval de point devrait être plus petit que zéro</translation>
     </message>
+    <message>
+        <source>the convergence period should be a multiple of the point interval</source>
+        <translation>la période de convergence devrait être un multiple de l&apos;interval de point</translation>
+    </message>
     <message>
         <source>the simulation worker could not be created</source>
         <translation>l&apos;agent de simulation n&apos;a pas pu être créé</translation>
     </message>
+    <message>
+        <source>the simulation checkpoint could not be loaded</source>
+        <translation>le point de reprise de la simulation n&apos;a pas pu être chargé</translation>
+    </message>
+</context>
+<context>
+    <name>OpenCOR::SingleCellView::SingleCellViewSimulationWorker</name>
+    <message>
+        <source>the %1 solver cannot compute the sensitivities of the states</source>
+        <translation>le solveur %1 ne peut pas calculer les sensibilités des états</translation>
+    </message>
 </context>
 <context>
     <name>OpenCOR::SingleCellView::SingleCellViewSimulationWidget</name>
@@ -292,6 +342,14 @@
         <source>We could not allocate the %1 of memory required for the simulation.</source>
         <translation>Nous n&apos;avons pas pu allouer les %1 de mémoire nécessaires pour la simulation.</translation>
     </message>
+    <message>
+        <source>The simulation was interrupted at %1. Do you want to resume it from there?</source>
+        <translation>La simulation a été interrompue à %1. Voulez-vous la reprendre à partir de là ?</translation>
+    </message>
+    <message>
+        <source>The simulation was interrupted at %1, but some of its parameters have been modified since. Do you want to resume it from there, using the value of its parameters at that time?</source>
+        <translation>La simulation a été interrompue à %1, mais certains de ses paramètres ont été modifiés depuis. Voulez-vous la reprendre à partir de là, en utilisant la valeur de ses paramètres à ce moment-là ?</translation>
+    </message>
     <message>
         <source>Run the simulation</source>
         <translation>Lancer la simulation</translation>
@@ -304,6 +362,54 @@
         <source>%1 s using %2</source>
         <translation>%1 s avec %2</translation>
     </message>
+    <message>
+        <source>Solver statistics:</source>
+        <translation>Statistiques du solveur :</translation>
+    </message>
+    <message>
+        <source>NLA solver statistics:</source>
+        <translation>Statistiques du solveur ANL :</translation>
+    </message>
+    <message>
+        <source>Convergence:</source>
+        <translation>Convergence :</translation>
+    </message>
+    <message>
+        <source>periodic steady state reached after %1 periods (at %2)</source>
+        <translation>état stationnaire périodique atteint après %1 périodes (à %2)</translation>
+    </message>
+    <message>
+        <source>steady state reached at %1</source>
+        <translation>état stationnaire atteint à %1</translation>
+    </message>
+    <message>
+        <source>%1 steps</source>
+        <translation>%1 pas</translation>
+    </message>
+    <message>
+        <source>%1 RHS evaluations</source>
+        <translation>%1 évaluations du membre de droite</translation>
+    </message>
+    <message>
+        <source>%1 Jacobian evaluations</source>
+        <translation>%1 évaluations du jacobien</translation>
+    </message>
+    <message>
+        <source>%1 Newton iterations</source>
+        <translation>%1 itérations de Newton</translation>
+    </message>
+    <message>
+        <source>%1 error test failures</source>
+        <translation>%1 échecs du test d&apos;erreur</translation>
+    </message>
+    <message>
+        <source>%1 solves</source>
+        <translation>%1 résolutions</translation>
+    </message>
+    <message>
+        <source>%1 s in model code</source>
+        <translation>%1 s dans le code du modèle</translation>
+    </message>
     <message>
         <source>Pause the simulation</source>
         <translation>Pauser la simulation</translation>
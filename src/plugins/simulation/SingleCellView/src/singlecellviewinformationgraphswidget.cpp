@@ -25,6 +25,7 @@ limitations under the License.
 #include "filemanager.h"
 #include "graphpanelwidget.h"
 #include "singlecellviewinformationgraphswidget.h"
+#include "singlecellviewparameterpickerwindow.h"
 #include "singlecellviewplugin.h"
 #include "singlecellviewsimulation.h"
 #include "singlecellviewsimulationwidget.h"
@@ -58,6 +59,9 @@ SingleCellViewInformationGraphsWidget::SingleCellViewInformationGraphsWidget(Sin
     mGraphs(QMap<Core::Property *, GraphPanelWidget::GraphPanelPlotGraph *>()),
     mGraphProperties(QMap<GraphPanelWidget::GraphPanelPlotGraph *, Core::Property *>()),
     mParameterActions(QMap<QAction *, CellMLSupport::CellmlFileRuntimeParameter *>()),
+    mComponentMenus(QMap<QMenu *, QString>()),
+    mComponentChildren(QMap<QString, QStringList>()),
+    mComponentParameters(QMap<QString, CellMLSupport::CellmlFileRuntimeParameters>()),
     mHorizontalScrollBarValue(0)
 {
     // Create our context menus and populate our main context menu
@@ -70,6 +74,7 @@ SingleCellViewInformationGraphsWidget::SingleCellViewInformationGraphsWidget(Sin
     mRemoveAllGraphsAction = Core::newAction(this);
     mSelectAllGraphsAction = Core::newAction(this);
     mUnselectAllGraphsAction = Core::newAction(this);
+    mSearchParameterAction = Core::newAction(this);
 
     connect(mAddGraphAction, SIGNAL(triggered(bool)),
             this, SLOT(addGraph()));
@@ -81,6 +86,8 @@ SingleCellViewInformationGraphsWidget::SingleCellViewInformationGraphsWidget(Sin
             this, SLOT(selectAllGraphs()));
     connect(mUnselectAllGraphsAction, SIGNAL(triggered(bool)),
             this, SLOT(unselectAllGraphs()));
+    connect(mSearchParameterAction, SIGNAL(triggered(bool)),
+            this, SLOT(searchParameter()));
 
     mContextMenu->addAction(mAddGraphAction);
     mContextMenu->addSeparator();
@@ -90,6 +97,10 @@ SingleCellViewInformationGraphsWidget::SingleCellViewInformationGraphsWidget(Sin
     mContextMenu->addAction(mSelectAllGraphsAction);
     mContextMenu->addAction(mUnselectAllGraphsAction);
 
+    // Create our parameter picker
+
+    mParameterPicker = new SingleCellViewParameterPickerWindow(this);
+
     // Some further initialisations that are done as part of retranslating the
     // GUI (so that they can be updated when changing languages)
 
@@ -112,6 +123,12 @@ void SingleCellViewInformationGraphsWidget::retranslateUi()
                                      tr("Select all the graphs"));
     I18nInterface::retranslateAction(mUnselectAllGraphsAction, tr("Unselect All Graphs"),
                                      tr("Unselect all the graphs"));
+    I18nInterface::retranslateAction(mSearchParameterAction, tr("Search Parameter..."),
+                                     tr("Search for a parameter by name"));
+
+    // Retranslate our parameter picker
+
+    mParameterPicker->retranslateUi();
 
     // Retranslate all our property editors
 
@@ -144,9 +161,19 @@ void SingleCellViewInformationGraphsWidget::initialize(SingleCellViewSimulation
 
 void SingleCellViewInformationGraphsWidget::finalize()
 {
-    // Clear our parameters context menu
+    // Clear our parameters context menu, including its component menus, and
+    // our parameter picker
 
     mParametersContextMenu->clear();
+
+    qDeleteAll(mParametersContextMenu->findChildren<QMenu *>(QString(), Qt::FindDirectChildrenOnly));
+
+    mParameterActions.clear();
+    mComponentMenus.clear();
+    mComponentChildren.clear();
+    mComponentParameters.clear();
+
+    mParameterPicker->setParameters(CellMLSupport::CellmlFileRuntimeParameters());
 }
 
 //==============================================================================
@@ -582,17 +609,23 @@ void SingleCellViewInformationGraphsWidget::propertyEditorSectionResized(const i
 void SingleCellViewInformationGraphsWidget::populateParametersContextMenu(CellMLSupport::CellmlFileRuntime *pRuntime)
 {
     // Populate our parameters context menu with the contents of our main
-    // context menu
+    // context menu and with our search parameter action
 
     mParametersContextMenu->addActions(mContextMenu->actions());
     mParametersContextMenu->addSeparator();
+    mParametersContextMenu->addAction(mSearchParameterAction);
+    mParametersContextMenu->addSeparator();
 
-    // Now, add our model parameters to it
+    // Keep track of our model parameters and of the children of each component
+    // in our component hierarchy
+    // Note: our component menus get populated only when they are about to be
+    //       shown, since populating them all at once can take a long time for
+    //       models with thousands of parameters...
 
+    CellMLSupport::CellmlFileRuntimeParameters parameters = pRuntime->parameters();
     QString componentHierarchy = QString();
-    QMenu *componentMenu = 0;
 
-    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, pRuntime->parameters()) {
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters) {
         // Check whether the current parameter is in the same component
         // hierarchy as the previous one
 
@@ -600,39 +633,17 @@ void SingleCellViewInformationGraphsWidget::populateParametersContextMenu(CellML
 
         if (crtComponentHierarchy.compare(componentHierarchy)) {
             // The current parameter is in a different component hierarchy, so
-            // create a new menu hierarchy for our 'new' component, reusing
-            // existing menus, whenever possible
+            // keep track of the components that make it, if needed
 
-            QMenu *menu = mParametersContextMenu;
+            QString parentComponentHierarchy = QString();
 
             foreach (const QString &component, parameter->componentHierarchy()) {
-                // Check whether we already have a menu for our current
-                // component
-
-                componentMenu = 0;
+                QStringList &children = mComponentChildren[parentComponentHierarchy];
 
-                foreach (QObject *object, menu->children()) {
-                    QMenu *subMenu = qobject_cast<QMenu *>(object);
+                if (!children.contains(component))
+                    children << component;
 
-                    if (subMenu && !subMenu->menuAction()->text().compare(component)) {
-                        componentMenu = subMenu;
-
-                        break;
-                    }
-                }
-
-                // Create a new menu for our current component, if none could be
-                // found
-
-                if (!componentMenu) {
-                    componentMenu = new QMenu(component, menu);
-
-                    menu->addMenu(componentMenu);
-                }
-
-                // Get ready for the next component in our component hierarchy
-
-                menu = componentMenu;
+                parentComponentHierarchy += (parentComponentHierarchy.isEmpty()?QString():".")+component;
             }
 
             // Keep track of the new component hierarchy
@@ -640,27 +651,41 @@ void SingleCellViewInformationGraphsWidget::populateParametersContextMenu(CellML
             componentHierarchy = crtComponentHierarchy;
         }
 
-        // Make sure that we have a 'current' component menu
-        // Note: this should never happen, but we never know...
+        // Keep track of the current parameter
 
-        if (!componentMenu)
-            continue;
+        mComponentParameters[componentHierarchy] << parameter;
+    }
 
-        // Add the current parameter to the 'current' component menu
+    // Add our top-level component menus
 
-        QAction *parameterAction = componentMenu->addAction(SingleCellViewSimulationWidget::parameterIcon(parameter->type()),
-                                                            parameter->formattedName());
+    foreach (const QString &component, mComponentChildren.value(QString()))
+        addComponentMenu(mParametersContextMenu, QString(), component);
 
-        // Create a connection to handle the parameter value update
+    // Let our parameter picker know about our model parameters
 
-        connect(parameterAction, SIGNAL(triggered(bool)),
-                this, SLOT(updateParameterValue()));
+    mParameterPicker->setParameters(parameters);
+}
 
-        // Keep track of the parameter associated with our model parameter
-        // action
+//==============================================================================
 
-        mParameterActions.insert(parameterAction, parameter);
-    }
+void SingleCellViewInformationGraphsWidget::addComponentMenu(QMenu *pParentMenu,
+                                                             const QString &pComponentHierarchy,
+                                                             const QString &pComponent)
+{
+    // Add an empty menu for the given component, which will get populated when
+    // it is about to be shown
+
+    QMenu *componentMenu = new QMenu(pComponent, pParentMenu);
+
+    pParentMenu->addMenu(componentMenu);
+
+    mComponentMenus.insert(componentMenu,
+                           pComponentHierarchy.isEmpty()?
+                               pComponent:
+                               pComponentHierarchy+"."+pComponent);
+
+    connect(componentMenu, SIGNAL(aboutToShow()),
+            this, SLOT(populateComponentMenu()));
 }
 
 //==============================================================================
@@ -797,9 +822,11 @@ void SingleCellViewInformationGraphsWidget::updateGraphInfo(Core::Property *pPro
 
     pProperty->setIcon(graphOk?BlankIcon:WarningIcon);
 
-    // Update the file name with which the graph is associated
+    // Update the file name with which the graph is associated, as well as its
+    // title (i.e. the name of its Y parameter)
 
     graph->setFileName(fileName);
+    graph->setTitle(pProperty->properties()[2]->value());
 
     // Let people know if we consider that the graph has been updated
 
@@ -965,6 +992,44 @@ void SingleCellViewInformationGraphsWidget::updateAllGraphsInfo()
 
 //==============================================================================
 
+void SingleCellViewInformationGraphsWidget::populateComponentMenu()
+{
+    // Make sure that the component menu that is about to be shown has not
+    // already been populated
+
+    QMenu *componentMenu = qobject_cast<QMenu *>(sender());
+
+    if (!mComponentMenus.contains(componentMenu))
+        return;
+
+    QString componentHierarchy = mComponentMenus.take(componentMenu);
+
+    // Add the parameters of the component to its menu
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter,
+             mComponentParameters.value(componentHierarchy)) {
+        QAction *parameterAction = componentMenu->addAction(SingleCellViewSimulationWidget::parameterIcon(parameter->type()),
+                                                            parameter->formattedName());
+
+        // Create a connection to handle the parameter value update
+
+        connect(parameterAction, SIGNAL(triggered(bool)),
+                this, SLOT(updateParameterValue()));
+
+        // Keep track of the parameter associated with our model parameter
+        // action
+
+        mParameterActions.insert(parameterAction, parameter);
+    }
+
+    // Add (empty) menus for the sub-components of the component
+
+    foreach (const QString &component, mComponentChildren.value(componentHierarchy))
+        addComponentMenu(componentMenu, componentHierarchy, component);
+}
+
+//==============================================================================
+
 void SingleCellViewInformationGraphsWidget::updateParameterValue()
 {
     // Update the current property's value
@@ -974,6 +1039,21 @@ void SingleCellViewInformationGraphsWidget::updateParameterValue()
 
 //==============================================================================
 
+void SingleCellViewInformationGraphsWidget::searchParameter()
+{
+    // Let the user search for a parameter and update the current property's
+    // value with it, if any
+
+    Core::Property *crtProperty = mPropertyEditor->currentProperty();
+
+    if (   (mParameterPicker->exec() == QDialog::Accepted)
+        && mParameterPicker->parameter()) {
+        crtProperty->setValue(mParameterPicker->parameter()->fullyFormattedName());
+    }
+}
+
+//==============================================================================
+
 }   // namespace SingleCellView
 }   // namespace OpenCOR
 
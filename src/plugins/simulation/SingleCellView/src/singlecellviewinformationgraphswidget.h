@@ -56,6 +56,7 @@ namespace SingleCellView {
 
 //==============================================================================
 
+class SingleCellViewParameterPickerWindow;
 class SingleCellViewPlugin;
 class SingleCellViewSimulation;
 class SingleCellViewSimulationWidget;
@@ -108,14 +109,24 @@ private:
     QAction *mRemoveAllGraphsAction;
     QAction *mSelectAllGraphsAction;
     QAction *mUnselectAllGraphsAction;
+    QAction *mSearchParameterAction;
 
     QMap<QAction *, CellMLSupport::CellmlFileRuntimeParameter *> mParameterActions;
 
+    QMap<QMenu *, QString> mComponentMenus;
+    QMap<QString, QStringList> mComponentChildren;
+    QMap<QString, CellMLSupport::CellmlFileRuntimeParameters> mComponentParameters;
+
+    SingleCellViewParameterPickerWindow *mParameterPicker;
+
     bool mCanEmitGraphsUpdatedSignal;
 
     int mHorizontalScrollBarValue;
 
     void populateParametersContextMenu(CellMLSupport::CellmlFileRuntime *pRuntime);
+    void addComponentMenu(QMenu *pParentMenu,
+                          const QString &pComponentHierarchy,
+                          const QString &pComponent);
 
     bool checkParameter(CellMLSupport::CellmlFileRuntime *pRuntime,
                         GraphPanelWidget::GraphPanelPlotGraph *pGraph,
@@ -161,7 +172,10 @@ private Q_SLOTS:
 
     void graphChanged(Core::Property *pProperty);
 
+    void populateComponentMenu();
+
     void updateParameterValue();
+    void searchParameter();
 };
 
 //==============================================================================
@@ -28,6 +28,8 @@ limitations under the License.
 //==============================================================================
 
 #include <QMenu>
+#include <QScrollBar>
+#include <QTimer>
 
 //==============================================================================
 
@@ -38,15 +40,46 @@ namespace SingleCellView {
 
 SingleCellViewInformationParametersWidget::SingleCellViewInformationParametersWidget(QWidget *pParent) :
     PropertyEditorWidget(false, pParent),
+    mComputeSensitivitiesAction(0),
     mParameters(QMap<Core::Property *, CellMLSupport::CellmlFileRuntimeParameter *>()),
     mParameterActions(QMap<QAction *, CellMLSupport::CellmlFileRuntimeParameter *>()),
+    mIndexProperties(QMap<QPersistentModelIndex, Core::Property *>()),
+    mPropertyValues(QMap<Core::Property *, double>()),
     mSimulation(0),
-    mNeedClearing(false)
+    mNeedClearing(false),
+    mCurrentPoint(0.0)
 {
     // Create our context menu
 
     mContextMenu = new QMenu(this);
 
+    // Create our update timer, which is used to coalesce the updates of our
+    // parameters to (roughly) the refresh rate of a display
+    // Note: our simulation data may get updated much more often than that
+    //       while a simulation is running...
+
+    enum {
+        UpdateInterval = 16
+    };
+
+    mUpdateTimer = new QTimer(this);
+
+    mUpdateTimer->setInterval(UpdateInterval);
+    mUpdateTimer->setSingleShot(true);
+
+    connect(mUpdateTimer, SIGNAL(timeout()),
+            this, SLOT(updateVisibleParameters()));
+
+    // Our parameters are only updated when they are visible, so make sure
+    // that those which become visible get updated
+
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(updateVisibleParameters()));
+    connect(this, SIGNAL(expanded(const QModelIndex &)),
+            this, SLOT(updateVisibleParameters()));
+    connect(this, SIGNAL(collapsed(const QModelIndex &)),
+            this, SLOT(updateVisibleParameters()));
+
     // We want our own context menu
 
     setContextMenuPolicy(Qt::CustomContextMenu);
@@ -70,6 +103,9 @@ void SingleCellViewInformationParametersWidget::retranslateContextMenu()
         mContextMenu->actions()[0]->setText(tr("Plot Against Variable of Integration"));
         mContextMenu->actions()[1]->setText(tr("Plot Against"));
     }
+
+    if (mComputeSensitivitiesAction)
+        mComputeSensitivitiesAction->setText(tr("Compute Sensitivities"));
 }
 
 //==============================================================================
@@ -97,6 +133,7 @@ void SingleCellViewInformationParametersWidget::initialize(SingleCellViewSimulat
     // Keep track of the simulation
 
     mSimulation = pSimulation;
+    mCurrentPoint = pSimulation->data()->startingPoint();
 
     // First clear ourselves, if needed
 
@@ -123,7 +160,7 @@ void SingleCellViewInformationParametersWidget::initialize(SingleCellViewSimulat
     // Keep track of when some of the model's data has changed
 
     connect(pSimulation->data(), SIGNAL(updated(const double &)),
-            this, SLOT(updateParameters(const double &)));
+            this, SLOT(scheduleParametersUpdate(const double &)));
 }
 
 //==============================================================================
@@ -131,68 +168,126 @@ void SingleCellViewInformationParametersWidget::initialize(SingleCellViewSimulat
 void SingleCellViewInformationParametersWidget::finalize()
 {
     // Clear ourselves, as well as our context menu, parameters and parameter
-    // actions
+    // actions, and stop any pending update
 
     mNeedClearing = true;
 
     mContextMenu->clear();
 
+    mComputeSensitivitiesAction = 0;
+
     mParameters.clear();
     mParameterActions.clear();
+
+    mIndexProperties.clear();
+    mPropertyValues.clear();
+
+    mUpdateTimer->stop();
 }
 
 //==============================================================================
 
-void SingleCellViewInformationParametersWidget::updateParameters(const double &pCurrentPoint,
-                                                                 const bool &pProcessEvents)
+void SingleCellViewInformationParametersWidget::resizeEvent(QResizeEvent *pEvent)
 {
-    // Update our data
+    // Default handling of the event
 
-    foreach (Core::Property *property, properties()) {
-        CellMLSupport::CellmlFileRuntimeParameter *parameter = mParameters.value(property);
+    PropertyEditorWidget::resizeEvent(pEvent);
 
-        if (parameter) {
-            switch (parameter->type()) {
-            case CellMLSupport::CellmlFileRuntimeParameter::Voi:
-                property->setDoubleValue(pCurrentPoint, false);
+    // Update the parameters that may have become visible
 
-                break;
-            case CellMLSupport::CellmlFileRuntimeParameter::Constant:
-            case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
-                property->setDoubleValue(mSimulation->data()->constants()[parameter->index()], false);
+    updateVisibleParameters();
+}
 
-                break;
-            case CellMLSupport::CellmlFileRuntimeParameter::Rate:
-                property->setDoubleValue(mSimulation->data()->rates()[parameter->index()], false);
+//==============================================================================
 
-                break;
-            case CellMLSupport::CellmlFileRuntimeParameter::State:
-                property->setDoubleValue(mSimulation->data()->states()[parameter->index()], false);
+double SingleCellViewInformationParametersWidget::parameterValue(CellMLSupport::CellmlFileRuntimeParameter *pParameter,
+                                                                 const double &pCurrentPoint) const
+{
+    // Return the current value of the given parameter, straight from our
+    // simulation data
+
+    switch (pParameter->type()) {
+    case CellMLSupport::CellmlFileRuntimeParameter::Voi:
+        return pCurrentPoint;
+    case CellMLSupport::CellmlFileRuntimeParameter::Constant:
+    case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
+        return mSimulation->data()->constants()[pParameter->index()];
+    case CellMLSupport::CellmlFileRuntimeParameter::Rate:
+        return mSimulation->data()->rates()[pParameter->index()];
+    case CellMLSupport::CellmlFileRuntimeParameter::State:
+        return mSimulation->data()->states()[pParameter->index()];
+    case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
+        return mSimulation->data()->algebraic()[pParameter->index()];
+    default:
+        // Not a relevant type, so return 0.0
+
+        return 0.0;
+    }
+}
 
-                break;
-            case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
-                property->setDoubleValue(mSimulation->data()->algebraic()[parameter->index()], false);
+//==============================================================================
 
-                break;
-            default:
-                // Not a relevant type, so do nothing
+void SingleCellViewInformationParametersWidget::updateParameters(const double &pCurrentPoint)
+{
+    // Update our parameters straightaway, cancelling any pending update
 
-                break;
+    mCurrentPoint = pCurrentPoint;
+
+    mUpdateTimer->stop();
+
+    updateVisibleParameters();
+}
+
+//==============================================================================
+
+void SingleCellViewInformationParametersWidget::scheduleParametersUpdate(const double &pCurrentPoint)
+{
+    // Keep track of the current point and schedule an update of our parameters,
+    // unless one is already pending
+
+    mCurrentPoint = pCurrentPoint;
+
+    if (!mUpdateTimer->isActive())
+        mUpdateTimer->start();
+}
+
+//==============================================================================
+
+void SingleCellViewInformationParametersWidget::updateVisibleParameters()
+{
+    // Make sure that we are initialised
+
+    if (!mSimulation || mParameters.isEmpty())
+        return;
+
+    // Update the parameters that are visible, going from the one at the top of
+    // our viewport down to the last one that is (partially) visible
+    // Note #1: the parameters that are not visible will get updated as soon as
+    //          they become visible, i.e. when scrolling or expanding a section
+    //          (see our constructor), or when resizing ourselves (see
+    //          resizeEvent())...
+    // Note #2: formatting a value is what is expensive, so we only do it if
+    //          the value of a parameter has actually changed since we last
+    //          displayed it...
+
+    int viewportHeight = viewport()->height();
+
+    for (QModelIndex index = indexAt(QPoint(0, 0));
+         index.isValid() && (visualRect(index).top() < viewportHeight);
+         index = indexBelow(index)) {
+        Core::Property *property = mIndexProperties.value(index.sibling(index.row(), 0));
+        CellMLSupport::CellmlFileRuntimeParameter *parameter = mParameters.value(property);
+
+        if (parameter) {
+            double value = parameterValue(parameter, mCurrentPoint);
+            QMap<Core::Property *, double>::iterator propertyValue = mPropertyValues.find(property);
+
+            if ((propertyValue == mPropertyValues.end()) || (propertyValue.value() != value)) {
+                property->setDoubleValue(value, false);
+
+                mPropertyValues.insert(property, value);
             }
         }
-
-        // Make sure that we don't hang up the GUI unnecessarily
-        // Note #1: this is useful when we run a model with loads of parameters
-        //          since otherwise the simulation won't finish smoothly (see
-        //          issue #656)...
-        // Note #2: we don't want to process events all the time otherwise it
-        //          would mean that whenever we move the mouse while editing a
-        //          parameter, then the GUI would keep flashing because of the
-        //          editor closing and then reopening repeatedly until we stop
-        //          moving the mouse (see issue #733)...
-
-        if (pProcessEvents)
-            QCoreApplication::processEvents();
     }
 
     // Check whether any of our properties has actually been modified
@@ -333,36 +428,7 @@ void SingleCellViewInformationParametersWidget::populateModel(CellMLSupport::Cel
         // Add the current parameter to the current section property, after
         // having retrieved its current value
 
-        double propertyValue = 0.0;
-
-        switch (parameter->type()) {
-        case CellMLSupport::CellmlFileRuntimeParameter::Voi:
-            propertyValue = mSimulation->data()->startingPoint();
-
-            break;
-        case CellMLSupport::CellmlFileRuntimeParameter::Constant:
-        case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
-            propertyValue = mSimulation->data()->constants()[parameter->index()];
-
-            break;
-        case CellMLSupport::CellmlFileRuntimeParameter::Rate:
-            propertyValue = mSimulation->data()->rates()[parameter->index()];
-
-            break;
-        case CellMLSupport::CellmlFileRuntimeParameter::State:
-            propertyValue = mSimulation->data()->states()[parameter->index()];
-
-            break;
-        case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
-            propertyValue = mSimulation->data()->algebraic()[parameter->index()];
-
-            break;
-        default:
-            // Not a relevant type, so do nothing
-
-            ;
-        }
-
+        double propertyValue = parameterValue(parameter, mSimulation->data()->startingPoint());
         Core::Property *property = addDoubleProperty(propertyValue, sectionProperty);
 
         property->setEditable(   (parameter->type() == CellMLSupport::CellmlFileRuntimeParameter::Constant)
@@ -373,9 +439,16 @@ void SingleCellViewInformationParametersWidget::populateModel(CellMLSupport::Cel
         property->setName(parameter->formattedName(), false);
         property->setUnit(parameter->formattedUnit(pRuntime->variableOfIntegration()->unit()), false);
 
-        // Keep track of the link between our property value and parameter
+        // Keep track of the link between our property value and parameter, as
+        // well as of our property's index and value
+        // Note: we keep track of our property's index using a persistent model
+        //       index since, unlike a model index, it remains valid if rows
+        //       get inserted, moved or removed...
 
         mParameters.insert(property, parameter);
+
+        mIndexProperties.insert(property->index(), property);
+        mPropertyValues.insert(property, propertyValue);
     }
 
     // Update (well, set here) the extra info of all our parameters
@@ -398,7 +471,21 @@ void SingleCellViewInformationParametersWidget::populateContextMenu(CellMLSuppor
 
     mContextMenu->addAction(plotAgainstMenu->menuAction());
 
-    // Initialise our two main menu items
+    // Create our menu item to compute the sensitivities of our states with
+    // respect to a constant, if our model is an ODE model
+
+    if (pRuntime->needOdeSolver()) {
+        mContextMenu->addSeparator();
+
+        mComputeSensitivitiesAction = mContextMenu->addAction(QString());
+
+        mComputeSensitivitiesAction->setCheckable(true);
+
+        connect(mComputeSensitivitiesAction, SIGNAL(triggered(bool)),
+                this, SLOT(computeSensitivities(const bool &)));
+    }
+
+    // Initialise our main menu items
 
     retranslateContextMenu();
 
@@ -556,6 +643,23 @@ void SingleCellViewInformationParametersWidget::propertyEditorContextMenu(const
     if (crtProperty->type() == Core::Property::Section)
         return;
 
+    // Show our menu item to compute sensitivities only for constants, and
+    // only allow it to be used when our simulation is neither running nor
+    // paused, since the sensitivities of our states are computed alongside
+    // our states
+
+    if (mComputeSensitivitiesAction) {
+        CellMLSupport::CellmlFileRuntimeParameter *parameter = mParameters.value(crtProperty);
+        bool constantParameter =    parameter
+                                 && (parameter->type() == CellMLSupport::CellmlFileRuntimeParameter::Constant);
+
+        mComputeSensitivitiesAction->setVisible(constantParameter);
+        mComputeSensitivitiesAction->setEnabled(   !mSimulation->isRunning()
+                                                && !mSimulation->isPaused());
+        mComputeSensitivitiesAction->setChecked(   constantParameter
+                                                && mSimulation->data()->sensitivityParameters().contains(parameter->index()));
+    }
+
     // Generate and show the context menu
 
     mContextMenu->exec(QCursor::pos());
@@ -574,6 +678,31 @@ void SingleCellViewInformationParametersWidget::emitGraphRequired()
 
 //==============================================================================
 
+void SingleCellViewInformationParametersWidget::computeSensitivities(const bool &pCompute)
+{
+    // Add/remove the current constant to/from the constants with respect to
+    // which we compute the sensitivities of our states
+    // Note: the new sensitivities will only be available the next time our
+    //       simulation is run, since our results need to be recreated to
+    //       accommodate them...
+
+    CellMLSupport::CellmlFileRuntimeParameter *parameter = mParameters.value(currentProperty());
+
+    if (!parameter)
+        return;
+
+    QList<int> sensitivityParameters = mSimulation->data()->sensitivityParameters();
+
+    if (pCompute)
+        sensitivityParameters << parameter->index();
+    else
+        sensitivityParameters.removeOne(parameter->index());
+
+    mSimulation->data()->setSensitivityParameters(sensitivityParameters);
+}
+
+//==============================================================================
+
 }   // namespace SingleCellView
 }   // namespace OpenCOR
 
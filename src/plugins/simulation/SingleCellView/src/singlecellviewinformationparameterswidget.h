@@ -28,6 +28,14 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QPersistentModelIndex>
+
+//==============================================================================
+
+class QTimer;
+
+//==============================================================================
+
 namespace OpenCOR {
 
 //==============================================================================
@@ -62,16 +70,29 @@ public:
 
     QMap<Core::Property *, CellMLSupport::CellmlFileRuntimeParameter *> parameters() const;
 
+protected:
+    virtual void resizeEvent(QResizeEvent *pEvent);
+
 private:
     QMenu *mContextMenu;
+    QAction *mComputeSensitivitiesAction;
 
     QMap<Core::Property *, CellMLSupport::CellmlFileRuntimeParameter *> mParameters;
     QMap<QAction *, CellMLSupport::CellmlFileRuntimeParameter *> mParameterActions;
 
+    QMap<QPersistentModelIndex, Core::Property *> mIndexProperties;
+    QMap<Core::Property *, double> mPropertyValues;
+
     SingleCellViewSimulation *mSimulation;
 
     bool mNeedClearing;
 
+    QTimer *mUpdateTimer;
+    double mCurrentPoint;
+
+    double parameterValue(CellMLSupport::CellmlFileRuntimeParameter *pParameter,
+                          const double &pCurrentPoint) const;
+
     void populateModel(CellMLSupport::CellmlFileRuntime *pRuntime);
     void populateContextMenu(CellMLSupport::CellmlFileRuntime *pRuntime);
 
@@ -84,15 +105,19 @@ Q_SIGNALS:
                        CellMLSupport::CellmlFileRuntimeParameter *pParameterY);
 
 public Q_SLOTS:
-    void updateParameters(const double &pCurrentPoint,
-                          const bool &pProcessEvents = false);
+    void updateParameters(const double &pCurrentPoint);
 
 private Q_SLOTS:
+    void scheduleParametersUpdate(const double &pCurrentPoint);
+    void updateVisibleParameters();
+
     void propertyEditorContextMenu(const QPoint &pPosition) const;
 
     void propertyChanged(Core::Property *pProperty);
 
     void emitGraphRequired();
+
+    void computeSensitivities(const bool &pCompute);
 };
 
 //==============================================================================
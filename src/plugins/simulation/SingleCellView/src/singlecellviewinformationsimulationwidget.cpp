@@ -40,9 +40,20 @@ SingleCellViewInformationSimulationWidget::SingleCellViewInformationSimulationWi
     mEndingPointProperty   = addDoubleProperty(1000.0);
     mPointIntervalProperty = addDoubleProperty(1.0);
 
+    mCheckpointIntervalProperty = addIntegerProperty(0);
+
+    mConvergencePeriodProperty    = addDoubleProperty(0.0);
+    mConvergenceToleranceProperty = addDoubleProperty(0.0);
+
     mStartingPointProperty->setEditable(true);
     mEndingPointProperty->setEditable(true);
     mPointIntervalProperty->setEditable(true);
+
+    mCheckpointIntervalProperty->setEditable(true);
+    mCheckpointIntervalProperty->setUnit("s");
+
+    mConvergencePeriodProperty->setEditable(true);
+    mConvergenceToleranceProperty->setEditable(true);
 }
 
 //==============================================================================
@@ -58,6 +69,11 @@ void SingleCellViewInformationSimulationWidget::retranslateUi()
     mStartingPointProperty->setName(tr("Starting point"));
     mEndingPointProperty->setName(tr("Ending point"));
     mPointIntervalProperty->setName(tr("Point interval"));
+
+    mCheckpointIntervalProperty->setName(tr("Checkpoint interval"));
+
+    mConvergencePeriodProperty->setName(tr("Convergence period"));
+    mConvergenceToleranceProperty->setName(tr("Convergence tolerance"));
 }
 
 //==============================================================================
@@ -72,6 +88,8 @@ void SingleCellViewInformationSimulationWidget::initialize(SingleCellViewSimulat
     mEndingPointProperty->setUnit(unit);
     mPointIntervalProperty->setUnit(unit);
 
+    mConvergencePeriodProperty->setUnit(unit);
+
     // Initialise our simulation's starting point so that we can then properly
     // reset our simulation the first time round
 
@@ -107,6 +125,33 @@ Core::Property * SingleCellViewInformationSimulationWidget::pointIntervalPropert
 
 //==============================================================================
 
+Core::Property * SingleCellViewInformationSimulationWidget::checkpointIntervalProperty() const
+{
+    // Return our checkpoint interval property
+
+    return mCheckpointIntervalProperty;
+}
+
+//==============================================================================
+
+Core::Property * SingleCellViewInformationSimulationWidget::convergencePeriodProperty() const
+{
+    // Return our convergence period property
+
+    return mConvergencePeriodProperty;
+}
+
+//==============================================================================
+
+Core::Property * SingleCellViewInformationSimulationWidget::convergenceToleranceProperty() const
+{
+    // Return our convergence tolerance property
+
+    return mConvergenceToleranceProperty;
+}
+
+//==============================================================================
+
 double SingleCellViewInformationSimulationWidget::startingPoint() const
 {
     // Return our starting point
@@ -134,6 +179,39 @@ double SingleCellViewInformationSimulationWidget::pointInterval() const
 
 //==============================================================================
 
+int SingleCellViewInformationSimulationWidget::checkpointInterval() const
+{
+    // Return our checkpoint interval
+    // Note: a checkpoint interval of zero means that no checkpoint is to be
+    //       saved...
+
+    return mCheckpointIntervalProperty->integerValue();
+}
+
+//==============================================================================
+
+double SingleCellViewInformationSimulationWidget::convergencePeriod() const
+{
+    // Return our convergence period
+    // Note: a convergence period of zero means that we check for a true steady
+    //       state rather than a periodic one...
+
+    return mConvergencePeriodProperty->doubleValue();
+}
+
+//==============================================================================
+
+double SingleCellViewInformationSimulationWidget::convergenceTolerance() const
+{
+    // Return our convergence tolerance
+    // Note: a convergence tolerance of zero means that we don't check for
+    //       convergence...
+
+    return mConvergenceToleranceProperty->doubleValue();
+}
+
+//==============================================================================
+
 }   // namespace SingleCellView
 }   // namespace OpenCOR
 
@@ -51,15 +51,24 @@ public:
     Core::Property * startingPointProperty() const;
     Core::Property * endingPointProperty() const;
     Core::Property * pointIntervalProperty() const;
+    Core::Property * checkpointIntervalProperty() const;
+    Core::Property * convergencePeriodProperty() const;
+    Core::Property * convergenceToleranceProperty() const;
 
     double startingPoint() const;
     double endingPoint() const;
     double pointInterval() const;
+    int checkpointInterval() const;
+    double convergencePeriod() const;
+    double convergenceTolerance() const;
 
 private:
     Core::Property *mStartingPointProperty;
     Core::Property *mEndingPointProperty;
     Core::Property *mPointIntervalProperty;
+    Core::Property *mCheckpointIntervalProperty;
+    Core::Property *mConvergencePeriodProperty;
+    Core::Property *mConvergenceToleranceProperty;
 
     void updateToolTips();
 };
@@ -0,0 +1,252 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view parameter picker window
+//==============================================================================
+
+#include "singlecellviewparameterpickerwindow.h"
+#include "singlecellviewsimulationwidget.h"
+
+//==============================================================================
+
+#include <QCoreApplication>
+#include <QDialogButtonBox>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QSet>
+#include <QVBoxLayout>
+
+//==============================================================================
+
+#include <algorithm>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace SingleCellView {
+
+//==============================================================================
+
+static const int MaxNbOfListedParameters = 250;
+
+//==============================================================================
+
+SingleCellViewParameterPickerWindow::SingleCellViewParameterPickerWindow(QWidget *pParent) :
+    QDialog(pParent),
+    mIndex(QVector<IndexEntry>()),
+    mParameters(QMap<QListWidgetItem *, CellMLSupport::CellmlFileRuntimeParameter *>())
+{
+    // Create our GUI, which consists of a filter, a list of (matching)
+    // parameters and some OK/Cancel buttons
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    mFilterValue = new QLineEdit(this);
+    mParametersValue = new QListWidget(this);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok|QDialogButtonBox::Cancel, this);
+
+    layout->addWidget(mFilterValue);
+    layout->addWidget(mParametersValue);
+    layout->addWidget(buttonBox);
+
+    // Let our filter handle the navigation keys on behalf of our list of
+    // parameters, so that the user can keep typing while browsing through
+    // matching parameters
+
+    mFilterValue->installEventFilter(this);
+
+    // Some connections to handle our filter, list of parameters and buttons
+
+    connect(mFilterValue, SIGNAL(textChanged(const QString &)),
+            this, SLOT(updateParameters(const QString &)));
+
+    connect(mParametersValue, SIGNAL(itemDoubleClicked(QListWidgetItem *)),
+            this, SLOT(parameterDoubleClicked(QListWidgetItem *)));
+
+    connect(buttonBox, SIGNAL(accepted()),
+            this, SLOT(accept()));
+    connect(buttonBox, SIGNAL(rejected()),
+            this, SLOT(reject()));
+
+    // Retranslate ourselves
+
+    retranslateUi();
+}
+
+//==============================================================================
+
+void SingleCellViewParameterPickerWindow::retranslateUi()
+{
+    // Retranslate ourselves
+
+    setWindowTitle(tr("Search Parameter"));
+
+    mFilterValue->setPlaceholderText(tr("Type the name of a parameter..."));
+}
+
+//==============================================================================
+
+void SingleCellViewParameterPickerWindow::setParameters(const CellMLSupport::CellmlFileRuntimeParameters &pParameters)
+{
+    // Build a (sorted) prefix index of our parameters, using the lower-case
+    // version of their fully formatted name and of each of its suffixes (i.e.
+    // the name of a parameter can be searched for from any of the components
+    // in its hierarchy), so that looking up a filter only requires a binary
+    // search and a walk through the entries that start with it
+
+    mIndex.clear();
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, pParameters) {
+        QString key = parameter->fullyFormattedName().toLower();
+
+        forever {
+            mIndex << IndexEntry(key, parameter);
+
+            int dotIndex = key.indexOf('.');
+
+            if (dotIndex == -1)
+                break;
+
+            key = key.mid(dotIndex+1);
+        }
+    }
+
+    std::sort(mIndex.begin(), mIndex.end());
+
+    // Reset our filter and list of parameters
+
+    mFilterValue->clear();
+
+    updateParameters(QString());
+}
+
+//==============================================================================
+
+CellMLSupport::CellmlFileRuntimeParameter * SingleCellViewParameterPickerWindow::parameter() const
+{
+    // Return the currently selected parameter, if any
+
+    return mParameters.value(mParametersValue->currentItem());
+}
+
+//==============================================================================
+
+bool SingleCellViewParameterPickerWindow::eventFilter(QObject *pObject,
+                                                      QEvent *pEvent)
+{
+    // Forward the navigation keys that were pressed in our filter to our list
+    // of parameters
+
+    if ((pObject == mFilterValue) && (pEvent->type() == QEvent::KeyPress)) {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent *>(pEvent);
+
+        if (   (keyEvent->key() == Qt::Key_Up)
+            || (keyEvent->key() == Qt::Key_Down)
+            || (keyEvent->key() == Qt::Key_PageUp)
+            || (keyEvent->key() == Qt::Key_PageDown)) {
+            QKeyEvent forwardedKeyEvent(keyEvent->type(), keyEvent->key(),
+                                        keyEvent->modifiers());
+
+            QCoreApplication::sendEvent(mParametersValue, &forwardedKeyEvent);
+
+            return true;
+        }
+    }
+
+    return QDialog::eventFilter(pObject, pEvent);
+}
+
+//==============================================================================
+
+void SingleCellViewParameterPickerWindow::showEvent(QShowEvent *pEvent)
+{
+    // Default handling of the event
+
+    QDialog::showEvent(pEvent);
+
+    // Select the contents of our filter, so that the user can start typing
+    // straightaway
+
+    mFilterValue->selectAll();
+    mFilterValue->setFocus();
+}
+
+//==============================================================================
+
+void SingleCellViewParameterPickerWindow::updateParameters(const QString &pFilter)
+{
+    // Retrieve the parameters that match the given filter, using our prefix
+    // index
+    // Note: we only list a limited number of parameters, so that the update is
+    //       instant whatever the size of the model...
+
+    QString filter = pFilter.trimmed().toLower();
+    QVector<IndexEntry>::ConstIterator indexEntry = std::lower_bound(mIndex.constBegin(), mIndex.constEnd(),
+                                                                     IndexEntry(filter, 0));
+    QVector<IndexEntry>::ConstIterator indexEnd = mIndex.constEnd();
+    CellMLSupport::CellmlFileRuntimeParameters parameters = CellMLSupport::CellmlFileRuntimeParameters();
+    QSet<CellMLSupport::CellmlFileRuntimeParameter *> listedParameters = QSet<CellMLSupport::CellmlFileRuntimeParameter *>();
+
+    for (; (indexEntry != indexEnd)
+           && (parameters.count() < MaxNbOfListedParameters)
+           && indexEntry->first.startsWith(filter); ++indexEntry) {
+        if (!listedParameters.contains(indexEntry->second)) {
+            parameters << indexEntry->second;
+
+            listedParameters << indexEntry->second;
+        }
+    }
+
+    // Update our list of parameters
+
+    mParametersValue->clear();
+    mParameters.clear();
+
+    foreach (CellMLSupport::CellmlFileRuntimeParameter *parameter, parameters) {
+        QListWidgetItem *item = new QListWidgetItem(SingleCellViewSimulationWidget::parameterIcon(parameter->type()),
+                                                    parameter->fullyFormattedName(),
+                                                    mParametersValue);
+
+        mParameters.insert(item, parameter);
+    }
+
+    mParametersValue->setCurrentRow(0);
+}
+
+//==============================================================================
+
+void SingleCellViewParameterPickerWindow::parameterDoubleClicked(QListWidgetItem *pItem)
+{
+    // Select the given parameter and close ourselves
+
+    mParametersValue->setCurrentItem(pItem);
+
+    accept();
+}
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
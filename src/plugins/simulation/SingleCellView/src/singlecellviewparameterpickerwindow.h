@@ -0,0 +1,88 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view parameter picker window
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "cellmlfileruntime.h"
+
+//==============================================================================
+
+#include <QDialog>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+
+//==============================================================================
+
+class QLineEdit;
+class QListWidget;
+class QListWidgetItem;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace SingleCellView {
+
+//==============================================================================
+
+class SingleCellViewParameterPickerWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SingleCellViewParameterPickerWindow(QWidget *pParent);
+
+    void retranslateUi();
+
+    void setParameters(const CellMLSupport::CellmlFileRuntimeParameters &pParameters);
+
+    CellMLSupport::CellmlFileRuntimeParameter * parameter() const;
+
+protected:
+    virtual bool eventFilter(QObject *pObject, QEvent *pEvent);
+    virtual void showEvent(QShowEvent *pEvent);
+
+private:
+    typedef QPair<QString, CellMLSupport::CellmlFileRuntimeParameter *> IndexEntry;
+
+    QLineEdit *mFilterValue;
+    QListWidget *mParametersValue;
+
+    QVector<IndexEntry> mIndex;
+    QMap<QListWidgetItem *, CellMLSupport::CellmlFileRuntimeParameter *> mParameters;
+
+private Q_SLOTS:
+    void updateParameters(const QString &pFilter);
+
+    void parameterDoubleClicked(QListWidgetItem *pItem);
+};
+
+//==============================================================================
+
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
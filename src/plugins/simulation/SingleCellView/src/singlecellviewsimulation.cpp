@@ -22,10 +22,17 @@ limitations under the License.
 
 #include "cellmlfile.h"
 #include "cellmlfileruntime.h"
+#include "corecliutils.h"
 #include "singlecellviewsimulation.h"
 
 //==============================================================================
 
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QtMath>
 
 //==============================================================================
@@ -35,6 +42,62 @@ namespace SingleCellView {
 
 //==============================================================================
 
+static const quint32 CheckpointMagicNumber = 0x4f435343;   // i.e. "OCSC"
+static const quint32 CheckpointVersion = 3;
+
+static const auto CheckpointResultsExtension = QStringLiteral("results");
+
+static const qint64 CheckpointChunkSize = 1 << 24;   // i.e. 16 MB
+
+//==============================================================================
+
+static bool writeCheckpointValues(QDataStream &pStream, const double *pValues,
+                                  const qulonglong &pCount)
+{
+    // Write the given values to the given stream
+    // Note: we write them in chunks since QDataStream::writeRawData() can only
+    //       write up to 2 GB at once...
+
+    const char *data = reinterpret_cast<const char *>(pValues);
+
+    for (qint64 dataSize = qint64(pCount*Solver::SizeOfDouble); dataSize > 0;) {
+        int chunkSize = int(qMin(dataSize, CheckpointChunkSize));
+
+        if (pStream.writeRawData(data, chunkSize) != chunkSize)
+            return false;
+
+        data += chunkSize;
+        dataSize -= chunkSize;
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+static bool readCheckpointValues(QDataStream &pStream, double *pValues,
+                                 const qulonglong &pCount)
+{
+    // Read the given number of values from the given stream
+    // Note: see writeCheckpointValues() for why we read them in chunks...
+
+    char *data = reinterpret_cast<char *>(pValues);
+
+    for (qint64 dataSize = qint64(pCount*Solver::SizeOfDouble); dataSize > 0;) {
+        int chunkSize = int(qMin(dataSize, CheckpointChunkSize));
+
+        if (pStream.readRawData(data, chunkSize) != chunkSize)
+            return false;
+
+        data += chunkSize;
+        dataSize -= chunkSize;
+    }
+
+    return true;
+}
+
+//==============================================================================
+
 SingleCellViewSimulationData::SingleCellViewSimulationData(SingleCellViewSimulation *pSimulation,
                                                            const SolverInterfaces &pSolverInterfaces) :
     mSimulation(pSimulation),
@@ -44,12 +107,16 @@ SingleCellViewSimulationData::SingleCellViewSimulationData(SingleCellViewSimulat
     mStartingPoint(0.0),
     mEndingPoint(1000.0),
     mPointInterval(1.0),
+    mCheckpointInterval(0),
+    mConvergencePeriod(0.0),
+    mConvergenceTolerance(0.0),
     mOdeSolverName(QString()),
     mOdeSolverProperties(Solver::Solver::Properties()),
     mDaeSolverName(QString()),
     mDaeSolverProperties(Solver::Solver::Properties()),
     mNlaSolverName(QString()),
-    mNlaSolverProperties(Solver::Solver::Properties())
+    mNlaSolverProperties(Solver::Solver::Properties()),
+    mSensitivityParameters(QList<int>())
 {
     // Create our various arrays
 
@@ -69,11 +136,14 @@ SingleCellViewSimulationData::~SingleCellViewSimulationData()
 
 void SingleCellViewSimulationData::update()
 {
-    // Update ourselves by updating our runtime, and deleting and recreating our
-    // arrays
+    // Update ourselves by updating our runtime, forgetting about our
+    // sensitivity parameters (since they may not exist anymore), and deleting
+    // and recreating our arrays
 
     mRuntime = mSimulation->runtime();
 
+    mSensitivityParameters.clear();
+
     deleteArrays();
     createArrays();
 }
@@ -134,6 +204,15 @@ double * SingleCellViewSimulationData::condVar() const
 
 //==============================================================================
 
+double * SingleCellViewSimulationData::sensitivities() const
+{
+    // Return our sensitivities array
+
+    return mSensitivities;
+}
+
+//==============================================================================
+
 int SingleCellViewSimulationData::delay() const
 {
     // Return our delay
@@ -213,6 +292,65 @@ void SingleCellViewSimulationData::setPointInterval(const double &pPointInterval
 
 //==============================================================================
 
+int SingleCellViewSimulationData::checkpointInterval() const
+{
+    // Return our checkpoint interval
+
+    return mCheckpointInterval;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::setCheckpointInterval(const int &pCheckpointInterval)
+{
+    // Set our checkpoint interval
+    // Note: the interval is in seconds of wall-clock time, with zero meaning
+    //       that no checkpoint is to be written...
+
+    mCheckpointInterval = qMax(0, pCheckpointInterval);
+}
+
+//==============================================================================
+
+double SingleCellViewSimulationData::convergencePeriod() const
+{
+    // Return our convergence period
+
+    return mConvergencePeriod;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::setConvergencePeriod(const double &pConvergencePeriod)
+{
+    // Set our convergence period
+    // Note: a period of zero means that we are after a true steady state rather
+    //       than a periodic one...
+
+    mConvergencePeriod = qAbs(pConvergencePeriod);
+}
+
+//==============================================================================
+
+double SingleCellViewSimulationData::convergenceTolerance() const
+{
+    // Return our convergence tolerance
+
+    return mConvergenceTolerance;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::setConvergenceTolerance(const double &pConvergenceTolerance)
+{
+    // Set our convergence tolerance
+    // Note: a tolerance of zero means that we don't check for convergence...
+
+    mConvergenceTolerance = qMax(0.0, pConvergenceTolerance);
+}
+
+//==============================================================================
+
 SolverInterface * SingleCellViewSimulationData::odeSolverInterface() const
 {
     // Return our ODE solver interface, if any
@@ -424,6 +562,50 @@ void SingleCellViewSimulationData::addNlaSolverProperty(const QString &pName,
 
 //==============================================================================
 
+QList<int> SingleCellViewSimulationData::sensitivityParameters() const
+{
+    // Return the indexes of the constants with respect to which we compute the
+    // sensitivities of our states
+
+    return mSensitivityParameters;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::setSensitivityParameters(const QList<int> &pSensitivityParameters)
+{
+    if (!mRuntime)
+        return;
+
+    // Keep track of the indexes of the constants with respect to which we want
+    // to compute the sensitivities of our states, and recreate our
+    // sensitivities array accordingly
+
+    mSensitivityParameters = pSensitivityParameters;
+
+    delete[] mSensitivities;
+
+    mSensitivities = new double[mRuntime->statesCount()*mSensitivityParameters.count()];
+
+    resetSensitivities();
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::resetSensitivities()
+{
+    if (!mRuntime)
+        return;
+
+    // Reset our sensitivities
+    // Note: this assumes that the initial value of our states doesn't depend on
+    //       our sensitivity parameters, which is the case for most models...
+
+    memset(mSensitivities, 0, mRuntime->statesCount()*mSensitivityParameters.count()*Solver::SizeOfDouble);
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationData::reset(const bool &pInitialize)
 {
     if (!mRuntime)
@@ -466,6 +648,8 @@ void SingleCellViewSimulationData::reset(const bool &pInitialize)
         memset(mAlgebraic, 0, mRuntime->algebraicCount()*Solver::SizeOfDouble);
         memset(mCondVar, 0, mRuntime->condVarCount()*Solver::SizeOfDouble);
 
+        resetSensitivities();
+
         mRuntime->initializeConstants()(mConstants, mRates, mStates);
     }
 
@@ -574,6 +758,89 @@ void SingleCellViewSimulationData::checkForModifications()
 
 //==============================================================================
 
+void SingleCellViewSimulationData::saveCheckpoint(QDataStream &pStream) const
+{
+    // Save the current values of our model to the given stream
+
+    pStream.writeRawData(reinterpret_cast<const char *>(mConstants), mRuntime->constantsCount()*Solver::SizeOfDouble);
+    pStream.writeRawData(reinterpret_cast<const char *>(mRates), mRuntime->ratesCount()*Solver::SizeOfDouble);
+    pStream.writeRawData(reinterpret_cast<const char *>(mStates), mRuntime->statesCount()*Solver::SizeOfDouble);
+    pStream.writeRawData(reinterpret_cast<const char *>(mAlgebraic), mRuntime->algebraicCount()*Solver::SizeOfDouble);
+    pStream.writeRawData(reinterpret_cast<const char *>(mCondVar), mRuntime->condVarCount()*Solver::SizeOfDouble);
+    pStream.writeRawData(reinterpret_cast<const char *>(mSensitivities), mRuntime->statesCount()*mSensitivityParameters.count()*Solver::SizeOfDouble);
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationData::loadCheckpoint(QDataStream &pStream,
+                                                  QByteArray &pValues) const
+{
+    // Load the values of our model from the given stream, but without using
+    // them yet (see useCheckpoint())
+    // Note: this is so that our model doesn't get clobbered should the rest of
+    //       the checkpoint fail to load...
+
+    int valuesSize = (  mRuntime->constantsCount()+mRuntime->ratesCount()
+                      +mRuntime->statesCount()+mRuntime->algebraicCount()
+                      +mRuntime->condVarCount()
+                      +mRuntime->statesCount()*mSensitivityParameters.count())*Solver::SizeOfDouble;
+
+    pValues.resize(valuesSize);
+
+    return pStream.readRawData(pValues.data(), valuesSize) == valuesSize;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationData::checkpointConstantsModified(const QByteArray &pValues) const
+{
+    // Return whether our constants differ from the ones in the values of our
+    // model that were loaded by loadCheckpoint(), i.e. whether they were
+    // modified after the checkpoint was saved
+
+    return memcmp(pValues.constData(), mConstants,
+                  size_t(mRuntime->constantsCount()*Solver::SizeOfDouble)) != 0;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulationData::useCheckpoint(const QByteArray &pValues)
+{
+    // Use the values of our model that were loaded by loadCheckpoint()
+
+    int constantsSize = mRuntime->constantsCount()*Solver::SizeOfDouble;
+    int ratesSize = mRuntime->ratesCount()*Solver::SizeOfDouble;
+    int statesSize = mRuntime->statesCount()*Solver::SizeOfDouble;
+    int algebraicSize = mRuntime->algebraicCount()*Solver::SizeOfDouble;
+    int condVarSize = mRuntime->condVarCount()*Solver::SizeOfDouble;
+    int sensitivitiesSize = mRuntime->statesCount()*mSensitivityParameters.count()*Solver::SizeOfDouble;
+    const char *values = pValues.constData();
+
+    memcpy(mConstants, values, size_t(constantsSize));
+
+    values += constantsSize;
+
+    memcpy(mRates, values, size_t(ratesSize));
+
+    values += ratesSize;
+
+    memcpy(mStates, values, size_t(statesSize));
+
+    values += statesSize;
+
+    memcpy(mAlgebraic, values, size_t(algebraicSize));
+
+    values += algebraicSize;
+
+    memcpy(mCondVar, values, size_t(condVarSize));
+
+    values += condVarSize;
+
+    memcpy(mSensitivities, values, size_t(sensitivitiesSize));
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationData::createArrays()
 {
     // Create our various arrays, if possible
@@ -588,12 +855,18 @@ void SingleCellViewSimulationData::createArrays()
         mAlgebraic   = new double[mRuntime->algebraicCount()];
         mCondVar     = new double[mRuntime->condVarCount()];
 
+        // Create our array to keep track of the sensitivities of our states
+
+        mSensitivities = new double[mRuntime->statesCount()*mSensitivityParameters.count()];
+
+        resetSensitivities();
+
         // Create our various arrays to keep track of our various initial values
 
         mInitialConstants = new double[mRuntime->constantsCount()];
         mInitialStates    = new double[mRuntime->statesCount()];
     } else {
-        mConstants = mRates = mStates = mDummyStates = mAlgebraic = mCondVar = 0;
+        mConstants = mRates = mStates = mDummyStates = mAlgebraic = mCondVar = mSensitivities = 0;
         mInitialConstants = mInitialStates = 0;
     }
 }
@@ -610,6 +883,7 @@ void SingleCellViewSimulationData::deleteArrays()
     delete[] mDummyStates;
     delete[] mAlgebraic;
     delete[] mCondVar;
+    delete[] mSensitivities;
 
     delete[] mInitialConstants;
     delete[] mInitialStates;
@@ -626,7 +900,8 @@ SingleCellViewSimulationResults::SingleCellViewSimulationResults(SingleCellViewS
     mConstants(DataStore::DataStoreVariables()),
     mRates(DataStore::DataStoreVariables()),
     mStates(DataStore::DataStoreVariables()),
-    mAlgebraic(DataStore::DataStoreVariables())
+    mAlgebraic(DataStore::DataStoreVariables()),
+    mSensitivities(DataStore::DataStoreVariables())
 {
 }
 
@@ -677,7 +952,7 @@ bool SingleCellViewSimulationResults::createDataStore()
         return true;
 
     // Create our data store and populate it with a variable of integration, as
-    // well as with constant, rate, state and algebraic variables
+    // well as with constant, rate, state, algebraic and sensitivity variables
 
     try {
         mDataStore = new DataStore::DataStore(mRuntime->cellmlFile()->xmlBase(),
@@ -688,6 +963,7 @@ bool SingleCellViewSimulationResults::createDataStore()
         mRates = mDataStore->addVariables(mRuntime->ratesCount(), mSimulation->data()->rates());
         mStates = mDataStore->addVariables(mRuntime->statesCount(), mSimulation->data()->states());
         mAlgebraic = mDataStore->addVariables(mRuntime->algebraicCount(), mSimulation->data()->algebraic());
+        mSensitivities = mDataStore->addVariables(mRuntime->statesCount()*mSimulation->data()->sensitivityParameters().count(), mSimulation->data()->sensitivities());
     } catch (...) {
         deleteDataStore();
 
@@ -695,13 +971,16 @@ bool SingleCellViewSimulationResults::createDataStore()
     }
 
     // Customise our variable of integration, as well as our constant, rate,
-    // state and algebraic variables
+    // state, algebraic and sensitivity variables
 
     mPoints->setUri(uri(mRuntime->variableOfIntegration()->componentHierarchy(),
                         mRuntime->variableOfIntegration()->name()));
     mPoints->setLabel(mRuntime->variableOfIntegration()->name());
     mPoints->setUnit(mRuntime->variableOfIntegration()->unit());
 
+    QMap<int, CellMLSupport::CellmlFileRuntimeParameter *> constants = QMap<int, CellMLSupport::CellmlFileRuntimeParameter *>();
+    QMap<int, CellMLSupport::CellmlFileRuntimeParameter *> states = QMap<int, CellMLSupport::CellmlFileRuntimeParameter *>();
+
     for (int i = 0, iMax = mRuntime->parameters().count(); i < iMax; ++i) {
         CellMLSupport::CellmlFileRuntimeParameter *parameter = mRuntime->parameters()[i];
         DataStore::DataStoreVariable *variable = 0;
@@ -711,6 +990,8 @@ bool SingleCellViewSimulationResults::createDataStore()
         case CellMLSupport::CellmlFileRuntimeParameter::ComputedConstant:
             variable = mConstants[parameter->index()];
 
+            constants.insert(parameter->index(), parameter);
+
             break;
         case CellMLSupport::CellmlFileRuntimeParameter::Rate:
             variable = mRates[parameter->index()];
@@ -719,6 +1000,8 @@ bool SingleCellViewSimulationResults::createDataStore()
         case CellMLSupport::CellmlFileRuntimeParameter::State:
             variable = mStates[parameter->index()];
 
+            states.insert(parameter->index(), parameter);
+
             break;
         case CellMLSupport::CellmlFileRuntimeParameter::Algebraic:
             variable = mAlgebraic[parameter->index()];
@@ -738,6 +1021,35 @@ bool SingleCellViewSimulationResults::createDataStore()
         }
     }
 
+    // Customise our sensitivity variables, i.e. the sensitivities of our states
+    // with respect to each of our sensitivity parameters
+    // Note: a sensitivity variable is labelled d(state)/d(constant) and it
+    //       lives in the same component as its state...
+
+    QList<int> sensitivityParameters = mSimulation->data()->sensitivityParameters();
+
+    for (int i = 0, iMax = sensitivityParameters.count(); i < iMax; ++i) {
+        CellMLSupport::CellmlFileRuntimeParameter *constant = constants.value(sensitivityParameters[i]);
+
+        if (!constant)
+            continue;
+
+        for (int j = 0, jMax = mRuntime->statesCount(); j < jMax; ++j) {
+            CellMLSupport::CellmlFileRuntimeParameter *state = states.value(j);
+
+            if (!state)
+                continue;
+
+            DataStore::DataStoreVariable *variable = mSensitivities[i*jMax+j];
+
+            variable->setUri(uri(state->componentHierarchy(),
+                                 QString("d(%1)_d(%2)").arg(state->formattedName(),
+                                                            constant->fullyFormattedName())));
+            variable->setLabel(QString("d(%1)/d(%2)").arg(state->formattedName(),
+                                                          constant->formattedName()));
+        }
+    }
+
     return true;
 }
 
@@ -861,13 +1173,97 @@ double * SingleCellViewSimulationResults::algebraic(const int &pIndex) const
 
 //==============================================================================
 
+double * SingleCellViewSimulationResults::sensitivities(const int &pIndex) const
+{
+    // Return our sensitivities data at the given index
+
+    return mSensitivities.isEmpty()?0:mSensitivities[pIndex]->values();
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationResults::saveCheckpoint(QDataStream &pStream,
+                                                     const qulonglong &pFrom,
+                                                     const qulonglong &pTo) const
+{
+    // Save the values of our variable of integration and of all our other
+    // variables from pFrom to pTo (excluded) to the given stream, as a block
+    // that can be appended to the ones of our previous checkpoints
+    // Note: we are given an end rather than use mSize since our size may have
+    //       changed since our caller last checked it...
+
+    if (pTo <= pFrom)
+        return true;
+
+    qulonglong count = pTo-pFrom;
+
+    pStream << quint64(count);
+
+    if (!writeCheckpointValues(pStream, mPoints->values()+pFrom, count))
+        return false;
+
+    foreach (DataStore::DataStoreVariable *variable, mConstants+mRates+mStates+mAlgebraic+mSensitivities) {
+        if (!writeCheckpointValues(pStream, variable->values()+pFrom, count))
+            return false;
+    }
+
+    return pStream.status() == QDataStream::Ok;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulationResults::loadCheckpoint(QDataStream &pStream,
+                                                     const qulonglong &pSize)
+{
+    // Load the first pSize values of our variable of integration and of all our
+    // other variables from the blocks in the given stream, making sure that
+    // they fit in our data store
+
+    if (!mDataStore || (pSize > mDataStore->size()))
+        return false;
+
+    for (qulonglong from = 0; from < pSize;) {
+        quint64 count;
+
+        pStream >> count;
+
+        if ((pStream.status() != QDataStream::Ok) || !count || (count > pSize-from))
+            return false;
+
+        if (!readCheckpointValues(pStream, mPoints->values()+from, count))
+            return false;
+
+        foreach (DataStore::DataStoreVariable *variable, mConstants+mRates+mStates+mAlgebraic+mSensitivities) {
+            if (!readCheckpointValues(pStream, variable->values()+from, count))
+                return false;
+        }
+
+        from += count;
+    }
+
+    // Everything went fine, so update our size
+
+    mSize = pSize;
+
+    return true;
+}
+
+//==============================================================================
+
 SingleCellViewSimulation::SingleCellViewSimulation(CellMLSupport::CellmlFileRuntime *pRuntime,
                                                    const SolverInterfaces &pSolverInterfaces) :
     mWorker(0),
     mRuntime(pRuntime),
     mSolverInterfaces(pSolverInterfaces),
     mData(new SingleCellViewSimulationData(this, pSolverInterfaces)),
-    mResults(new SingleCellViewSimulationResults(this))
+    mResults(new SingleCellViewSimulationResults(this)),
+    mVoiSolverStatistics(Solver::Statistics()),
+    mNlaSolverStatistics(Solver::Statistics()),
+    mConverged(false),
+    mConvergencePoint(0.0),
+    mConvergencePeriods(0),
+    mCheckpointResultsSize(0),
+    mCheckpointResultsFileSize(0)
 {
     // Keep track of any error occurring in our data
 
@@ -995,7 +1391,8 @@ double SingleCellViewSimulation::requiredMemory()
                  +mRuntime->constantsCount()
                  +mRuntime->ratesCount()
                  +mRuntime->statesCount()
-                 +mRuntime->algebraicCount())
+                 +mRuntime->algebraicCount()
+                 +mRuntime->statesCount()*mData->sensitivityParameters().count())
                *Solver::SizeOfDouble;
     } else {
         return 0.0;
@@ -1029,6 +1426,11 @@ bool SingleCellViewSimulation::simulationSettingsOk(const bool &pEmitSignal)
         if (pEmitSignal)
             emit error(tr("the ending point is smaller than the starting point, so the point interval should be smaller than zero"));
 
+        return false;
+    } else if (!convergencePeriodOk()) {
+        if (pEmitSignal)
+            emit error(tr("the convergence period should be a multiple of the point interval"));
+
         return false;
     } else {
         return true;
@@ -1037,6 +1439,25 @@ bool SingleCellViewSimulation::simulationSettingsOk(const bool &pEmitSignal)
 
 //==============================================================================
 
+bool SingleCellViewSimulation::convergencePeriodOk() const
+{
+    // Check whether our convergence period, if any, is a multiple of our point
+    // interval, since we can only check for a periodic steady state at points
+    // that we compute
+    // Note: we allow for some round-off error, e.g. a period of 0.3 with a
+    //       point interval of 0.1...
+
+    if (!mData->convergenceTolerance() || !mData->convergencePeriod())
+        return true;
+
+    double nbOfPoints = mData->convergencePeriod()/qAbs(mData->pointInterval());
+
+    return    (nbOfPoints >= 0.5)
+           && (qAbs(nbOfPoints-qRound64(nbOfPoints)) <= 1.0e-9*nbOfPoints);
+}
+
+//==============================================================================
+
 double SingleCellViewSimulation::size()
 {
     // Return the size of our simulation (i.e. the number of data points that
@@ -1053,6 +1474,24 @@ double SingleCellViewSimulation::size()
 //==============================================================================
 
 bool SingleCellViewSimulation::run()
+{
+    // Run our simulation from scratch
+
+    return start(false);
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::restart()
+{
+    // Run our simulation from its last checkpoint
+
+    return start(true);
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::start(const bool &pRestart)
 {
     if (!mRuntime)
         return false;
@@ -1067,6 +1506,22 @@ bool SingleCellViewSimulation::run()
         if (!simulationSettingsOk())
             return false;
 
+        // Load our last checkpoint, if we are to restart our simulation, or
+        // remove it since it is now obsolete
+
+        quint64 pointCounter = 0;
+        double currentPoint = mData->startingPoint();
+
+        if (pRestart) {
+            if (!loadCheckpoint(pointCounter, currentPoint)) {
+                emit error(tr("the simulation checkpoint could not be loaded"));
+
+                return false;
+            }
+        } else {
+            removeCheckpoint();
+        }
+
         // Create our worker
 
         mWorker = new SingleCellViewSimulationWorker(this, mWorker);
@@ -1077,6 +1532,9 @@ bool SingleCellViewSimulation::run()
             return false;
         }
 
+        if (pRestart)
+            mWorker->setRestartPoint(pointCounter, currentPoint);
+
         // Create a few connections
 
         connect(mWorker, SIGNAL(running(const bool &)),
@@ -1138,6 +1596,321 @@ bool SingleCellViewSimulation::reset()
 
 //==============================================================================
 
+QString SingleCellViewSimulation::checkpointFileName(const QString &pExtension) const
+{
+    // Return the name of the file where (part of) our checkpoint is to be kept
+    // Note: we use the SHA-1 value of our CellML file name so that a checkpoint
+    //       only ever gets used for the model it was written for...
+
+    return  QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           +QDir::separator()+"Checkpoints"+QDir::separator()
+           +Core::sha1(mRuntime->cellmlFile()->fileName().toUtf8())+"."+pExtension;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::readCheckpointHeader(QDataStream &pStream,
+                                                    quint64 &pPointCounter,
+                                                    double &pCurrentPoint,
+                                                    quint64 &pResultsSize,
+                                                    qint64 &pResultsFileSize) const
+{
+    // Read the header of a checkpoint and make sure that it is compatible with
+    // our current model and simulation settings
+
+    quint32 magicNumber;
+    quint32 version;
+
+    pStream >> magicNumber >> version;
+
+    if ((magicNumber != CheckpointMagicNumber) || (version != CheckpointVersion))
+        return false;
+
+    qint32 constantsCount;
+    qint32 ratesCount;
+    qint32 statesCount;
+    qint32 algebraicCount;
+    qint32 condVarCount;
+    double startingPoint;
+    double endingPoint;
+    double pointInterval;
+    QString voiSolverName;
+    QString nlaSolverName;
+    QList<int> sensitivityParameters;
+
+    pStream >> constantsCount >> ratesCount >> statesCount >> algebraicCount
+            >> condVarCount >> startingPoint >> endingPoint >> pointInterval
+            >> voiSolverName >> nlaSolverName >> sensitivityParameters
+            >> pPointCounter >> pCurrentPoint >> pResultsSize >> pResultsFileSize;
+
+    return    (pStream.status() == QDataStream::Ok)
+           && (constantsCount == mRuntime->constantsCount())
+           && (ratesCount == mRuntime->ratesCount())
+           && (statesCount == mRuntime->statesCount())
+           && (algebraicCount == mRuntime->algebraicCount())
+           && (condVarCount == mRuntime->condVarCount())
+           && (startingPoint == mData->startingPoint())
+           && (endingPoint == mData->endingPoint())
+           && (pointInterval == mData->pointInterval())
+           && !voiSolverName.compare(mRuntime->needOdeSolver()?mData->odeSolverName():mData->daeSolverName())
+           && !nlaSolverName.compare(mRuntime->needNlaSolver()?mData->nlaSolverName():QString())
+           && (sensitivityParameters == mData->sensitivityParameters());
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::saveCheckpoint(const quint64 &pPointCounter,
+                                              const double &pCurrentPoint) const
+{
+    // Save a checkpoint of our simulation, i.e. our simulation settings, the
+    // current values of our model and the results we have got so far
+    // Note #1: this method is called from our worker's thread while it is not
+    //          computing our model, so our data and results are not going to
+    //          change while we are saving them...
+    // Note #2: our results are kept in a separate file to which we only append
+    //          the results we have got since our last checkpoint, so that the
+    //          cost of a checkpoint doesn't grow with the size of our
+    //          results. Anything that may have been appended after our last
+    //          checkpoint (e.g. if we crashed while saving the current one) is
+    //          discarded first...
+    // Note #3: we use a QSaveFile object for the rest of our checkpoint, which
+    //          also keeps track of how much of our results file is valid, so
+    //          that a crash while we are saving our checkpoint doesn't leave
+    //          us with a corrupted one...
+
+    QString fileName = checkpointFileName();
+
+    if (!QDir().mkpath(QFileInfo(fileName).absolutePath()))
+        return false;
+
+    QFile resultsFile(checkpointFileName(CheckpointResultsExtension));
+
+    if (   !resultsFile.open(QIODevice::ReadWrite)
+        || !resultsFile.resize(mCheckpointResultsFileSize)
+        || !resultsFile.seek(mCheckpointResultsFileSize)) {
+        return false;
+    }
+
+    QDataStream resultsStream(&resultsFile);
+    quint64 resultsSize = mResults->size();
+
+    if (   !mResults->saveCheckpoint(resultsStream, mCheckpointResultsSize, resultsSize)
+        || !resultsFile.flush()) {
+        return false;
+    }
+
+    qint64 resultsFileSize = resultsFile.pos();
+
+    resultsFile.close();
+
+    QSaveFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    stream << CheckpointMagicNumber << CheckpointVersion
+           << qint32(mRuntime->constantsCount()) << qint32(mRuntime->ratesCount())
+           << qint32(mRuntime->statesCount()) << qint32(mRuntime->algebraicCount())
+           << qint32(mRuntime->condVarCount())
+           << mData->startingPoint() << mData->endingPoint() << mData->pointInterval()
+           << (mRuntime->needOdeSolver()?mData->odeSolverName():mData->daeSolverName())
+           << (mRuntime->needNlaSolver()?mData->nlaSolverName():QString())
+           << mData->sensitivityParameters()
+           << pPointCounter << pCurrentPoint << resultsSize << resultsFileSize;
+
+    mData->saveCheckpoint(stream);
+
+    if ((stream.status() != QDataStream::Ok) || !file.commit())
+        return false;
+
+    // Our checkpoint has been saved, so keep track of how much of our results
+    // it covers
+
+    mCheckpointResultsSize = resultsSize;
+    mCheckpointResultsFileSize = resultsFileSize;
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::loadCheckpoint(quint64 &pPointCounter,
+                                              double &pCurrentPoint)
+{
+    // Load our checkpoint, if any and if compatible with our current model and
+    // simulation settings
+
+    QFile file(checkpointFileName());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint64 resultsSize;
+    qint64 resultsFileSize;
+    QByteArray values;
+
+    if (   !readCheckpointHeader(stream, pPointCounter, pCurrentPoint,
+                                 resultsSize, resultsFileSize)
+        || !mData->loadCheckpoint(stream, values)) {
+        return false;
+    }
+
+    // Load our results, making sure that we read exactly the part of our
+    // results file that is covered by our checkpoint
+
+    QFile resultsFile(checkpointFileName(CheckpointResultsExtension));
+
+    if (!resultsFile.open(QIODevice::ReadOnly) || (resultsFile.size() < resultsFileSize))
+        return false;
+
+    QDataStream resultsStream(&resultsFile);
+
+    if (   !mResults->loadCheckpoint(resultsStream, resultsSize)
+        || (resultsFile.pos() != resultsFileSize)) {
+        return false;
+    }
+
+    // Everything could be loaded, so we can now use the values of our model
+    // and carry on appending to our results file from where we are
+
+    mData->useCheckpoint(values);
+
+    mCheckpointResultsSize = resultsSize;
+    mCheckpointResultsFileSize = resultsFileSize;
+
+    return true;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::hasCheckpoint(double &pCheckpointPoint,
+                                             bool &pConstantsModified) const
+{
+    // Return whether we have a checkpoint that is compatible with our current
+    // model and simulation settings, and if so the point at which it was saved
+    // and whether our constants were modified since, in which case resuming
+    // our simulation would restore the value they had at that point
+
+    if (!mRuntime)
+        return false;
+
+    QFile file(checkpointFileName());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint64 pointCounter;
+    quint64 resultsSize;
+    qint64 resultsFileSize;
+    QByteArray values;
+
+    if (   !readCheckpointHeader(stream, pointCounter, pCheckpointPoint,
+                                 resultsSize, resultsFileSize)
+        || !mData->loadCheckpoint(stream, values)) {
+        return false;
+    }
+
+    pConstantsModified = mData->checkpointConstantsModified(values);
+
+    return true;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulation::removeCheckpoint() const
+{
+    // Remove our checkpoint, if any, and reset what our results file covers
+
+    if (mRuntime) {
+        QFile::remove(checkpointFileName());
+        QFile::remove(checkpointFileName(CheckpointResultsExtension));
+    }
+
+    mCheckpointResultsSize = 0;
+    mCheckpointResultsFileSize = 0;
+}
+
+//==============================================================================
+
+Solver::Statistics SingleCellViewSimulation::voiSolverStatistics() const
+{
+    // Return the statistics of the ODE/DAE solver used by our last run
+
+    return mVoiSolverStatistics;
+}
+
+//==============================================================================
+
+Solver::Statistics SingleCellViewSimulation::nlaSolverStatistics() const
+{
+    // Return the statistics of the NLA solver, if any, used by our last run
+
+    return mNlaSolverStatistics;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulation::setSolversStatistics(const Solver::Statistics &pVoiSolverStatistics,
+                                                    const Solver::Statistics &pNlaSolverStatistics)
+{
+    // Keep track of the statistics of the solvers used by our last run
+    // Note: this method is called by our worker, just before it lets people
+    //       know that it is done...
+
+    mVoiSolverStatistics = pVoiSolverStatistics;
+    mNlaSolverStatistics = pNlaSolverStatistics;
+}
+
+//==============================================================================
+
+bool SingleCellViewSimulation::hasConverged() const
+{
+    // Return whether our last run stopped early because it had converged
+
+    return mConverged;
+}
+
+//==============================================================================
+
+double SingleCellViewSimulation::convergencePoint() const
+{
+    // Return the point at which our last run converged, if it did
+
+    return mConvergencePoint;
+}
+
+//==============================================================================
+
+int SingleCellViewSimulation::convergencePeriods() const
+{
+    // Return the number of periods that our last run needed to converge, if it
+    // did and if we were after a periodic steady state
+
+    return mConvergencePeriods;
+}
+
+//==============================================================================
+
+void SingleCellViewSimulation::setConvergence(const bool &pConverged,
+                                              const double &pConvergencePoint,
+                                              const int &pConvergencePeriods)
+{
+    // Keep track of whether our last run converged and, if so, where and after
+    // how many periods
+    // Note: this method is called by our worker, just before it lets people
+    //       know that it is done...
+
+    mConverged = pConverged;
+    mConvergencePoint = pConvergencePoint;
+    mConvergencePeriods = pConvergencePeriods;
+}
+
+//==============================================================================
+
 }   // namespace SingleCellView
 }   // namespace OpenCOR
 
@@ -30,6 +30,7 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDataStream>
 #include <QObject>
 
 //==============================================================================
@@ -70,6 +71,7 @@ public:
     double * states() const;
     double * algebraic() const;
     double * condVar() const;
+    double * sensitivities() const;
 
     int delay() const;
     void setDelay(const int &pDelay);
@@ -84,6 +86,15 @@ public:
     double pointInterval() const;
     void setPointInterval(const double &pPointInterval);
 
+    int checkpointInterval() const;
+    void setCheckpointInterval(const int &pCheckpointInterval);
+
+    double convergencePeriod() const;
+    void setConvergencePeriod(const double &pConvergencePeriod);
+
+    double convergenceTolerance() const;
+    void setConvergenceTolerance(const double &pConvergenceTolerance);
+
     SolverInterface * odeSolverInterface() const;
 
     QString odeSolverName() const;
@@ -110,6 +121,10 @@ public:
     void addNlaSolverProperty(const QString &pName, const QVariant &pValue,
                               const bool &pReset = true);
 
+    QList<int> sensitivityParameters() const;
+    void setSensitivityParameters(const QList<int> &pSensitivityParameters);
+    void resetSensitivities();
+
     void reset(const bool &pInitialize = true);
 
     void recomputeComputedConstantsAndVariables(const double &pCurrentPoint,
@@ -119,6 +134,11 @@ public:
     bool isModified() const;
     void checkForModifications();
 
+    void saveCheckpoint(QDataStream &pStream) const;
+    bool loadCheckpoint(QDataStream &pStream, QByteArray &pValues) const;
+    bool checkpointConstantsModified(const QByteArray &pValues) const;
+    void useCheckpoint(const QByteArray &pValues);
+
 private:
     SingleCellViewSimulation *mSimulation;
 
@@ -132,6 +152,11 @@ private:
     double mEndingPoint;
     double mPointInterval;
 
+    int mCheckpointInterval;
+
+    double mConvergencePeriod;
+    double mConvergenceTolerance;
+
     QString mOdeSolverName;
     Solver::Solver::Properties mOdeSolverProperties;
 
@@ -141,12 +166,15 @@ private:
     QString mNlaSolverName;
     Solver::Solver::Properties mNlaSolverProperties;
 
+    QList<int> mSensitivityParameters;
+
     double *mConstants;
     double *mRates;
     double *mStates;
     double *mDummyStates;
     double *mAlgebraic;
     double *mCondVar;
+    double *mSensitivities;
 
     double *mInitialConstants;
     double *mInitialStates;
@@ -187,6 +215,11 @@ public:
     double * rates(const int &pIndex) const;
     double * states(const int &pIndex) const;
     double * algebraic(const int &pIndex) const;
+    double * sensitivities(const int &pIndex) const;
+
+    bool saveCheckpoint(QDataStream &pStream, const qulonglong &pFrom,
+                        const qulonglong &pTo) const;
+    bool loadCheckpoint(QDataStream &pStream, const qulonglong &pSize);
 
 private:
     SingleCellViewSimulation *mSimulation;
@@ -203,6 +236,7 @@ private:
     DataStore::DataStoreVariables mRates;
     DataStore::DataStoreVariables mStates;
     DataStore::DataStoreVariables mAlgebraic;
+    DataStore::DataStoreVariables mSensitivities;
 
     bool createDataStore();
     void deleteDataStore();
@@ -243,12 +277,24 @@ public:
     double size();
 
     bool run();
+    bool restart();
     bool pause();
     bool resume();
     bool stop();
 
     bool reset();
 
+    bool hasCheckpoint(double &pCheckpointPoint,
+                       bool &pConstantsModified) const;
+    void removeCheckpoint() const;
+
+    Solver::Statistics voiSolverStatistics() const;
+    Solver::Statistics nlaSolverStatistics() const;
+
+    bool hasConverged() const;
+    double convergencePoint() const;
+    int convergencePeriods() const;
+
 private:
     SingleCellViewSimulationWorker *mWorker;
 
@@ -259,7 +305,35 @@ private:
     SingleCellViewSimulationData *mData;
     SingleCellViewSimulationResults *mResults;
 
+    Solver::Statistics mVoiSolverStatistics;
+    Solver::Statistics mNlaSolverStatistics;
+
+    bool mConverged;
+    double mConvergencePoint;
+    int mConvergencePeriods;
+
+    mutable quint64 mCheckpointResultsSize;
+    mutable qint64 mCheckpointResultsFileSize;
+
     bool simulationSettingsOk(const bool &pEmitSignal = true);
+    bool convergencePeriodOk() const;
+
+    bool start(const bool &pRestart);
+
+    QString checkpointFileName(const QString &pExtension = "dat") const;
+
+    bool readCheckpointHeader(QDataStream &pStream, quint64 &pPointCounter,
+                              double &pCurrentPoint, quint64 &pResultsSize,
+                              qint64 &pResultsFileSize) const;
+    bool saveCheckpoint(const quint64 &pPointCounter,
+                        const double &pCurrentPoint) const;
+    bool loadCheckpoint(quint64 &pPointCounter, double &pCurrentPoint);
+
+    void setSolversStatistics(const Solver::Statistics &pVoiSolverStatistics,
+                              const Solver::Statistics &pNlaSolverStatistics);
+    void setConvergence(const bool &pConverged,
+                        const double &pConvergencePoint = 0.0,
+                        const int &pConvergencePeriods = 0);
 
 Q_SIGNALS:
     void running(const bool &pIsResuming);
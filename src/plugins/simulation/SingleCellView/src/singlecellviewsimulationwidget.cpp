@@ -1080,8 +1080,17 @@ bool SingleCellViewSimulationWidget::save(const QString &pFileName)
                 ObjRef<iface::cellml_api::CellMLVariable> variable = variables->getVariable(property->name().toStdWString());
                 ObjRef<iface::cellml_api::CellMLVariable> sourceVariable = variable->sourceVariable();
 
+                // Note: we retrieve the value of our parameter from our
+                //       simulation data since our property may not be up to
+                //       date, should it not have been visible recently (see
+                //       SingleCellViewInformationParametersWidget::updateVisibleParameters())...
+
+                double value = (parameter->type() == CellMLSupport::CellmlFileRuntimeParameter::State)?
+                                   mSimulation->data()->states()[parameter->index()]:
+                                   mSimulation->data()->constants()[parameter->index()];
+
                 if (variable == sourceVariable)
-                    variable->initialValue(property->value().toStdWString());
+                    variable->initialValue(QString::number(value, 'g', 15).toStdWString());
                 else
                     importedParameters += "\n - "+QString::fromStdWString(component->name())+" | "+QString::fromStdWString(variable->name());
             }
@@ -1284,6 +1293,23 @@ void SingleCellViewSimulationWidget::runPauseResumeSimulation()
         if (mSimulation->isPaused()) {
             mSimulation->resume();
         } else {
+            // Check whether our simulation was interrupted and, if so, whether
+            // it should be resumed from its last checkpoint
+
+            // Note: resuming our simulation restores the value of our
+            //       constants at the time of the checkpoint, so we warn the
+            //       user if some of them have been modified since...
+
+            double checkpointPoint;
+            bool constantsModified;
+            bool restartSimulation =    mSimulation->hasCheckpoint(checkpointPoint, constantsModified)
+                                     && (QMessageBox::question(Core::mainWindow(), tr("Run Simulation"),
+                                                               constantsModified?
+                                                                   tr("The simulation was interrupted at %1, but some of its parameters have been modified since. Do you want to resume it from there, using the value of its parameters at that time?").arg(QLocale().toString(checkpointPoint)):
+                                                                   tr("The simulation was interrupted at %1. Do you want to resume it from there?").arg(QLocale().toString(checkpointPoint)),
+                                                               QMessageBox::Yes|QMessageBox::No,
+                                                               QMessageBox::Yes) == QMessageBox::Yes);
+
             // Check that we have enough memory to run our simulation
 
             bool runSimulation = true;
@@ -1308,7 +1334,10 @@ void SingleCellViewSimulationWidget::runPauseResumeSimulation()
                 // allocate all the memory we need to run the simulation
 
                 if (runSimulation) {
-                    mSimulation->run();
+                    if (restartSimulation)
+                        mSimulation->restart();
+                    else
+                        mSimulation->run();
                 } else {
                     QMessageBox::warning(Core::mainWindow(), tr("Run Simulation"),
                                          tr("We could not allocate the %1 of memory required for the simulation.").arg(Core::sizeAsString(requiredMemory)));
@@ -1928,6 +1957,27 @@ void SingleCellViewSimulationWidget::updateSimulationProperties(Core::Property *
         if (pProperty)
             return;
     }
+
+    if (!pProperty || (pProperty == simulationWidget->checkpointIntervalProperty())) {
+        mSimulation->data()->setCheckpointInterval(simulationWidget->checkpointIntervalProperty()->integerValue());
+
+        if (pProperty)
+            return;
+    }
+
+    if (!pProperty || (pProperty == simulationWidget->convergencePeriodProperty())) {
+        mSimulation->data()->setConvergencePeriod(simulationWidget->convergencePeriodProperty()->doubleValue());
+
+        if (pProperty)
+            return;
+    }
+
+    if (!pProperty || (pProperty == simulationWidget->convergenceToleranceProperty())) {
+        mSimulation->data()->setConvergenceTolerance(simulationWidget->convergenceToleranceProperty()->doubleValue());
+
+        if (pProperty)
+            return;
+    }
 }
 
 //==============================================================================
@@ -2474,7 +2524,7 @@ void SingleCellViewSimulationWidget::simulationPaused()
 
     updateSimulationMode();
 
-    mContentsWidget->informationWidget()->parametersWidget()->updateParameters(mSimulation->currentPoint(), true);
+    mContentsWidget->informationWidget()->parametersWidget()->updateParameters(mSimulation->currentPoint());
 
     mPlugin->viewWidget()->checkSimulationResults(mFileName);
 }
@@ -2497,13 +2547,35 @@ void SingleCellViewSimulationWidget::simulationStopped(const qint64 &pElapsedTim
             solversInformation += "+"+mSimulation->data()->nlaSolverName();
 
         output(QString(OutputTab+"<strong>"+tr("Simulation time:")+"</strong> <span"+OutputInfo+">"+tr("%1 s using %2").arg(QString::number(0.001*pElapsedTime, 'g', 3), solversInformation)+"</span>."+OutputBrLn));
+
+        // Output the statistics of our solvers, if any
+
+        QString voiSolverStatistics = statisticsAsString(mSimulation->voiSolverStatistics());
+        QString nlaSolverStatistics = statisticsAsString(mSimulation->nlaSolverStatistics());
+
+        if (!voiSolverStatistics.isEmpty())
+            output(QString(OutputTab+"<strong>"+tr("Solver statistics:")+"</strong> <span"+OutputInfo+">"+voiSolverStatistics+"</span>."+OutputBrLn));
+
+        if (!nlaSolverStatistics.isEmpty())
+            output(QString(OutputTab+"<strong>"+tr("NLA solver statistics:")+"</strong> <span"+OutputInfo+">"+nlaSolverStatistics+"</span>."+OutputBrLn));
+
+        // Output where our simulation converged, if it did
+
+        if (mSimulation->hasConverged()) {
+            QString convergencePoint = QString::number(mSimulation->convergencePoint())+" "+mSimulation->runtime()->variableOfIntegration()->unit();
+
+            if (mSimulation->convergencePeriods())
+                output(QString(OutputTab+"<strong>"+tr("Convergence:")+"</strong> <span"+OutputInfo+">"+tr("periodic steady state reached after %1 periods (at %2)").arg(QLocale().toString(mSimulation->convergencePeriods()), convergencePoint)+"</span>."+OutputBrLn));
+            else
+                output(QString(OutputTab+"<strong>"+tr("Convergence:")+"</strong> <span"+OutputInfo+">"+tr("steady state reached at %1").arg(convergencePoint)+"</span>."+OutputBrLn));
+        }
     }
 
     // Update our parameters and simulation mode
 
     updateSimulationMode();
 
-    mContentsWidget->informationWidget()->parametersWidget()->updateParameters(mSimulation->currentPoint(), true);
+    mContentsWidget->informationWidget()->parametersWidget()->updateParameters(mSimulation->currentPoint());
 
     // Stop keeping track of our simulation progress
 
@@ -2524,6 +2596,53 @@ void SingleCellViewSimulationWidget::simulationStopped(const qint64 &pElapsedTim
 
 //==============================================================================
 
+QString SingleCellViewSimulationWidget::statisticsAsString(const Solver::Statistics &pStatistics) const
+{
+    // Return the given solver statistics as a string
+
+    QStringList res = QStringList();
+    QLocale locale = QLocale();
+
+    foreach (const Solver::Statistic &statistic, pStatistics.keys()) {
+        qint64 value = pStatistics.value(statistic);
+
+        switch (statistic) {
+        case Solver::NbOfSteps:
+            res << tr("%1 steps").arg(locale.toString(value));
+
+            break;
+        case Solver::NbOfRhsEvaluations:
+            res << tr("%1 RHS evaluations").arg(locale.toString(value));
+
+            break;
+        case Solver::NbOfJacobianEvaluations:
+            res << tr("%1 Jacobian evaluations").arg(locale.toString(value));
+
+            break;
+        case Solver::NbOfNewtonIterations:
+            res << tr("%1 Newton iterations").arg(locale.toString(value));
+
+            break;
+        case Solver::NbOfErrorTestFailures:
+            res << tr("%1 error test failures").arg(locale.toString(value));
+
+            break;
+        case Solver::NbOfNlaSolves:
+            res << tr("%1 solves").arg(locale.toString(value));
+
+            break;
+        case Solver::ModelTime:
+            res << tr("%1 s in model code").arg(QString::number(1.0e-9*value, 'g', 3));
+
+            break;
+        }
+    }
+
+    return res.join(", ");
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationWidget::resetProgressBar()
 {
     // Reset our progress bar
@@ -2617,14 +2736,18 @@ void SingleCellViewSimulationWidget::simulationDataModified(const bool &pIsModif
 
 void SingleCellViewSimulationWidget::simulationPropertyChanged(Core::Property *pProperty)
 {
-    // Update our simulation properties, as well as our plots, if it's not the
-    // point interval property that has been updated
+    // Update our simulation properties, as well as our plots, if it's neither
+    // the point interval, the checkpoint interval nor one of the convergence
+    // properties that has been updated
 
     updateSimulationProperties(pProperty);
 
     SingleCellViewInformationSimulationWidget *simulationWidget = mContentsWidget->informationWidget()->simulationWidget();
 
-    if (pProperty != simulationWidget->pointIntervalProperty()) {
+    if (   (pProperty != simulationWidget->pointIntervalProperty())
+        && (pProperty != simulationWidget->checkpointIntervalProperty())
+        && (pProperty != simulationWidget->convergencePeriodProperty())
+        && (pProperty != simulationWidget->convergenceToleranceProperty())) {
         bool needProcessingEvents = false;
         // Note: needProcessingEvents is used to ensure that our plots are all
         //       updated at once...
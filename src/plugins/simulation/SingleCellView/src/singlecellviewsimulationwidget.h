@@ -29,6 +29,7 @@ limitations under the License.
 #include "graphpanelplotwidget.h"
 #include "sedmlfileissue.h"
 #include "singlecellviewwidget.h"
+#include "solverinterface.h"
 #include "widget.h"
 
 //==============================================================================
@@ -229,6 +230,8 @@ private:
 
     void output(const QString &pMessage);
 
+    QString statisticsAsString(const Solver::Statistics &pStatistics) const;
+
     void updateSimulationMode();
 
     int tabBarPixmapSize() const;
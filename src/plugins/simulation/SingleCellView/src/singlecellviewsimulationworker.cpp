@@ -30,6 +30,7 @@ limitations under the License.
 #include <QElapsedTimer>
 #include <QMutex>
 #include <QThread>
+#include <QtMath>
 
 //==============================================================================
 
@@ -43,6 +44,9 @@ SingleCellViewSimulationWorker::SingleCellViewSimulationWorker(SingleCellViewSim
     mSimulation(pSimulation),
     mRuntime(pSimulation->runtime()),
     mCurrentPoint(0.0),
+    mRestart(false),
+    mRestartPointCounter(0),
+    mRestartPoint(0.0),
     mPaused(false),
     mStopped(false),
     mReset(false),
@@ -102,6 +106,21 @@ double SingleCellViewSimulationWorker::currentPoint() const
 
 //==============================================================================
 
+void SingleCellViewSimulationWorker::setRestartPoint(const quint64 &pPointCounter,
+                                                     const double &pCurrentPoint)
+{
+    // Keep track of the point from which we are to restart our simulation
+    // Note: our solver cannot carry on with the history it had when our
+    //       checkpoint was saved, so it will be reinitialised at that point
+    //       instead, just like when our simulation gets reset...
+
+    mRestart = true;
+    mRestartPointCounter = pPointCounter;
+    mRestartPoint = pCurrentPoint;
+}
+
+//==============================================================================
+
 bool SingleCellViewSimulationWorker::run()
 {
     // Start our thread, but only if we are not already running
@@ -247,16 +266,67 @@ void SingleCellViewSimulationWorker::started()
     double endingPoint   = mSimulation->data()->endingPoint();
     double pointInterval = mSimulation->data()->pointInterval();
 
-    bool increasingPoints = endingPoint > startingPoint;
-    quint64 pointCounter = 0;
+    int checkpointInterval = 1000*mSimulation->data()->checkpointInterval();
 
-    mCurrentPoint = startingPoint;
+    bool increasingPoints = endingPoint > startingPoint;
+    quint64 pointCounter = mRestart?mRestartPointCounter:0;
+
+    // Retrieve our convergence settings
+    // Note: a periodic steady state is checked for at period boundaries, which
+    //       are a multiple of our point interval (see
+    //       SingleCellViewSimulation::simulationSettingsOk()), while a true
+    //       steady state is checked for at every point...
+
+    double convergencePeriod = mSimulation->data()->convergencePeriod();
+    double convergenceTolerance = mSimulation->data()->convergenceTolerance();
+    quint64 periodPointCounter = (convergenceTolerance && convergencePeriod)?
+                                     qMax(Q_INT64_C(1), qRound64(convergencePeriod/qAbs(pointInterval))):
+                                     0;
+    double *referenceStates = periodPointCounter?
+                                  new double[mRuntime->statesCount()]:
+                                  0;
+    bool hasReferenceStates = false;
+    bool converged = false;
+
+    mCurrentPoint = mRestart?mRestartPoint:startingPoint;
 
     // Initialise our ODE/DAE solver
 
     if (odeSolver) {
         odeSolver->setProperties(mSimulation->data()->odeSolverProperties());
 
+        // Ask our ODE solver to compute the sensitivities of our states, if
+        // needed and possible
+        // Note: our sensitivities are zero at the start of our simulation,
+        //       unless we are restarting it from a checkpoint...
+
+        QList<int> sensitivityParameters = mSimulation->data()->sensitivityParameters();
+
+        if (!sensitivityParameters.isEmpty()) {
+            if (odeSolver->supportsSensitivities()) {
+                if (!mRestart)
+                    mSimulation->data()->resetSensitivities();
+
+                odeSolver->setSensitivityParameters(sensitivityParameters,
+                                                    mRuntime->constantsCount(),
+                                                    mSimulation->data()->sensitivities(),
+                                                    mRuntime->computeComputedConstants());
+            } else {
+                emitError(tr("the %1 solver cannot compute the sensitivities of the states").arg(mSimulation->data()->odeSolverName()));
+            }
+        }
+
+        // Let our ODE solver know about the conditions of our model, so that it
+        // can stop at its events (e.g. the start and end of a stimulus)
+
+        odeSolver->setRootInformation(mRuntime->condVarCount(),
+                                      mRuntime->computeOdeRootInformation());
+
+        // Let our ODE solver know about the blocks of our rates that can be
+        // computed in parallel, if any
+
+        odeSolver->setComputeRatesBlocks(mRuntime->computeOdeRatesBlocks());
+
         odeSolver->initialize(mCurrentPoint,
                               mRuntime->statesCount(),
                               mSimulation->data()->constants(),
@@ -301,11 +371,34 @@ void SingleCellViewSimulationWorker::started()
         timer.start();
 
         // Add our first point after making sure that all the variables are up
-        // to date
+        // to date, unless we are restarting from a checkpoint, in which case
+        // that point is already in our results
+
+        if (!mRestart) {
+            mSimulation->data()->recomputeVariables(mCurrentPoint);
+
+            mSimulation->results()->addPoint(mCurrentPoint);
+        }
 
-        mSimulation->data()->recomputeVariables(mCurrentPoint);
+        // Keep track of our states, if we are checking for a periodic steady
+        // state and are on a period boundary
+        // Note: if we are restarting from a checkpoint that is not on a period
+        //       boundary, then we will have to wait for the next one before we
+        //       can start comparing our states...
 
-        mSimulation->results()->addPoint(mCurrentPoint);
+        if (periodPointCounter && !(pointCounter % periodPointCounter)) {
+            memcpy(referenceStates, mSimulation->data()->states(),
+                   size_t(mRuntime->statesCount()*Solver::SizeOfDouble));
+
+            hasReferenceStates = true;
+        }
+
+        // Start our checkpoint timer, if needed
+
+        QElapsedTimer checkpointTimer;
+
+        if (checkpointInterval)
+            checkpointTimer.start();
 
         // Our main work loop
         // Note: for performance reasons, it is essential that the following
@@ -331,6 +424,20 @@ void SingleCellViewSimulationWorker::started()
             if (mError)
                 break;
 
+            // Make sure that our rates are up to date, if we are checking for a
+            // true steady state
+            // Note: our ODE solver may have last computed our rates at a point
+            //       other than our current one...
+
+            if (   convergenceTolerance && !periodPointCounter
+                && (mRuntime->modelType() == CellMLSupport::CellmlFileRuntime::Ode)) {
+                mRuntime->computeOdeRates()(mCurrentPoint,
+                                            mSimulation->data()->constants(),
+                                            mSimulation->data()->rates(),
+                                            mSimulation->data()->states(),
+                                            mSimulation->data()->algebraic());
+            }
+
             // Add our new point after making sure that all the variables are up
             // to date
 
@@ -343,6 +450,37 @@ void SingleCellViewSimulationWorker::started()
             if ((mCurrentPoint == endingPoint) || mStopped)
                 break;
 
+            // Check whether we have converged to a (periodic) steady state, in
+            // which case there is no point in carrying on
+
+            if (convergenceTolerance) {
+                if (!periodPointCounter) {
+                    converged = hasConverged(mSimulation->data()->rates(), 0,
+                                             convergenceTolerance);
+                } else if (!(pointCounter % periodPointCounter)) {
+                    converged = hasReferenceStates
+                                && hasConverged(mSimulation->data()->states(),
+                                                referenceStates,
+                                                convergenceTolerance);
+
+                    memcpy(referenceStates, mSimulation->data()->states(),
+                           size_t(mRuntime->statesCount()*Solver::SizeOfDouble));
+
+                    hasReferenceStates = true;
+                }
+
+                if (converged)
+                    break;
+            }
+
+            // Save a checkpoint of our simulation, if needed
+
+            if (checkpointInterval && checkpointTimer.hasExpired(checkpointInterval)) {
+                mSimulation->saveCheckpoint(pointCounter, mCurrentPoint);
+
+                checkpointTimer.start();
+            }
+
             // Delay things a bit, if (really) needed
 
             if (mSimulation->delay() && !mStopped)
@@ -405,9 +543,27 @@ void SingleCellViewSimulationWorker::started()
                 }
 
                 mReset = false;
+
+                // Our states may have been modified, so we cannot compare them
+                // with our reference states anymore
+
+                hasReferenceStates = false;
             }
         }
 
+        // Remove our checkpoint if we are done (be it because we have reached
+        // our ending point or converged), or save a final one if we have been
+        // asked to stop, so that we can later resume from where we are now
+        // Note: should an error have occurred, we keep our last checkpoint, if
+        //       any, as is...
+
+        if (!mError) {
+            if (converged || (mCurrentPoint == endingPoint))
+                mSimulation->removeCheckpoint();
+            else if (checkpointInterval)
+                mSimulation->saveCheckpoint(pointCounter, mCurrentPoint);
+        }
+
         // Retrieve the total elapsed time, should no error have occurred
 
         if (mError)
@@ -420,6 +576,23 @@ void SingleCellViewSimulationWorker::started()
         // Note: we use -1 as a way to indicate that something went wrong...
     }
 
+    // Let our simulation know whether we have converged and, if so, where and
+    // after how many periods
+
+    mSimulation->setConvergence(converged && !mError, mCurrentPoint,
+                                periodPointCounter?
+                                    int(pointCounter/periodPointCounter):
+                                    0);
+
+    delete[] referenceStates;
+
+    // Keep track of our solvers' statistics before deleting them
+
+    mSimulation->setSolversStatistics(voiSolver->statistics(),
+                                      nlaSolver?
+                                          nlaSolver->statistics():
+                                          Solver::Statistics());
+
     // Delete our solver(s)
 
     delete voiSolver;
@@ -444,6 +617,37 @@ void SingleCellViewSimulationWorker::started()
 
 //==============================================================================
 
+bool SingleCellViewSimulationWorker::hasConverged(const double *pValues,
+                                                  const double *pReferenceValues,
+                                                  const double &pTolerance) const
+{
+    // Check whether the given values are within the given tolerance of the
+    // given reference values (i.e. whether our states are the same as they were
+    // a period ago) or, if there are no reference values, of zero (i.e. whether
+    // our rates are all null)
+    // Note: we use a weighted maximum norm, with each difference being scaled
+    //       by the magnitude of its corresponding state (or one, whichever is
+    //       the largest), so that the tolerance is in effect relative for large
+    //       states and absolute for small ones...
+
+    double *states = mSimulation->data()->states();
+
+    for (int i = 0, iMax = mRuntime->statesCount(); i < iMax; ++i) {
+        double difference = pReferenceValues?
+                                pValues[i]-pReferenceValues[i]:
+                                pValues[i];
+
+        if (   !qIsFinite(difference)
+            || (qAbs(difference) > pTolerance*qMax(1.0, qAbs(states[i])))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
 void SingleCellViewSimulationWorker::emitError(const QString &pMessage)
 {
     // A solver error occurred, so keep track of it and let people know about it
@@ -60,6 +60,9 @@ public:
 
     double currentPoint() const;
 
+    void setRestartPoint(const quint64 &pPointCounter,
+                         const double &pCurrentPoint);
+
     bool run();
     bool pause();
     bool resume();
@@ -76,6 +79,10 @@ private:
 
     double mCurrentPoint;
 
+    bool mRestart;
+    quint64 mRestartPointCounter;
+    double mRestartPoint;
+
     bool mPaused;
     bool mStopped;
 
@@ -87,6 +94,9 @@ private:
 
     SingleCellViewSimulationWorker *&mSelf;
 
+    bool hasConverged(const double *pValues, const double *pReferenceValues,
+                      const double &pTolerance) const;
+
 Q_SIGNALS:
     void running(const bool &pIsResuming);
     void paused();
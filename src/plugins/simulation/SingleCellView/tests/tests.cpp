@@ -0,0 +1,375 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view tests
+//==============================================================================
+
+#include "../../../../tests/src/testsutils.h"
+
+//==============================================================================
+
+#include "cellmlfile.h"
+#include "cellmlfileruntime.h"
+#include "plugin.h"
+#include "singlecellviewsimulation.h"
+#include "solverinterface.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QPluginLoader>
+
+//==============================================================================
+
+static const qulonglong SimulationSize = 1001;
+
+//==============================================================================
+
+void Tests::initTestCase()
+{
+    // Make sure that our checkpoints don't end up in the user's cache
+
+    QStandardPaths::setTestModeEnabled(true);
+
+    mSolverPluginLoader = 0;
+    mCellmlFile = 0;
+    mSimulation = 0;
+
+    // Load our forward Euler solver plugin
+
+    static const QString BuildDir = OpenCOR::fileContents(":build_directory").first();
+
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
+    static const QString PluginsDir = BuildDir+"/plugins/OpenCOR";
+#elif defined(Q_OS_MAC)
+    static const QString PluginsDir = BuildDir+"/OpenCOR.app/Contents/PlugIns/OpenCOR";
+#else
+    #error Unsupported platform
+#endif
+
+    mSolverPluginLoader = new QPluginLoader(PluginsDir+QDir::separator()+OpenCOR::PluginPrefix+"ForwardEulerSolver"+OpenCOR::PluginExtension);
+
+    OpenCOR::SolverInterface *solverInterface = qobject_cast<OpenCOR::SolverInterface *>(mSolverPluginLoader->instance());
+
+    QVERIFY(solverInterface);
+
+    // Create a simulation of the van der Pol model, which we compute using the
+    // forward Euler solver, so that resuming our simulation from a checkpoint
+    // gives us exactly the same results as running it in one go
+
+    mCellmlFile = new OpenCOR::CellMLSupport::CellmlFile(OpenCOR::fileName("models/van_der_pol_model_1928.cellml"));
+
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = mCellmlFile->runtime();
+
+    QVERIFY(runtime);
+    QVERIFY(runtime->isValid());
+    QVERIFY(runtime->constantsCount() > 0);
+
+    mSimulation = new OpenCOR::SingleCellView::SingleCellViewSimulation(runtime, OpenCOR::SolverInterfaces() << solverInterface);
+
+    OpenCOR::SingleCellView::SingleCellViewSimulationData *data = mSimulation->data();
+
+    data->setStartingPoint(0.0, false);
+    data->setEndingPoint(10.0);
+    data->setPointInterval(0.01);
+    data->setCheckpointInterval(3600);
+    // Note: this means that a checkpoint only gets saved when our simulation
+    //       is stopped...
+    data->setOdeSolverName(solverInterface->solverName());
+    data->addOdeSolverProperty("Step", 0.001);
+
+    QCOMPARE(mSimulation->size(), double(SimulationSize));
+}
+
+//==============================================================================
+
+void Tests::cleanupTestCase()
+{
+    // Clean up after ourselves
+
+    if (mSimulation)
+        mSimulation->removeCheckpoint();
+
+    delete mSimulation;
+    delete mCellmlFile;
+
+    if (mSolverPluginLoader)
+        mSolverPluginLoader->unload();
+
+    delete mSolverPluginLoader;
+}
+
+//==============================================================================
+
+bool Tests::runSimulation(const bool &pRestart)
+{
+    // Run our simulation, from scratch or from its last checkpoint, with fresh
+    // results, and wait for it to be done
+
+    QSignalSpy stoppedSpy(mSimulation, SIGNAL(stopped(const qint64 &)));
+
+    if (!pRestart)
+        mSimulation->data()->reset();
+
+    if (   !mSimulation->results()->reset()
+        || !(pRestart?mSimulation->restart():mSimulation->run())) {
+        return false;
+    }
+
+    return    stoppedSpy.wait(60000)
+           && (stoppedSpy.first().first().toLongLong() >= 0);
+}
+
+//==============================================================================
+
+bool Tests::interruptSimulation()
+{
+    // Run our simulation slowly and stop it once it has computed a few points,
+    // which means that a checkpoint gets saved
+
+    QSignalSpy stoppedSpy(mSimulation, SIGNAL(stopped(const qint64 &)));
+
+    mSimulation->data()->reset();
+    mSimulation->setDelay(1000000);
+
+    if (!mSimulation->results()->reset() || !mSimulation->run())
+        return false;
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    while ((mSimulation->results()->size() < 3) && !timer.hasExpired(60000))
+        QTest::qWait(10);
+
+    bool res = mSimulation->stop() && stoppedSpy.wait(60000);
+
+    mSimulation->setDelay(0);
+
+    return    res
+           && (mSimulation->results()->size() >= 3)
+           && (mSimulation->results()->size() < SimulationSize);
+}
+
+//==============================================================================
+
+void Tests::checkpointRoundTripTests()
+{
+    // Run our simulation and keep track of our model values and results
+
+    QVERIFY(runSimulation());
+
+    OpenCOR::CellMLSupport::CellmlFileRuntime *runtime = mSimulation->runtime();
+    OpenCOR::SingleCellView::SingleCellViewSimulationData *data = mSimulation->data();
+    OpenCOR::SingleCellView::SingleCellViewSimulationResults *results = mSimulation->results();
+    int statesCount = runtime->statesCount();
+    QVector<double> states = QVector<double>(statesCount);
+    QVector<double> points = QVector<double>(int(SimulationSize));
+    QVector<double> resultsStates = QVector<double>(int(SimulationSize)*statesCount);
+
+    QCOMPARE(results->size(), SimulationSize);
+
+    memcpy(states.data(), data->states(), size_t(statesCount*OpenCOR::Solver::SizeOfDouble));
+    memcpy(points.data(), results->points(), size_t(SimulationSize*OpenCOR::Solver::SizeOfDouble));
+
+    for (int i = 0; i < statesCount; ++i)
+        memcpy(resultsStates.data()+i*SimulationSize, results->states(i), size_t(SimulationSize*OpenCOR::Solver::SizeOfDouble));
+
+    // Save our model values and our results, the latter in two blocks, as is
+    // done when our results are appended to a checkpoint
+
+    QByteArray checkpoint;
+
+    {
+        QDataStream stream(&checkpoint, QIODevice::WriteOnly);
+
+        data->saveCheckpoint(stream);
+
+        QVERIFY(results->saveCheckpoint(stream, 0, 400));
+        QVERIFY(results->saveCheckpoint(stream, 400, SimulationSize));
+    }
+
+    // Reset our model values and results, and load them back from our
+    // checkpoint, making sure that we get what we saved
+
+    data->reset();
+    QVERIFY(results->reset());
+
+    QVERIFY(data->states()[0] != states[0]);
+
+    {
+        QDataStream stream(checkpoint);
+        QByteArray values;
+
+        QVERIFY(data->loadCheckpoint(stream, values));
+        QVERIFY(!data->checkpointConstantsModified(values));
+        QVERIFY(results->loadCheckpoint(stream, SimulationSize));
+        QVERIFY(stream.atEnd());
+
+        data->useCheckpoint(values);
+    }
+
+    for (int i = 0; i < statesCount; ++i)
+        QCOMPARE(data->states()[i], states[i]);
+
+    QCOMPARE(results->size(), SimulationSize);
+
+    for (qulonglong i = 0; i < SimulationSize; ++i) {
+        QCOMPARE(results->points()[i], points[int(i)]);
+
+        for (int j = 0; j < statesCount; ++j)
+            QCOMPARE(results->states(j)[i], resultsStates[int(j*SimulationSize+i)]);
+    }
+
+    // Make sure that we cannot load a truncated checkpoint or more results
+    // than we have room for
+
+    {
+        QDataStream stream(checkpoint.left(checkpoint.size()-1));
+        QByteArray values;
+
+        QVERIFY(results->reset());
+        QVERIFY(data->loadCheckpoint(stream, values));
+        QVERIFY(!results->loadCheckpoint(stream, SimulationSize));
+    }
+
+    {
+        QDataStream stream(checkpoint);
+        QByteArray values;
+
+        QVERIFY(results->reset());
+        QVERIFY(data->loadCheckpoint(stream, values));
+        QVERIFY(!results->loadCheckpoint(stream, SimulationSize+1));
+    }
+}
+
+//==============================================================================
+
+void Tests::incompatibleCheckpointTests()
+{
+    // Interrupt our simulation and make sure that its checkpoint can be used
+
+    QVERIFY(interruptSimulation());
+
+    OpenCOR::SingleCellView::SingleCellViewSimulationData *data = mSimulation->data();
+    double checkpointPoint;
+    bool constantsModified;
+
+    QVERIFY(mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+    QVERIFY(!constantsModified);
+
+    // Make sure that our checkpoint cannot be used if our simulation settings
+    // have changed
+
+    QSignalSpy errorSpy(mSimulation, SIGNAL(error(const QString &)));
+
+    data->setEndingPoint(20.0);
+
+    QVERIFY(!mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+    QVERIFY(mSimulation->results()->reset());
+    QVERIFY(!mSimulation->restart());
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(errorSpy.first().first().toString(),
+             QString("the simulation checkpoint could not be loaded"));
+
+    data->setEndingPoint(10.0);
+
+    QVERIFY(mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+
+    // Make sure that we know when our constants have been modified since our
+    // checkpoint was saved, since resuming our simulation would restore them
+
+    double *constants = data->constants();
+    double constant = constants[0];
+
+    constants[0] = constant+1.0;
+
+    QVERIFY(mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+    QVERIFY(constantsModified);
+
+    constants[0] = constant;
+
+    QVERIFY(mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+    QVERIFY(!constantsModified);
+
+    // Make sure that our checkpoint cannot be used once removed
+
+    mSimulation->removeCheckpoint();
+
+    QVERIFY(!mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+}
+
+//==============================================================================
+
+void Tests::resumeTests()
+{
+    // Run our simulation in one go and keep track of its results
+
+    QVERIFY(runSimulation());
+
+    OpenCOR::SingleCellView::SingleCellViewSimulationResults *results = mSimulation->results();
+    int statesCount = mSimulation->runtime()->statesCount();
+    QVector<double> points = QVector<double>(int(SimulationSize));
+    QVector<double> resultsStates = QVector<double>(int(SimulationSize)*statesCount);
+    double checkpointPoint;
+    bool constantsModified;
+
+    QCOMPARE(results->size(), SimulationSize);
+    QVERIFY(!mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+
+    memcpy(points.data(), results->points(), size_t(SimulationSize*OpenCOR::Solver::SizeOfDouble));
+
+    for (int i = 0; i < statesCount; ++i)
+        memcpy(resultsStates.data()+i*SimulationSize, results->states(i), size_t(SimulationSize*OpenCOR::Solver::SizeOfDouble));
+
+    // Interrupt our simulation and make sure that its checkpoint was saved
+    // where it got interrupted
+
+    QVERIFY(interruptSimulation());
+    QVERIFY(mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+    QVERIFY(!constantsModified);
+    QCOMPARE(checkpointPoint, results->points()[results->size()-1]);
+
+    // Resume our simulation and make sure that we get the same results as when
+    // running it in one go, and that our checkpoint is gone
+
+    QVERIFY(runSimulation(true));
+    QCOMPARE(results->size(), SimulationSize);
+
+    for (qulonglong i = 0; i < SimulationSize; ++i) {
+        QCOMPARE(results->points()[i], points[int(i)]);
+
+        for (int j = 0; j < statesCount; ++j)
+            QCOMPARE(results->states(j)[i], resultsStates[int(j*SimulationSize+i)]);
+    }
+
+    QVERIFY(!mSimulation->hasCheckpoint(checkpointPoint, constantsModified));
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,70 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Single Cell view tests
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QObject>
+
+//==============================================================================
+
+class QPluginLoader;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace CellMLSupport {
+    class CellmlFile;
+}   // namespace CellMLSupport
+
+namespace SingleCellView {
+    class SingleCellViewSimulation;
+}   // namespace SingleCellView
+}   // namespace OpenCOR
+
+//==============================================================================
+
+class Tests : public QObject
+{
+    Q_OBJECT
+
+private:
+    QPluginLoader *mSolverPluginLoader;
+    OpenCOR::CellMLSupport::CellmlFile *mCellmlFile;
+    OpenCOR::SingleCellView::SingleCellViewSimulation *mSimulation;
+
+    bool runSimulation(const bool &pRestart = false);
+    bool interruptSimulation();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void checkpointRoundTripTests();
+    void incompatibleCheckpointTests();
+    void resumeTests();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -23,6 +23,14 @@
         <source>the &apos;interpolate solution&apos; property value could not be retrieved</source>
         <translation>la valeur de la propriété &apos;interpoler solution&apos; n&apos;a pas pu être retrouvée</translation>
     </message>
+    <message>
+        <source>the &apos;number of threads&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;nombre de threads&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;number of threads&apos; property must have a value greater than or equal to 1</source>
+        <translation>la propriété &apos;nombre de threads&apos; doit avoir une valeur plus grande que ou égale à 1</translation>
+    </message>
     <message>
         <source>the &apos;integration method&apos; property value could not be retrieved</source>
         <translation>la valeur de la propriété &apos;méthode d&apos;intégration&apos; n&apos;a pas pu être retrouvée</translation>
@@ -35,6 +43,10 @@
         <source>the &apos;preconditioner&apos; property value could not be retrieved</source>
         <translation>la valeur de la propriété &apos;préconditionneur&apos; n&apos;a pas pu être retrouvée</translation>
     </message>
+    <message>
+        <source>the sensitivities of the states cannot be computed using a banded linear solver or preconditioner</source>
+        <translation>les sensibilités des états ne peuvent pas être calculées en utilisant un solveur linéaire ou un préconditionneur à bande</translation>
+    </message>
     <message>
         <source>the &apos;upper half-bandwidth&apos; property must have a value between 0 and %1</source>
         <translation>la propriété &apos;demi largeur de bande supérieure&apos; doit avoir une valeur comprise entre 0 et %1</translation>
@@ -63,5 +75,13 @@
         <source>the &apos;absolute tolerance&apos; property must have a value greater than or equal to 0</source>
         <translation>la propriété &apos;tolérance absolue&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
     </message>
+    <message>
+        <source>the &apos;automatic half-bandwidths&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;demi largeurs de bande automatiques&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;reorder states&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;réordonner les états&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
 </context>
 </TS>
@@ -21,6 +21,8 @@ limitations under the License.
 //==============================================================================
 
 #include "cvodesolver.h"
+#include "sparsitypattern.h"
+#include "threadednvector.h"
 
 //==============================================================================
 
@@ -35,6 +37,10 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QtMath>
+
+//==============================================================================
+
 namespace OpenCOR {
 namespace CVODESolver {
 
@@ -44,18 +50,121 @@ int rhsFunction(double pVoi, N_Vector pStates, N_Vector pRates, void *pUserData)
 {
     // Compute the RHS function
 
+    // Note: if our model's rates can be split into independent blocks, then
+    //       we compute those blocks in parallel...
+
     CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+    bool timed = userData->solver()->startModelEvaluation();
 
-    userData->computeRates()(pVoi, userData->constants(),
-                             N_VGetArrayPointer_Serial(pRates),
-                             N_VGetArrayPointer_Serial(pStates),
-                             userData->algebraic());
+    if (userData->computeRatesBlocks().isEmpty()) {
+        userData->computeRates()(pVoi, userData->constants(),
+                                 N_VGetArrayPointer_Serial(pRates),
+                                 N_VGetArrayPointer_Serial(pStates),
+                                 userData->algebraic());
+    } else {
+        OpenCOR::Solver::computeRatesBlocks(userData->computeRatesBlocks(),
+                                            userData->nbOfThreads(), pVoi,
+                                            userData->constants(),
+                                            N_VGetArrayPointer_Serial(pRates),
+                                            N_VGetArrayPointer_Serial(pStates),
+                                            userData->algebraic());
+    }
+
+    userData->solver()->stopModelEvaluation(timed);
+
+    return 0;
+}
+
+//==============================================================================
+
+int reorderedRhsFunction(double pVoi, N_Vector pStates, N_Vector pRates,
+                         void *pUserData)
+{
+    // Compute the RHS function of our model, which states have been reordered
+
+    CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+
+    static_cast<const CvodeSolver *>(userData->solver())->computeReorderedRates(pVoi,
+                                                                                N_VGetArrayPointer_Serial(pStates),
+                                                                                N_VGetArrayPointer_Serial(pRates));
+
+    return 0;
+}
+
+//==============================================================================
+
+int sensitivityRhsFunction(double pVoi, N_Vector pStates, N_Vector pRates,
+                           void *pUserData)
+{
+    // Compute the RHS function of both our model and the sensitivities of its
+    // states
+
+    CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+
+    static_cast<const CvodeSolver *>(userData->solver())->computeSensitivityRates(pVoi,
+                                                                                  N_VGetArrayPointer_Serial(pStates),
+                                                                                  N_VGetArrayPointer_Serial(pRates));
+
+    return 0;
+}
+
+//==============================================================================
+
+int sensitivityJacobianFunction(long int pN, double pVoi, N_Vector pStates,
+                                N_Vector pRates, DlsMat pJacobian,
+                                void *pUserData, N_Vector pTemp1,
+                                N_Vector pTemp2, N_Vector pTemp3)
+{
+    Q_UNUSED(pN);
+    Q_UNUSED(pTemp1);
+    Q_UNUSED(pTemp2);
+    Q_UNUSED(pTemp3);
+
+    // Compute the Jacobian of both our model and the sensitivities of its
+    // states
+
+    CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+
+    static_cast<const CvodeSolver *>(userData->solver())->computeSensitivityJacobian(pVoi,
+                                                                                     N_VGetArrayPointer_Serial(pStates),
+                                                                                     N_VGetArrayPointer_Serial(pRates),
+                                                                                     pJacobian);
+
+    return 0;
+}
+
+//==============================================================================
+
+int rootFindingFunction(double pVoi, N_Vector pStates, double *pRoots,
+                        void *pUserData)
+{
+    // Compute the conditions of our model, whose roots are its events
+
+    CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+    const CvodeSolver *solver = static_cast<const CvodeSolver *>(userData->solver());
+
+    solver->computeRootInformation(pVoi,
+                                   solver->originalStates(N_VGetArrayPointer_Serial(pStates)),
+                                   pRoots);
 
     return 0;
 }
 
 //==============================================================================
 
+void sparsityFunction(const double &pVoi, double *pStates, double *pRates,
+                      void *pUserData)
+{
+    // Compute the rates of our (perturbed) states
+
+    CvodeSolverUserData *userData = static_cast<CvodeSolverUserData *>(pUserData);
+
+    userData->computeRates()(pVoi, userData->constants(), pRates, pStates,
+                             userData->algebraic());
+}
+
+//==============================================================================
+
 void errorHandler(int pErrorCode, const char *pModule, const char *pFunction,
                   char *pErrorMessage, void *pUserData)
 {
@@ -72,10 +181,16 @@ void errorHandler(int pErrorCode, const char *pModule, const char *pFunction,
 //==============================================================================
 
 CvodeSolverUserData::CvodeSolverUserData(double *pConstants, double *pAlgebraic,
-                                         Solver::OdeSolver::ComputeRatesFunction pComputeRates) :
+                                         Solver::OdeSolver::ComputeRatesFunction pComputeRates,
+                                         const QList<Solver::OdeSolver::ComputeRatesFunction> &pComputeRatesBlocks,
+                                         const int &pNbOfThreads,
+                                         const Solver::OdeSolver *pSolver) :
     mConstants(pConstants),
     mAlgebraic(pAlgebraic),
-    mComputeRates(pComputeRates)
+    mComputeRates(pComputeRates),
+    mComputeRatesBlocks(pComputeRatesBlocks),
+    mNbOfThreads(pNbOfThreads),
+    mSolver(pSolver)
 {
 }
 
@@ -108,11 +223,51 @@ Solver::OdeSolver::ComputeRatesFunction CvodeSolverUserData::computeRates() cons
 
 //==============================================================================
 
+QList<Solver::OdeSolver::ComputeRatesFunction> CvodeSolverUserData::computeRatesBlocks() const
+{
+    // Return our compute rates functions for the independent blocks of our
+    // rates, if any
+
+    return mComputeRatesBlocks;
+}
+
+//==============================================================================
+
+int CvodeSolverUserData::nbOfThreads() const
+{
+    // Return the number of threads to use to compute our rates
+
+    return mNbOfThreads;
+}
+
+//==============================================================================
+
+const Solver::OdeSolver * CvodeSolverUserData::solver() const
+{
+    // Return our solver
+
+    return mSolver;
+}
+
+//==============================================================================
+
 CvodeSolver::CvodeSolver() :
     mSolver(0),
     mStatesVector(0),
     mUserData(0),
-    mInterpolateSolution(InterpolateSolutionDefaultValue)
+    mInterpolateSolution(InterpolateSolutionDefaultValue),
+    mDirectLinearSolver(false),
+    mRelativeTolerance(RelativeToleranceDefaultValue),
+    mAbsoluteTolerance(AbsoluteToleranceDefaultValue),
+    mAbsoluteTolerancesVector(0),
+    mSensitivityScales(0),
+    mOriginalConstants(0),
+    mPerturbedStates(0),
+    mPerturbedRates(0),
+    mOrdering(QVector<int>()),
+    mOriginalStates(0),
+    mOriginalRates(0),
+    mPreviousStatistics(OpenCOR::Solver::Statistics())
 {
 }
 
@@ -129,9 +284,19 @@ CvodeSolver::~CvodeSolver()
 
     N_VDestroy_Serial(mStatesVector);
 
+    if (mAbsoluteTolerancesVector)
+        N_VDestroy_Serial(mAbsoluteTolerancesVector);
+
     CVodeFree(&mSolver);
 
     delete mUserData;
+
+    delete[] mSensitivityScales;
+    delete[] mOriginalConstants;
+    delete[] mPerturbedStates;
+    delete[] mPerturbedRates;
+    delete[] mOriginalStates;
+    delete[] mOriginalRates;
 }
 
 //==============================================================================
@@ -151,10 +316,14 @@ void CvodeSolver::initialize(const double &pVoiStart,
         QString iterationType = IterationTypeDefaultValue;
         QString linearSolver = LinearSolverDefaultValue;
         QString preconditioner = PreconditionerDefaultValue;
+        bool needUpperAndLowerHalfBandwidths = false;
+        bool automaticHalfBandwidths = AutomaticHalfBandwidthsDefaultValue;
         int upperHalfBandwidth = UpperHalfBandwidthDefaultValue;
         int lowerHalfBandwidth = LowerHalfBandwidthDefaultValue;
+        bool reorderStates = ReorderStatesDefaultValue;
         double relativeTolerance = RelativeToleranceDefaultValue;
         double absoluteTolerance = AbsoluteToleranceDefaultValue;
+        int numberOfThreads = NumberOfThreadsDefaultValue;
 
         if (mProperties.contains(MaximumStepId)) {
             maximumStep = mProperties.value(MaximumStepId).toDouble();
@@ -190,8 +359,6 @@ void CvodeSolver::initialize(const double &pVoiStart,
                 if (mProperties.contains(LinearSolverId)) {
                     linearSolver = mProperties.value(LinearSolverId).toString();
 
-                    bool needUpperAndLowerHalfBandwidths = false;
-
                     if (   !linearSolver.compare(DenseLinearSolver)
                         || !linearSolver.compare(DiagonalLinearSolver)) {
                         // We are dealing with a dense/diagonal linear solver,
@@ -221,35 +388,68 @@ void CvodeSolver::initialize(const double &pVoiStart,
                         }
                     }
 
-                    if (needUpperAndLowerHalfBandwidths) {
-                        if (mProperties.contains(UpperHalfBandwidthId)) {
-                            upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
+                    if (needUpperAndLowerHalfBandwidths && !mSensitivityParameters.isEmpty()) {
+                        // We are to compute the sensitivities of our states,
+                        // but they are integrated together with our states,
+                        // meaning that the Jacobian of our system is not
+                        // banded anymore
 
-                            if (   (upperHalfBandwidth < 0)
-                                || (upperHalfBandwidth >= pRatesStatesCount)) {
-                                emit error(QObject::tr("the 'upper half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+                        emit error(QObject::tr("the sensitivities of the states cannot be computed using a banded linear solver or preconditioner"));
 
-                                return;
-                            }
+                        return;
+                    }
+
+                    if (needUpperAndLowerHalfBandwidths) {
+                        if (mProperties.contains(AutomaticHalfBandwidthsId)) {
+                            automaticHalfBandwidths = mProperties.value(AutomaticHalfBandwidthsId).toBool();
                         } else {
-                            emit error(QObject::tr("the 'upper half-bandwidth' property value could not be retrieved"));
+                            emit error(QObject::tr("the 'automatic half-bandwidths' property value could not be retrieved"));
 
                             return;
                         }
 
-                        if (mProperties.contains(LowerHalfBandwidthId)) {
-                            lowerHalfBandwidth = mProperties.value(LowerHalfBandwidthId).toInt();
+                        if (automaticHalfBandwidths) {
+                            // Our half bandwidths are to be determined
+                            // automatically, so check whether we can also
+                            // reorder our states
 
-                            if (   (lowerHalfBandwidth < 0)
-                                || (lowerHalfBandwidth >= pRatesStatesCount)) {
-                                emit error(QObject::tr("the 'lower half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+                            if (mProperties.contains(ReorderStatesId)) {
+                                reorderStates = mProperties.value(ReorderStatesId).toBool();
+                            } else {
+                                emit error(QObject::tr("the 'reorder states' property value could not be retrieved"));
 
                                 return;
                             }
                         } else {
-                            emit error(QObject::tr("the 'lower half-bandwidth' property value could not be retrieved"));
+                            if (mProperties.contains(UpperHalfBandwidthId)) {
+                                upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
 
-                            return;
+                                if (   (upperHalfBandwidth < 0)
+                                    || (upperHalfBandwidth >= pRatesStatesCount)) {
+                                    emit error(QObject::tr("the 'upper half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+
+                                    return;
+                                }
+                            } else {
+                                emit error(QObject::tr("the 'upper half-bandwidth' property value could not be retrieved"));
+
+                                return;
+                            }
+
+                            if (mProperties.contains(LowerHalfBandwidthId)) {
+                                lowerHalfBandwidth = mProperties.value(LowerHalfBandwidthId).toInt();
+
+                                if (   (lowerHalfBandwidth < 0)
+                                    || (lowerHalfBandwidth >= pRatesStatesCount)) {
+                                    emit error(QObject::tr("the 'lower half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+
+                                    return;
+                                }
+                            } else {
+                                emit error(QObject::tr("the 'lower half-bandwidth' property value could not be retrieved"));
+
+                                return;
+                            }
                         }
                     }
                 } else {
@@ -300,15 +500,133 @@ void CvodeSolver::initialize(const double &pVoiStart,
             return;
         }
 
+        if (mProperties.contains(NumberOfThreadsId)) {
+            numberOfThreads = mProperties.value(NumberOfThreadsId).toInt();
+
+            if (numberOfThreads < 1) {
+                emit error(QObject::tr("the 'number of threads' property must have a value greater than or equal to 1"));
+
+                return;
+            }
+        } else {
+            emit error(QObject::tr("the 'number of threads' property value could not be retrieved"));
+
+            return;
+        }
+
         // Initialise the ODE solver itself
 
         OpenCOR::Solver::OdeSolver::initialize(pVoiStart, pRatesStatesCount,
                                                pConstants, pRates, pStates,
                                                pAlgebraic, pComputeRates);
 
+        // Create our user data
+
+        // Note: we only compute the blocks of our rates in parallel if more
+        //       than one thread was requested...
+
+        mUserData = new CvodeSolverUserData(pConstants, pAlgebraic,
+                                            pComputeRates,
+                                            (numberOfThreads > 1)?
+                                                mComputeRatesBlocks:
+                                                QList<ComputeRatesFunction>(),
+                                            numberOfThreads, this);
+
+        // Determine our half bandwidths, if needed, from the sparsity pattern
+        // of our rates with respect to our states, and see whether reordering
+        // our states would reduce them
+        // Note: we only reorder our states if it reduces our bandwidth, in
+        //       which case our rates get reordered the same way...
+
+        if (needUpperAndLowerHalfBandwidths && automaticHalfBandwidths) {
+            OpenCOR::Solver::SparsityPattern sparsityPattern(pRatesStatesCount);
+
+            sparsityPattern.addDependencies(sparsityFunction, pVoiStart, pStates, mUserData);
+
+            sparsityPattern.halfBandwidths(sparsityPattern.identityOrdering(),
+                                           upperHalfBandwidth, lowerHalfBandwidth);
+
+            if (reorderStates) {
+                QVector<int> ordering = sparsityPattern.bandwidthReducingOrdering();
+                int reorderedUpperHalfBandwidth;
+                int reorderedLowerHalfBandwidth;
+
+                sparsityPattern.halfBandwidths(ordering,
+                                               reorderedUpperHalfBandwidth,
+                                               reorderedLowerHalfBandwidth);
+
+                if (  reorderedUpperHalfBandwidth+reorderedLowerHalfBandwidth
+                    < upperHalfBandwidth+lowerHalfBandwidth) {
+                    mOrdering = ordering;
+
+                    upperHalfBandwidth = reorderedUpperHalfBandwidth;
+                    lowerHalfBandwidth = reorderedLowerHalfBandwidth;
+                }
+            }
+        }
+
         // Create the states vector
+        // Note #1: it is threaded if more than one thread was requested, in
+        //          which case CVODE's vector operations get split between
+        //          threads...
+        // Note #2: if we are to compute the sensitivities of our states, then
+        //          they are integrated together with our states, i.e. our
+        //          states are followed by their sensitivities with respect to
+        //          each of our sensitivity parameters, which means that our
+        //          states vector cannot use pStates directly...
+        // Note #3: if we reorder our states, then our states vector cannot use
+        //          pStates directly either, and we need some arrays to compute
+        //          our rates using our states in their original order...
+
+        int sensitivityParametersCount = mSensitivityParameters.count();
+
+        if (sensitivityParametersCount) {
+            mStatesVector = OpenCOR::Solver::newNVector(long(pRatesStatesCount)*(1+sensitivityParametersCount),
+                                                        numberOfThreads);
+
+            memcpy(N_VGetArrayPointer_Serial(mStatesVector), pStates,
+                   size_t(pRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+            memcpy(N_VGetArrayPointer_Serial(mStatesVector)+pRatesStatesCount,
+                   mSensitivities,
+                   size_t(pRatesStatesCount*sensitivityParametersCount*OpenCOR::Solver::SizeOfDouble));
+
+            // Keep track of the typical magnitude of our sensitivity
+            // parameters, which we need to scale both the increments used to
+            // compute the rates of our sensitivities and the absolute
+            // tolerance of those sensitivities
+            // Note: like CVODES, we use the initial value of a parameter, or
+            //       one if that value is zero...
+
+            mSensitivityScales = new double[sensitivityParametersCount];
+
+            for (int i = 0; i < sensitivityParametersCount; ++i) {
+                double parameter = qAbs(pConstants[mSensitivityParameters[i]]);
+
+                mSensitivityScales[i] = parameter?parameter:1.0;
+            }
+
+            // Create the arrays that we need to compute the rates of our
+            // sensitivities and our Jacobian
+
+            mOriginalConstants = new double[mConstantsCount];
+            mPerturbedStates = new double[pRatesStatesCount];
+            mPerturbedRates = new double[pRatesStatesCount];
+        } else if (!mOrdering.isEmpty()) {
+            mStatesVector = OpenCOR::Solver::newNVector(pRatesStatesCount,
+                                                        numberOfThreads);
+
+            OpenCOR::Solver::reorderValues(mOrdering, pStates,
+                                           N_VGetArrayPointer_Serial(mStatesVector));
+
+            mOriginalStates = new double[pRatesStatesCount];
+            mOriginalRates = new double[pRatesStatesCount];
+        } else {
+            mStatesVector = OpenCOR::Solver::makeNVector(pRatesStatesCount,
+                                                         pStates,
+                                                         numberOfThreads);
+        }
 
-        mStatesVector = N_VMake_Serial(pRatesStatesCount, pStates);
+        long statesVectorSize = NV_LENGTH_S(mStatesVector);
 
         // Create the CVODE solver
 
@@ -323,15 +641,22 @@ void CvodeSolver::initialize(const double &pVoiStart,
 
         // Initialise the CVODE solver
 
-        CVodeInit(mSolver, rhsFunction, pVoiStart, mStatesVector);
+        CVodeInit(mSolver,
+                  sensitivityParametersCount?
+                      sensitivityRhsFunction:
+                      mOrdering.isEmpty()?rhsFunction:reorderedRhsFunction,
+                  pVoiStart, mStatesVector);
 
         // Set some user data
 
-        mUserData = new CvodeSolverUserData(pConstants, pAlgebraic,
-                                            pComputeRates);
-
         CVodeSetUserData(mSolver, mUserData);
 
+        // Look for the roots of the conditions of our model, if any, so that
+        // we can stop at its events
+
+        if (mCondVarCount)
+            CVodeRootInit(mSolver, mCondVarCount, rootFindingFunction);
+
         // Set the maximum step
 
         CVodeSetMaxStep(mSolver, maximumStep);
@@ -342,9 +667,20 @@ void CvodeSolver::initialize(const double &pVoiStart,
 
         // Set the linear solver, if needed
 
+        mDirectLinearSolver =    newtonIteration
+                              && (   !linearSolver.compare(DenseLinearSolver)
+                                  || !linearSolver.compare(BandedLinearSolver));
+
         if (newtonIteration) {
             if (!linearSolver.compare(DenseLinearSolver)) {
-                CVDense(mSolver, pRatesStatesCount);
+                CVDense(mSolver, statesVectorSize);
+
+                // Use our own Jacobian if we are to compute the sensitivities
+                // of our states, since it is much cheaper to compute than
+                // CVODE's difference quotient version of it
+
+                if (sensitivityParametersCount)
+                    CVDlsSetDenseJacFn(mSolver, sensitivityJacobianFunction);
             } else if (!linearSolver.compare(BandedLinearSolver)) {
                 CVBand(mSolver, pRatesStatesCount, upperHalfBandwidth, lowerHalfBandwidth);
             } else if (!linearSolver.compare(DiagonalLinearSolver)) {
@@ -373,10 +709,51 @@ void CvodeSolver::initialize(const double &pVoiStart,
         }
 
         // Set the relative and absolute tolerances
+        // Note: like CVODES, the absolute tolerance of the sensitivities with
+        //       respect to a parameter is scaled by the typical magnitude of
+        //       that parameter...
 
-        CVodeSStolerances(mSolver, relativeTolerance, absoluteTolerance);
+        mRelativeTolerance = relativeTolerance;
+        mAbsoluteTolerance = absoluteTolerance;
+
+        if (sensitivityParametersCount) {
+            mAbsoluteTolerancesVector = OpenCOR::Solver::newNVector(statesVectorSize,
+                                                                    numberOfThreads);
+
+            double *absoluteTolerances = N_VGetArrayPointer_Serial(mAbsoluteTolerancesVector);
+
+            for (int i = 0; i < pRatesStatesCount; ++i)
+                absoluteTolerances[i] = absoluteTolerance;
+
+            for (int i = 0; i < sensitivityParametersCount; ++i) {
+                for (int j = 0; j < pRatesStatesCount; ++j)
+                    absoluteTolerances[(i+1)*pRatesStatesCount+j] = absoluteTolerance/mSensitivityScales[i];
+            }
+
+            CVodeSVtolerances(mSolver, relativeTolerance, mAbsoluteTolerancesVector);
+        } else {
+            CVodeSStolerances(mSolver, relativeTolerance, absoluteTolerance);
+        }
     } else {
-        // Reinitialise the CVODE object
+        // Reinitialise the CVODE object, after keeping track of its current
+        // statistics since they are about to be reset
+        // Note: if we compute the sensitivities of our states or reorder
+        //       them, then our states vector doesn't use pStates directly, so
+        //       we need to update it with the (possibly modified) values of our
+        //       states and of their sensitivities, if any...
+
+        OpenCOR::Solver::addStatistics(mPreviousStatistics, cvodeStatistics());
+
+        if (!mSensitivityParameters.isEmpty()) {
+            memcpy(N_VGetArrayPointer_Serial(mStatesVector), pStates,
+                   size_t(pRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+            memcpy(N_VGetArrayPointer_Serial(mStatesVector)+pRatesStatesCount,
+                   mSensitivities,
+                   size_t(pRatesStatesCount*mSensitivityParameters.count()*OpenCOR::Solver::SizeOfDouble));
+        } else if (!mOrdering.isEmpty()) {
+            OpenCOR::Solver::reorderValues(mOrdering, pStates,
+                                           N_VGetArrayPointer_Serial(mStatesVector));
+        }
 
         CVodeReInit(mSolver, pVoiStart, mStatesVector);
     }
@@ -386,12 +763,47 @@ void CvodeSolver::initialize(const double &pVoiStart,
 
 void CvodeSolver::solve(double &pVoi, const double &pVoiEnd) const
 {
-    // Solve the model
+    // Solve the model, restarting from any event that occurs on our way
+    // Note: an event (e.g. the start or end of a stimulus) is likely to
+    //       introduce a discontinuity in our model, so rather than let CVODE
+    //       deal with it (which it may do badly or, if it steps over it, not at
+    //       all), we reinitialise CVODE right after it, after keeping track of
+    //       its current statistics since they are about to be reset. We don't
+    //       do this if the event is (almost) at pVoiEnd since there would then
+    //       be nothing left for CVODE to do, in which case it would complain,
+    //       so we consider that we have reached pVoiEnd instead...
 
     if (!mInterpolateSolution)
         CVodeSetStopTime(mSolver, pVoiEnd);
 
-    CVode(mSolver, pVoiEnd, mStatesVector, &pVoi, CV_NORMAL);
+    while (CVode(mSolver, pVoiEnd, mStatesVector, &pVoi, CV_NORMAL) == CV_ROOT_RETURN) {
+        OpenCOR::Solver::addStatistics(mPreviousStatistics, cvodeStatistics());
+
+        CVodeReInit(mSolver, pVoi, mStatesVector);
+
+        if (pVoiEnd-pVoi <= 2.0*UNIT_ROUNDOFF*qMax(qAbs(pVoi), qAbs(pVoiEnd))) {
+            pVoi = pVoiEnd;
+
+            break;
+        }
+    }
+
+    // Retrieve our states and their sensitivities, if we compute them, or our
+    // states, if we reorder them
+    // Note: otherwise, our states vector uses our states directly...
+
+    if (!mSensitivityParameters.isEmpty()) {
+        double *statesAndSensitivities = N_VGetArrayPointer_Serial(mStatesVector);
+
+        memcpy(mStates, statesAndSensitivities,
+               size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+        memcpy(mSensitivities, statesAndSensitivities+mRatesStatesCount,
+               size_t(mRatesStatesCount*mSensitivityParameters.count()*OpenCOR::Solver::SizeOfDouble));
+    } else if (!mOrdering.isEmpty()) {
+        OpenCOR::Solver::restoreValues(mOrdering,
+                                       N_VGetArrayPointer_Serial(mStatesVector),
+                                       mStates);
+    }
 
     // Compute the rates one more time to get up to date values for the rates
     // Note: another way of doing this would be to copy the contents of the
@@ -400,8 +812,205 @@ void CvodeSolver::solve(double &pVoi, const double &pVoiEnd) const
     //       few calls to rhsFunction(), so that would be quite a few memory
     //       transfers while here we 'only' compute the rates one more time...
 
-    mComputeRates(pVoiEnd, mConstants, mRates,
-                  N_VGetArrayPointer_Serial(mStatesVector), mAlgebraic);
+    computeRates(pVoiEnd, mStates);
+}
+
+//==============================================================================
+
+bool CvodeSolver::supportsSensitivities() const
+{
+    // We can compute the sensitivities of our states
+
+    return true;
+}
+
+//==============================================================================
+
+void CvodeSolver::computeSensitivityRates(const double &pVoi, double *pStates,
+                                          double *pRates) const
+{
+    // Compute the rates of our states
+
+    computeRates(pVoi, pStates, pRates);
+
+    // Compute the rates of the sensitivities of our states with respect to
+    // each of our sensitivity parameters, using a forward difference quotient
+    // in the direction of those sensitivities and of that parameter, i.e.
+    //     ds_i/dt ~ [f(t, y+delta*s_i, p+delta*e_i)-f(t, y, p)]/delta
+    // Note #1: this is what CVODES does by default, with delta based on both
+    //          the size of s_i and the magnitude of the parameter, and it costs
+    //          only one evaluation of our model per parameter...
+    // Note #2: some computed constants may depend on our parameter, so we
+    //          need to recompute them after having perturbed our parameter.
+    //          This is done using our perturbed states and rates arrays as
+    //          dummy states and rates arrays, since computing our computed
+    //          constants may also (re)initialise some of our states. Our
+    //          constants are then restored from a copy of them rather than by
+    //          recomputing our computed constants a second time...
+
+    double increment = sqrt(qMax(mRelativeTolerance, UNIT_ROUNDOFF));
+    size_t constantsSize = size_t(mConstantsCount*OpenCOR::Solver::SizeOfDouble);
+
+    memcpy(mOriginalConstants, mConstants, constantsSize);
+
+    for (int i = 0, iMax = mSensitivityParameters.count(); i < iMax; ++i) {
+        double *sensitivities = pStates+(i+1)*mRatesStatesCount;
+        double *sensitivityRates = pRates+(i+1)*mRatesStatesCount;
+
+        // Determine the increment to use, based on the weighted RMS norm of
+        // our sensitivities and on the magnitude of our parameter
+
+        double sensitivitiesNorm = 0.0;
+
+        for (int j = 0; j < mRatesStatesCount; ++j) {
+            double weightedSensitivity = sensitivities[j]/(mRelativeTolerance*qAbs(pStates[j])+mAbsoluteTolerance);
+
+            sensitivitiesNorm += weightedSensitivity*weightedSensitivity;
+        }
+
+        sensitivitiesNorm = sqrt(sensitivitiesNorm/mRatesStatesCount)*mSensitivityScales[i];
+
+        double delta = qMin(mSensitivityScales[i]/qMax(sensitivitiesNorm, 1.0/increment),
+                            mSensitivityScales[i]*increment);
+
+        // Perturb our parameter and recompute our computed constants
+
+        mConstants[mSensitivityParameters[i]] += delta;
+
+        mComputeComputedConstants(mConstants, mPerturbedRates, mPerturbedStates);
+
+        // Compute the rates of our perturbed states
+
+        for (int j = 0; j < mRatesStatesCount; ++j)
+            mPerturbedStates[j] = pStates[j]+delta*sensitivities[j];
+
+        computeRates(pVoi, mPerturbedStates, mPerturbedRates);
+
+        for (int j = 0; j < mRatesStatesCount; ++j)
+            sensitivityRates[j] = (mPerturbedRates[j]-pRates[j])/delta;
+
+        // Restore our parameter and computed constants
+
+        memcpy(mConstants, mOriginalConstants, constantsSize);
+    }
+}
+
+//==============================================================================
+
+void CvodeSolver::computeSensitivityJacobian(const double &pVoi,
+                                             double *pStates, double *pRates,
+                                             DlsMat pJacobian) const
+{
+    // Compute the Jacobian of our model using forward difference quotients,
+    // and use it for each of the diagonal blocks of the Jacobian of our system
+    // Note: like the simultaneous corrector method of CVODES, we neglect the
+    //       off-diagonal blocks, i.e. the derivatives of the rates of our
+    //       sensitivities with respect to our states. This only affects the
+    //       convergence rate of CVODE's Newton iterations, not the accuracy of
+    //       our solution, while it means that our Jacobian only costs as many
+    //       evaluations of our model as we have states...
+
+    double increment = sqrt(UNIT_ROUNDOFF);
+
+    memcpy(mPerturbedStates, pStates,
+           size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+    for (int j = 0; j < mRatesStatesCount; ++j) {
+        double stateValue = mPerturbedStates[j];
+        double stateIncrement = increment*qMax(qAbs(stateValue), 1.0);
+
+        mPerturbedStates[j] += stateIncrement;
+
+        computeRates(pVoi, mPerturbedStates, mPerturbedRates);
+
+        mPerturbedStates[j] = stateValue;
+
+        for (int i = 0; i < mRatesStatesCount; ++i) {
+            double jacobianValue = (mPerturbedRates[i]-pRates[i])/stateIncrement;
+
+            for (int k = 0, kMax = mSensitivityParameters.count(); k <= kMax; ++k)
+                DENSE_ELEM(pJacobian, k*mRatesStatesCount+i, k*mRatesStatesCount+j) = jacobianValue;
+        }
+    }
+}
+
+//==============================================================================
+
+void CvodeSolver::computeReorderedRates(const double &pVoi, double *pStates,
+                                        double *pRates) const
+{
+    // Compute the rates of our reordered states, after having put them back in
+    // their original order, and reorder those rates the same way
+
+    OpenCOR::Solver::restoreValues(mOrdering, pStates, mOriginalStates);
+
+    computeRates(pVoi, mOriginalStates, mOriginalRates);
+
+    OpenCOR::Solver::reorderValues(mOrdering, mOriginalRates, pRates);
+}
+
+//==============================================================================
+
+double * CvodeSolver::originalStates(double *pStates) const
+{
+    // Return the given states in their original order, i.e. as expected by our
+    // model
+
+    if (mOrdering.isEmpty())
+        return pStates;
+
+    OpenCOR::Solver::restoreValues(mOrdering, pStates, mOriginalStates);
+
+    return mOriginalStates;
+}
+
+//==============================================================================
+
+Solver::Statistics CvodeSolver::cvodeStatistics() const
+{
+    // Retrieve CVODE's statistics since it was last (re)initialised
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::Statistics();
+
+    if (!mSolver)
+        return res;
+
+    long int nbOfSteps;
+    long int nbOfErrorTestFailures;
+    long int nbOfNewtonIterations;
+
+    CVodeGetNumSteps(mSolver, &nbOfSteps);
+    CVodeGetNumErrTestFails(mSolver, &nbOfErrorTestFailures);
+    CVodeGetNumNonlinSolvIters(mSolver, &nbOfNewtonIterations);
+
+    res.insert(OpenCOR::Solver::NbOfSteps, nbOfSteps);
+    res.insert(OpenCOR::Solver::NbOfErrorTestFailures, nbOfErrorTestFailures);
+    res.insert(OpenCOR::Solver::NbOfNewtonIterations, nbOfNewtonIterations);
+
+    if (mDirectLinearSolver) {
+        long int nbOfJacobianEvaluations;
+
+        CVDlsGetNumJacEvals(mSolver, &nbOfJacobianEvaluations);
+
+        res.insert(OpenCOR::Solver::NbOfJacobianEvaluations, nbOfJacobianEvaluations);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+Solver::Statistics CvodeSolver::statistics() const
+{
+    // Return our statistics, i.e. those of our model evaluations and those of
+    // CVODE since we were first initialised
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::OdeSolver::statistics();
+
+    OpenCOR::Solver::addStatistics(res, mPreviousStatistics);
+    OpenCOR::Solver::addStatistics(res, cvodeStatistics());
+
+    return res;
 }
 
 //==============================================================================
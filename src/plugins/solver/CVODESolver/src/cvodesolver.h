@@ -28,7 +28,12 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QVector>
+
+//==============================================================================
+
 #include "nvector/nvector_serial.h"
+#include "sundials/sundials_direct.h"
 
 //==============================================================================
 
@@ -37,17 +42,20 @@ namespace CVODESolver {
 
 //==============================================================================
 
-static const auto MaximumStepId          = QStringLiteral("MaximumStep");
-static const auto MaximumNumberOfStepsId = QStringLiteral("MaximumNumberOfSteps");
-static const auto IntegrationMethodId    = QStringLiteral("IntegrationMethod");
-static const auto IterationTypeId        = QStringLiteral("IterationType");
-static const auto LinearSolverId         = QStringLiteral("LinearSolver");
-static const auto PreconditionerId       = QStringLiteral("Preconditioner");
-static const auto UpperHalfBandwidthId   = QStringLiteral("UpperHalfBandwidth");
-static const auto LowerHalfBandwidthId   = QStringLiteral("LowerHalfBandwidth");
-static const auto RelativeToleranceId    = QStringLiteral("RelativeTolerance");
-static const auto AbsoluteToleranceId    = QStringLiteral("AbsoluteTolerance");
-static const auto InterpolateSolutionId  = QStringLiteral("InterpolateSolution");
+static const auto MaximumStepId             = QStringLiteral("MaximumStep");
+static const auto MaximumNumberOfStepsId    = QStringLiteral("MaximumNumberOfSteps");
+static const auto IntegrationMethodId       = QStringLiteral("IntegrationMethod");
+static const auto IterationTypeId           = QStringLiteral("IterationType");
+static const auto LinearSolverId            = QStringLiteral("LinearSolver");
+static const auto PreconditionerId          = QStringLiteral("Preconditioner");
+static const auto AutomaticHalfBandwidthsId = QStringLiteral("AutomaticHalfBandwidths");
+static const auto UpperHalfBandwidthId      = QStringLiteral("UpperHalfBandwidth");
+static const auto LowerHalfBandwidthId      = QStringLiteral("LowerHalfBandwidth");
+static const auto ReorderStatesId           = QStringLiteral("ReorderStates");
+static const auto RelativeToleranceId       = QStringLiteral("RelativeTolerance");
+static const auto AbsoluteToleranceId       = QStringLiteral("AbsoluteTolerance");
+static const auto InterpolateSolutionId     = QStringLiteral("InterpolateSolution");
+static const auto NumberOfThreadsId         = QStringLiteral("NumberOfThreads");
 
 //==============================================================================
 
@@ -80,6 +88,8 @@ static const auto BandedPreconditioner = QStringLiteral("Banded");
 //          that CVODE can use whatever step it sees fit...
 // Note #2: CVODE's default maximum number of steps is 500 which ought to be big
 //          enough in most cases...
+// Note #3: a number of threads of 1 means that we use SUNDIALS' serial
+//          N_Vector as such...
 
 static const double MaximumStepDefaultValue = 0.0;
 
@@ -91,32 +101,49 @@ static const auto IntegrationMethodDefaultValue = BdfMethod;
 static const auto IterationTypeDefaultValue = NewtonIteration;
 static const auto LinearSolverDefaultValue = DenseLinearSolver;
 static const auto PreconditionerDefaultValue = BandedPreconditioner;
+static const bool AutomaticHalfBandwidthsDefaultValue = false;
 static const int UpperHalfBandwidthDefaultValue = 0;
 static const int LowerHalfBandwidthDefaultValue = 0;
+static const bool ReorderStatesDefaultValue = false;
 
 static const double RelativeToleranceDefaultValue = 1.0e-7;
 static const double AbsoluteToleranceDefaultValue = 1.0e-7;
 
 static const bool InterpolateSolutionDefaultValue = true;
 
+static const int NumberOfThreadsDefaultValue = 1;
+
 //==============================================================================
 
 class CvodeSolverUserData
 {
 public:
     explicit CvodeSolverUserData(double *pConstants, double *pAlgebraic,
-                                 Solver::OdeSolver::ComputeRatesFunction pComputeRates);
+                                 Solver::OdeSolver::ComputeRatesFunction pComputeRates,
+                                 const QList<Solver::OdeSolver::ComputeRatesFunction> &pComputeRatesBlocks,
+                                 const int &pNbOfThreads,
+                                 const Solver::OdeSolver *pSolver);
 
     double * constants() const;
     double * algebraic() const;
 
     Solver::OdeSolver::ComputeRatesFunction computeRates() const;
+    QList<Solver::OdeSolver::ComputeRatesFunction> computeRatesBlocks() const;
+
+    int nbOfThreads() const;
+
+    const Solver::OdeSolver * solver() const;
 
 private:
     double *mConstants;
     double *mAlgebraic;
 
     Solver::OdeSolver::ComputeRatesFunction mComputeRates;
+    QList<Solver::OdeSolver::ComputeRatesFunction> mComputeRatesBlocks;
+
+    int mNbOfThreads;
+
+    const Solver::OdeSolver *mSolver;
 };
 
 //==============================================================================
@@ -134,12 +161,47 @@ public:
 
     virtual void solve(double &pVoi, const double &pVoiEnd) const;
 
+    virtual bool supportsSensitivities() const;
+
+    virtual OpenCOR::Solver::Statistics statistics() const;
+
+    void computeSensitivityRates(const double &pVoi, double *pStates,
+                                 double *pRates) const;
+    void computeSensitivityJacobian(const double &pVoi, double *pStates,
+                                    double *pRates, DlsMat pJacobian) const;
+
+    void computeReorderedRates(const double &pVoi, double *pStates,
+                               double *pRates) const;
+
+    double * originalStates(double *pStates) const;
+
 private:
     void *mSolver;
     N_Vector mStatesVector;
     CvodeSolverUserData *mUserData;
 
     bool mInterpolateSolution;
+
+    bool mDirectLinearSolver;
+
+    double mRelativeTolerance;
+    double mAbsoluteTolerance;
+
+    N_Vector mAbsoluteTolerancesVector;
+
+    double *mSensitivityScales;
+    double *mOriginalConstants;
+    double *mPerturbedStates;
+    double *mPerturbedRates;
+
+    QVector<int> mOrdering;
+
+    double *mOriginalStates;
+    double *mOriginalRates;
+
+    mutable OpenCOR::Solver::Statistics mPreviousStatistics;
+
+    OpenCOR::Solver::Statistics cvodeStatistics() const;
 };
 
 //==============================================================================
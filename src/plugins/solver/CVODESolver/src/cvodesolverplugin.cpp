@@ -163,11 +163,14 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
     Descriptions IterationTypeDescriptions;
     Descriptions LinearSolverDescriptions;
     Descriptions PreconditionerDescriptions;
+    Descriptions AutomaticHalfBandwidthsDescriptions;
     Descriptions UpperHalfBandwidthDescriptions;
     Descriptions LowerHalfBandwidthDescriptions;
+    Descriptions ReorderStatesDescriptions;
     Descriptions RelativeToleranceDescriptions;
     Descriptions AbsoluteToleranceDescriptions;
     Descriptions InterpolateSolutionDescriptions;
+    Descriptions NumberOfThreadsDescriptions;
 
     MaximumStepDescriptions.insert("en", QString::fromUtf8("Maximum step"));
     MaximumStepDescriptions.insert("fr", QString::fromUtf8("Pas maximum"));
@@ -187,12 +190,18 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
     PreconditionerDescriptions.insert("en", QString::fromUtf8("Preconditioner"));
     PreconditionerDescriptions.insert("fr", QString::fromUtf8("Préconditionneur"));
 
+    AutomaticHalfBandwidthsDescriptions.insert("en", QString::fromUtf8("Automatic half-bandwidths"));
+    AutomaticHalfBandwidthsDescriptions.insert("fr", QString::fromUtf8("Demi largeurs de bande automatiques"));
+
     UpperHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Upper half-bandwidth"));
     UpperHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande supérieure"));
 
     LowerHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Lower half-bandwidth"));
     LowerHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande inférieure"));
 
+    ReorderStatesDescriptions.insert("en", QString::fromUtf8("Reorder states"));
+    ReorderStatesDescriptions.insert("fr", QString::fromUtf8("Réordonner les états"));
+
     RelativeToleranceDescriptions.insert("en", QString::fromUtf8("Relative tolerance"));
     RelativeToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance relative"));
 
@@ -202,6 +211,9 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
     InterpolateSolutionDescriptions.insert("en", QString::fromUtf8("Interpolate solution"));
     InterpolateSolutionDescriptions.insert("fr", QString::fromUtf8("Interpoler solution"));
 
+    NumberOfThreadsDescriptions.insert("en", QString::fromUtf8("Number of threads"));
+    NumberOfThreadsDescriptions.insert("fr", QString::fromUtf8("Nombre de threads"));
+
     QStringList IntegrationMethodListValues = QStringList() << AdamsMoultonMethod
                                                             << BdfMethod;
 
@@ -224,11 +236,14 @@ Solver::Properties CVODESolverPlugin::solverProperties() const
                                 << Solver::Property(Solver::Property::List, IterationTypeId, IterationTypeDescriptions, IterationTypeListValues, IterationTypeDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, LinearSolverId, LinearSolverDescriptions, LinearSolverListValues, LinearSolverDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, PreconditionerId, PreconditionerDescriptions, PreconditionerListValues, PreconditionerDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, AutomaticHalfBandwidthsId, AutomaticHalfBandwidthsDescriptions, QStringList(), AutomaticHalfBandwidthsDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, UpperHalfBandwidthId, UpperHalfBandwidthDescriptions, QStringList(), UpperHalfBandwidthDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, LowerHalfBandwidthId, LowerHalfBandwidthDescriptions, QStringList(), LowerHalfBandwidthDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, ReorderStatesId, ReorderStatesDescriptions, QStringList(), ReorderStatesDefaultValue, false)
                                 << Solver::Property(Solver::Property::Double, RelativeToleranceId, RelativeToleranceDescriptions, QStringList(), RelativeToleranceDefaultValue, false)
                                 << Solver::Property(Solver::Property::Double, AbsoluteToleranceId, AbsoluteToleranceDescriptions, QStringList(), AbsoluteToleranceDefaultValue, false)
-                                << Solver::Property(Solver::Property::Boolean, InterpolateSolutionId, InterpolateSolutionDescriptions, QStringList(), InterpolateSolutionDefaultValue, false);
+                                << Solver::Property(Solver::Property::Boolean, InterpolateSolutionId, InterpolateSolutionDescriptions, QStringList(), InterpolateSolutionDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, NumberOfThreadsId, NumberOfThreadsDescriptions, QStringList(), NumberOfThreadsDefaultValue, false);
 }
 
 //==============================================================================
@@ -239,6 +254,7 @@ QMap<QString, bool> CVODESolverPlugin::solverPropertiesVisibility(const QMap<QSt
     // values
 
     QMap<QString, bool> res = QMap<QString, bool>();
+    bool needUpperAndLowerHalfBandwidths = false;
 
     if (!pSolverPropertiesValues.value(IterationTypeId).compare(NewtonIteration)) {
         // Newton iteration
@@ -252,38 +268,42 @@ QMap<QString, bool> CVODESolverPlugin::solverPropertiesVisibility(const QMap<QSt
             // Dense/diagonal linear solver
 
             res.insert(PreconditionerId, false);
-            res.insert(UpperHalfBandwidthId, false);
-            res.insert(LowerHalfBandwidthId, false);
         } else if (!linearSolver.compare(BandedLinearSolver)) {
             // Banded linear solver
 
             res.insert(PreconditionerId, false);
-            res.insert(UpperHalfBandwidthId, true);
-            res.insert(LowerHalfBandwidthId, true);
+
+            needUpperAndLowerHalfBandwidths = true;
         } else {
             // GMRES/Bi-CGStab/TFQMR linear solver
 
             res.insert(PreconditionerId, true);
 
-            if (!pSolverPropertiesValues.value(PreconditionerId).compare(BandedPreconditioner)) {
-                // Banded preconditioner
-
-                res.insert(UpperHalfBandwidthId, true);
-                res.insert(LowerHalfBandwidthId, true);
-            } else {
-                // No preconditioner
-
-                res.insert(UpperHalfBandwidthId, false);
-                res.insert(LowerHalfBandwidthId, false);
-            }
+            needUpperAndLowerHalfBandwidths = !pSolverPropertiesValues.value(PreconditionerId).compare(BandedPreconditioner);
         }
     } else {
         // Functional iteration
 
         res.insert(LinearSolverId, false);
         res.insert(PreconditionerId, false);
+    }
+
+    if (needUpperAndLowerHalfBandwidths) {
+        // Banded linear solver or preconditioner, whose half bandwidths are
+        // either determined automatically (in which case our states may also
+        // be reordered) or specified by the user
+
+        bool automaticHalfBandwidths = QVariant(pSolverPropertiesValues.value(AutomaticHalfBandwidthsId)).toBool();
+
+        res.insert(AutomaticHalfBandwidthsId, true);
+        res.insert(UpperHalfBandwidthId, !automaticHalfBandwidths);
+        res.insert(LowerHalfBandwidthId, !automaticHalfBandwidths);
+        res.insert(ReorderStatesId, automaticHalfBandwidths);
+    } else {
+        res.insert(AutomaticHalfBandwidthsId, false);
         res.insert(UpperHalfBandwidthId, false);
         res.insert(LowerHalfBandwidthId, false);
+        res.insert(ReorderStatesId, false);
     }
 
     return res;
@@ -0,0 +1,393 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// CVODE solver tests
+//==============================================================================
+
+#include "cvodesolver.h"
+#include "sparsitypattern.h"
+#include "tests.h"
+#include "threadednvector.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+static void compareVectors(N_Vector pVector1, N_Vector pVector2)
+{
+    // Make sure that the two given vectors are identical
+
+    QCOMPARE(NV_LENGTH_S(pVector1), NV_LENGTH_S(pVector2));
+
+    for (long i = 0, iMax = NV_LENGTH_S(pVector1); i < iMax; ++i) {
+        if (NV_Ith_S(pVector1, i) != NV_Ith_S(pVector2, i))
+            QFAIL(qPrintable(QString("element %1 differs: %2 vs. %3").arg(i)
+                                                                      .arg(NV_Ith_S(pVector1, i))
+                                                                      .arg(NV_Ith_S(pVector2, i))));
+    }
+}
+
+//==============================================================================
+
+static void compareReductions(const double &pValue1, const double &pValue2)
+{
+    // Make sure that the two given reductions are the same, give or take the
+    // order in which their partial results were combined
+
+    QVERIFY2(qAbs(pValue1-pValue2) <= 1.0e-12*qMax(qAbs(pValue1), qAbs(pValue2)),
+             qPrintable(QString("%1 vs. %2").arg(pValue1, 0, 'g', 17)
+                                            .arg(pValue2, 0, 'g', 17)));
+}
+
+//==============================================================================
+
+static void compareOperations(const long &pLength, const int &pNbOfThreads,
+                              const bool &pChunked)
+{
+    // Create serial and threaded versions of the same vectors
+
+    N_Vector serialX = N_VNew_Serial(pLength);
+    N_Vector serialY = N_VNew_Serial(pLength);
+    N_Vector serialW = N_VNew_Serial(pLength);
+    N_Vector serialId = N_VNew_Serial(pLength);
+    N_Vector serialZ = N_VNew_Serial(pLength);
+    N_Vector threadedX = OpenCOR::Solver::newNVector(pLength, pNbOfThreads);
+    N_Vector threadedY = OpenCOR::Solver::newNVector(pLength, pNbOfThreads);
+    N_Vector threadedW = OpenCOR::Solver::newNVector(pLength, pNbOfThreads);
+    N_Vector threadedId = OpenCOR::Solver::newNVector(pLength, pNbOfThreads);
+    N_Vector threadedZ = OpenCOR::Solver::newNVector(pLength, pNbOfThreads);
+
+    QCOMPARE(OpenCOR::Solver::nVectorNbOfThreads(threadedZ), pNbOfThreads);
+    QCOMPARE(OpenCOR::Solver::nVectorNbOfChunks(threadedZ) > 1, pChunked);
+
+    for (long i = 0; i < pLength; ++i) {
+        NV_Ith_S(serialX, i) = NV_Ith_S(threadedX, i) = qSin(0.001*i)-0.25;
+        NV_Ith_S(serialY, i) = NV_Ith_S(threadedY, i) = 2.0+qCos(0.003*i);
+        NV_Ith_S(serialW, i) = NV_Ith_S(threadedW, i) = 1.0/(1.0+i%7);
+        NV_Ith_S(serialId, i) = NV_Ith_S(threadedId, i) = i%3?1.0:0.0;
+    }
+
+    // Carry out the operations that we have overridden and make sure that we
+    // get the same results as with a serial vector
+
+    N_VLinearSum(1.5, serialX, -0.5, serialY, serialZ);
+    N_VLinearSum(1.5, threadedX, -0.5, threadedY, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VConst(3.0, serialZ);
+    N_VConst(3.0, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VProd(serialX, serialY, serialZ);
+    N_VProd(threadedX, threadedY, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VDiv(serialX, serialY, serialZ);
+    N_VDiv(threadedX, threadedY, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VScale(-2.0, serialX, serialZ);
+    N_VScale(-2.0, threadedX, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VAbs(serialX, serialZ);
+    N_VAbs(threadedX, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VInv(serialY, serialZ);
+    N_VInv(threadedY, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    N_VAddConst(serialX, 0.75, serialZ);
+    N_VAddConst(threadedX, 0.75, threadedZ);
+
+    compareVectors(serialZ, threadedZ);
+
+    compareReductions(N_VDotProd(serialX, serialY),
+                      N_VDotProd(threadedX, threadedY));
+    compareReductions(N_VWrmsNorm(serialX, serialW),
+                      N_VWrmsNorm(threadedX, threadedW));
+    compareReductions(N_VWrmsNormMask(serialX, serialW, serialId),
+                      N_VWrmsNormMask(threadedX, threadedW, threadedId));
+    compareReductions(N_VWL2Norm(serialX, serialW),
+                      N_VWL2Norm(threadedX, threadedW));
+    compareReductions(N_VL1Norm(serialX),
+                      N_VL1Norm(threadedX));
+
+    QCOMPARE(N_VMaxNorm(threadedX), N_VMaxNorm(serialX));
+    QCOMPARE(N_VMin(threadedX), N_VMin(serialX));
+
+    // Make sure that a clone of a threaded vector is also threaded
+
+    N_Vector threadedClone = N_VClone(threadedX);
+
+    QCOMPARE(OpenCOR::Solver::nVectorNbOfThreads(threadedClone), pNbOfThreads);
+
+    N_VDestroy(threadedClone);
+
+    // Clean up after ourselves
+
+    N_VDestroy(serialX);
+    N_VDestroy(serialY);
+    N_VDestroy(serialW);
+    N_VDestroy(serialId);
+    N_VDestroy(serialZ);
+    N_VDestroy(threadedX);
+    N_VDestroy(threadedY);
+    N_VDestroy(threadedW);
+    N_VDestroy(threadedId);
+    N_VDestroy(threadedZ);
+}
+
+//==============================================================================
+
+void Tests::threadedNVectorTests()
+{
+    // Compare the operations of a threaded vector with those of a serial one,
+    // using a vector that is large enough to be split into chunks and one that
+    // is too small for that
+
+    compareOperations(1 << 20, 4, true);
+    compareOperations(1 << 20, 3, true);
+    compareOperations(100, 4, false);
+}
+
+//==============================================================================
+
+static int computeDecayRates(double VOI, double *CONSTANTS, double *RATES,
+                             double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A state that decays exponentially, i.e. y' = -k*y, with k a computed
+    // constant that is equal to our parameter
+
+    RATES[0] = -CONSTANTS[1]*STATES[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeDecayComputedConstants(double *CONSTANTS, double *RATES,
+                                         double *STATES)
+{
+    Q_UNUSED(RATES);
+    Q_UNUSED(STATES);
+
+    CONSTANTS[1] = CONSTANTS[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+void Tests::sensitivityTests()
+{
+    // Solve y' = -k*y with y(0) = 1 and compute the sensitivity of y with
+    // respect to k, which we know to be dy/dk = -t*exp(-k*t)
+
+    static const double K = 1.5;
+
+    double constants[2] = { K, 0.0 };
+    double rates[1];
+    double states[1] = { 1.0 };
+    double algebraic[1];
+    double sensitivities[1] = { 0.0 };
+
+    computeDecayComputedConstants(constants, rates, states);
+
+    OpenCOR::Solver::Solver::Properties properties = OpenCOR::Solver::Solver::Properties();
+
+    properties.insert(OpenCOR::CVODESolver::MaximumStepId, 0.0);
+    properties.insert(OpenCOR::CVODESolver::MaximumNumberOfStepsId, 500);
+    properties.insert(OpenCOR::CVODESolver::IntegrationMethodId, OpenCOR::CVODESolver::BdfMethod);
+    properties.insert(OpenCOR::CVODESolver::IterationTypeId, OpenCOR::CVODESolver::NewtonIteration);
+    properties.insert(OpenCOR::CVODESolver::LinearSolverId, OpenCOR::CVODESolver::DenseLinearSolver);
+    properties.insert(OpenCOR::CVODESolver::RelativeToleranceId, 1.0e-9);
+    properties.insert(OpenCOR::CVODESolver::AbsoluteToleranceId, 1.0e-9);
+    properties.insert(OpenCOR::CVODESolver::InterpolateSolutionId, true);
+    properties.insert(OpenCOR::CVODESolver::NumberOfThreadsId, 1);
+
+    OpenCOR::CVODESolver::CvodeSolver solver;
+
+    solver.setProperties(properties);
+    solver.setSensitivityParameters(QList<int>() << 0, 2, sensitivities,
+                                    computeDecayComputedConstants);
+    solver.initialize(0.0, 1, constants, rates, states, algebraic,
+                      computeDecayRates);
+
+    QVERIFY(solver.supportsSensitivities());
+
+    double voi = 0.0;
+
+    for (int i = 1; i <= 20; ++i) {
+        double voiEnd = 0.1*i;
+
+        solver.solve(voi, voiEnd);
+
+        QCOMPARE(voi, voiEnd);
+        QVERIFY(qAbs(states[0]-qExp(-K*voiEnd)) < 1.0e-6);
+        QVERIFY2(qAbs(sensitivities[0]+voiEnd*qExp(-K*voiEnd)) < 1.0e-4,
+                 qPrintable(QString("dy/dk at t = %1: %2 vs. %3").arg(voiEnd)
+                                                                 .arg(sensitivities[0])
+                                                                 .arg(-voiEnd*qExp(-K*voiEnd))));
+    }
+
+    // Computing the sensitivities must have left our constants untouched
+
+    QCOMPARE(constants[0], K);
+    QCOMPARE(constants[1], K);
+}
+
+//==============================================================================
+
+static const int SparsityPatternSize = 50;
+
+//==============================================================================
+
+static void computeTridiagonalSystem(const double &pVoi, double *pVariables,
+                                     double *pResults, void *pUserData)
+{
+    Q_UNUSED(pVoi);
+    Q_UNUSED(pUserData);
+
+    // A tridiagonal system, i.e. a discretised 1D Laplacian
+
+    for (int i = 0; i < SparsityPatternSize; ++i) {
+        pResults[i] = -2.0*pVariables[i];
+
+        if (i)
+            pResults[i] += pVariables[i-1];
+
+        if (i != SparsityPatternSize-1)
+            pResults[i] += pVariables[i+1];
+    }
+}
+
+//==============================================================================
+
+static int shuffledIndex(const int &pIndex)
+{
+    // Return the shuffled version of the given index
+    // Note: 7 and our size are coprime, so this gives us a permutation...
+
+    return (7*pIndex)%SparsityPatternSize;
+}
+
+//==============================================================================
+
+static void computeShuffledBandedSystem(const double &pVoi, double *pVariables,
+                                        double *pResults, void *pUserData)
+{
+    Q_UNUSED(pVoi);
+    Q_UNUSED(pUserData);
+
+    // A pentadiagonal system which equations and variables have been shuffled
+
+    for (int i = 0; i < SparsityPatternSize; ++i) {
+        double result = 0.0;
+
+        for (int k = qMax(i-2, 0), kMax = qMin(i+2, SparsityPatternSize-1); k <= kMax; ++k)
+            result += (k-i+3)*pVariables[shuffledIndex(k)];
+
+        pResults[shuffledIndex(i)] = result;
+    }
+}
+
+//==============================================================================
+
+void Tests::sparsityPatternTests()
+{
+    // Check that we determine the half-bandwidths of a tridiagonal system and
+    // that reordering it doesn't make them any worse
+
+    double variables[SparsityPatternSize];
+    double reorderedVariables[SparsityPatternSize];
+    double restoredVariables[SparsityPatternSize];
+    int upperHalfBandwidth;
+    int lowerHalfBandwidth;
+
+    for (int i = 0; i < SparsityPatternSize; ++i)
+        variables[i] = i+1.0;
+
+    OpenCOR::Solver::SparsityPattern tridiagonalPattern(SparsityPatternSize);
+
+    tridiagonalPattern.addDependencies(computeTridiagonalSystem, 0.0, variables, 0);
+
+    tridiagonalPattern.halfBandwidths(tridiagonalPattern.identityOrdering(),
+                                      upperHalfBandwidth, lowerHalfBandwidth);
+
+    QCOMPARE(upperHalfBandwidth, 1);
+    QCOMPARE(lowerHalfBandwidth, 1);
+
+    tridiagonalPattern.halfBandwidths(tridiagonalPattern.bandwidthReducingOrdering(),
+                                      upperHalfBandwidth, lowerHalfBandwidth);
+
+    QCOMPARE(upperHalfBandwidth, 1);
+    QCOMPARE(lowerHalfBandwidth, 1);
+
+    // Check that our shuffled pentadiagonal system has large half-bandwidths,
+    // unless we reorder it, in which case we should recover its original
+    // half-bandwidths
+
+    OpenCOR::Solver::SparsityPattern shuffledBandedPattern(SparsityPatternSize);
+
+    shuffledBandedPattern.addDependencies(computeShuffledBandedSystem, 0.0, variables, 0);
+
+    shuffledBandedPattern.halfBandwidths(shuffledBandedPattern.identityOrdering(),
+                                         upperHalfBandwidth, lowerHalfBandwidth);
+
+    QVERIFY(upperHalfBandwidth > 10);
+    QVERIFY(lowerHalfBandwidth > 10);
+
+    QVector<int> ordering = shuffledBandedPattern.bandwidthReducingOrdering();
+
+    shuffledBandedPattern.halfBandwidths(ordering, upperHalfBandwidth, lowerHalfBandwidth);
+
+    QCOMPARE(upperHalfBandwidth, 2);
+    QCOMPARE(lowerHalfBandwidth, 2);
+
+    // Check that our ordering is a permutation, i.e. that we can reorder our
+    // variables and restore them
+
+    OpenCOR::Solver::reorderValues(ordering, variables, reorderedVariables);
+    OpenCOR::Solver::restoreValues(ordering, reorderedVariables, restoredVariables);
+
+    for (int i = 0; i < SparsityPatternSize; ++i)
+        QCOMPARE(restoredVariables[i], variables[i]);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
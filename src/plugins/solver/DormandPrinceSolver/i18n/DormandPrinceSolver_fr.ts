@@ -0,0 +1,47 @@
+<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE TS>
+<TS version="2.1" language="fr_FR" sourcelanguage="en_GB">
+<context>
+    <name>QObject</name>
+    <message>
+        <source>the &apos;maximum step&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;pas maximum&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;maximum step&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;pas maximum&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance relative&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance relative&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;absolute tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance absolue&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;absolute tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance absolue&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;relative tolerance&apos; and &apos;absolute tolerance&apos; properties cannot both be equal to 0</source>
+        <translation>les propriétés &apos;tolérance relative&apos; et &apos;tolérance absolue&apos; ne peuvent pas être toutes les deux égales à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;interpolate solution&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;interpoler solution&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the step became too small at %1</source>
+        <translation>le pas est devenu trop petit à %1</translation>
+    </message>
+    <message>
+        <source>the solution is not a finite number at %1</source>
+        <translation>la solution n&apos;est pas un nombre fini à %1</translation>
+    </message>
+</context>
+</TS>
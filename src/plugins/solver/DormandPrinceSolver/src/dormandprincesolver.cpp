@@ -0,0 +1,596 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver
+//==============================================================================
+
+#include "dormandprincesolver.h"
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+#include <limits>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace DormandPrinceSolver {
+
+//==============================================================================
+
+// Coefficients of the Dormand-Prince 5(4) method, as well as those of its
+// error estimator and of its dense output (see E. Hairer, S.P. Nørsett and G.
+// Wanner, "Solving Ordinary Differential Equations I", 2nd edition, Springer,
+// 1993)
+
+static const double C2 = 1.0/5.0;
+static const double C3 = 3.0/10.0;
+static const double C4 = 4.0/5.0;
+static const double C5 = 8.0/9.0;
+
+static const double A21 = 1.0/5.0;
+static const double A31 = 3.0/40.0;
+static const double A32 = 9.0/40.0;
+static const double A41 = 44.0/45.0;
+static const double A42 = -56.0/15.0;
+static const double A43 = 32.0/9.0;
+static const double A51 = 19372.0/6561.0;
+static const double A52 = -25360.0/2187.0;
+static const double A53 = 64448.0/6561.0;
+static const double A54 = -212.0/729.0;
+static const double A61 = 9017.0/3168.0;
+static const double A62 = -355.0/33.0;
+static const double A63 = 46732.0/5247.0;
+static const double A64 = 49.0/176.0;
+static const double A65 = -5103.0/18656.0;
+static const double A71 = 35.0/384.0;
+static const double A73 = 500.0/1113.0;
+static const double A74 = 125.0/192.0;
+static const double A75 = -2187.0/6784.0;
+static const double A76 = 11.0/84.0;
+
+static const double E1 = 71.0/57600.0;
+static const double E3 = -71.0/16695.0;
+static const double E4 = 71.0/1920.0;
+static const double E5 = -17253.0/339200.0;
+static const double E6 = 22.0/525.0;
+static const double E7 = -1.0/40.0;
+
+static const double D1 = -12715105075.0/11282082432.0;
+static const double D3 = 87487479700.0/32700410799.0;
+static const double D4 = -10690763975.0/1880347072.0;
+static const double D5 = 701980252875.0/199316789632.0;
+static const double D6 = -1453857185.0/822651844.0;
+static const double D7 = 69997945.0/29380423.0;
+
+//==============================================================================
+
+// Parameters of our PI step size controller
+
+static const double Beta  = 0.04;
+static const double Expo1 = 0.2-0.75*Beta;
+static const double Safe  = 0.9;
+static const double Facc1 = 5.0;   // i.e. 1/0.2, the smallest step decrease
+static const double Facc2 = 0.1;   // i.e. 1/10, the biggest step increase
+
+static const double MinimumErrorNorm = 1.0e-4;
+
+//==============================================================================
+
+DormandPrinceSolver::DormandPrinceSolver() :
+    mMaximumStep(MaximumStepDefaultValue),
+    mRelativeTolerance(RelativeToleranceDefaultValue),
+    mAbsoluteTolerance(AbsoluteToleranceDefaultValue),
+    mInterpolateSolution(InterpolateSolutionDefaultValue),
+    mVoi(0.0),
+    mStep(0.0),
+    mPreviousVoi(0.0),
+    mPreviousStep(0.0),
+    mPreviousErrorNorm(MinimumErrorNorm),
+    mNeedInitialStep(true),
+    mHasDenseOutput(false),
+    mNbOfErrorTestFailures(0),
+    mY(0),
+    mYk(0),
+    mYNew(0),
+    mK1(0),
+    mK2(0),
+    mK3(0),
+    mK4(0),
+    mK5(0),
+    mK6(0),
+    mK7(0),
+    mErrors(0),
+    mDenseOutput1(0),
+    mDenseOutput2(0),
+    mDenseOutput3(0),
+    mDenseOutput4(0),
+    mDenseOutput5(0)
+{
+}
+
+//==============================================================================
+
+DormandPrinceSolver::~DormandPrinceSolver()
+{
+    // Delete some internal objects
+
+    deleteArrays();
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::deleteArrays()
+{
+    // Delete our various arrays
+
+    delete[] mY;
+    delete[] mYk;
+    delete[] mYNew;
+    delete[] mK1;
+    delete[] mK2;
+    delete[] mK3;
+    delete[] mK4;
+    delete[] mK5;
+    delete[] mK6;
+    delete[] mK7;
+    delete[] mErrors;
+
+    delete[] mDenseOutput1;
+    delete[] mDenseOutput2;
+    delete[] mDenseOutput3;
+    delete[] mDenseOutput4;
+    delete[] mDenseOutput5;
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::initialize(const double &pVoiStart,
+                                     const int &pRatesStatesCount,
+                                     double *pConstants, double *pRates,
+                                     double *pStates, double *pAlgebraic,
+                                     ComputeRatesFunction pComputeRates)
+{
+    // Retrieve the solver's properties
+
+    if (mProperties.contains(MaximumStepId)) {
+        mMaximumStep = mProperties.value(MaximumStepId).toDouble();
+
+        if (mMaximumStep < 0) {
+            emit error(QObject::tr("the 'maximum step' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'maximum step' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(RelativeToleranceId)) {
+        mRelativeTolerance = mProperties.value(RelativeToleranceId).toDouble();
+
+        if (mRelativeTolerance < 0) {
+            emit error(QObject::tr("the 'relative tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'relative tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(AbsoluteToleranceId)) {
+        mAbsoluteTolerance = mProperties.value(AbsoluteToleranceId).toDouble();
+
+        if (mAbsoluteTolerance < 0) {
+            emit error(QObject::tr("the 'absolute tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'absolute tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (!mRelativeTolerance && !mAbsoluteTolerance) {
+        emit error(QObject::tr("the 'relative tolerance' and 'absolute tolerance' properties cannot both be equal to 0"));
+
+        return;
+    }
+
+    if (mProperties.contains(InterpolateSolutionId)) {
+        mInterpolateSolution = mProperties.value(InterpolateSolutionId).toBool();
+    } else {
+        emit error(QObject::tr("the 'interpolate solution' property value could not be retrieved"));
+
+        return;
+    }
+
+    // Initialise the ODE solver itself
+
+    OpenCOR::Solver::OdeSolver::initialize(pVoiStart, pRatesStatesCount,
+                                           pConstants, pRates, pStates,
+                                           pAlgebraic, pComputeRates);
+
+    // (Re)create our various arrays
+
+    deleteArrays();
+
+    mY      = new double[pRatesStatesCount];
+    mYk     = new double[pRatesStatesCount];
+    mYNew   = new double[pRatesStatesCount];
+    mK1     = new double[pRatesStatesCount];
+    mK2     = new double[pRatesStatesCount];
+    mK3     = new double[pRatesStatesCount];
+    mK4     = new double[pRatesStatesCount];
+    mK5     = new double[pRatesStatesCount];
+    mK6     = new double[pRatesStatesCount];
+    mK7     = new double[pRatesStatesCount];
+    mErrors = new double[pRatesStatesCount];
+
+    mDenseOutput1 = new double[pRatesStatesCount];
+    mDenseOutput2 = new double[pRatesStatesCount];
+    mDenseOutput3 = new double[pRatesStatesCount];
+    mDenseOutput4 = new double[pRatesStatesCount];
+    mDenseOutput5 = new double[pRatesStatesCount];
+
+    // (Re)start our integration from the given point and states
+    // Note: we integrate our own copy of the states since, when interpolating
+    //       our solution, we are likely to be ahead of the point that was
+    //       requested from us...
+
+    mVoi = pVoiStart;
+
+    memcpy(mY, pStates, pRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+
+    mPreviousErrorNorm = MinimumErrorNorm;
+    mNeedInitialStep = true;
+    mHasDenseOutput = false;
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::solve(double &pVoi, const double &pVoiEnd) const
+{
+    // Compute our initial rates and step, if needed
+    // Note: our initial rates are then kept up to date by reusing the last
+    //       rates evaluation of each step (the so-called FSAL property of the
+    //       Dormand-Prince method)...
+
+    double direction = (pVoiEnd >= pVoi)?1.0:-1.0;
+
+    if (mNeedInitialStep) {
+        computeRates(mVoi, mY, mK1);
+
+        if (!initialStep(direction)) {
+            pVoi = mVoi;
+
+            return;
+        }
+
+        mNeedInitialStep = false;
+    }
+
+    // Take as many steps as needed to reach pVoiEnd or, if we are to
+    // interpolate our solution, to go past it
+
+    while ((pVoiEnd-mVoi)*direction > 0.0) {
+        if (!step(pVoiEnd)) {
+            pVoi = mVoi;
+
+            return;
+        }
+    }
+
+    // Retrieve our states at pVoiEnd, using our dense output if we went past
+    // it
+
+    if ((mVoi == pVoiEnd) || !mHasDenseOutput)
+        memcpy(mStates, mY, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+    else
+        interpolate(pVoiEnd, mStates);
+
+    pVoi = pVoiEnd;
+
+    // Compute the rates one more time to get up to date values for the rates
+    // (see CvodeSolver::solve())
+
+    computeRates(pVoiEnd, mStates);
+}
+
+//==============================================================================
+
+OpenCOR::Solver::Statistics DormandPrinceSolver::statistics() const
+{
+    // Return our statistics, including the number of steps that got rejected
+    // by our error test
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::OdeSolver::statistics();
+
+    if (mNbOfErrorTestFailures)
+        res.insert(OpenCOR::Solver::NbOfErrorTestFailures, mNbOfErrorTestFailures);
+
+    return res;
+}
+
+//==============================================================================
+
+double DormandPrinceSolver::errorNorm(const double *pErrors, const double *pY,
+                                      const double *pYNew) const
+{
+    // Return the root mean square of the given errors, scaled using our
+    // tolerances
+
+    if (!mRatesStatesCount)
+        return 0.0;
+
+    double res = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scaledError = pErrors[i]/(mAbsoluteTolerance+mRelativeTolerance*qMax(fabs(pY[i]), fabs(pYNew[i])));
+
+        res += scaledError*scaledError;
+    }
+
+    return sqrt(res/mRatesStatesCount);
+}
+
+//==============================================================================
+
+bool DormandPrinceSolver::initialStep(const double &pDirection) const
+{
+    // Determine a good initial step using an explicit Euler step (see
+    // Hairer et al., section II.4), and make it our current step
+    // Note: we expect mK1 to contain the rates at our starting point...
+
+    double ratesNorm = 0.0;
+    double statesNorm = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scale = mAbsoluteTolerance+mRelativeTolerance*fabs(mY[i]);
+
+        ratesNorm += (mK1[i]/scale)*(mK1[i]/scale);
+        statesNorm += (mY[i]/scale)*(mY[i]/scale);
+    }
+
+    double res = ((ratesNorm <= 1.0e-10) || (statesNorm <= 1.0e-10))?
+                     1.0e-6:
+                     0.01*sqrt(statesNorm/ratesNorm);
+
+    if (mMaximumStep > 0.0)
+        res = qMin(res, mMaximumStep);
+
+    // Estimate our second derivative using an explicit Euler step
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        mYk[i] = mY[i]+pDirection*res*mK1[i];
+
+    computeRates(mVoi+pDirection*res, mYk, mK2);
+
+    double secondDerivativeNorm = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double scaledDifference = (mK2[i]-mK1[i])/(mAbsoluteTolerance+mRelativeTolerance*fabs(mY[i]));
+
+        secondDerivativeNorm += scaledDifference*scaledDifference;
+    }
+
+    secondDerivativeNorm = sqrt(secondDerivativeNorm)/res;
+
+    // Our initial step is such that our step times the maximum of our first
+    // and second derivatives norms is about 0.01
+
+    double derivativesNorm = qMax(secondDerivativeNorm, sqrt(ratesNorm));
+
+    res = qMin(100.0*res, (derivativesNorm <= 1.0e-15)?
+                              qMax(1.0e-6, 1.0e-3*res):
+                              pow(0.01/derivativesNorm, 0.2));
+
+    if (mMaximumStep > 0.0)
+        res = qMin(res, mMaximumStep);
+
+    // Make sure that our initial step is meaningful, i.e. that our model
+    // didn't produce a NaN or an infinite value
+
+    if (!qIsFinite(res)) {
+        const_cast<DormandPrinceSolver *>(this)->emitError(QObject::tr("the solution is not a finite number at %1").arg(mVoi));
+        // Note: we are const, hence we need to cast ourselves before we can
+        //       let people know about the error...
+
+        return false;
+    }
+
+    mStep = pDirection*res;
+
+    return true;
+}
+
+//==============================================================================
+
+bool DormandPrinceSolver::step(const double &pVoiEnd) const
+{
+    // Take one step, trying smaller steps until our error test passes
+
+    double direction = (mStep >= 0.0)?1.0:-1.0;
+    bool rejectedStep = false;
+
+    forever {
+        // Make sure that our step isn't too big and, if we are not to
+        // interpolate our solution, that it doesn't take us past pVoiEnd
+
+        double h = mStep;
+        double voiNew = mVoi+h;
+
+        if ((mMaximumStep > 0.0) && (fabs(h) > mMaximumStep)) {
+            h = direction*mMaximumStep;
+            voiNew = mVoi+h;
+        }
+
+        if (!mInterpolateSolution && ((mVoi+1.01*h-pVoiEnd)*direction > 0.0)) {
+            h = pVoiEnd-mVoi;
+            voiNew = pVoiEnd;
+        }
+
+        // Make sure that our step is still meaningful
+
+        if (!qIsFinite(h)) {
+            const_cast<DormandPrinceSolver *>(this)->emitError(QObject::tr("the solution is not a finite number at %1").arg(mVoi));
+
+            return false;
+        }
+
+        if (fabs(h) <= 10.0*std::numeric_limits<double>::epsilon()*fabs(mVoi)) {
+            const_cast<DormandPrinceSolver *>(this)->emitError(QObject::tr("the step became too small at %1").arg(mVoi));
+            // Note: we are const, hence we need to cast ourselves before we
+            //       can let people know about the error...
+
+            return false;
+        }
+
+        // Compute our different stages
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYk[i] = mY[i]+h*A21*mK1[i];
+
+        computeRates(mVoi+C2*h, mYk, mK2);
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYk[i] = mY[i]+h*(A31*mK1[i]+A32*mK2[i]);
+
+        computeRates(mVoi+C3*h, mYk, mK3);
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYk[i] = mY[i]+h*(A41*mK1[i]+A42*mK2[i]+A43*mK3[i]);
+
+        computeRates(mVoi+C4*h, mYk, mK4);
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYk[i] = mY[i]+h*(A51*mK1[i]+A52*mK2[i]+A53*mK3[i]+A54*mK4[i]);
+
+        computeRates(mVoi+C5*h, mYk, mK5);
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYk[i] = mY[i]+h*(A61*mK1[i]+A62*mK2[i]+A63*mK3[i]+A64*mK4[i]+A65*mK5[i]);
+
+        computeRates(voiNew, mYk, mK6);
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mYNew[i] = mY[i]+h*(A71*mK1[i]+A73*mK3[i]+A74*mK4[i]+A75*mK5[i]+A76*mK6[i]);
+
+        computeRates(voiNew, mYNew, mK7);
+
+        // Estimate our local error
+
+        for (int i = 0; i < mRatesStatesCount; ++i)
+            mErrors[i] = h*(E1*mK1[i]+E3*mK3[i]+E4*mK4[i]+E5*mK5[i]+E6*mK6[i]+E7*mK7[i]);
+
+        double error = errorNorm(mErrors, mY, mYNew);
+
+        if (!qIsFinite(error)) {
+            // Our model produced a NaN or an infinite value, so there is no
+            // point in trying a smaller step since our error test would
+            // never pass
+
+            const_cast<DormandPrinceSolver *>(this)->emitError(QObject::tr("the solution is not a finite number at %1").arg(mVoi));
+
+            return false;
+        }
+
+        double errorFactor = pow(error, Expo1);
+
+        if (error <= 1.0) {
+            // Our step is accepted, so determine our next step using our PI
+            // step size controller
+
+            double factor = qMax(Facc2, qMin(Facc1, errorFactor/pow(mPreviousErrorNorm, Beta)/Safe));
+            double hNew = h/factor;
+
+            if (rejectedStep)
+                hNew = direction*qMin(fabs(hNew), fabs(h));
+
+            mPreviousErrorNorm = qMax(error, MinimumErrorNorm);
+
+            // Compute the coefficients of our dense output
+
+            for (int i = 0; i < mRatesStatesCount; ++i) {
+                double yDifference = mYNew[i]-mY[i];
+                double b = h*mK1[i]-yDifference;
+
+                mDenseOutput1[i] = mY[i];
+                mDenseOutput2[i] = yDifference;
+                mDenseOutput3[i] = b;
+                mDenseOutput4[i] = yDifference-h*mK7[i]-b;
+                mDenseOutput5[i] = h*(D1*mK1[i]+D3*mK3[i]+D4*mK4[i]+D5*mK5[i]+D6*mK6[i]+D7*mK7[i]);
+            }
+
+            mPreviousVoi = mVoi;
+            mPreviousStep = h;
+            mHasDenseOutput = true;
+
+            // Move on to our new point, reusing our last rates evaluation as
+            // our first one for our next step
+
+            memcpy(mY, mYNew, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+            memcpy(mK1, mK7, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+
+            mVoi = voiNew;
+            mStep = hNew;
+
+            ++mNbOfSteps;
+
+            return true;
+        } else {
+            // Our step is rejected, so try again with a smaller step
+
+            mStep = h/qMin(Facc1, errorFactor/Safe);
+
+            rejectedStep = true;
+
+            ++mNbOfErrorTestFailures;
+        }
+    }
+}
+
+//==============================================================================
+
+void DormandPrinceSolver::interpolate(const double &pVoi, double *pStates) const
+{
+    // Compute our states at the given point using our dense output
+
+    double theta = (pVoi-mPreviousVoi)/mPreviousStep;
+    double oneMinusTheta = 1.0-theta;
+
+    for (int i = 0; i < mRatesStatesCount; ++i)
+        pStates[i] = mDenseOutput1[i]+theta*(mDenseOutput2[i]+oneMinusTheta*(mDenseOutput3[i]+theta*(mDenseOutput4[i]+oneMinusTheta*mDenseOutput5[i])));
+}
+
+//==============================================================================
+
+}   // namespace DormandPrinceSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
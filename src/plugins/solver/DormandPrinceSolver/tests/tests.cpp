@@ -0,0 +1,366 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Dormand-Prince solver tests
+//==============================================================================
+
+#include "../../../../tests/src/testsutils.h"
+
+//==============================================================================
+
+#include "dormandprincesolver.h"
+#include "plugin.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QPluginLoader>
+#include <QtMath>
+
+//==============================================================================
+
+static int computeOscillatorRates(double VOI, double *CONSTANTS, double *RATES,
+                                  double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A harmonic oscillator, i.e. x'' = -x, which solution is x = cos(t)
+
+    RATES[0] = STATES[1];
+    RATES[1] = -STATES[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeDecayRates(double VOI, double *CONSTANTS, double *RATES,
+                             double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // An exponential decay, i.e. y' = -y, which solution is y = exp(-t)
+
+    RATES[0] = -STATES[0];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeNanRates(double VOI, double *CONSTANTS, double *RATES,
+                           double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // An exponential decay, which rate becomes NaN after the time given by
+    // our first state
+
+    RATES[0] = (VOI < STATES[0])?-STATES[0]:qQNaN();
+
+    return 0;
+}
+
+//==============================================================================
+
+static const double Duration = 10.0;
+static const double PointInterval = 0.01;
+
+//==============================================================================
+
+static double dormandPrinceError(const double &pTolerance,
+                                 const bool &pInterpolateSolution,
+                                 qint64 &pNbOfRhsEvaluations)
+{
+    // Solve our harmonic oscillator using the Dormand-Prince solver and return
+    // the maximum error against its analytical solution
+
+    OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+    OpenCOR::Solver::Solver::Properties properties;
+
+    properties.insert(OpenCOR::DormandPrinceSolver::MaximumStepId, 0.0);
+    properties.insert(OpenCOR::DormandPrinceSolver::RelativeToleranceId, pTolerance);
+    properties.insert(OpenCOR::DormandPrinceSolver::AbsoluteToleranceId, pTolerance);
+    properties.insert(OpenCOR::DormandPrinceSolver::InterpolateSolutionId, pInterpolateSolution);
+
+    solver.setProperties(properties);
+
+    double constants[1];
+    double rates[2];
+    double states[2] = { 1.0, 0.0 };
+    double algebraic[1];
+
+    solver.initialize(0.0, 2, constants, rates, states, algebraic,
+                      computeOscillatorRates);
+
+    double voi = 0.0;
+    double res = 0.0;
+    int nbOfPoints = qRound(Duration/PointInterval);
+
+    for (int i = 1; i <= nbOfPoints; ++i) {
+        solver.solve(voi, i*PointInterval);
+
+        res = qMax(res, qMax(qAbs(states[0]-qCos(voi)),
+                             qAbs(states[1]+qSin(voi))));
+    }
+
+    pNbOfRhsEvaluations = solver.statistics().value(OpenCOR::Solver::NbOfRhsEvaluations);
+
+    return res;
+}
+
+//==============================================================================
+
+static bool fixedStepError(const QString &pSolverName, const double &pStep,
+                           double &pError, qint64 &pNbOfRhsEvaluations)
+{
+    // Solve our harmonic oscillator using the given fixed-step solver plugin
+    // and retrieve the maximum error against its analytical solution, if we
+    // could load that plugin
+
+    static const QString BuildDir = OpenCOR::fileContents(":build_directory").first();
+
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
+    static const QString PluginsDir = BuildDir+"/plugins/OpenCOR";
+#elif defined(Q_OS_MAC)
+    static const QString PluginsDir = BuildDir+"/OpenCOR.app/Contents/PlugIns/OpenCOR";
+#else
+    #error Unsupported platform
+#endif
+
+    QPluginLoader pluginLoader(PluginsDir+QDir::separator()+OpenCOR::PluginPrefix+pSolverName+OpenCOR::PluginExtension);
+    OpenCOR::SolverInterface *solverInterface = qobject_cast<OpenCOR::SolverInterface *>(pluginLoader.instance());
+
+    if (!solverInterface)
+        return false;
+
+    // Use the default value of all the solver's properties, except for its
+    // step
+
+    OpenCOR::Solver::Solver::Properties properties;
+
+    foreach (const OpenCOR::Solver::Property &property, solverInterface->solverProperties())
+        properties.insert(property.id(), property.defaultValue());
+
+    properties.insert("Step", pStep);
+
+    OpenCOR::Solver::OdeSolver *solver = static_cast<OpenCOR::Solver::OdeSolver *>(solverInterface->solverInstance());
+
+    solver->setProperties(properties);
+
+    double constants[1];
+    double rates[2];
+    double states[2] = { 1.0, 0.0 };
+    double algebraic[1];
+
+    solver->initialize(0.0, 2, constants, rates, states, algebraic,
+                       computeOscillatorRates);
+
+    double voi = 0.0;
+    int nbOfPoints = qRound(Duration/PointInterval);
+
+    pError = 0.0;
+
+    for (int i = 1; i <= nbOfPoints; ++i) {
+        solver->solve(voi, i*PointInterval);
+
+        pError = qMax(pError, qMax(qAbs(states[0]-qCos(voi)),
+                                   qAbs(states[1]+qSin(voi))));
+    }
+
+    pNbOfRhsEvaluations = solver->statistics().value(OpenCOR::Solver::NbOfRhsEvaluations);
+
+    delete solver;
+
+    return true;
+}
+
+//==============================================================================
+
+void Tests::accuracyTests()
+{
+    // Check that the Dormand-Prince solver gets more accurate as we tighten its
+    // tolerances and that it remains within a reasonable distance of them
+
+    qint64 nbOfRhsEvaluations;
+    double previousError = 1.0;
+
+    foreach (double tolerance, QList<double>() << 1.0e-3 << 1.0e-5 << 1.0e-7 << 1.0e-9) {
+        double error = dormandPrinceError(tolerance, true, nbOfRhsEvaluations);
+
+        QVERIFY(error < 100.0*tolerance);
+        QVERIFY(error < previousError);
+
+        previousError = error;
+    }
+}
+
+//==============================================================================
+
+void Tests::denseOutputTests()
+{
+    // Check that interpolating the solution is nearly as accurate as stepping
+    // exactly to each output point, while requiring far fewer evaluations
+
+    qint64 interpolatedNbOfRhsEvaluations;
+    qint64 exactNbOfRhsEvaluations;
+
+    double interpolatedError = dormandPrinceError(1.0e-7, true, interpolatedNbOfRhsEvaluations);
+    double exactError = dormandPrinceError(1.0e-7, false, exactNbOfRhsEvaluations);
+
+    QVERIFY(interpolatedError < 1.0e-5);
+    QVERIFY(exactError < 1.0e-5);
+    QVERIFY(interpolatedNbOfRhsEvaluations < exactNbOfRhsEvaluations);
+}
+
+//==============================================================================
+
+void Tests::backwardIntegrationTests()
+{
+    // Check that we can integrate backward in time
+
+    OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+    OpenCOR::Solver::Solver::Properties properties;
+
+    properties.insert(OpenCOR::DormandPrinceSolver::MaximumStepId, 0.0);
+    properties.insert(OpenCOR::DormandPrinceSolver::RelativeToleranceId, 1.0e-8);
+    properties.insert(OpenCOR::DormandPrinceSolver::AbsoluteToleranceId, 1.0e-8);
+    properties.insert(OpenCOR::DormandPrinceSolver::InterpolateSolutionId, true);
+
+    solver.setProperties(properties);
+
+    double constants[1];
+    double rates[1];
+    double states[1] = { 1.0 };
+    double algebraic[1];
+
+    solver.initialize(0.0, 1, constants, rates, states, algebraic,
+                      computeDecayRates);
+
+    double voi = 0.0;
+
+    for (int i = 1; i <= 100; ++i)
+        solver.solve(voi, -0.05*i);
+
+    QCOMPARE(voi, -5.0);
+    QVERIFY(qAbs(states[0]-qExp(5.0))/qExp(5.0) < 1.0e-6);
+}
+
+//==============================================================================
+
+void Tests::nanRatesTests()
+{
+    // Check that we report an error rather than hang when our model produces
+    // a NaN, be it from the start (i.e. when computing our initial step) or
+    // in the middle of our simulation (i.e. when computing a step)
+
+    OpenCOR::Solver::Solver::Properties properties;
+
+    properties.insert(OpenCOR::DormandPrinceSolver::MaximumStepId, 0.0);
+    properties.insert(OpenCOR::DormandPrinceSolver::RelativeToleranceId, 1.0e-7);
+    properties.insert(OpenCOR::DormandPrinceSolver::AbsoluteToleranceId, 1.0e-7);
+    properties.insert(OpenCOR::DormandPrinceSolver::InterpolateSolutionId, true);
+
+    foreach (double nanVoi, QList<double>() << 0.0 << 0.5) {
+        OpenCOR::DormandPrinceSolver::DormandPrinceSolver solver;
+        QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+
+        solver.setProperties(properties);
+
+        double constants[1];
+        double rates[1];
+        double states[1] = { nanVoi };
+        double algebraic[1];
+
+        solver.initialize(0.0, 1, constants, rates, states, algebraic,
+                          computeNanRates);
+
+        double voi = 0.0;
+
+        solver.solve(voi, 1.0);
+
+        QCOMPARE(errorSpy.count(), 1);
+        QVERIFY(errorSpy.first().first().toString().startsWith("the solution is not a finite number at "));
+        QVERIFY(voi <= nanVoi);
+    }
+}
+
+//==============================================================================
+
+void Tests::benchmarkTests()
+{
+    // Check that, for a given accuracy, the Dormand-Prince solver requires
+    // fewer right-hand side evaluations than any of our fixed-step solvers
+    // Note: this requires our fixed-step solver plugins to have been built...
+
+    static const QList<double> Tolerances = QList<double>() << 1.0e-3 << 1.0e-4
+                                                            << 1.0e-5 << 1.0e-6
+                                                            << 1.0e-7 << 1.0e-8
+                                                            << 1.0e-9 << 1.0e-10;
+
+    QList<double> dormandPrinceErrors = QList<double>();
+    QList<qint64> dormandPrinceNbOfRhsEvaluations = QList<qint64>();
+
+    foreach (double tolerance, Tolerances) {
+        qint64 nbOfRhsEvaluations;
+
+        dormandPrinceErrors << dormandPrinceError(tolerance, true, nbOfRhsEvaluations);
+        dormandPrinceNbOfRhsEvaluations << nbOfRhsEvaluations;
+    }
+
+    foreach (const QString &solverName, QStringList() << "ForwardEulerSolver"
+                                                      << "HeunSolver"
+                                                      << "SecondOrderRungeKuttaSolver"
+                                                      << "FourthOrderRungeKuttaSolver") {
+        foreach (double step, QList<double>() << 1.0e-2 << 1.0e-3) {
+            double error;
+            qint64 nbOfRhsEvaluations;
+
+            QVERIFY(fixedStepError(solverName, step, error, nbOfRhsEvaluations));
+
+            // Use the loosest tolerance for which the Dormand-Prince solver is
+            // at least as accurate as our fixed-step solver, if any
+
+            for (int i = 0, iMax = Tolerances.count(); i < iMax; ++i) {
+                if (dormandPrinceErrors[i] <= error) {
+                    QVERIFY(dormandPrinceNbOfRhsEvaluations[i] < nbOfRhsEvaluations);
+
+                    break;
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
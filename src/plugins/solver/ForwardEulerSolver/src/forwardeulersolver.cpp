@@ -76,27 +76,52 @@ void ForwardEulerSolver::solve(double &pVoi, const double &pVoiEnd) const
     int stepNumber = 0;
     double realStep = mStep;
 
+    startEventDetection(pVoi);
+
     while (pVoi != pVoiEnd) {
         // Check that the time step is correct
 
         if (pVoi+realStep > pVoiEnd)
             realStep = pVoiEnd-pVoi;
 
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
         // Compute f(t_n, Y_n)
 
-        mComputeRates(pVoi, mConstants, mRates, mStates, mAlgebraic);
+        computeRates(pVoi, mStates);
 
         // Compute Y_n+1
 
         for (int i = 0; i < mRatesStatesCount; ++i)
             mStates[i] += realStep*mRates[i];
 
-        // Advance through time
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
+
+        if (eventStatus == EventLocated) {
+            continue;
+        }
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        ++mNbOfSteps;
 
-        if (realStep != mStep)
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+        } else if (realStep != mStep) {
             pVoi = pVoiEnd;
-        else
+        } else {
             pVoi = voiStart+(++stepNumber)*mStep;
+        }
     }
 }
 
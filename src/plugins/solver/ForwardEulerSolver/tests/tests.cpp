@@ -0,0 +1,162 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Forward Euler solver tests
+//==============================================================================
+
+#include "forwardeulersolver.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+static int computeVoiEventRates(double VOI, double *CONSTANTS, double *RATES,
+                                double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(STATES);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A state which rate doubles at t = 0.5, i.e. with y(0) = 0:
+    //   y = t            if t < 0.5
+    //   y = 0.5+2(t-0.5) otherwise
+
+    RATES[0] = (VOI < 0.5)?1.0:2.0;
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeVoiEventRootInformation(double VOI, double *CONSTANTS,
+                                          double *RATES, double *STATES,
+                                          double *ALGEBRAIC, double *CONDVAR)
+{
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(RATES);
+    Q_UNUSED(STATES);
+    Q_UNUSED(ALGEBRAIC);
+
+    CONDVAR[0] = VOI-0.5;
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeStateEventRates(double VOI, double *CONSTANTS, double *RATES,
+                                  double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A state which rate doubles once it reaches 0.5, i.e. with y(0) = 0 and
+    // the same solution as above
+
+    RATES[0] = (STATES[0] < 0.5)?1.0:2.0;
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeStateEventRootInformation(double VOI, double *CONSTANTS,
+                                            double *RATES, double *STATES,
+                                            double *ALGEBRAIC, double *CONDVAR)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(RATES);
+    Q_UNUSED(ALGEBRAIC);
+
+    CONDVAR[0] = STATES[0]-0.5;
+
+    return 0;
+}
+
+//==============================================================================
+
+static void solveEventModel(OpenCOR::Solver::OdeSolver::ComputeRatesFunction pComputeRates,
+                            OpenCOR::Solver::OdeSolver::ComputeRootInformationFunction pComputeRootInformation)
+{
+    // Solve the given model, using a step which doesn't fall on its event, and
+    // check that we stop at that event and get the exact solution (since our
+    // rates are piecewise constant)
+
+    OpenCOR::ForwardEulerSolver::ForwardEulerSolver solver;
+    OpenCOR::Solver::Solver::Properties properties;
+    double constants[1];
+    double rates[1];
+    double states[1] = { 0.0 };
+    double algebraic[1];
+
+    properties.insert(OpenCOR::ForwardEulerSolver::StepId, 0.07);
+
+    solver.setProperties(properties);
+    solver.setRootInformation(1, pComputeRootInformation);
+
+    solver.initialize(0.0, 1, constants, rates, states, algebraic,
+                      pComputeRates);
+
+    double voi = 0.0;
+
+    for (int i = 1; i <= 10; ++i) {
+        solver.solve(voi, 0.1*i);
+
+        QCOMPARE(voi, 0.1*i);
+        QVERIFY(qAbs(states[0]-((voi < 0.5)?voi:0.5+2.0*(voi-0.5))) < 1.0e-6);
+    }
+
+    // Check that we didn't need more than a few extra steps to stop at our
+    // event, i.e. that we didn't get stuck just before it
+
+    QVERIFY(solver.statistics().value(OpenCOR::Solver::NbOfSteps) < 30);
+}
+
+//==============================================================================
+
+void Tests::voiEventTests()
+{
+    // Check that we stop at an event that only depends on the variable of
+    // integration, e.g. the start of a stimulus
+
+    solveEventModel(computeVoiEventRates, computeVoiEventRootInformation);
+}
+
+//==============================================================================
+
+void Tests::stateEventTests()
+{
+    // Check that we stop at an event that depends on our states, e.g. a
+    // membrane potential crossing a threshold
+
+    solveEventModel(computeStateEventRates, computeStateEventRootInformation);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -113,6 +113,8 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
     double realStep = mStep;
     double realHalfStep = 0.5*realStep;
 
+    startEventDetection(pVoi);
+
     while (pVoi != pVoiEnd) {
         // Check that the time step is correct
 
@@ -121,9 +123,13 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
             realHalfStep = 0.5*realStep;
         }
 
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
         // Compute f(t_n, Y_n)
 
-        mComputeRates(pVoi, mConstants, mRates, mStates, mAlgebraic);
+        computeRates(pVoi, mStates);
 
         // Compute k1 and Yk1
 
@@ -134,7 +140,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute f(t_n + h / 2, Y_n + k1 / 2)
 
-        mComputeRates(pVoi+realHalfStep, mConstants, mRates, mYk123, mAlgebraic);
+        computeRates(pVoi+realHalfStep, mYk123);
 
         // Compute k2 and Yk2
 
@@ -145,7 +151,7 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute f(t_n + h / 2, Y_n + k2 / 2)
 
-        mComputeRates(pVoi+realHalfStep, mConstants, mRates, mYk123, mAlgebraic);
+        computeRates(pVoi+realHalfStep, mYk123);
 
         // Compute k3 and Yk3
 
@@ -156,19 +162,41 @@ void FourthOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute f(t_n + h, Y_n + k3)
 
-        mComputeRates(pVoi+realStep, mConstants, mRates, mYk123, mAlgebraic);
+        computeRates(pVoi+realStep, mYk123);
 
         // Compute k4 and therefore Y_n+1
 
         for (int i = 0; i < mRatesStatesCount; ++i)
             mStates[i] += realStep*(OneOverSix*(mK1[i]+mRates[i])+OneOverThree*mK23[i]);
 
-        // Advance through time
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
 
-        if (realStep != mStep)
+        if (eventStatus == EventLocated) {
+            realHalfStep = 0.5*realStep;
+
+            continue;
+        }
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        ++mNbOfSteps;
+
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+            realHalfStep = 0.5*realStep;
+        } else if (realStep != mStep) {
             pVoi = pVoiEnd;
-        else
+        } else {
             pVoi = voiStart+(++stepNumber)*mStep;
+        }
     }
 }
 
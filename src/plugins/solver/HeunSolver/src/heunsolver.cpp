@@ -97,6 +97,8 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
     double realStep = mStep;
     double realHalfStep = 0.5*realStep;
 
+    startEventDetection(pVoi);
+
     while (pVoi != pVoiEnd) {
         // Check that the time step is correct
 
@@ -105,9 +107,13 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
             realHalfStep = 0.5*realStep;
         }
 
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
         // Compute f(t_n, Y_n)
 
-        mComputeRates(pVoi, mConstants, mRates, mStates, mAlgebraic);
+        computeRates(pVoi, mStates);
 
         // Compute k and Yk
 
@@ -118,19 +124,41 @@ void HeunSolver::solve(double &pVoi, const double &pVoiEnd) const
 
         // Compute f(t_n + h, Y_n + k)
 
-        mComputeRates(pVoi+realStep, mConstants, mRates, mYk, mAlgebraic);
+        computeRates(pVoi+realStep, mYk);
 
         // Compute Y_n+1
 
         for (int i = 0; i < mRatesStatesCount; ++i)
             mStates[i] += realHalfStep*(mK[i]+mRates[i]);
 
-        // Advance through time
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
 
-        if (realStep != mStep)
+        if (eventStatus == EventLocated) {
+            realHalfStep = 0.5*realStep;
+
+            continue;
+        }
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        ++mNbOfSteps;
+
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+            realHalfStep = 0.5*realStep;
+        } else if (realStep != mStep) {
             pVoi = pVoiEnd;
-        else
+        } else {
             pVoi = voiStart+(++stepNumber)*mStep;
+        }
     }
 }
 
@@ -23,6 +23,14 @@
         <source>the &apos;interpolate solution&apos; property value could not be retrieved</source>
         <translation>la valeur de la propriété &apos;interpoler solution&apos; n&apos;a pas pu être retrouvée</translation>
     </message>
+    <message>
+        <source>the &apos;number of threads&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;nombre de threads&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;number of threads&apos; property must have a value greater than or equal to 1</source>
+        <translation>la propriété &apos;nombre de threads&apos; doit avoir une valeur plus grande que ou égale à 1</translation>
+    </message>
     <message>
         <source>the &apos;linear solver&apos; property value could not be retrieved</source>
         <translation>la valeur de la propriété &apos;solveur linéaire&apos; n&apos;a pas pu être retrouvée</translation>
@@ -51,5 +59,17 @@
         <source>the &apos;absolute tolerance&apos; property must have a value greater than or equal to 0</source>
         <translation>la propriété &apos;tolérance absolue&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
     </message>
+    <message>
+        <source>the &apos;preconditioner&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;préconditionneur&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;automatic half-bandwidths&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;demi largeurs de bande automatiques&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;reorder states&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;réordonner les états&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
 </context>
 </TS>
@@ -21,11 +21,14 @@ limitations under the License.
 //==============================================================================
 
 #include "idasolver.h"
+#include "sparsitypattern.h"
+#include "threadednvector.h"
 
 //==============================================================================
 
 #include "ida/ida.h"
 #include "ida/ida_band.h"
+#include "ida/ida_bbdpre.h"
 #include "ida/ida_dense.h"
 #include "ida/ida_spbcgs.h"
 #include "ida/ida_spgmr.h"
@@ -45,28 +48,26 @@ int residualFunction(double pVoi, N_Vector pStates, N_Vector pRates,
 
     IdaSolverUserData *userData = static_cast<IdaSolverUserData *>(pUserData);
 
-    double *rates     = N_VGetArrayPointer(pRates);
-    double *states    = N_VGetArrayPointer(pStates);
-    double *residuals = N_VGetArrayPointer(pResiduals);
+    static_cast<const IdaSolver *>(userData->solver())->computeResiduals(pVoi,
+                                                                         N_VGetArrayPointer(pStates),
+                                                                         N_VGetArrayPointer(pRates),
+                                                                         N_VGetArrayPointer(pResiduals));
 
-    userData->computeRootInformation()(pVoi, userData->constants(), rates,
-                                       userData->oldRates(), states,
-                                       userData->oldStates(),
-                                       userData->algebraic(),
-                                       userData->condVar());
+    return 0;
+}
 
-    userData->computeEssentialVariables()(pVoi, userData->constants(), rates,
-                                          userData->oldRates(), states,
-                                          userData->oldStates(),
-                                          userData->algebraic(),
-                                          userData->condVar());
+//==============================================================================
 
-    userData->computeResiduals()(pVoi, userData->constants(), rates,
-                                 userData->oldRates(), states,
-                                 userData->oldStates(), userData->algebraic(),
-                                 userData->condVar(), residuals);
+int localResidualFunction(long int pN, double pVoi, N_Vector pStates,
+                          N_Vector pRates, N_Vector pResiduals,
+                          void *pUserData)
+{
+    Q_UNUSED(pN);
 
-    return 0;
+    // Compute the residual function for our banded preconditioner, which
+    // approximates the Jacobian of the whole of our residual function
+
+    return residualFunction(pVoi, pStates, pRates, pResiduals, pUserData);
 }
 
 //==============================================================================
@@ -78,18 +79,30 @@ int rootFindingFunction(double pVoi, N_Vector pStates, N_Vector pRates,
 
     IdaSolverUserData *userData = static_cast<IdaSolverUserData *>(pUserData);
 
-    userData->computeRootInformation()(pVoi, userData->constants(),
-                                       N_VGetArrayPointer(pRates),
-                                       userData->oldRates(),
-                                       N_VGetArrayPointer(pStates),
-                                       userData->oldStates(),
-                                       userData->algebraic(), pRoots);
+    static_cast<const IdaSolver *>(userData->solver())->computeRootInformation(pVoi,
+                                                                               N_VGetArrayPointer(pStates),
+                                                                               N_VGetArrayPointer(pRates),
+                                                                               pRoots);
 
     return 0;
 }
 
 //==============================================================================
 
+void sparsityFunction(const double &pVoi, double *pVariables,
+                      double *pResiduals, void *pUserData)
+{
+    Q_UNUSED(pVariables);
+
+    // Compute our residuals
+    // Note: pVariables is either our states or our rates, which have been
+    //       perturbed in place...
+
+    static_cast<const IdaSolver *>(pUserData)->computeSparsityResiduals(pVoi, pResiduals);
+}
+
+//==============================================================================
+
 void errorHandler(int pErrorCode, const char *pModule, const char *pFunction,
                   char *pErrorMessage, void *pUserData)
 {
@@ -110,7 +123,8 @@ IdaSolverUserData::IdaSolverUserData(double *pConstants, double *pOldRates,
                                      double *pCondVar,
                                      Solver::DaeSolver::ComputeEssentialVariablesFunction pComputeEssentialVariables,
                                      Solver::DaeSolver::ComputeResidualsFunction pComputeResiduals,
-                                     Solver::DaeSolver::ComputeRootInformationFunction pComputeRootInformation) :
+                                     Solver::DaeSolver::ComputeRootInformationFunction pComputeRootInformation,
+                                     const Solver::DaeSolver *pSolver) :
     mConstants(pConstants),
     mOldRates(pOldRates),
     mOldStates(pOldStates),
@@ -118,7 +132,8 @@ IdaSolverUserData::IdaSolverUserData(double *pConstants, double *pOldRates,
     mCondVar(pCondVar),
     mComputeEssentialVariables(pComputeEssentialVariables),
     mComputeResiduals(pComputeResiduals),
-    mComputeRootInformation(pComputeRootInformation)
+    mComputeRootInformation(pComputeRootInformation),
+    mSolver(pSolver)
 {
 }
 
@@ -196,12 +211,27 @@ Solver::DaeSolver::ComputeRootInformationFunction IdaSolverUserData::computeRoot
 
 //==============================================================================
 
+const Solver::DaeSolver * IdaSolverUserData::solver() const
+{
+    // Return our solver
+
+    return mSolver;
+}
+
+//==============================================================================
+
 IdaSolver::IdaSolver() :
     mSolver(0),
     mRatesVector(0),
     mStatesVector(0),
     mUserData(0),
-    mInterpolateSolution(InterpolateSolutionDefaultValue)
+    mInterpolateSolution(InterpolateSolutionDefaultValue),
+    mDirectLinearSolver(false),
+    mOrdering(QVector<int>()),
+    mOriginalRates(0),
+    mOriginalStates(0),
+    mOriginalResiduals(0),
+    mPreviousStatistics(OpenCOR::Solver::Statistics())
 {
 }
 
@@ -222,6 +252,10 @@ IdaSolver::~IdaSolver()
     IDAFree(&mSolver);
 
     delete mUserData;
+
+    delete[] mOriginalRates;
+    delete[] mOriginalStates;
+    delete[] mOriginalResiduals;
 }
 
 //==============================================================================
@@ -242,10 +276,15 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
         double maximumStep = MaximumStepDefaultValue;
         int maximumNumberOfSteps = MaximumNumberOfStepsDefaultValue;
         QString linearSolver = LinearSolverDefaultValue;
+        QString preconditioner = PreconditionerDefaultValue;
+        bool needUpperAndLowerHalfBandwidths = false;
+        bool automaticHalfBandwidths = AutomaticHalfBandwidthsDefaultValue;
         int upperHalfBandwidth = UpperHalfBandwidthDefaultValue;
         int lowerHalfBandwidth = LowerHalfBandwidthDefaultValue;
+        bool reorderStates = ReorderStatesDefaultValue;
         double relativeTolerance = RelativeToleranceDefaultValue;
         double absoluteTolerance = AbsoluteToleranceDefaultValue;
+        int numberOfThreads = NumberOfThreadsDefaultValue;
 
         if (mProperties.contains(MaximumStepId)) {
             maximumStep = mProperties.value(MaximumStepId).toDouble();
@@ -266,35 +305,84 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
         if (mProperties.contains(LinearSolverId)) {
             linearSolver = mProperties.value(LinearSolverId).toString();
 
-            if (!linearSolver.compare(BandedLinearSolver)) {
-                if (mProperties.contains(UpperHalfBandwidthId)) {
-                    upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
+            if (!linearSolver.compare(DenseLinearSolver)) {
+                // We are dealing with a dense linear solver, so nothing more
+                // to do
+            } else if (!linearSolver.compare(BandedLinearSolver)) {
+                // We are dealing with a banded linear solver, so we need both
+                // an upper and a lower half bandwidth
 
-                    if (   (upperHalfBandwidth < 0)
-                        || (upperHalfBandwidth >= pRatesStatesCount)) {
-                        emit error(QObject::tr("the 'upper half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+                needUpperAndLowerHalfBandwidths = true;
+            } else {
+                // We are dealing with a GMRES/Bi-CGStab/TFQMR linear solver,
+                // so retrieve and check its preconditioner
 
-                        return;
-                    }
+                if (mProperties.contains(PreconditionerId)) {
+                    preconditioner = mProperties.value(PreconditionerId).toString();
+                } else {
+                    emit error(QObject::tr("the 'preconditioner' property value could not be retrieved"));
+
+                    return;
+                }
+
+                if (!preconditioner.compare(BandedPreconditioner)) {
+                    // We are dealing with a banded preconditioner, so we need
+                    // both an upper and a lower half bandwidth
+
+                    needUpperAndLowerHalfBandwidths = true;
+                }
+            }
+
+            if (needUpperAndLowerHalfBandwidths) {
+                if (mProperties.contains(AutomaticHalfBandwidthsId)) {
+                    automaticHalfBandwidths = mProperties.value(AutomaticHalfBandwidthsId).toBool();
                 } else {
-                    emit error(QObject::tr("the 'upper half-bandwidth' property value could not be retrieved"));
+                    emit error(QObject::tr("the 'automatic half-bandwidths' property value could not be retrieved"));
 
                     return;
                 }
 
-                if (mProperties.contains(LowerHalfBandwidthId)) {
-                    lowerHalfBandwidth = mProperties.value(LowerHalfBandwidthId).toInt();
+                if (automaticHalfBandwidths) {
+                    // Our half bandwidths are to be determined automatically,
+                    // so check whether we can also reorder our states
 
-                    if (   (lowerHalfBandwidth < 0)
-                        || (lowerHalfBandwidth >= pRatesStatesCount)) {
-                        emit error(QObject::tr("the 'lower half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+                    if (mProperties.contains(ReorderStatesId)) {
+                        reorderStates = mProperties.value(ReorderStatesId).toBool();
+                    } else {
+                        emit error(QObject::tr("the 'reorder states' property value could not be retrieved"));
 
                         return;
                     }
                 } else {
-                    emit error(QObject::tr("the 'lower half-bandwidth' property value could not be retrieved"));
+                    if (mProperties.contains(UpperHalfBandwidthId)) {
+                        upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
 
-                    return;
+                        if (   (upperHalfBandwidth < 0)
+                            || (upperHalfBandwidth >= pRatesStatesCount)) {
+                            emit error(QObject::tr("the 'upper half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+
+                            return;
+                        }
+                    } else {
+                        emit error(QObject::tr("the 'upper half-bandwidth' property value could not be retrieved"));
+
+                        return;
+                    }
+
+                    if (mProperties.contains(LowerHalfBandwidthId)) {
+                        lowerHalfBandwidth = mProperties.value(LowerHalfBandwidthId).toInt();
+
+                        if (   (lowerHalfBandwidth < 0)
+                            || (lowerHalfBandwidth >= pRatesStatesCount)) {
+                            emit error(QObject::tr("the 'lower half-bandwidth' property must have a value between 0 and %1").arg(pRatesStatesCount-1));
+
+                            return;
+                        }
+                    } else {
+                        emit error(QObject::tr("the 'lower half-bandwidth' property value could not be retrieved"));
+
+                        return;
+                    }
                 }
             }
         } else {
@@ -339,6 +427,20 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
             return;
         }
 
+        if (mProperties.contains(NumberOfThreadsId)) {
+            numberOfThreads = mProperties.value(NumberOfThreadsId).toInt();
+
+            if (numberOfThreads < 1) {
+                emit error(QObject::tr("the 'number of threads' property must have a value greater than or equal to 1"));
+
+                return;
+            }
+        } else {
+            emit error(QObject::tr("the 'number of threads' property value could not be retrieved"));
+
+            return;
+        }
+
         // Initialise the DAE solver itself
 
         OpenCOR::Solver::DaeSolver::initialize(pVoiStart, pVoiEnd,
@@ -350,10 +452,77 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
                                                pComputeRootInformation,
                                                pComputeStateInformation);
 
-        // Create the states vector
+        // Create our user data
+
+        mUserData = new IdaSolverUserData(pConstants, mOldRates, mOldStates,
+                                          pAlgebraic, pCondVar,
+                                          pComputeEssentialVariables,
+                                          pComputeResiduals,
+                                          pComputeRootInformation, this);
+
+        // Determine our half bandwidths, if needed, from the sparsity pattern
+        // of our residuals with respect to both our states and our rates, and
+        // see whether reordering our states would reduce them
+        // Note: we only reorder our states if it reduces our bandwidth, in
+        //       which case our residuals get reordered the same way...
+
+        if (needUpperAndLowerHalfBandwidths && automaticHalfBandwidths) {
+            OpenCOR::Solver::SparsityPattern sparsityPattern(pRatesStatesCount);
+
+            sparsityPattern.addDependencies(sparsityFunction, pVoiStart, pStates, this);
+            sparsityPattern.addDependencies(sparsityFunction, pVoiStart, pRates, this);
+
+            sparsityPattern.halfBandwidths(sparsityPattern.identityOrdering(),
+                                           upperHalfBandwidth, lowerHalfBandwidth);
+
+            if (reorderStates) {
+                QVector<int> ordering = sparsityPattern.bandwidthReducingOrdering();
+                int reorderedUpperHalfBandwidth;
+                int reorderedLowerHalfBandwidth;
+
+                sparsityPattern.halfBandwidths(ordering,
+                                               reorderedUpperHalfBandwidth,
+                                               reorderedLowerHalfBandwidth);
 
-        mRatesVector  = N_VMake_Serial(pRatesStatesCount, pRates);
-        mStatesVector = N_VMake_Serial(pRatesStatesCount, pStates);
+                if (  reorderedUpperHalfBandwidth+reorderedLowerHalfBandwidth
+                    < upperHalfBandwidth+lowerHalfBandwidth) {
+                    mOrdering = ordering;
+
+                    upperHalfBandwidth = reorderedUpperHalfBandwidth;
+                    lowerHalfBandwidth = reorderedLowerHalfBandwidth;
+                }
+            }
+        }
+
+        // Create the states vector
+        // Note #1: it is threaded if more than one thread was requested, in
+        //          which case IDA's vector operations get split between
+        //          threads...
+        // Note #2: if we reorder our states, then our rates and states vectors
+        //          cannot use pRates and pStates directly, and we need some
+        //          arrays to compute our residuals and root information using
+        //          our rates and states in their original order...
+
+        if (mOrdering.isEmpty()) {
+            mRatesVector  = OpenCOR::Solver::makeNVector(pRatesStatesCount, pRates,
+                                                         numberOfThreads);
+            mStatesVector = OpenCOR::Solver::makeNVector(pRatesStatesCount, pStates,
+                                                         numberOfThreads);
+        } else {
+            mRatesVector  = OpenCOR::Solver::newNVector(pRatesStatesCount,
+                                                        numberOfThreads);
+            mStatesVector = OpenCOR::Solver::newNVector(pRatesStatesCount,
+                                                        numberOfThreads);
+
+            OpenCOR::Solver::reorderValues(mOrdering, pRates,
+                                           N_VGetArrayPointer(mRatesVector));
+            OpenCOR::Solver::reorderValues(mOrdering, pStates,
+                                           N_VGetArrayPointer(mStatesVector));
+
+            mOriginalRates = new double[pRatesStatesCount];
+            mOriginalStates = new double[pRatesStatesCount];
+            mOriginalResiduals = new double[pRatesStatesCount];
+        }
 
         // Create the IDA solver
 
@@ -375,26 +544,39 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
 
         // Set some user data
 
-        mUserData = new IdaSolverUserData(pConstants, mOldRates, mOldStates,
-                                          pAlgebraic, pCondVar,
-                                          pComputeEssentialVariables,
-                                          pComputeResiduals,
-                                          pComputeRootInformation);
-
         IDASetUserData(mSolver, mUserData);
 
         // Set the linear solver
 
-        if (!linearSolver.compare(DenseLinearSolver))
+        mDirectLinearSolver =    !linearSolver.compare(DenseLinearSolver)
+                              || !linearSolver.compare(BandedLinearSolver);
+
+        if (!linearSolver.compare(DenseLinearSolver)) {
             IDADense(mSolver, pRatesStatesCount);
-        else if (!linearSolver.compare(BandedLinearSolver))
+        } else if (!linearSolver.compare(BandedLinearSolver)) {
             IDABand(mSolver, pRatesStatesCount, upperHalfBandwidth, lowerHalfBandwidth);
-        else if (!linearSolver.compare(GmresLinearSolver))
-            IDASpgmr(mSolver, 0);
-        else if (!linearSolver.compare(BiCgStabLinearSolver))
-            IDASpbcg(mSolver, 0);
-        else
-            IDASptfqmr(mSolver, 0);
+        } else {
+            // We are dealing with a GMRES/Bi-CGStab/TFQMR linear solver
+
+            if (!linearSolver.compare(GmresLinearSolver))
+                IDASpgmr(mSolver, 0);
+            else if (!linearSolver.compare(BiCgStabLinearSolver))
+                IDASpbcg(mSolver, 0);
+            else
+                IDASptfqmr(mSolver, 0);
+
+            // Use a banded preconditioner, if requested
+            // Note: IDA doesn't have a banded preconditioner as such, but its
+            //       band-block-diagonal one is a banded preconditioner when it
+            //       has only one block, i.e. when it is used serially...
+
+            if (!preconditioner.compare(BandedPreconditioner)) {
+                IDABBDPrecInit(mSolver, pRatesStatesCount,
+                               upperHalfBandwidth, lowerHalfBandwidth,
+                               upperHalfBandwidth, lowerHalfBandwidth,
+                               0.0, localResidualFunction, 0);
+            }
+        }
 
         // Set the maximum step
 
@@ -408,24 +590,58 @@ void IdaSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
 
         IDASStolerances(mSolver, relativeTolerance, absoluteTolerance);
     } else {
-        // Reinitialise the IDA object
+        // Reinitialise the IDA object, after keeping track of its current
+        // statistics since they are about to be reset
+
+        // Note: if we reorder our states, then our rates and states vectors
+        //       don't use pRates and pStates directly, so we need to update
+        //       them with the (possibly modified) values of our rates and
+        //       states...
+
+        OpenCOR::Solver::addStatistics(mPreviousStatistics, idaStatistics());
+
+        if (!mOrdering.isEmpty()) {
+            OpenCOR::Solver::reorderValues(mOrdering, pRates,
+                                           N_VGetArrayPointer(mRatesVector));
+            OpenCOR::Solver::reorderValues(mOrdering, pStates,
+                                           N_VGetArrayPointer(mStatesVector));
+        }
 
         IDAReInit(mSolver, pVoiStart, mStatesVector, mRatesVector);
     }
 
     // Compute the model's (new) initial conditions
+    // Note: if we reorder our states, then our state information must be
+    //       reordered too and our (new) initial conditions must be put back in
+    //       their original order...
 
     double *id = new double[pRatesStatesCount];
 
     pComputeStateInformation(id);
 
-    N_Vector idVector = N_VMake_Serial(pRatesStatesCount, id);
+    N_Vector idVector = OpenCOR::Solver::newNVector(pRatesStatesCount,
+                                                    OpenCOR::Solver::nVectorNbOfThreads(mStatesVector));
+
+    if (mOrdering.isEmpty()) {
+        memcpy(N_VGetArrayPointer(idVector), id,
+               size_t(pRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+    } else {
+        OpenCOR::Solver::reorderValues(mOrdering, id,
+                                       N_VGetArrayPointer(idVector));
+    }
 
     IDASetId(mSolver, idVector);
 
     IDACalcIC(mSolver, IDA_YA_YDP_INIT, pVoiEnd);
     IDAGetConsistentIC(mSolver, mStatesVector, mRatesVector);
 
+    if (!mOrdering.isEmpty()) {
+        OpenCOR::Solver::restoreValues(mOrdering, N_VGetArrayPointer(mRatesVector),
+                                       pRates);
+        OpenCOR::Solver::restoreValues(mOrdering, N_VGetArrayPointer(mStatesVector),
+                                       pStates);
+    }
+
     N_VDestroy_Serial(idVector);
 
     delete[] id;
@@ -442,8 +658,152 @@ void IdaSolver::solve(double &pVoi, const double &pVoiEnd) const
 
     IDASolve(mSolver, pVoiEnd, &pVoi, mStatesVector, mRatesVector, IDA_NORMAL);
 
-    memcpy(mOldRates, N_VGetArrayPointer(mRatesVector), mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
-    memcpy(mOldStates, N_VGetArrayPointer(mStatesVector), mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+    // Retrieve our rates and states, if we reorder them
+    // Note: otherwise, our rates and states vectors use our rates and states
+    //       directly...
+
+    if (!mOrdering.isEmpty()) {
+        OpenCOR::Solver::restoreValues(mOrdering, N_VGetArrayPointer(mRatesVector),
+                                       mRates);
+        OpenCOR::Solver::restoreValues(mOrdering, N_VGetArrayPointer(mStatesVector),
+                                       mStates);
+    }
+
+    memcpy(mOldRates, mRates, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+    memcpy(mOldStates, mStates, mRatesStatesCount*OpenCOR::Solver::SizeOfDouble);
+}
+
+//==============================================================================
+
+void IdaSolver::computeResiduals(const double &pVoi, double *pStates,
+                                 double *pRates, double *pResiduals) const
+{
+    // Compute our residuals, after having put our states and rates back in
+    // their original order, if needed, in which case our residuals need to be
+    // reordered afterwards
+
+    bool reorder = !mOrdering.isEmpty();
+    double *states = pStates;
+    double *rates = pRates;
+    double *residuals = pResiduals;
+
+    if (reorder) {
+        OpenCOR::Solver::restoreValues(mOrdering, pStates, mOriginalStates);
+        OpenCOR::Solver::restoreValues(mOrdering, pRates, mOriginalRates);
+
+        states = mOriginalStates;
+        rates = mOriginalRates;
+        residuals = mOriginalResiduals;
+    }
+
+    bool timed = startModelEvaluation();
+
+    mUserData->computeRootInformation()(pVoi, mUserData->constants(), rates,
+                                        mUserData->oldRates(), states,
+                                        mUserData->oldStates(),
+                                        mUserData->algebraic(),
+                                        mUserData->condVar());
+
+    mUserData->computeEssentialVariables()(pVoi, mUserData->constants(), rates,
+                                           mUserData->oldRates(), states,
+                                           mUserData->oldStates(),
+                                           mUserData->algebraic(),
+                                           mUserData->condVar());
+
+    mUserData->computeResiduals()(pVoi, mUserData->constants(), rates,
+                                  mUserData->oldRates(), states,
+                                  mUserData->oldStates(), mUserData->algebraic(),
+                                  mUserData->condVar(), residuals);
+
+    stopModelEvaluation(timed);
+
+    if (reorder)
+        OpenCOR::Solver::reorderValues(mOrdering, mOriginalResiduals, pResiduals);
+}
+
+//==============================================================================
+
+void IdaSolver::computeRootInformation(const double &pVoi, double *pStates,
+                                       double *pRates, double *pRoots) const
+{
+    // Compute our root information, after having put our states and rates
+    // back in their original order, if needed
+
+    double *states = pStates;
+    double *rates = pRates;
+
+    if (!mOrdering.isEmpty()) {
+        OpenCOR::Solver::restoreValues(mOrdering, pStates, mOriginalStates);
+        OpenCOR::Solver::restoreValues(mOrdering, pRates, mOriginalRates);
+
+        states = mOriginalStates;
+        rates = mOriginalRates;
+    }
+
+    mUserData->computeRootInformation()(pVoi, mUserData->constants(), rates,
+                                        mUserData->oldRates(), states,
+                                        mUserData->oldStates(),
+                                        mUserData->algebraic(), pRoots);
+}
+
+//==============================================================================
+
+void IdaSolver::computeSparsityResiduals(const double &pVoi,
+                                         double *pResiduals) const
+{
+    // Compute our residuals using our current states and rates, i.e. as
+    // perturbed by our sparsity pattern
+
+    computeResiduals(pVoi, mStates, mRates, pResiduals);
+}
+
+//==============================================================================
+
+Solver::Statistics IdaSolver::idaStatistics() const
+{
+    // Retrieve IDA's statistics since it was last (re)initialised
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::Statistics();
+
+    if (!mSolver)
+        return res;
+
+    long int nbOfSteps;
+    long int nbOfErrorTestFailures;
+    long int nbOfNewtonIterations;
+
+    IDAGetNumSteps(mSolver, &nbOfSteps);
+    IDAGetNumErrTestFails(mSolver, &nbOfErrorTestFailures);
+    IDAGetNumNonlinSolvIters(mSolver, &nbOfNewtonIterations);
+
+    res.insert(OpenCOR::Solver::NbOfSteps, nbOfSteps);
+    res.insert(OpenCOR::Solver::NbOfErrorTestFailures, nbOfErrorTestFailures);
+    res.insert(OpenCOR::Solver::NbOfNewtonIterations, nbOfNewtonIterations);
+
+    if (mDirectLinearSolver) {
+        long int nbOfJacobianEvaluations;
+
+        IDADlsGetNumJacEvals(mSolver, &nbOfJacobianEvaluations);
+
+        res.insert(OpenCOR::Solver::NbOfJacobianEvaluations, nbOfJacobianEvaluations);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+Solver::Statistics IdaSolver::statistics() const
+{
+    // Return our statistics, i.e. those of our model evaluations and those of
+    // IDA since we were first initialised
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::DaeSolver::statistics();
+
+    OpenCOR::Solver::addStatistics(res, mPreviousStatistics);
+    OpenCOR::Solver::addStatistics(res, idaStatistics());
+
+    return res;
 }
 
 //==============================================================================
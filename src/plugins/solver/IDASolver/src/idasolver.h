@@ -28,6 +28,10 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QVector>
+
+//==============================================================================
+
 #include "nvector/nvector_serial.h"
 
 //==============================================================================
@@ -37,14 +41,18 @@ namespace IDASolver {
 
 //==============================================================================
 
-static const auto MaximumStepId          = QStringLiteral("MaximumStep");
-static const auto MaximumNumberOfStepsId = QStringLiteral("MaximumNumberOfSteps");
-static const auto LinearSolverId         = QStringLiteral("LinearSolver");
-static const auto UpperHalfBandwidthId   = QStringLiteral("UpperHalfBandwidth");
-static const auto LowerHalfBandwidthId   = QStringLiteral("LowerHalfBandwidth");
-static const auto RelativeToleranceId    = QStringLiteral("RelativeTolerance");
-static const auto AbsoluteToleranceId    = QStringLiteral("AbsoluteTolerance");
-static const auto InterpolateSolutionId  = QStringLiteral("InterpolateSolution");
+static const auto MaximumStepId             = QStringLiteral("MaximumStep");
+static const auto MaximumNumberOfStepsId    = QStringLiteral("MaximumNumberOfSteps");
+static const auto LinearSolverId            = QStringLiteral("LinearSolver");
+static const auto PreconditionerId          = QStringLiteral("Preconditioner");
+static const auto AutomaticHalfBandwidthsId = QStringLiteral("AutomaticHalfBandwidths");
+static const auto UpperHalfBandwidthId      = QStringLiteral("UpperHalfBandwidth");
+static const auto LowerHalfBandwidthId      = QStringLiteral("LowerHalfBandwidth");
+static const auto ReorderStatesId           = QStringLiteral("ReorderStates");
+static const auto RelativeToleranceId       = QStringLiteral("RelativeTolerance");
+static const auto AbsoluteToleranceId       = QStringLiteral("AbsoluteTolerance");
+static const auto InterpolateSolutionId     = QStringLiteral("InterpolateSolution");
+static const auto NumberOfThreadsId         = QStringLiteral("NumberOfThreads");
 
 //==============================================================================
 
@@ -56,11 +64,20 @@ static const auto TfqmrLinearSolver    = QStringLiteral("TFQMR");
 
 //==============================================================================
 
+static const auto NoPreconditioner     = QStringLiteral("None");
+static const auto BandedPreconditioner = QStringLiteral("Banded");
+
+//==============================================================================
+
 // Default CVODE parameter values
 // Note #1: a maximum step of 0 means that there is no maximum step as such and
 //          that IDA can use whatever step it sees fit...
 // Note #2: IDA's default maximum number of steps is 500 which ought to be big
 //          enough in most cases...
+// Note #3: unlike CVODE, we don't use a preconditioner by default since IDA's
+//          GMRES/Bi-CGStab/TFQMR linear solvers used not to have one...
+// Note #4: a number of threads of 1 means that we use SUNDIALS' serial
+//          N_Vector as such...
 
 static const double MaximumStepDefaultValue = 0.0;
 
@@ -69,14 +86,19 @@ enum {
 };
 
 static const auto LinearSolverDefaultValue = DenseLinearSolver;
+static const auto PreconditionerDefaultValue = NoPreconditioner;
+static const bool AutomaticHalfBandwidthsDefaultValue = false;
 static const int UpperHalfBandwidthDefaultValue = 0;
 static const int LowerHalfBandwidthDefaultValue = 0;
+static const bool ReorderStatesDefaultValue = false;
 
 static const double RelativeToleranceDefaultValue = 1.0e-7;
 static const double AbsoluteToleranceDefaultValue = 1.0e-7;
 
 static const bool InterpolateSolutionDefaultValue = true;
 
+static const int NumberOfThreadsDefaultValue = 1;
+
 //==============================================================================
 
 class IdaSolverUserData
@@ -87,7 +109,8 @@ public:
                                double *pCondVar,
                                Solver::DaeSolver::ComputeEssentialVariablesFunction pComputeEssentialVariables,
                                Solver::DaeSolver::ComputeResidualsFunction pComputeResiduals,
-                               Solver::DaeSolver::ComputeRootInformationFunction pComputeRootInformation);
+                               Solver::DaeSolver::ComputeRootInformationFunction pComputeRootInformation,
+                               const Solver::DaeSolver *pSolver);
 
     double * constants() const;
     double * oldRates() const;
@@ -99,6 +122,8 @@ public:
     Solver::DaeSolver::ComputeResidualsFunction computeResiduals() const;
     Solver::DaeSolver::ComputeRootInformationFunction computeRootInformation() const;
 
+    const Solver::DaeSolver * solver() const;
+
 private:
     double *mConstants;
     double *mOldRates;
@@ -109,6 +134,8 @@ private:
     Solver::DaeSolver::ComputeEssentialVariablesFunction mComputeEssentialVariables;
     Solver::DaeSolver::ComputeResidualsFunction mComputeResiduals;
     Solver::DaeSolver::ComputeRootInformationFunction mComputeRootInformation;
+
+    const Solver::DaeSolver *mSolver;
 };
 
 //==============================================================================
@@ -131,6 +158,16 @@ public:
 
     virtual void solve(double &pVoi, const double &pVoiEnd) const;
 
+    virtual OpenCOR::Solver::Statistics statistics() const;
+
+    void computeResiduals(const double &pVoi, double *pStates, double *pRates,
+                          double *pResiduals) const;
+    void computeRootInformation(const double &pVoi, double *pStates,
+                                double *pRates, double *pRoots) const;
+
+    void computeSparsityResiduals(const double &pVoi,
+                                  double *pResiduals) const;
+
 private:
     void *mSolver;
     N_Vector mRatesVector;
@@ -138,6 +175,18 @@ private:
     IdaSolverUserData *mUserData;
 
     bool mInterpolateSolution;
+
+    bool mDirectLinearSolver;
+
+    QVector<int> mOrdering;
+
+    double *mOriginalRates;
+    double *mOriginalStates;
+    double *mOriginalResiduals;
+
+    OpenCOR::Solver::Statistics mPreviousStatistics;
+
+    OpenCOR::Solver::Statistics idaStatistics() const;
 };
 
 //==============================================================================
@@ -81,6 +81,8 @@ QString IDASolverPlugin::id(const QString &pKisaoId) const
         return MaximumNumberOfStepsId;
     else if (!pKisaoId.compare("KISAO:0000477"))
         return LinearSolverId;
+    else if (!pKisaoId.compare("KISAO:0000478"))
+        return PreconditionerId;
     else if (!pKisaoId.compare("KISAO:0000479"))
         return UpperHalfBandwidthId;
     else if (!pKisaoId.compare("KISAO:0000480"))
@@ -109,6 +111,8 @@ QString IDASolverPlugin::kisaoId(const QString &pId) const
         return "KISAO:0000415";
     else if (!pId.compare(LinearSolverId))
         return "KISAO:0000477";
+    else if (!pId.compare(PreconditionerId))
+        return "KISAO:0000478";
     else if (!pId.compare(UpperHalfBandwidthId))
         return "KISAO:0000479";
     else if (!pId.compare(LowerHalfBandwidthId))
@@ -150,11 +154,15 @@ Solver::Properties IDASolverPlugin::solverProperties() const
     Descriptions MaximumStepDescriptions;
     Descriptions MaximumNumberOfStepsDescriptions;
     Descriptions LinearSolverDescriptions;
+    Descriptions PreconditionerDescriptions;
+    Descriptions AutomaticHalfBandwidthsDescriptions;
     Descriptions UpperHalfBandwidthDescriptions;
     Descriptions LowerHalfBandwidthDescriptions;
+    Descriptions ReorderStatesDescriptions;
     Descriptions RelativeToleranceDescriptions;
     Descriptions AbsoluteToleranceDescriptions;
     Descriptions InterpolateSolutionDescriptions;
+    Descriptions NumberOfThreadsDescriptions;
 
     MaximumStepDescriptions.insert("en", QString::fromUtf8("Maximum step"));
     MaximumStepDescriptions.insert("fr", QString::fromUtf8("Pas maximum"));
@@ -165,12 +173,21 @@ Solver::Properties IDASolverPlugin::solverProperties() const
     LinearSolverDescriptions.insert("en", QString::fromUtf8("Linear solver"));
     LinearSolverDescriptions.insert("fr", QString::fromUtf8("Solveur linéaire"));
 
+    PreconditionerDescriptions.insert("en", QString::fromUtf8("Preconditioner"));
+    PreconditionerDescriptions.insert("fr", QString::fromUtf8("Préconditionneur"));
+
+    AutomaticHalfBandwidthsDescriptions.insert("en", QString::fromUtf8("Automatic half-bandwidths"));
+    AutomaticHalfBandwidthsDescriptions.insert("fr", QString::fromUtf8("Demi largeurs de bande automatiques"));
+
     UpperHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Upper half-bandwidth"));
     UpperHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande supérieure"));
 
     LowerHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Lower half-bandwidth"));
     LowerHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande inférieure"));
 
+    ReorderStatesDescriptions.insert("en", QString::fromUtf8("Reorder states"));
+    ReorderStatesDescriptions.insert("fr", QString::fromUtf8("Réordonner les états"));
+
     RelativeToleranceDescriptions.insert("en", QString::fromUtf8("Relative tolerance"));
     RelativeToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance relative"));
 
@@ -180,20 +197,30 @@ Solver::Properties IDASolverPlugin::solverProperties() const
     InterpolateSolutionDescriptions.insert("en", QString::fromUtf8("Interpolate solution"));
     InterpolateSolutionDescriptions.insert("fr", QString::fromUtf8("Interpoler solution"));
 
+    NumberOfThreadsDescriptions.insert("en", QString::fromUtf8("Number of threads"));
+    NumberOfThreadsDescriptions.insert("fr", QString::fromUtf8("Nombre de threads"));
+
     QStringList LinearSolverListValues = QStringList() << DenseLinearSolver
                                                        << BandedLinearSolver
                                                        << GmresLinearSolver
                                                        << BiCgStabLinearSolver
                                                        << TfqmrLinearSolver;
 
+    QStringList PreconditionerListValues = QStringList() << NoPreconditioner
+                                                         << BandedPreconditioner;
+
     return Solver::Properties() << Solver::Property(Solver::Property::Double, MaximumStepId, MaximumStepDescriptions, QStringList(), MaximumStepDefaultValue, true)
                                 << Solver::Property(Solver::Property::Integer, MaximumNumberOfStepsId, MaximumNumberOfStepsDescriptions, QStringList(), MaximumNumberOfStepsDefaultValue, false)
                                 << Solver::Property(Solver::Property::List, LinearSolverId, LinearSolverDescriptions, LinearSolverListValues, LinearSolverDefaultValue, false)
+                                << Solver::Property(Solver::Property::List, PreconditionerId, PreconditionerDescriptions, PreconditionerListValues, PreconditionerDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, AutomaticHalfBandwidthsId, AutomaticHalfBandwidthsDescriptions, QStringList(), AutomaticHalfBandwidthsDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, UpperHalfBandwidthId, UpperHalfBandwidthDescriptions, QStringList(), UpperHalfBandwidthDefaultValue, false)
                                 << Solver::Property(Solver::Property::Integer, LowerHalfBandwidthId, LowerHalfBandwidthDescriptions, QStringList(), LowerHalfBandwidthDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, ReorderStatesId, ReorderStatesDescriptions, QStringList(), ReorderStatesDefaultValue, false)
                                 << Solver::Property(Solver::Property::Double, RelativeToleranceId, RelativeToleranceDescriptions, QStringList(), RelativeToleranceDefaultValue, false)
                                 << Solver::Property(Solver::Property::Double, AbsoluteToleranceId, AbsoluteToleranceDescriptions, QStringList(), AbsoluteToleranceDefaultValue, false)
-                                << Solver::Property(Solver::Property::Boolean, InterpolateSolutionId, InterpolateSolutionDescriptions, QStringList(), InterpolateSolutionDefaultValue, false);
+                                << Solver::Property(Solver::Property::Boolean, InterpolateSolutionId, InterpolateSolutionDescriptions, QStringList(), InterpolateSolutionDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, NumberOfThreadsId, NumberOfThreadsDescriptions, QStringList(), NumberOfThreadsDefaultValue, false);
 }
 
 //==============================================================================
@@ -206,17 +233,42 @@ QMap<QString, bool> IDASolverPlugin::solverPropertiesVisibility(const QMap<QStri
     QMap<QString, bool> res = QMap<QString, bool>();
 
     QString linearSolver = pSolverPropertiesValues.value(LinearSolverId);
+    bool needUpperAndLowerHalfBandwidths = false;
+
+    if (!linearSolver.compare(DenseLinearSolver)) {
+        // Dense linear solver
 
-    if (!linearSolver.compare(BandedLinearSolver)) {
+        res.insert(PreconditionerId, false);
+    } else if (!linearSolver.compare(BandedLinearSolver)) {
         // Banded linear solver
 
-        res.insert(UpperHalfBandwidthId, true);
-        res.insert(LowerHalfBandwidthId, true);
+        res.insert(PreconditionerId, false);
+
+        needUpperAndLowerHalfBandwidths = true;
     } else {
-        // Dense/GMRES/Bi-CGStab/TFQMR linear solver
+        // GMRES/Bi-CGStab/TFQMR linear solver
 
+        res.insert(PreconditionerId, true);
+
+        needUpperAndLowerHalfBandwidths = !pSolverPropertiesValues.value(PreconditionerId).compare(BandedPreconditioner);
+    }
+
+    if (needUpperAndLowerHalfBandwidths) {
+        // Banded linear solver or preconditioner, whose half bandwidths are
+        // either determined automatically (in which case our states may also
+        // be reordered) or specified by the user
+
+        bool automaticHalfBandwidths = QVariant(pSolverPropertiesValues.value(AutomaticHalfBandwidthsId)).toBool();
+
+        res.insert(AutomaticHalfBandwidthsId, true);
+        res.insert(UpperHalfBandwidthId, !automaticHalfBandwidths);
+        res.insert(LowerHalfBandwidthId, !automaticHalfBandwidths);
+        res.insert(ReorderStatesId, automaticHalfBandwidths);
+    } else {
+        res.insert(AutomaticHalfBandwidthsId, false);
         res.insert(UpperHalfBandwidthId, false);
         res.insert(LowerHalfBandwidthId, false);
+        res.insert(ReorderStatesId, false);
     }
 
     return res;
@@ -0,0 +1,67 @@
+<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE TS>
+<TS version="2.1" language="fr_FR" sourcelanguage="en_GB">
+<context>
+    <name>QObject</name>
+    <message>
+        <source>the &apos;linear solver&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;solveur linéaire&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;upper half-bandwidth&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;demi largeur de bande supérieure&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;upper half-bandwidth&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;demi largeur de bande supérieure&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;lower half-bandwidth&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;demi largeur de bande inférieure&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;lower half-bandwidth&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;demi largeur de bande inférieure&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;strategy&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;stratégie&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;maximum setup calls&apos; property must have a value greater than or equal to 1</source>
+        <translation>la propriété &apos;nombre maximum d&apos;initialisations&apos; doit avoir une valeur plus grande que ou égale à 1</translation>
+    </message>
+    <message>
+        <source>the &apos;maximum setup calls&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;nombre maximum d&apos;initialisations&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;automatic scaling&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;mise à l&apos;échelle automatique&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;function tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance de la fonction&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;function tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance de la fonction&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;scaled step tolerance&apos; property must have a value greater than or equal to 0</source>
+        <translation>la propriété &apos;tolérance du pas mis à l&apos;échelle&apos; doit avoir une valeur plus grande que ou égale à 0</translation>
+    </message>
+    <message>
+        <source>the &apos;scaled step tolerance&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;tolérance du pas mis à l&apos;échelle&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;number of threads&apos; property must have a value greater than or equal to 1</source>
+        <translation>la propriété &apos;nombre de threads&apos; doit avoir une valeur plus grande que ou égale à 1</translation>
+    </message>
+    <message>
+        <source>the &apos;number of threads&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;nombre de threads&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+</context>
+</TS>
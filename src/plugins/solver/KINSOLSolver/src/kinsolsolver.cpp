@@ -21,11 +21,16 @@ limitations under the License.
 //==============================================================================
 
 #include "kinsolsolver.h"
+#include "threadednvector.h"
 
 //==============================================================================
 
 #include "kinsol/kinsol.h"
+#include "kinsol/kinsol_band.h"
 #include "kinsol/kinsol_dense.h"
+#include "kinsol/kinsol_spbcgs.h"
+#include "kinsol/kinsol_spgmr.h"
+#include "kinsol/kinsol_sptfqmr.h"
 
 //==============================================================================
 
@@ -82,6 +87,15 @@ void * KinsolSolverUserData::userData() const
 
 //==============================================================================
 
+void KinsolSolverUserData::setUserData(void *pUserData)
+{
+    // Set our user data
+
+    mUserData = pUserData;
+}
+
+//==============================================================================
+
 Solver::NlaSolver::ComputeSystemFunction KinsolSolverUserData::computeSystem() const
 {
     // Return our compute system function
@@ -91,91 +105,426 @@ Solver::NlaSolver::ComputeSystemFunction KinsolSolverUserData::computeSystem() c
 
 //==============================================================================
 
-KinsolSolver::KinsolSolver() :
-    mSolver(0),
-    mParametersVector(0),
-    mOnesVector(0),
-    mUserData(0)
+KinsolSolverData::KinsolSolverData(void *pSolver, N_Vector pParametersVector,
+                                   N_Vector pParametersScaleVector,
+                                   N_Vector pFunctionScaleVector,
+                                   KinsolSolverUserData *pUserData,
+                                   const bool &pDirectLinearSolver) :
+    mSolver(pSolver),
+    mParametersVector(pParametersVector),
+    mParametersScaleVector(pParametersScaleVector),
+    mFunctionScaleVector(pFunctionScaleVector),
+    mUserData(pUserData),
+    mDirectLinearSolver(pDirectLinearSolver)
 {
 }
 
 //==============================================================================
 
-KinsolSolver::~KinsolSolver()
+KinsolSolverData::~KinsolSolverData()
 {
     // Delete some internal objects
 
-    reset();
+    N_VDestroy_Serial(mParametersVector);
+    N_VDestroy_Serial(mParametersScaleVector);
+    N_VDestroy_Serial(mFunctionScaleVector);
+
+    KINFree(&mSolver);
+
+    delete mUserData;
 }
 
 //==============================================================================
 
-void KinsolSolver::reset()
+void * KinsolSolverData::solver() const
 {
-    // Make sure that the solver has been initialised
+    // Return our solver
 
-    if (!mSolver)
-        return;
+    return mSolver;
+}
 
-    N_VDestroy_Serial(mParametersVector);
-    N_VDestroy_Serial(mOnesVector);
+//==============================================================================
 
-    KINFree(&mSolver);
+N_Vector KinsolSolverData::parametersVector() const
+{
+    // Return our parameters vector
 
-    delete mUserData;
+    return mParametersVector;
 }
 
 //==============================================================================
 
-void KinsolSolver::initialize(ComputeSystemFunction pComputeSystem,
-                              double *pParameters, int pSize, void *pUserData)
+N_Vector KinsolSolverData::parametersScaleVector() const
 {
-    if (mSolver)
-        // The solver has already been initialised, so reset things...
+    // Return our parameters scale vector
+
+    return mParametersScaleVector;
+}
 
-        reset();
+//==============================================================================
 
-    // Initialise the ODE solver itself
+N_Vector KinsolSolverData::functionScaleVector() const
+{
+    // Return our function scale vector
 
-    OpenCOR::Solver::NlaSolver::initialize(pComputeSystem, pParameters, pSize);
+    return mFunctionScaleVector;
+}
+
+//==============================================================================
+
+KinsolSolverUserData * KinsolSolverData::userData() const
+{
+    // Return our user data
+
+    return mUserData;
+}
+
+//==============================================================================
+
+bool KinsolSolverData::directLinearSolver() const
+{
+    // Return whether we use a direct linear solver
+
+    return mDirectLinearSolver;
+}
+
+//==============================================================================
+
+KinsolSolver::KinsolSolver() :
+    mData(QMap<ComputeSystemFunction, KinsolSolverData *>()),
+    mCurrentData(0),
+    mStrategy(StrategyDefaultValue),
+    mMaximumSetupCalls(MaximumSetupCallsDefaultValue),
+    mAutomaticScaling(AutomaticScalingDefaultValue),
+    mKinsolStatistics(OpenCOR::Solver::Statistics())
+{
+}
+
+//==============================================================================
+
+KinsolSolver::~KinsolSolver()
+{
+    // Delete some internal objects
+
+    foreach (KinsolSolverData *data, mData)
+        delete data;
+}
+
+//==============================================================================
+
+KinsolSolverData * KinsolSolver::newData(ComputeSystemFunction pComputeSystem,
+                                         double *pParameters, int pSize,
+                                         void *pUserData)
+{
+    // Retrieve some of the KINSOL properties
+
+    QString linearSolver = LinearSolverDefaultValue;
+    int upperHalfBandwidth = UpperHalfBandwidthDefaultValue;
+    int lowerHalfBandwidth = LowerHalfBandwidthDefaultValue;
+    double functionTolerance = FunctionToleranceDefaultValue;
+    double scaledStepTolerance = ScaledStepToleranceDefaultValue;
+    int numberOfThreads = NumberOfThreadsDefaultValue;
+
+    if (mProperties.contains(LinearSolverId)) {
+        linearSolver = mProperties.value(LinearSolverId).toString();
+
+        if (!linearSolver.compare(BandedLinearSolver)) {
+            // We are dealing with a banded linear solver, so we need both an
+            // upper and a lower half bandwidth
+            // Note: we may have several NLA systems of different sizes, so
+            //       rather than reject a half bandwidth that is too big for a
+            //       given system, we clamp it to that system's size...
+
+            if (mProperties.contains(UpperHalfBandwidthId)) {
+                upperHalfBandwidth = mProperties.value(UpperHalfBandwidthId).toInt();
+
+                if (upperHalfBandwidth < 0) {
+                    emit error(QObject::tr("the 'upper half-bandwidth' property must have a value greater than or equal to 0"));
+
+                    return 0;
+                }
+            } else {
+                emit error(QObject::tr("the 'upper half-bandwidth' property value could not be retrieved"));
+
+                return 0;
+            }
+
+            if (mProperties.contains(LowerHalfBandwidthId)) {
+                lowerHalfBandwidth = mProperties.value(LowerHalfBandwidthId).toInt();
+
+                if (lowerHalfBandwidth < 0) {
+                    emit error(QObject::tr("the 'lower half-bandwidth' property must have a value greater than or equal to 0"));
+
+                    return 0;
+                }
+            } else {
+                emit error(QObject::tr("the 'lower half-bandwidth' property value could not be retrieved"));
+
+                return 0;
+            }
+
+            upperHalfBandwidth = qMin(upperHalfBandwidth, pSize-1);
+            lowerHalfBandwidth = qMin(lowerHalfBandwidth, pSize-1);
+        }
+    } else {
+        emit error(QObject::tr("the 'linear solver' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(StrategyId)) {
+        mStrategy = mProperties.value(StrategyId).toString();
+    } else {
+        emit error(QObject::tr("the 'strategy' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(MaximumSetupCallsId)) {
+        mMaximumSetupCalls = mProperties.value(MaximumSetupCallsId).toInt();
+
+        if (mMaximumSetupCalls < 1) {
+            emit error(QObject::tr("the 'maximum setup calls' property must have a value greater than or equal to 1"));
+
+            return 0;
+        }
+    } else {
+        emit error(QObject::tr("the 'maximum setup calls' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(AutomaticScalingId)) {
+        mAutomaticScaling = mProperties.value(AutomaticScalingId).toBool();
+    } else {
+        emit error(QObject::tr("the 'automatic scaling' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(FunctionToleranceId)) {
+        functionTolerance = mProperties.value(FunctionToleranceId).toDouble();
+
+        if (functionTolerance < 0) {
+            emit error(QObject::tr("the 'function tolerance' property must have a value greater than or equal to 0"));
+
+            return 0;
+        }
+    } else {
+        emit error(QObject::tr("the 'function tolerance' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(ScaledStepToleranceId)) {
+        scaledStepTolerance = mProperties.value(ScaledStepToleranceId).toDouble();
+
+        if (scaledStepTolerance < 0) {
+            emit error(QObject::tr("the 'scaled step tolerance' property must have a value greater than or equal to 0"));
+
+            return 0;
+        }
+    } else {
+        emit error(QObject::tr("the 'scaled step tolerance' property value could not be retrieved"));
+
+        return 0;
+    }
+
+    if (mProperties.contains(NumberOfThreadsId)) {
+        numberOfThreads = mProperties.value(NumberOfThreadsId).toInt();
+
+        if (numberOfThreads < 1) {
+            emit error(QObject::tr("the 'number of threads' property must have a value greater than or equal to 1"));
+
+            return 0;
+        }
+    } else {
+        emit error(QObject::tr("the 'number of threads' property value could not be retrieved"));
+
+        return 0;
+    }
 
     // Create some vectors
+    // Note: they are threaded if more than one thread was requested, in which
+    //       case KINSOL's vector operations get split between threads...
 
-    mParametersVector = N_VMake_Serial(pSize, pParameters);
-    mOnesVector = N_VNew_Serial(pSize);
+    N_Vector parametersVector = OpenCOR::Solver::makeNVector(pSize, pParameters,
+                                                             numberOfThreads);
+    N_Vector parametersScaleVector = OpenCOR::Solver::newNVector(pSize, numberOfThreads);
+    N_Vector functionScaleVector = OpenCOR::Solver::newNVector(pSize, numberOfThreads);
 
-    N_VConst(1.0, mOnesVector);
+    N_VConst(1.0, parametersScaleVector);
+    N_VConst(1.0, functionScaleVector);
 
     // Create the KINSOL solver
 
-    mSolver = KINCreate();
+    void *solver = KINCreate();
 
     // Use our own error handler
 
-    KINSetErrHandlerFn(mSolver, errorHandler, this);
+    KINSetErrHandlerFn(solver, errorHandler, this);
 
     // Initialise the KINSOL solver
 
-    KINInit(mSolver, systemFunction, mParametersVector);
+    KINInit(solver, systemFunction, parametersVector);
 
     // Set some user data
 
-    mUserData = new KinsolSolverUserData(pUserData, pComputeSystem);
+    KinsolSolverUserData *userData = new KinsolSolverUserData(pUserData, pComputeSystem);
 
-    KINSetUserData(mSolver, mUserData);
+    KINSetUserData(solver, userData);
 
     // Set the linear solver
 
-    KINDense(mSolver, pSize);
+    bool directLinearSolver = true;
+
+    if (!linearSolver.compare(DenseLinearSolver)) {
+        KINDense(solver, pSize);
+    } else if (!linearSolver.compare(BandedLinearSolver)) {
+        KINBand(solver, pSize, upperHalfBandwidth, lowerHalfBandwidth);
+    } else {
+        directLinearSolver = false;
+
+        if (!linearSolver.compare(GmresLinearSolver))
+            KINSpgmr(solver, 0);
+        else if (!linearSolver.compare(BiCgStabLinearSolver))
+            KINSpbcg(solver, 0);
+        else
+            KINSptfqmr(solver, 0);
+    }
+
+    // Set the maximum number of Newton iterations between two Jacobian
+    // evaluations, as well as our tolerances
+
+    KINSetMaxSetupCalls(solver, mMaximumSetupCalls);
+    KINSetFuncNormTol(solver, functionTolerance);
+    KINSetScaledStepTol(solver, scaledStepTolerance);
+
+    return new KinsolSolverData(solver, parametersVector, parametersScaleVector,
+                                functionScaleVector, userData,
+                                directLinearSolver);
+}
+
+//==============================================================================
+
+void KinsolSolver::initialize(ComputeSystemFunction pComputeSystem,
+                              double *pParameters, int pSize, void *pUserData)
+{
+    // Initialise the NLA solver itself
+
+    OpenCOR::Solver::NlaSolver::initialize(pComputeSystem, pParameters, pSize);
+
+    // Retrieve the KINSOL solver for the given system or create one if needed
+    // Note: we get initialised before every solve, but we only create a KINSOL
+    //       solver the first time we are asked to solve a given system. This
+    //       saves us from recreating it every time and, more importantly, it
+    //       allows KINSOL to reuse its Jacobian from one solve to the next...
+
+    mCurrentData = mData.value(pComputeSystem);
+
+    if (mCurrentData) {
+        // We already have a KINSOL solver for the given system, but our
+        // parameters and user data may have moved since we last used it, so
+        // update them
+
+        N_VSetArrayPointer_Serial(pParameters, mCurrentData->parametersVector());
+
+        mCurrentData->userData()->setUserData(pUserData);
+    } else {
+        mCurrentData = newData(pComputeSystem, pParameters, pSize, pUserData);
+
+        if (mCurrentData)
+            mData.insert(pComputeSystem, mCurrentData);
+    }
 }
 
 //==============================================================================
 
 void KinsolSolver::solve() const
 {
-    // Solve the linear system
+    // Make sure that we have a KINSOL solver
+
+    if (!mCurrentData)
+        return;
+
+    // Scale our parameters using our initial guess, if requested
+    // Note: a parameter that is (nearly) zero is left unscaled...
+
+    if (mAutomaticScaling) {
+        N_Vector parametersVector = mCurrentData->parametersVector();
+        double *parameters = N_VGetArrayPointer_Serial(parametersVector);
+        double *parametersScale = N_VGetArrayPointer_Serial(mCurrentData->parametersScaleVector());
+
+        for (long i = 0, iMax = NV_LENGTH_S(parametersVector); i < iMax; ++i) {
+            double absParameter = qAbs(parameters[i]);
+
+            parametersScale[i] = (absParameter > UNIT_ROUNDOFF)?1.0/absParameter:1.0;
+        }
+    }
+
+    // Solve the non-linear system
+
+    void *solver = mCurrentData->solver();
+
+    KINSol(solver, mCurrentData->parametersVector(),
+           (!mStrategy.compare(NewtonStrategy))?KIN_NONE:KIN_LINESEARCH,
+           mCurrentData->parametersScaleVector(),
+           mCurrentData->functionScaleVector());
+
+    // Keep track of KINSOL's statistics since they only cover its last solve
+
+    OpenCOR::Solver::addStatistics(mKinsolStatistics, kinsolStatistics());
+
+    // Reuse our Jacobian the next time we are asked to solve our system, if we
+    // are allowed to use the same Jacobian for several Newton iterations
+    // Note: KINSOL will still reevaluate our Jacobian if it turns out to be too
+    //       outdated to make progress...
+
+    if (mMaximumSetupCalls > 1)
+        KINSetNoInitSetup(solver, TRUE);
+}
+
+//==============================================================================
+
+Solver::Statistics KinsolSolver::kinsolStatistics() const
+{
+    // Retrieve KINSOL's statistics for its last solve
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::Statistics();
+
+    void *solver = mCurrentData->solver();
+    long int nbOfNewtonIterations;
+    long int nbOfFunctionEvaluations;
+
+    KINGetNumNonlinSolvIters(solver, &nbOfNewtonIterations);
+    KINGetNumFuncEvals(solver, &nbOfFunctionEvaluations);
+
+    res.insert(OpenCOR::Solver::NbOfNewtonIterations, nbOfNewtonIterations);
+    res.insert(OpenCOR::Solver::NbOfRhsEvaluations, nbOfFunctionEvaluations);
+
+    if (mCurrentData->directLinearSolver()) {
+        long int nbOfJacobianEvaluations;
+
+        KINDlsGetNumJacEvals(solver, &nbOfJacobianEvaluations);
+
+        res.insert(OpenCOR::Solver::NbOfJacobianEvaluations, nbOfJacobianEvaluations);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+Solver::Statistics KinsolSolver::statistics() const
+{
+    // Return our statistics, i.e. the number of times we were asked to solve
+    // our systems and KINSOL's statistics for all those solves
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::NlaSolver::statistics();
+
+    OpenCOR::Solver::addStatistics(res, mKinsolStatistics);
 
-    KINSol(mSolver, mParametersVector, KIN_LINESEARCH, mOnesVector, mOnesVector);
+    return res;
 }
 
 //==============================================================================
@@ -37,6 +37,56 @@ namespace KINSOLSolver {
 
 //==============================================================================
 
+static const auto LinearSolverId        = QStringLiteral("LinearSolver");
+static const auto UpperHalfBandwidthId  = QStringLiteral("UpperHalfBandwidth");
+static const auto LowerHalfBandwidthId  = QStringLiteral("LowerHalfBandwidth");
+static const auto StrategyId            = QStringLiteral("Strategy");
+static const auto MaximumSetupCallsId   = QStringLiteral("MaximumSetupCalls");
+static const auto AutomaticScalingId    = QStringLiteral("AutomaticScaling");
+static const auto FunctionToleranceId   = QStringLiteral("FunctionTolerance");
+static const auto ScaledStepToleranceId = QStringLiteral("ScaledStepTolerance");
+static const auto NumberOfThreadsId     = QStringLiteral("NumberOfThreads");
+
+//==============================================================================
+
+static const auto DenseLinearSolver    = QStringLiteral("Dense");
+static const auto BandedLinearSolver   = QStringLiteral("Banded");
+static const auto GmresLinearSolver    = QStringLiteral("GMRES");
+static const auto BiCgStabLinearSolver = QStringLiteral("BiCGStab");
+static const auto TfqmrLinearSolver    = QStringLiteral("TFQMR");
+
+//==============================================================================
+
+static const auto NewtonStrategy     = QStringLiteral("Newton");
+static const auto LineSearchStrategy = QStringLiteral("Line search");
+
+//==============================================================================
+
+// Default KINSOL parameter values
+// Note #1: a maximum number of setup calls of 10 is KINSOL's default value...
+// Note #2: a function/scaled step tolerance of 0 means that we use KINSOL's
+//          default value...
+// Note #3: a number of threads of 1 means that we use SUNDIALS' serial N_Vector
+//          as such...
+
+static const auto LinearSolverDefaultValue = DenseLinearSolver;
+
+static const int UpperHalfBandwidthDefaultValue = 0;
+static const int LowerHalfBandwidthDefaultValue = 0;
+
+static const auto StrategyDefaultValue = LineSearchStrategy;
+
+static const int MaximumSetupCallsDefaultValue = 10;
+
+static const bool AutomaticScalingDefaultValue = false;
+
+static const double FunctionToleranceDefaultValue   = 0.0;
+static const double ScaledStepToleranceDefaultValue = 0.0;
+
+static const int NumberOfThreadsDefaultValue = 1;
+
+//==============================================================================
+
 class KinsolSolverUserData
 {
 public:
@@ -44,6 +94,7 @@ public:
                                   Solver::NlaSolver::ComputeSystemFunction pComputeSystem);
 
     void * userData() const;
+    void setUserData(void *pUserData);
 
     Solver::NlaSolver::ComputeSystemFunction computeSystem() const;
 
@@ -55,6 +106,40 @@ private:
 
 //==============================================================================
 
+class KinsolSolverData
+{
+public:
+    explicit KinsolSolverData(void *pSolver, N_Vector pParametersVector,
+                              N_Vector pParametersScaleVector,
+                              N_Vector pFunctionScaleVector,
+                              KinsolSolverUserData *pUserData,
+                              const bool &pDirectLinearSolver);
+    ~KinsolSolverData();
+
+    void * solver() const;
+
+    N_Vector parametersVector() const;
+    N_Vector parametersScaleVector() const;
+    N_Vector functionScaleVector() const;
+
+    KinsolSolverUserData * userData() const;
+
+    bool directLinearSolver() const;
+
+private:
+    void *mSolver;
+
+    N_Vector mParametersVector;
+    N_Vector mParametersScaleVector;
+    N_Vector mFunctionScaleVector;
+
+    KinsolSolverUserData *mUserData;
+
+    bool mDirectLinearSolver;
+};
+
+//==============================================================================
+
 class KinsolSolver : public Solver::NlaSolver
 {
 public:
@@ -66,13 +151,23 @@ public:
 
     virtual void solve() const;
 
+    virtual OpenCOR::Solver::Statistics statistics() const;
+
 private:
-    void *mSolver;
-    N_Vector mParametersVector;
-    N_Vector mOnesVector;
-    KinsolSolverUserData *mUserData;
+    QMap<ComputeSystemFunction, KinsolSolverData *> mData;
+    KinsolSolverData *mCurrentData;
+
+    QString mStrategy;
+    int mMaximumSetupCalls;
+    bool mAutomaticScaling;
+
+    mutable OpenCOR::Solver::Statistics mKinsolStatistics;
+
+    KinsolSolverData * newData(ComputeSystemFunction pComputeSystem,
+                               double *pParameters, int pSize,
+                               void *pUserData);
 
-    void reset();
+    OpenCOR::Solver::Statistics kinsolStatistics() const;
 };
 
 //==============================================================================
@@ -42,6 +42,18 @@ PLUGININFO_FUNC KINSOLSolverPluginInfo()
                           descriptions);
 }
 
+//==============================================================================
+// I18n interface
+//==============================================================================
+
+void KINSOLSolverPlugin::retranslateUi()
+{
+    // We don't handle this interface...
+    // Note: even though we don't handle this interface, we still want to
+    //       support it since some other aspects of our plugin are
+    //       multilingual...
+}
+
 //==============================================================================
 // Solver interface
 //==============================================================================
@@ -99,20 +111,99 @@ QString KINSOLSolverPlugin::solverName() const
 
 Solver::Properties KINSOLSolverPlugin::solverProperties() const
 {
-    // Return the properties supported by the solver, i.e. none in our case
-
-    return Solver::Properties();
+    // Return the properties supported by the solver
+
+    Descriptions LinearSolverDescriptions;
+    Descriptions UpperHalfBandwidthDescriptions;
+    Descriptions LowerHalfBandwidthDescriptions;
+    Descriptions StrategyDescriptions;
+    Descriptions MaximumSetupCallsDescriptions;
+    Descriptions AutomaticScalingDescriptions;
+    Descriptions FunctionToleranceDescriptions;
+    Descriptions ScaledStepToleranceDescriptions;
+    Descriptions NumberOfThreadsDescriptions;
+
+    LinearSolverDescriptions.insert("en", QString::fromUtf8("Linear solver"));
+    LinearSolverDescriptions.insert("fr", QString::fromUtf8("Solveur linéaire"));
+
+    UpperHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Upper half-bandwidth"));
+    UpperHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande supérieure"));
+
+    LowerHalfBandwidthDescriptions.insert("en", QString::fromUtf8("Lower half-bandwidth"));
+    LowerHalfBandwidthDescriptions.insert("fr", QString::fromUtf8("Demi largeur de bande inférieure"));
+
+    StrategyDescriptions.insert("en", QString::fromUtf8("Strategy"));
+    StrategyDescriptions.insert("fr", QString::fromUtf8("Stratégie"));
+
+    MaximumSetupCallsDescriptions.insert("en", QString::fromUtf8("Maximum setup calls"));
+    MaximumSetupCallsDescriptions.insert("fr", QString::fromUtf8("Nombre maximum d'initialisations"));
+
+    AutomaticScalingDescriptions.insert("en", QString::fromUtf8("Automatic scaling"));
+    AutomaticScalingDescriptions.insert("fr", QString::fromUtf8("Mise à l'échelle automatique"));
+
+    FunctionToleranceDescriptions.insert("en", QString::fromUtf8("Function tolerance"));
+    FunctionToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance de la fonction"));
+
+    ScaledStepToleranceDescriptions.insert("en", QString::fromUtf8("Scaled step tolerance"));
+    ScaledStepToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance du pas mis à l'échelle"));
+
+    NumberOfThreadsDescriptions.insert("en", QString::fromUtf8("Number of threads"));
+    NumberOfThreadsDescriptions.insert("fr", QString::fromUtf8("Nombre de threads"));
+
+    QStringList LinearSolverListValues = QStringList() << DenseLinearSolver
+                                                       << BandedLinearSolver
+                                                       << GmresLinearSolver
+                                                       << BiCgStabLinearSolver
+                                                       << TfqmrLinearSolver;
+
+    QStringList StrategyListValues = QStringList() << NewtonStrategy
+                                                   << LineSearchStrategy;
+
+    return Solver::Properties() << Solver::Property(Solver::Property::List, LinearSolverId, LinearSolverDescriptions, LinearSolverListValues, LinearSolverDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, UpperHalfBandwidthId, UpperHalfBandwidthDescriptions, QStringList(), UpperHalfBandwidthDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, LowerHalfBandwidthId, LowerHalfBandwidthDescriptions, QStringList(), LowerHalfBandwidthDefaultValue, false)
+                                << Solver::Property(Solver::Property::List, StrategyId, StrategyDescriptions, StrategyListValues, StrategyDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, MaximumSetupCallsId, MaximumSetupCallsDescriptions, QStringList(), MaximumSetupCallsDefaultValue, false)
+                                << Solver::Property(Solver::Property::Boolean, AutomaticScalingId, AutomaticScalingDescriptions, QStringList(), AutomaticScalingDefaultValue, false)
+                                << Solver::Property(Solver::Property::Double, FunctionToleranceId, FunctionToleranceDescriptions, QStringList(), FunctionToleranceDefaultValue, false)
+                                << Solver::Property(Solver::Property::Double, ScaledStepToleranceId, ScaledStepToleranceDescriptions, QStringList(), ScaledStepToleranceDefaultValue, false)
+                                << Solver::Property(Solver::Property::Integer, NumberOfThreadsId, NumberOfThreadsDescriptions, QStringList(), NumberOfThreadsDefaultValue, false);
 }
 
 //==============================================================================
 
 QMap<QString, bool> KINSOLSolverPlugin::solverPropertiesVisibility(const QMap<QString, QString> &pSolverPropertiesValues) const
 {
-    Q_UNUSED(pSolverPropertiesValues);
+    // Return the visibility of our properties based on the given properties
+    // values
 
-    // We don't handle this interface...
+    QMap<QString, bool> res = QMap<QString, bool>();
+
+    QString linearSolver = pSolverPropertiesValues.value(LinearSolverId);
+
+    if (!linearSolver.compare(DenseLinearSolver)) {
+        // Dense linear solver
+
+        res.insert(UpperHalfBandwidthId, false);
+        res.insert(LowerHalfBandwidthId, false);
+        res.insert(MaximumSetupCallsId, true);
+    } else if (!linearSolver.compare(BandedLinearSolver)) {
+        // Banded linear solver
+
+        res.insert(UpperHalfBandwidthId, true);
+        res.insert(LowerHalfBandwidthId, true);
+        res.insert(MaximumSetupCallsId, true);
+    } else {
+        // GMRES/Bi-CGStab/TFQMR linear solver
+        // Note: we don't use a preconditioner with those linear solvers, so
+        //       there is nothing for KINSOL to set up...
+
+        res.insert(UpperHalfBandwidthId, false);
+        res.insert(LowerHalfBandwidthId, false);
+        res.insert(MaximumSetupCallsId, false);
+    }
 
-    return QMap<QString, bool>();
+    return res;
 }
 
 //==============================================================================
@@ -0,0 +1,212 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// KINSOL solver tests
+//==============================================================================
+
+#include "kinsolsolver.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+// Our NLA system is an implicit Euler step of a reaction-diffusion equation,
+// i.e. u' = D*u_xx-u^3, which gives a tridiagonal system, similar to what we
+// might get when solving a DAE
+
+static const int Size = 400;
+
+static const double Diffusion = 100.0;
+static const double Step = 0.01;
+
+static const double FunctionTolerance = 1.0e-10;
+
+//==============================================================================
+
+static void computeReactionDiffusionSystem(double *pParameters,
+                                           double *pResiduals, void *pUserData)
+{
+    // Compute the residuals of our reaction-diffusion system, i.e.
+    //   F_i(u) = u_i-uOld_i-h*(D*(u_i-1-2*u_i+u_i+1)-u_i^3)
+    // with zero-flux boundary conditions
+
+    double *oldParameters = static_cast<double *>(pUserData);
+
+    for (int i = 0; i < Size; ++i) {
+        double u = pParameters[i];
+        double uLeft = pParameters[i?i-1:i+1];
+        double uRight = pParameters[(i != Size-1)?i+1:i-1];
+
+        pResiduals[i] = u-oldParameters[i]-Step*(Diffusion*(uLeft-2.0*u+uRight)-u*u*u);
+    }
+}
+
+//==============================================================================
+
+static OpenCOR::Solver::Solver::Properties solverProperties(const QString &pLinearSolver,
+                                                            const int &pHalfBandwidth,
+                                                            const int &pMaximumSetupCalls)
+{
+    // Return the properties of our solver
+
+    OpenCOR::Solver::Solver::Properties res;
+
+    res.insert(OpenCOR::KINSOLSolver::LinearSolverId, pLinearSolver);
+    res.insert(OpenCOR::KINSOLSolver::UpperHalfBandwidthId, pHalfBandwidth);
+    res.insert(OpenCOR::KINSOLSolver::LowerHalfBandwidthId, pHalfBandwidth);
+    res.insert(OpenCOR::KINSOLSolver::StrategyId, OpenCOR::KINSOLSolver::LineSearchStrategy);
+    res.insert(OpenCOR::KINSOLSolver::MaximumSetupCallsId, pMaximumSetupCalls);
+    res.insert(OpenCOR::KINSOLSolver::AutomaticScalingId, false);
+    res.insert(OpenCOR::KINSOLSolver::FunctionToleranceId, FunctionTolerance);
+    res.insert(OpenCOR::KINSOLSolver::ScaledStepToleranceId, 0.0);
+    res.insert(OpenCOR::KINSOLSolver::NumberOfThreadsId, 1);
+
+    return res;
+}
+
+//==============================================================================
+
+static double solveReactionDiffusionSystem(OpenCOR::KINSOLSolver::KinsolSolver &pSolver,
+                                           const int &pNbOfSolves)
+{
+    // Chain the given number of solves of our reaction-diffusion system, each
+    // of them starting from the solution of the previous one, and return the
+    // maximum residual of the last one
+
+    double parameters[Size];
+    double oldParameters[Size];
+    double residuals[Size];
+
+    for (int i = 0; i < Size; ++i)
+        parameters[i] = qSin(M_PI*i/(Size-1));
+
+    for (int i = 0; i < pNbOfSolves; ++i) {
+        memcpy(oldParameters, parameters, Size*sizeof(double));
+
+        pSolver.initialize(computeReactionDiffusionSystem, parameters, Size,
+                           oldParameters);
+        pSolver.solve();
+    }
+
+    computeReactionDiffusionSystem(parameters, residuals, oldParameters);
+
+    double res = 0.0;
+
+    for (int i = 0; i < Size; ++i)
+        res = qMax(res, qAbs(residuals[i]));
+
+    return res;
+}
+
+//==============================================================================
+
+void Tests::linearSolversTests()
+{
+    // Check that we can solve our reaction-diffusion system using any of our
+    // linear solvers
+
+    foreach (const QString &linearSolver, QStringList() << OpenCOR::KINSOLSolver::DenseLinearSolver
+                                                        << OpenCOR::KINSOLSolver::BandedLinearSolver
+                                                        << OpenCOR::KINSOLSolver::GmresLinearSolver
+                                                        << OpenCOR::KINSOLSolver::BiCgStabLinearSolver
+                                                        << OpenCOR::KINSOLSolver::TfqmrLinearSolver) {
+        OpenCOR::KINSOLSolver::KinsolSolver solver;
+
+        solver.setProperties(solverProperties(linearSolver, 1, 10));
+
+        QVERIFY(solveReactionDiffusionSystem(solver, 10) < 1.0e-8);
+    }
+}
+
+//==============================================================================
+
+void Tests::jacobianReuseTests()
+{
+    // Check that reusing our Jacobian from one solve to the next means that we
+    // evaluate it (much) less often, without affecting our solution
+
+    OpenCOR::KINSOLSolver::KinsolSolver solver;
+    OpenCOR::KINSOLSolver::KinsolSolver reuseSolver;
+
+    solver.setProperties(solverProperties(OpenCOR::KINSOLSolver::BandedLinearSolver, 1, 1));
+    reuseSolver.setProperties(solverProperties(OpenCOR::KINSOLSolver::BandedLinearSolver, 1, 10));
+
+    QVERIFY(solveReactionDiffusionSystem(solver, 100) < 1.0e-8);
+    QVERIFY(solveReactionDiffusionSystem(reuseSolver, 100) < 1.0e-8);
+
+    QCOMPARE(solver.statistics().value(OpenCOR::Solver::NbOfNlaSolves), qint64(100));
+    QCOMPARE(reuseSolver.statistics().value(OpenCOR::Solver::NbOfNlaSolves), qint64(100));
+
+    QVERIFY(   2*reuseSolver.statistics().value(OpenCOR::Solver::NbOfJacobianEvaluations)
+            <= solver.statistics().value(OpenCOR::Solver::NbOfJacobianEvaluations));
+}
+
+//==============================================================================
+
+void Tests::benchmarkTests_data()
+{
+    // Benchmark our linear solvers, with and without reusing our Jacobian
+
+    QTest::addColumn<QString>("linearSolver");
+    QTest::addColumn<int>("halfBandwidth");
+    QTest::addColumn<int>("maximumSetupCalls");
+
+    QTest::newRow("Dense, no Jacobian reuse") << OpenCOR::KINSOLSolver::DenseLinearSolver << 0 << 1;
+    QTest::newRow("Dense") << OpenCOR::KINSOLSolver::DenseLinearSolver << 0 << 10;
+    QTest::newRow("Banded") << OpenCOR::KINSOLSolver::BandedLinearSolver << 1 << 10;
+    QTest::newRow("GMRES") << OpenCOR::KINSOLSolver::GmresLinearSolver << 0 << 10;
+}
+
+//==============================================================================
+
+void Tests::benchmarkTests()
+{
+    // Chain a large number of solves of our reaction-diffusion system
+
+    QFETCH(QString, linearSolver);
+    QFETCH(int, halfBandwidth);
+    QFETCH(int, maximumSetupCalls);
+
+    double residual = 0.0;
+
+    QBENCHMARK {
+        OpenCOR::KINSOLSolver::KinsolSolver solver;
+
+        solver.setProperties(solverProperties(linearSolver, halfBandwidth, maximumSetupCalls));
+
+        residual = solveReactionDiffusionSystem(solver, 200);
+    }
+
+    QVERIFY(residual < 1.0e-8);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
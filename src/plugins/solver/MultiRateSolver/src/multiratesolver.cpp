@@ -0,0 +1,604 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Multi-rate solver
+//==============================================================================
+
+#include "multiratesolver.h"
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+#include <limits>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace MultiRateSolver {
+
+//==============================================================================
+
+// Relative size of the perturbation used to estimate the time scale of our
+// states, and largest step, relative to the time scale of a state, that we
+// consider small enough to integrate that state accurately
+
+static const double Perturbation = 1.0e-6;
+static const double SubstepFactor = 0.5;
+
+//==============================================================================
+
+// Largest number of substeps that we are willing to take over one macro step
+
+static const int MaximumSubstepsCount = 1000000;
+
+//==============================================================================
+
+// Parameters of our macro step and substep size controllers
+
+static const double Safe              = 0.9;
+static const double MinimumStepFactor = 0.2;
+static const double MaximumStepFactor = 2.0;
+
+//==============================================================================
+
+MultiRateSolver::MultiRateSolver() :
+    mStep(StepDefaultValue),
+    mRelativeTolerance(RelativeToleranceDefaultValue),
+    mAbsoluteTolerance(AbsoluteToleranceDefaultValue),
+    mFastStatesCount(0),
+    mFastStates(0),
+    mSlowStatesCount(0),
+    mSlowStates(0),
+    mMacroStep(0.0),
+    mSubstep(0.0),
+    mStartRates(0),
+    mSubstepRates(0),
+    mPreviousRates(0),
+    mEndRates(0),
+    mYk(0),
+    mNbOfErrorTestFailures(0)
+{
+}
+
+//==============================================================================
+
+MultiRateSolver::~MultiRateSolver()
+{
+    // Delete some internal objects
+
+    deleteArrays();
+}
+
+//==============================================================================
+
+void MultiRateSolver::deleteArrays()
+{
+    // Delete our various arrays
+
+    delete[] mFastStates;
+    delete[] mSlowStates;
+    delete[] mStartRates;
+    delete[] mSubstepRates;
+    delete[] mPreviousRates;
+    delete[] mEndRates;
+    delete[] mYk;
+
+    mFastStates = 0;
+    mSlowStates = 0;
+    mStartRates = 0;
+    mSubstepRates = 0;
+    mPreviousRates = 0;
+    mEndRates = 0;
+    mYk = 0;
+}
+
+//==============================================================================
+
+void MultiRateSolver::initialize(const double &pVoiStart,
+                                 const int &pRatesStatesCount,
+                                 double *pConstants, double *pRates,
+                                 double *pStates, double *pAlgebraic,
+                                 ComputeRatesFunction pComputeRates)
+{
+    // Retrieve the solver's properties
+
+    if (mProperties.contains(StepId)) {
+        mStep = mProperties.value(StepId).toDouble();
+
+        if (!mStep) {
+            emit error(QObject::tr("the 'step' property value cannot be equal to zero"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'step' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(RelativeToleranceId)) {
+        mRelativeTolerance = mProperties.value(RelativeToleranceId).toDouble();
+
+        if (mRelativeTolerance < 0) {
+            emit error(QObject::tr("the 'relative tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'relative tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(AbsoluteToleranceId)) {
+        mAbsoluteTolerance = mProperties.value(AbsoluteToleranceId).toDouble();
+
+        if (mAbsoluteTolerance < 0) {
+            emit error(QObject::tr("the 'absolute tolerance' property must have a value greater than or equal to 0"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'absolute tolerance' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (!mRelativeTolerance && !mAbsoluteTolerance) {
+        emit error(QObject::tr("the 'relative tolerance' and 'absolute tolerance' properties cannot both be equal to 0"));
+
+        return;
+    }
+
+    // Initialise the ODE solver itself
+
+    OpenCOR::Solver::OdeSolver::initialize(pVoiStart, pRatesStatesCount,
+                                           pConstants, pRates, pStates,
+                                           pAlgebraic, pComputeRates);
+
+    // (Re)create our various arrays
+
+    deleteArrays();
+
+    mFastStates = new int[pRatesStatesCount];
+    mSlowStates = new int[pRatesStatesCount];
+    mStartRates = new double[pRatesStatesCount];
+    mSubstepRates = new double[pRatesStatesCount];
+    mPreviousRates = new double[pRatesStatesCount];
+    mEndRates = new double[pRatesStatesCount];
+    mYk = new double[pRatesStatesCount];
+
+    // Split our states into fast and slow states, and start with a macro step
+    // that is as big as possible
+    // Note: our initial substep is set when partitioning our states...
+
+    partitionStates(pVoiStart);
+
+    mMacroStep = mStep;
+}
+
+//==============================================================================
+
+void MultiRateSolver::partitionStates(const double &pVoi)
+{
+    // Split our states into fast and slow states, based on their time scale,
+    // i.e. 1/|a| with a the diagonal entry of our Jacobian for a given state,
+    // which we estimate by perturbing our states, one at a time
+    // Note #1: a state is a fast state if its time scale is too small for it
+    //          to be integrated accurately using our (macro) step, in which
+    //          case it gets integrated using substeps, the first of which is
+    //          small enough for our fastest state...
+    // Note #2: our time scales are only estimated at the start of our
+    //          integration, so a slow state may get (much) faster later on
+    //          (e.g. the membrane potential during the upstroke of an action
+    //          potential). This is where our error control comes in, since it
+    //          then forces us to take smaller macro steps...
+
+    memcpy(mYk, mStates, size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+    computeRates(pVoi, mYk, mStartRates);
+
+    mFastStatesCount = 0;
+    mSlowStatesCount = 0;
+    mSubstep = 0.0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        double perturbation = Perturbation*qMax(qAbs(mStates[i]), 1.0);
+
+        mYk[i] = mStates[i]+perturbation;
+
+        computeRates(pVoi, mYk, mSubstepRates);
+
+        mYk[i] = mStates[i];
+
+        double coefficient = qAbs(mSubstepRates[i]-mStartRates[i])/perturbation;
+
+        if (qAbs(mStep)*coefficient > SubstepFactor) {
+            mFastStates[mFastStatesCount++] = i;
+
+            if (!mSubstep || (SubstepFactor/coefficient < mSubstep))
+                mSubstep = SubstepFactor/coefficient;
+        } else {
+            mSlowStates[mSlowStatesCount++] = i;
+        }
+    }
+
+    // Compute our rates one last time, so that our algebraic variables are
+    // consistent with our states
+
+    computeRates(pVoi, mStates);
+}
+
+//==============================================================================
+
+int MultiRateSolver::fastStatesCount() const
+{
+    // Return the number of fast states
+
+    return mFastStatesCount;
+}
+
+//==============================================================================
+
+bool MultiRateSolver::isFastState(const int &pIndex) const
+{
+    // Return whether the given state is a fast state
+
+    for (int i = 0; i < mFastStatesCount; ++i) {
+        if (mFastStates[i] == pIndex)
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+int MultiRateSolver::substepsCount(const double &pStep) const
+{
+    // Return the number of substeps needed to integrate our fast states over
+    // the given (macro) step
+
+    // Note: our number of substeps is bounded so that it cannot overflow if
+    //       our substep is tiny compared to the given step, although advance()
+    //       gives up before we ever need that many substeps...
+
+    if (!mFastStatesCount)
+        return 1;
+
+    return int(qBound(1.0, ceil(qAbs(pStep)/mSubstep), double(MaximumSubstepsCount)));
+}
+
+//==============================================================================
+
+static double stepFactor(const double &pError)
+{
+    // Return the factor by which to multiply a step which local error, of
+    // second order, has the given scaled norm
+
+    if (!pError)
+        return MaximumStepFactor;
+
+    return qMax(MinimumStepFactor, qMin(MaximumStepFactor, Safe/qSqrt(pError)));
+}
+
+//==============================================================================
+
+static double largestError(const double &pError1, const double &pError2)
+{
+    // Return the largest of the given errors, making sure that a NaN doesn't
+    // get lost (unlike with qMax())
+
+    return (qIsNaN(pError1) || (pError1 > pError2))?pError1:pError2;
+}
+
+//==============================================================================
+
+double MultiRateSolver::fastStatesError(const double *pRates,
+                                        const double *pNewRates,
+                                        const double &pSubstep) const
+{
+    // Return the root mean square of the local error of the forward Euler
+    // method for our fast states, scaled using our tolerances, i.e.
+    //   h / 2 * (f_f(t_k + h, Y_k+1) - f_f(t_k, Y_k))
+    // Note: this is the difference between the forward Euler method and Heun's
+    //       method, and it doesn't require any additional model evaluation
+    //       since f_f(t_k + h, Y_k+1) is needed for our next substep anyway...
+
+    double res = 0.0;
+
+    for (int i = 0; i < mFastStatesCount; ++i) {
+        int index = mFastStates[i];
+        double scaledError = 0.5*pSubstep*(pNewRates[index]-pRates[index])/(mAbsoluteTolerance+mRelativeTolerance*qAbs(mYk[index]));
+
+        res += scaledError*scaledError;
+    }
+
+    return qSqrt(res/mFastStatesCount);
+}
+
+//==============================================================================
+
+bool MultiRateSolver::macroStep(const double &pVoi, const double &pStep,
+                                double &pSlowStatesError,
+                                double &pFastStatesError) const
+{
+    // Take one macro step H, i.e.
+    //  - predict our slow states using the forward Euler method:
+    //      Y_s,n+1 = Y_s,n + H * f_s(t_n, Y_n)
+    //  - integrate our fast states using the forward Euler method with m
+    //    substeps h = H / m, using a linear interpolation of our slow states
+    //    between Y_s,n and their predicted value;
+    //  - correct our slow states using Heun's method, with our fast states at
+    //    the end of our substeps:
+    //      Y_s,n+1 = Y_s,n + H / 2 * (f_s(t_n, Y_n) + f_s(t_n + H, Y_n+1))
+    // The difference between our predicted and corrected slow states is both
+    // an estimate of the local error of our slow states and of the error made
+    // by our fast states using our predicted slow states. So, we return the
+    // norm of that difference, as well as the largest norm of the local error
+    // of our fast states over our substeps, both scaled using our tolerances,
+    // and only accept our macro step, i.e. update our states, if both norms
+    // are smaller than or equal to one
+
+    int substepsNb = substepsCount(pStep);
+    double substep = pStep/substepsNb;
+    double *rates = mStartRates;
+
+    computeRates(pVoi, mStates, mStartRates);
+
+    memcpy(mYk, mStates, size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+    pFastStatesError = 0.0;
+
+    for (int i = 0; i < substepsNb; ++i) {
+        if (i) {
+            computeRates(pVoi+i*substep, mYk, mSubstepRates);
+
+            rates = mSubstepRates;
+
+            pFastStatesError = largestError(pFastStatesError, fastStatesError(mPreviousRates, rates, substep));
+        }
+
+        for (int j = 0; j < mFastStatesCount; ++j) {
+            int index = mFastStates[j];
+
+            mPreviousRates[index] = rates[index];
+
+            mYk[index] += substep*rates[index];
+        }
+
+        for (int j = 0; j < mSlowStatesCount; ++j) {
+            int index = mSlowStates[j];
+
+            mYk[index] = mStates[index]+(i+1)*substep*mStartRates[index];
+        }
+    }
+
+    // Estimate the error of our last substep, and correct our slow states and
+    // estimate their error
+
+    computeRates(pVoi+pStep, mYk, mEndRates);
+
+    if (mFastStatesCount)
+        pFastStatesError = largestError(pFastStatesError, fastStatesError(mPreviousRates, mEndRates, substep));
+
+    pSlowStatesError = 0.0;
+
+    for (int i = 0; i < mSlowStatesCount; ++i) {
+        int index = mSlowStates[i];
+        double correction = 0.5*pStep*(mEndRates[index]-mStartRates[index]);
+        double slowState = mYk[index]+correction;
+        double scaledError = correction/(mAbsoluteTolerance+mRelativeTolerance*qMax(qAbs(mStates[index]), qAbs(slowState)));
+
+        pSlowStatesError += scaledError*scaledError;
+
+        mYk[index] = slowState;
+    }
+
+    if (mSlowStatesCount)
+        pSlowStatesError = qSqrt(pSlowStatesError/mSlowStatesCount);
+
+    if (   !qIsFinite(pSlowStatesError) || !qIsFinite(pFastStatesError)
+        || (pSlowStatesError > 1.0) || (pFastStatesError > 1.0)) {
+        return false;
+    }
+
+    memcpy(mStates, mYk, size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+    ++mNbOfSteps;
+
+    return true;
+}
+
+//==============================================================================
+
+bool MultiRateSolver::advance(const double &pVoi, const double &pStep) const
+{
+    // Integrate our states over the given step, using as many macro steps as
+    // needed for our error test to pass
+    // Note #1: the size of our next macro step is based on the error of our
+    //          slow states while the size of our next substeps is based on the
+    //          error of our fast states. Both are kept from one call to the
+    //          next, but they can never be bigger than mStep...
+    // Note #2: our last macro step may be shortened so that we don't go past
+    //          the end of the given step, in which case we don't let it reduce
+    //          the size of our next macro step, nor that of our next substeps
+    //          unless our fast states failed our error test...
+    // Note #3: we check whether we would reach or go past the end of the given
+    //          step using the VOI we would actually end up with, since
+    //          comparing the remaining interval with our macro step may, due to
+    //          round-off errors, let us go past it by a tiny amount and
+    //          therefore never reach it...
+
+    double voi = pVoi;
+    double voiEnd = pVoi+pStep;
+    double slowStatesError;
+    double fastStatesError;
+
+    while (voi != voiEnd) {
+        double step = mMacroStep;
+        bool lastStep = false;
+
+        if ((voi+step-voiEnd)*step >= 0.0) {
+            step = voiEnd-voi;
+
+            lastStep = true;
+        }
+
+        // Make sure that we don't need too many substeps
+
+        if (mFastStatesCount && (qAbs(step)/mSubstep > MaximumSubstepsCount)) {
+            const_cast<MultiRateSolver *>(this)->emitError(QObject::tr("the step became too small at %1").arg(voi));
+            // Note: we are const, hence we need to cast ourselves before we
+            //       can let people know about the error...
+
+            return false;
+        }
+
+        double substep = qAbs(step)/substepsCount(step);
+        bool accepted = macroStep(voi, step, slowStatesError, fastStatesError);
+
+        // Make sure that our model didn't produce a NaN or an infinite value,
+        // in which case there is no point in trying smaller steps
+
+        if (!qIsFinite(slowStatesError) || !qIsFinite(fastStatesError)) {
+            const_cast<MultiRateSolver *>(this)->emitError(QObject::tr("the solution is not a finite number at %1").arg(voi));
+
+            return false;
+        }
+
+        if (mFastStatesCount) {
+            double newSubstep = qMin(substep*stepFactor(fastStatesError), qAbs(mStep));
+
+            if (!lastStep || (fastStatesError > 1.0) || (newSubstep > mSubstep))
+                mSubstep = newSubstep;
+        }
+
+        if (accepted) {
+            double newMacroStep = step*stepFactor(slowStatesError);
+
+            if (!lastStep || (qAbs(newMacroStep) > qAbs(mMacroStep)))
+                mMacroStep = (qAbs(newMacroStep) < qAbs(mStep))?newMacroStep:mStep;
+
+            voi = lastStep?voiEnd:voi+step;
+        } else {
+            ++mNbOfErrorTestFailures;
+
+            if (slowStatesError > 1.0)
+                mMacroStep = step*stepFactor(slowStatesError);
+
+            double minimumStep = 10.0*std::numeric_limits<double>::epsilon()*qAbs(voi);
+
+            if (   (qAbs(mMacroStep) <= minimumStep)
+                || (mFastStatesCount && (mSubstep <= minimumStep))) {
+                const_cast<MultiRateSolver *>(this)->emitError(QObject::tr("the step became too small at %1").arg(voi));
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+
+void MultiRateSolver::solve(double &pVoi, const double &pVoiEnd) const
+{
+    // Integrate our states from pVoi to pVoiEnd using steps of mStep, each of
+    // which consists of one or several macro steps
+
+    double voiStart = pVoi;
+
+    int stepNumber = 0;
+    double realStep = mStep;
+
+    startEventDetection(pVoi);
+
+    while (pVoi != pVoiEnd) {
+        // Check that the time step is correct
+
+        if (pVoi+realStep > pVoiEnd)
+            realStep = pVoiEnd-pVoi;
+
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
+        // Integrate our states over our step
+
+        if (!advance(pVoi, realStep))
+            return;
+
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
+
+        if (eventStatus == EventLocated)
+            continue;
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+        } else if (realStep != mStep) {
+            pVoi = pVoiEnd;
+        } else {
+            pVoi = voiStart+(++stepNumber)*mStep;
+        }
+    }
+
+    // Compute the rates one more time to get up to date values for the rates
+    // (see CvodeSolver::solve())
+
+    computeRates(pVoiEnd, mStates);
+}
+
+//==============================================================================
+
+OpenCOR::Solver::Statistics MultiRateSolver::statistics() const
+{
+    // Return our statistics, including the number of macro steps that got
+    // rejected by our error test
+
+    OpenCOR::Solver::Statistics res = OpenCOR::Solver::OdeSolver::statistics();
+
+    if (mNbOfErrorTestFailures)
+        res.insert(OpenCOR::Solver::NbOfErrorTestFailures, mNbOfErrorTestFailures);
+
+    return res;
+}
+
+//==============================================================================
+
+}   // namespace MultiRateSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
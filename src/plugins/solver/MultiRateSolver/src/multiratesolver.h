@@ -0,0 +1,110 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Multi-rate solver
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "solverinterface.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace MultiRateSolver {
+
+//==============================================================================
+
+static const auto StepId              = QStringLiteral("Step");
+static const auto RelativeToleranceId = QStringLiteral("RelativeTolerance");
+static const auto AbsoluteToleranceId = QStringLiteral("AbsoluteTolerance");
+
+//==============================================================================
+
+static const double StepDefaultValue = 1.0;
+
+static const double RelativeToleranceDefaultValue = 1.0e-5;
+static const double AbsoluteToleranceDefaultValue = 1.0e-5;
+
+//==============================================================================
+
+class MultiRateSolver : public Solver::OdeSolver
+{
+public:
+    explicit MultiRateSolver();
+    ~MultiRateSolver();
+
+    virtual void initialize(const double &pVoiStart,
+                            const int &pRatesStatesCount, double *pConstants,
+                            double *pRates, double *pStates, double *pAlgebraic,
+                            ComputeRatesFunction pComputeRates);
+
+    virtual void solve(double &pVoi, const double &pVoiEnd) const;
+
+    virtual OpenCOR::Solver::Statistics statistics() const;
+
+    int fastStatesCount() const;
+    bool isFastState(const int &pIndex) const;
+
+    int substepsCount(const double &pStep) const;
+
+private:
+    double mStep;
+    double mRelativeTolerance;
+    double mAbsoluteTolerance;
+
+    int mFastStatesCount;
+    int *mFastStates;
+
+    int mSlowStatesCount;
+    int *mSlowStates;
+
+    mutable double mMacroStep;
+    mutable double mSubstep;
+
+    double *mStartRates;
+    double *mSubstepRates;
+    double *mPreviousRates;
+    double *mEndRates;
+    double *mYk;
+
+    mutable qint64 mNbOfErrorTestFailures;
+
+    void deleteArrays();
+
+    void partitionStates(const double &pVoi);
+
+    double fastStatesError(const double *pRates, const double *pNewRates,
+                           const double &pSubstep) const;
+
+    bool advance(const double &pVoi, const double &pStep) const;
+    bool macroStep(const double &pVoi, const double &pStep,
+                   double &pSlowStatesError, double &pFastStatesError) const;
+};
+
+//==============================================================================
+
+}   // namespace MultiRateSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
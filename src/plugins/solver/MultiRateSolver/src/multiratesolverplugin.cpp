@@ -0,0 +1,167 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Multi-rate solver plugin
+//==============================================================================
+
+#include "multiratesolver.h"
+#include "multiratesolverplugin.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace MultiRateSolver {
+
+//==============================================================================
+
+PLUGININFO_FUNC MultiRateSolverPluginInfo()
+{
+    Descriptions descriptions;
+
+    descriptions.insert("en", QString::fromUtf8("a plugin that implements a multi-rate method to solve ODEs."));
+    descriptions.insert("fr", QString::fromUtf8("une extension qui implémente une méthode multi-pas de temps pour résoudre des EDOs."));
+
+    return new PluginInfo("Solver", true, false,
+                          QStringList(),
+                          descriptions);
+}
+
+//==============================================================================
+// I18n interface
+//==============================================================================
+
+void MultiRateSolverPlugin::retranslateUi()
+{
+    // We don't handle this interface...
+    // Note: even though we don't handle this interface, we still want to
+    //       support it since some other aspects of our plugin are
+    //       multilingual...
+}
+
+//==============================================================================
+// Solver interface
+//==============================================================================
+
+Solver::Solver * MultiRateSolverPlugin::solverInstance() const
+{
+    // Create and return an instance of the solver
+
+    return new MultiRateSolver();
+}
+
+//==============================================================================
+
+QString MultiRateSolverPlugin::id(const QString &pKisaoId) const
+{
+    // Return the id for the given KiSAO id
+
+    if (!pKisaoId.compare("KISAO:0000000"))
+        return solverName();
+    else if (!pKisaoId.compare("KISAO:0000483"))
+        return StepId;
+    else if (!pKisaoId.compare("KISAO:0000209"))
+        return RelativeToleranceId;
+    else if (!pKisaoId.compare("KISAO:0000211"))
+        return AbsoluteToleranceId;
+
+    return QString();
+}
+
+//==============================================================================
+
+QString MultiRateSolverPlugin::kisaoId(const QString &pId) const
+{
+    // Return the KiSAO id for the given id
+    // Note: KiSAO has no term for multi-rate methods, so we use its root term,
+    //       which, unlike a more specific term, cannot be mistaken for that of
+    //       another of our solvers...
+
+    if (!pId.compare(solverName()))
+        return "KISAO:0000000";
+    else if (!pId.compare(StepId))
+        return "KISAO:0000483";
+    else if (!pId.compare(RelativeToleranceId))
+        return "KISAO:0000209";
+    else if (!pId.compare(AbsoluteToleranceId))
+        return "KISAO:0000211";
+
+    return QString();
+}
+
+//==============================================================================
+
+Solver::Type MultiRateSolverPlugin::solverType() const
+{
+    // Return the type of the solver
+
+    return Solver::Ode;
+}
+
+//==============================================================================
+
+QString MultiRateSolverPlugin::solverName() const
+{
+    // Return the name of the solver
+
+    return "Multi-rate";
+}
+
+//==============================================================================
+
+Solver::Properties MultiRateSolverPlugin::solverProperties() const
+{
+    // Return the properties supported by the solver
+
+    Descriptions stepDescriptions;
+    Descriptions relativeToleranceDescriptions;
+    Descriptions absoluteToleranceDescriptions;
+
+    stepDescriptions.insert("en", QString::fromUtf8("Step"));
+    stepDescriptions.insert("fr", QString::fromUtf8("Pas"));
+
+    relativeToleranceDescriptions.insert("en", QString::fromUtf8("Relative tolerance"));
+    relativeToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance relative"));
+
+    absoluteToleranceDescriptions.insert("en", QString::fromUtf8("Absolute tolerance"));
+    absoluteToleranceDescriptions.insert("fr", QString::fromUtf8("Tolérance absolue"));
+
+    return Solver::Properties() << Solver::Property(Solver::Property::Double, StepId, stepDescriptions, QStringList(), StepDefaultValue, true)
+                                << Solver::Property(Solver::Property::Double, RelativeToleranceId, relativeToleranceDescriptions, QStringList(), RelativeToleranceDefaultValue, false)
+                                << Solver::Property(Solver::Property::Double, AbsoluteToleranceId, absoluteToleranceDescriptions, QStringList(), AbsoluteToleranceDefaultValue, false);
+}
+
+//==============================================================================
+
+QMap<QString, bool> MultiRateSolverPlugin::solverPropertiesVisibility(const QMap<QString, QString> &pSolverPropertiesValues) const
+{
+    Q_UNUSED(pSolverPropertiesValues);
+
+    // We don't handle this interface...
+
+    return QMap<QString, bool>();
+}
+
+//==============================================================================
+
+}   // namespace MultiRateSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,316 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Multi-rate solver tests
+//==============================================================================
+
+#include "../../solvertestsutils.h"
+
+//==============================================================================
+
+#include "multiratesolver.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+static int computeFastSlowRates(double VOI, double *CONSTANTS, double *RATES,
+                                double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A fast state which follows a slow state, i.e. with y0(0) = 0 and
+    // y1(0) = 1:
+    //   y0 = 100/99*(exp(-t)-exp(-100*t))
+    //   y1 = exp(-t)
+
+    RATES[0] = -100.0*(STATES[0]-STATES[1]);
+    RATES[1] = -STATES[1];
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeNanRates(double VOI, double *CONSTANTS, double *RATES,
+                           double *STATES, double *ALGEBRAIC)
+{
+    // Our fast/slow model, except that the rate of our slow state becomes NaN
+    // after t = 0.25
+
+    computeFastSlowRates(VOI, CONSTANTS, RATES, STATES, ALGEBRAIC);
+
+    if (VOI > 0.25)
+        RATES[1] = qQNaN();
+
+    return 0;
+}
+
+//==============================================================================
+
+static int computeVeryStiffRates(double VOI, double *CONSTANTS, double *RATES,
+                                 double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A fast state which follows a slow state, but on a time scale that would
+    // require trillions of substeps per unit of time
+
+    RATES[0] = -1.0e12*(STATES[0]-STATES[1]);
+    RATES[1] = -STATES[1];
+
+    return 0;
+}
+
+//==============================================================================
+
+static OpenCOR::Solver::Solver::Properties solverProperties(const double &pStep,
+                                                           const double &pTolerance)
+{
+    // Return the properties of our solver
+
+    OpenCOR::Solver::Solver::Properties res;
+
+    res.insert(OpenCOR::MultiRateSolver::StepId, pStep);
+    res.insert(OpenCOR::MultiRateSolver::RelativeToleranceId, pTolerance);
+    res.insert(OpenCOR::MultiRateSolver::AbsoluteToleranceId, pTolerance);
+
+    return res;
+}
+
+//==============================================================================
+
+static double fastSlowError(OpenCOR::MultiRateSolver::MultiRateSolver &pSolver,
+                            const double &pStep, const double &pTolerance)
+{
+    // Solve our fast/slow model and return the maximum error against its exact
+    // solution
+
+    double constants[1];
+    double rates[2];
+    double states[2] = { 0.0, 1.0 };
+    double algebraic[1];
+
+    OpenCOR::initializeSolver(pSolver, solverProperties(pStep, pTolerance),
+                              2, constants, rates, states, algebraic,
+                              computeFastSlowRates);
+
+    double voi = 0.0;
+    double res = 0.0;
+
+    for (int i = 1; i <= 50; ++i) {
+        pSolver.solve(voi, 0.1*i);
+
+        res = qMax(res, qMax(qAbs(states[0]-100.0/99.0*(qExp(-voi)-qExp(-100.0*voi))),
+                             qAbs(states[1]-qExp(-voi))));
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void Tests::partitionTests()
+{
+    // Check that our fast state is considered as such and that it gets
+    // integrated using substeps that are small enough for it, i.e. such that
+    // h*100 <= 0.5
+
+    OpenCOR::MultiRateSolver::MultiRateSolver solver;
+    double constants[1];
+    double rates[2];
+    double states[2] = { 0.0, 1.0 };
+    double algebraic[1];
+
+    OpenCOR::initializeSolver(solver, solverProperties(0.1, 1.0e-5),
+                              2, constants, rates, states, algebraic,
+                              computeFastSlowRates);
+
+    QCOMPARE(solver.fastStatesCount(), 1);
+    QVERIFY(solver.isFastState(0));
+    QVERIFY(!solver.isFastState(1));
+    QVERIFY(solver.substepsCount(0.1) >= 20);
+
+    // Check that there are no fast states if our step is small enough for all
+    // of our states
+
+    OpenCOR::MultiRateSolver::MultiRateSolver smallStepSolver;
+
+    OpenCOR::initializeSolver(smallStepSolver, solverProperties(0.001, 1.0e-5),
+                              2, constants, rates, states, algebraic,
+                              computeFastSlowRates);
+
+    QCOMPARE(smallStepSolver.fastStatesCount(), 0);
+    QCOMPARE(smallStepSolver.substepsCount(0.001), 1);
+}
+
+//==============================================================================
+
+void Tests::accuracyTests()
+{
+    // Check that we follow the exact solution of our fast/slow model
+
+    OpenCOR::MultiRateSolver::MultiRateSolver solver;
+
+    QVERIFY(fastSlowError(solver, 0.1, 1.0e-5) < 1.0e-4);
+}
+
+//==============================================================================
+
+void Tests::efficiencyTests()
+{
+    // Check that, for a given accuracy, integrating the slow state of our
+    // fast/slow model using a (much) bigger step than its fast state requires
+    // fewer model evaluations than integrating both states using the same
+    // step, i.e. the largest step for which there is no fast state (since
+    // h*100 <= 0.5)
+
+    OpenCOR::MultiRateSolver::MultiRateSolver multiRateSolver;
+    OpenCOR::MultiRateSolver::MultiRateSolver singleRateSolver;
+
+    double multiRateError = fastSlowError(multiRateSolver, 0.1, 1.0e-4);
+    double singleRateError = fastSlowError(singleRateSolver, 0.0049, 1.0e-4);
+
+    QCOMPARE(multiRateSolver.fastStatesCount(), 1);
+    QCOMPARE(singleRateSolver.fastStatesCount(), 0);
+
+    QVERIFY(multiRateError < 1.0e-4);
+    QVERIFY(singleRateError < 1.0e-4);
+
+    QVERIFY(  multiRateSolver.statistics().value(OpenCOR::Solver::NbOfRhsEvaluations)
+            < singleRateSolver.statistics().value(OpenCOR::Solver::NbOfRhsEvaluations));
+}
+
+//==============================================================================
+
+void Tests::errorControlTests()
+{
+    // Check that we can simulate the Hodgkin-Huxley model with a step that is
+    // much bigger than the time scale of its fast gating variable and of its
+    // membrane potential during the upstroke, and still get an action
+    // potential, thanks to our error control
+
+    OpenCOR::MultiRateSolver::MultiRateSolver solver;
+    double constants[1];
+    double rates[OpenCOR::HodgkinHuxleyStatesCount];
+    double states[OpenCOR::HodgkinHuxleyStatesCount];
+    double algebraic[1];
+
+    OpenCOR::initializeHodgkinHuxleyStates(states);
+    OpenCOR::initializeSolver(solver, solverProperties(0.5, 1.0e-5),
+                              OpenCOR::HodgkinHuxleyStatesCount, constants,
+                              rates, states, algebraic,
+                              OpenCOR::computeHodgkinHuxleyRates);
+
+    QVERIFY(solver.isFastState(1));
+
+    double voi = 0.0;
+    double minimumV = 0.0;
+
+    for (int i = 1; i <= 100; ++i) {
+        solver.solve(voi, 0.5*i);
+
+        QVERIFY(qIsFinite(states[0]));
+
+        minimumV = qMin(minimumV, states[0]);
+    }
+
+    QVERIFY((minimumV < -90.0) && (minimumV > -110.0));
+    QVERIFY(qAbs(states[0]) < 5.0);
+    QVERIFY(solver.statistics().value(OpenCOR::Solver::NbOfErrorTestFailures) > 0);
+}
+
+//==============================================================================
+
+void Tests::nanRatesTests()
+{
+    // Check that we report an error rather than accept NaN states or shrink
+    // our step until it underflows when our model produces a NaN
+
+    OpenCOR::MultiRateSolver::MultiRateSolver solver;
+    QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+    double constants[1];
+    double rates[2];
+    double states[2] = { 0.0, 1.0 };
+    double algebraic[1];
+
+    OpenCOR::initializeSolver(solver, solverProperties(0.1, 1.0e-5),
+                              2, constants, rates, states, algebraic,
+                              computeNanRates);
+
+    double voi = 0.0;
+
+    solver.solve(voi, 1.0);
+
+    QCOMPARE(errorSpy.count(), 1);
+    QVERIFY(errorSpy.first().first().toString().startsWith("the solution is not a finite number at "));
+    QVERIFY(voi <= 0.25);
+    QVERIFY(qIsFinite(states[0]) && qIsFinite(states[1]));
+}
+
+//==============================================================================
+
+void Tests::tooManySubstepsTests()
+{
+    // Check that our number of substeps doesn't overflow when our fast state
+    // is extremely fast compared to our step, and that we report an error
+    // rather than try to take that many substeps
+
+    OpenCOR::MultiRateSolver::MultiRateSolver solver;
+    QSignalSpy errorSpy(&solver, SIGNAL(error(const QString &)));
+    double constants[1];
+    double rates[2];
+    double states[2] = { 0.0, 1.0 };
+    double algebraic[1];
+
+    OpenCOR::initializeSolver(solver, solverProperties(1.0, 1.0e-5),
+                              2, constants, rates, states, algebraic,
+                              computeVeryStiffRates);
+
+    QVERIFY(solver.isFastState(0));
+    QVERIFY(solver.substepsCount(1.0) > 1);
+    QVERIFY(solver.substepsCount(-1.0) > 1);
+
+    double voi = 0.0;
+
+    solver.solve(voi, 1.0);
+
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(errorSpy.first().first().toString(), QString("the step became too small at 0"));
+    QCOMPARE(voi, 0.0);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
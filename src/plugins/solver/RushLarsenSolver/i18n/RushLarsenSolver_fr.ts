@@ -0,0 +1,19 @@
+<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE TS>
+<TS version="2.1" language="fr_FR" sourcelanguage="en_GB">
+<context>
+    <name>QObject</name>
+    <message>
+        <source>the &apos;step&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;pas&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+    <message>
+        <source>the &apos;step&apos; property value cannot be equal to zero</source>
+        <translation>la valeur de la propriété &apos;pas&apos; ne peut pas être égale à zéro</translation>
+    </message>
+    <message>
+        <source>the &apos;non-gating integration method&apos; property value could not be retrieved</source>
+        <translation>la valeur de la propriété &apos;méthode d&apos;intégration non-gating&apos; n&apos;a pas pu être retrouvée</translation>
+    </message>
+</context>
+</TS>
@@ -0,0 +1,484 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Rush-Larsen solver
+//==============================================================================
+
+#include "rushlarsensolver.h"
+
+//==============================================================================
+
+#include <QMap>
+#include <QSet>
+
+//==============================================================================
+
+#include <cmath>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace RushLarsenSolver {
+
+//==============================================================================
+
+// Relative size of the perturbation used to probe our states and relative
+// tolerance used to decide whether a rate is affine in its state
+
+static const double Perturbation = 1.0e-3;
+static const double AffineTolerance = 1.0e-6;
+
+//==============================================================================
+
+RushLarsenSolver::RushLarsenSolver() :
+    mStep(StepDefaultValue),
+    mSecondOrder(false),
+    mGatingStatesCount(0),
+    mGatingStates(0),
+    mGroupsCount(0),
+    mGroupOffsets(0),
+    mNonGatingStatesCount(0),
+    mNonGatingStates(0),
+    mCoefficients(0),
+    mYk(0),
+    mYPerturbed(0),
+    mPerturbations(0),
+    mPerturbedRates(0)
+{
+}
+
+//==============================================================================
+
+RushLarsenSolver::~RushLarsenSolver()
+{
+    // Delete some internal objects
+
+    deleteArrays();
+}
+
+//==============================================================================
+
+void RushLarsenSolver::deleteArrays()
+{
+    // Delete our various arrays
+
+    delete[] mGatingStates;
+    delete[] mGroupOffsets;
+    delete[] mNonGatingStates;
+    delete[] mCoefficients;
+    delete[] mYk;
+    delete[] mYPerturbed;
+    delete[] mPerturbations;
+    delete[] mPerturbedRates;
+
+    mGatingStates = 0;
+    mGroupOffsets = 0;
+    mNonGatingStates = 0;
+    mCoefficients = 0;
+    mYk = 0;
+    mYPerturbed = 0;
+    mPerturbations = 0;
+    mPerturbedRates = 0;
+}
+
+//==============================================================================
+
+void RushLarsenSolver::initialize(const double &pVoiStart,
+                                  const int &pRatesStatesCount,
+                                  double *pConstants, double *pRates,
+                                  double *pStates, double *pAlgebraic,
+                                  ComputeRatesFunction pComputeRates)
+{
+    // Retrieve the solver's properties
+
+    if (mProperties.contains(StepId)) {
+        mStep = mProperties.value(StepId).toDouble();
+
+        if (!mStep) {
+            emit error(QObject::tr("the 'step' property value cannot be equal to zero"));
+
+            return;
+        }
+    } else {
+        emit error(QObject::tr("the 'step' property value could not be retrieved"));
+
+        return;
+    }
+
+    if (mProperties.contains(NonGatingIntegrationMethodId)) {
+        mSecondOrder = !mProperties.value(NonGatingIntegrationMethodId).toString().compare(SecondOrderRungeKuttaMethod);
+    } else {
+        emit error(QObject::tr("the 'non-gating integration method' property value could not be retrieved"));
+
+        return;
+    }
+
+    // Initialise the ODE solver itself
+
+    OpenCOR::Solver::OdeSolver::initialize(pVoiStart, pRatesStatesCount,
+                                           pConstants, pRates, pStates,
+                                           pAlgebraic, pComputeRates);
+
+    // (Re)create our various arrays
+
+    deleteArrays();
+
+    mGatingStates = new int[pRatesStatesCount];
+    mGroupOffsets = new int[pRatesStatesCount+1];
+    mNonGatingStates = new int[pRatesStatesCount];
+    mCoefficients = new double[pRatesStatesCount];
+    mYk = new double[pRatesStatesCount];
+    mYPerturbed = new double[pRatesStatesCount];
+    mPerturbations = new double[pRatesStatesCount];
+    mPerturbedRates = new double[pRatesStatesCount];
+
+    // Determine which of our states are gating states
+
+    detectGatingStates(pVoiStart);
+}
+
+//==============================================================================
+
+void RushLarsenSolver::detectGatingStates(const double &pVoi)
+{
+    // Determine which of our states are gating-like states, i.e. states which
+    // rate is of the form dy/dt = a*y+b = (y_inf-y)/tau, with a and b not
+    // depending on y
+    // Note #1: our model is only available to us as compiled code, so rather
+    //          than analysing its equations, we probe it by perturbing our
+    //          states, one at a time, and checking how our rates respond...
+    // Note #2: a state is a gating state if its rate is (numerically) affine
+    //          in it with a negative coefficient. We then want to retrieve the
+    //          coefficients of our gating states with as few model
+    //          evaluations as possible, so we split them into groups of states
+    //          which rates don't depend on one another, meaning that all the
+    //          states in a group can be perturbed at once. For a
+    //          Hodgkin-Huxley-type model, the gates, which only depend on the
+    //          membrane potential, end up in a first group while the membrane
+    //          potential, which rate is affine in it for given gates, ends up
+    //          in a second group...
+
+    double *rates = new double[mRatesStatesCount];
+
+    memcpy(mYPerturbed, mStates, size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+    computeRates(pVoi, mYPerturbed, rates);
+
+    // Look for our candidates
+
+    QList<int> candidates = QList<int>();
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        mPerturbations[i] = Perturbation*qMax(qAbs(mStates[i]), 1.0);
+
+        mYPerturbed[i] = mStates[i]+mPerturbations[i];
+
+        computeRates(pVoi, mYPerturbed, mPerturbedRates);
+
+        double firstDifference = mPerturbedRates[i]-rates[i];
+
+        mYPerturbed[i] = mStates[i]+2.0*mPerturbations[i];
+
+        computeRates(pVoi, mYPerturbed, mPerturbedRates);
+
+        double secondDifference = mPerturbedRates[i]-rates[i]-firstDifference;
+
+        mYPerturbed[i] = mStates[i];
+
+        if (   (firstDifference < 0.0)
+            && (qAbs(secondDifference-firstDifference) <= AffineTolerance*qAbs(firstDifference))) {
+            candidates << i;
+        }
+    }
+
+    // Determine on which other candidates each candidate depends
+
+    QMap<int, QSet<int>> dependencies = QMap<int, QSet<int>>();
+
+    foreach (int j, candidates) {
+        mYPerturbed[j] = mStates[j]+mPerturbations[j];
+
+        computeRates(pVoi, mYPerturbed, mPerturbedRates);
+
+        mYPerturbed[j] = mStates[j];
+
+        foreach (int i, candidates) {
+            if ((i != j) && (mPerturbedRates[i] != rates[i]))
+                dependencies[i] << j;
+        }
+    }
+
+    // Split our candidates into groups of states that don't depend on one
+    // another, starting with those that depend on the fewest other candidates
+
+    QList<QList<int>> groups = QList<QList<int>>();
+
+    for (int nbOfDependencies = 0, nbOfCandidates = candidates.count();
+         nbOfCandidates; ++nbOfDependencies) {
+        foreach (int candidate, candidates) {
+            if (dependencies.value(candidate).count() != nbOfDependencies)
+                continue;
+
+            --nbOfCandidates;
+
+            bool groupFound = false;
+
+            for (int i = 0, iMax = groups.count(); i < iMax; ++i) {
+                bool independent = true;
+
+                foreach (int state, groups[i]) {
+                    if (   dependencies.value(candidate).contains(state)
+                        || dependencies.value(state).contains(candidate)) {
+                        independent = false;
+
+                        break;
+                    }
+                }
+
+                if (independent) {
+                    groups[i] << candidate;
+
+                    groupFound = true;
+
+                    break;
+                }
+            }
+
+            if (!groupFound)
+                groups << (QList<int>() << candidate);
+        }
+    }
+
+    // Keep track of our gating states, group by group, and of our non-gating
+    // states
+
+    mGatingStatesCount = 0;
+    mGroupsCount = groups.count();
+
+    for (int i = 0; i < mGroupsCount; ++i) {
+        mGroupOffsets[i] = mGatingStatesCount;
+
+        foreach (int state, groups[i])
+            mGatingStates[mGatingStatesCount++] = state;
+    }
+
+    mGroupOffsets[mGroupsCount] = mGatingStatesCount;
+
+    mNonGatingStatesCount = 0;
+
+    for (int i = 0; i < mRatesStatesCount; ++i) {
+        if (!candidates.contains(i))
+            mNonGatingStates[mNonGatingStatesCount++] = i;
+    }
+
+    delete[] rates;
+}
+
+//==============================================================================
+
+int RushLarsenSolver::gatingStatesCount() const
+{
+    // Return the number of gating states
+
+    return mGatingStatesCount;
+}
+
+//==============================================================================
+
+bool RushLarsenSolver::isGatingState(const int &pIndex) const
+{
+    // Return whether the given state is a gating state
+
+    for (int i = 0; i < mGatingStatesCount; ++i) {
+        if (mGatingStates[i] == pIndex)
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+void RushLarsenSolver::computeRatesAndCoefficients(const double &pVoi,
+                                                   double *pStates) const
+{
+    // Compute the coefficient a of each of our gating states, i.e.
+    // dy/dt = a*y+b, by perturbing all the states of a group at once
+    // Note: this is exact (up to round-off errors) since the rate of a gating
+    //       state is affine in it and doesn't depend on any other state in its
+    //       group...
+
+    for (int i = 0; i < mGroupsCount; ++i) {
+        memcpy(mYPerturbed, pStates, size_t(mRatesStatesCount*OpenCOR::Solver::SizeOfDouble));
+
+        for (int j = mGroupOffsets[i], jMax = mGroupOffsets[i+1]; j < jMax; ++j) {
+            int index = mGatingStates[j];
+
+            mPerturbations[index] = Perturbation*qMax(qAbs(pStates[index]), 1.0);
+
+            mYPerturbed[index] += mPerturbations[index];
+        }
+
+        computeRates(pVoi, mYPerturbed, mPerturbedRates);
+
+        for (int j = mGroupOffsets[i], jMax = mGroupOffsets[i+1]; j < jMax; ++j) {
+            int index = mGatingStates[j];
+
+            mCoefficients[index] = mPerturbedRates[index];
+        }
+    }
+
+    // Compute our rates
+    // Note: we do this last so that our algebraic variables are consistent
+    //       with the given states...
+
+    computeRates(pVoi, pStates);
+
+    for (int i = 0; i < mGatingStatesCount; ++i) {
+        int index = mGatingStates[i];
+
+        mCoefficients[index] = (mCoefficients[index]-mRates[index])/mPerturbations[index];
+    }
+}
+
+//==============================================================================
+
+void RushLarsenSolver::advance(double *pStates, const double *pStartStates,
+                               const double *pCurrentStates,
+                               const double &pStep) const
+{
+    // Advance our gating states from the given start states using the rates
+    // and coefficients computed at the given current states, i.e.
+    //   y_n+1 = y_inf + (y_n - y_inf) * exp(a * h)
+    //         = y_n + f(y_n) / a * (exp(a * h) - 1)
+    // with f(y_n) = f(y_k) + a * (y_n - y_k)
+
+    for (int i = 0; i < mGatingStatesCount; ++i) {
+        int index = mGatingStates[i];
+        double coefficient = mCoefficients[index];
+        double rate = mRates[index]+coefficient*(pStartStates[index]-pCurrentStates[index]);
+
+        if (coefficient)
+            pStates[index] = pStartStates[index]+rate*std::expm1(coefficient*pStep)/coefficient;
+        else
+            pStates[index] = pStartStates[index]+pStep*rate;
+    }
+
+    // Advance our non-gating states using the rates computed at the given
+    // current states, i.e.
+    //   Y_n+1 = Y_n + h * f(t_k, Y_k)
+
+    for (int i = 0; i < mNonGatingStatesCount; ++i) {
+        int index = mNonGatingStates[i];
+
+        pStates[index] = pStartStates[index]+pStep*mRates[index];
+    }
+}
+
+//==============================================================================
+
+void RushLarsenSolver::solve(double &pVoi, const double &pVoiEnd) const
+{
+    // Forward Euler for our non-gating states:
+    //   Y_n+1 = Y_n + h * f(t_n, Y_n)
+    // Second-order Runge-Kutta for our non-gating states:
+    //   Y_k = Y_n + h / 2 * f(t_n, Y_n)
+    //   Y_n+1 = Y_n + h * f(t_n + h / 2, Y_k)
+    // Our gating states are integrated exactly over h (or h / 2 for Y_k) using
+    // their coefficients at the same points
+
+    double voiStart = pVoi;
+
+    int stepNumber = 0;
+    double realStep = mStep;
+    double realHalfStep = 0.5*realStep;
+
+    startEventDetection(pVoi);
+
+    while (pVoi != pVoiEnd) {
+        // Check that the time step is correct
+
+        if (pVoi+realStep > pVoiEnd) {
+            realStep = pVoiEnd-pVoi;
+            realHalfStep = 0.5*realStep;
+        }
+
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
+        // Compute f(t_n, Y_n) and our coefficients
+
+        computeRatesAndCoefficients(pVoi, mStates);
+
+        if (mSecondOrder) {
+            // Compute Y_k and then f(t_n + h / 2, Y_k) and our coefficients
+
+            advance(mYk, mStates, mStates, realHalfStep);
+
+            computeRatesAndCoefficients(pVoi+realHalfStep, mYk);
+
+            // Compute Y_n+1
+
+            advance(mStates, mStates, mYk, realStep);
+        } else {
+            // Compute Y_n+1
+
+            advance(mStates, mStates, mStates, realStep);
+        }
+
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
+
+        if (eventStatus == EventLocated) {
+            realHalfStep = 0.5*realStep;
+
+            continue;
+        }
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        ++mNbOfSteps;
+
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+            realHalfStep = 0.5*realStep;
+        } else if (realStep != mStep) {
+            pVoi = pVoiEnd;
+        } else {
+            pVoi = voiStart+(++stepNumber)*mStep;
+        }
+    }
+}
+
+//==============================================================================
+
+}   // namespace RushLarsenSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,104 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Rush-Larsen solver
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "solverinterface.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace RushLarsenSolver {
+
+//==============================================================================
+
+static const auto StepId                       = QStringLiteral("Step");
+static const auto NonGatingIntegrationMethodId = QStringLiteral("NonGatingIntegrationMethod");
+
+//==============================================================================
+
+static const auto ForwardEulerMethod          = QStringLiteral("Forward Euler");
+static const auto SecondOrderRungeKuttaMethod = QStringLiteral("Runge-Kutta (2nd order)");
+
+//==============================================================================
+
+static const double StepDefaultValue = 1.0;
+
+static const auto NonGatingIntegrationMethodDefaultValue = ForwardEulerMethod;
+
+//==============================================================================
+
+class RushLarsenSolver : public Solver::OdeSolver
+{
+public:
+    explicit RushLarsenSolver();
+    ~RushLarsenSolver();
+
+    virtual void initialize(const double &pVoiStart,
+                            const int &pRatesStatesCount, double *pConstants,
+                            double *pRates, double *pStates, double *pAlgebraic,
+                            ComputeRatesFunction pComputeRates);
+
+    virtual void solve(double &pVoi, const double &pVoiEnd) const;
+
+    int gatingStatesCount() const;
+    bool isGatingState(const int &pIndex) const;
+
+private:
+    double mStep;
+    bool mSecondOrder;
+
+    int mGatingStatesCount;
+    int *mGatingStates;
+
+    int mGroupsCount;
+    int *mGroupOffsets;
+
+    int mNonGatingStatesCount;
+    int *mNonGatingStates;
+
+    double *mCoefficients;
+    double *mYk;
+    double *mYPerturbed;
+    double *mPerturbations;
+    double *mPerturbedRates;
+
+    void deleteArrays();
+
+    void detectGatingStates(const double &pVoi);
+
+    void computeRatesAndCoefficients(const double &pVoi,
+                                     double *pStates) const;
+    void advance(double *pStates, const double *pStartStates,
+                 const double *pCurrentStates, const double &pStep) const;
+};
+
+//==============================================================================
+
+}   // namespace RushLarsenSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
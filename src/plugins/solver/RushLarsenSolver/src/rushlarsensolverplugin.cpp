@@ -0,0 +1,156 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Rush-Larsen solver plugin
+//==============================================================================
+
+#include "rushlarsensolver.h"
+#include "rushlarsensolverplugin.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace RushLarsenSolver {
+
+//==============================================================================
+
+PLUGININFO_FUNC RushLarsenSolverPluginInfo()
+{
+    Descriptions descriptions;
+
+    descriptions.insert("en", QString::fromUtf8("a plugin that implements the <a href=\"http://dx.doi.org/10.1109/TBME.1978.326270\">Rush-Larsen method</a> to solve ODEs."));
+    descriptions.insert("fr", QString::fromUtf8("une extension qui implémente la <a href=\"http://dx.doi.org/10.1109/TBME.1978.326270\">méthode de Rush-Larsen</a> pour résoudre des EDOs."));
+
+    return new PluginInfo("Solver", true, false,
+                          QStringList(),
+                          descriptions);
+}
+
+//==============================================================================
+// I18n interface
+//==============================================================================
+
+void RushLarsenSolverPlugin::retranslateUi()
+{
+    // We don't handle this interface...
+    // Note: even though we don't handle this interface, we still want to
+    //       support it since some other aspects of our plugin are
+    //       multilingual...
+}
+
+//==============================================================================
+// Solver interface
+//==============================================================================
+
+Solver::Solver * RushLarsenSolverPlugin::solverInstance() const
+{
+    // Create and return an instance of the solver
+
+    return new RushLarsenSolver();
+}
+
+//==============================================================================
+
+QString RushLarsenSolverPlugin::id(const QString &pKisaoId) const
+{
+    // Return the id for the given KiSAO id
+
+    if (!pKisaoId.compare("KISAO:0000377"))
+        return solverName();
+    else if (!pKisaoId.compare("KISAO:0000483"))
+        return StepId;
+
+    return QString();
+}
+
+//==============================================================================
+
+QString RushLarsenSolverPlugin::kisaoId(const QString &pId) const
+{
+    // Return the KiSAO id for the given id
+    // Note: KiSAO has no term for the Rush-Larsen method, so we use the one
+    //       for one-step methods, which it is...
+
+    if (!pId.compare(solverName()))
+        return "KISAO:0000377";
+    else if (!pId.compare(StepId))
+        return "KISAO:0000483";
+
+    return QString();
+}
+
+//==============================================================================
+
+Solver::Type RushLarsenSolverPlugin::solverType() const
+{
+    // Return the type of the solver
+
+    return Solver::Ode;
+}
+
+//==============================================================================
+
+QString RushLarsenSolverPlugin::solverName() const
+{
+    // Return the name of the solver
+
+    return "Rush-Larsen";
+}
+
+//==============================================================================
+
+Solver::Properties RushLarsenSolverPlugin::solverProperties() const
+{
+    // Return the properties supported by the solver
+
+    Descriptions stepDescriptions;
+    Descriptions nonGatingIntegrationMethodDescriptions;
+
+    stepDescriptions.insert("en", QString::fromUtf8("Step"));
+    stepDescriptions.insert("fr", QString::fromUtf8("Pas"));
+
+    nonGatingIntegrationMethodDescriptions.insert("en", QString::fromUtf8("Non-gating integration method"));
+    nonGatingIntegrationMethodDescriptions.insert("fr", QString::fromUtf8("Méthode d'intégration non-gating"));
+
+    QStringList nonGatingIntegrationMethodListValues = QStringList() << ForwardEulerMethod
+                                                                     << SecondOrderRungeKuttaMethod;
+
+    return Solver::Properties() << Solver::Property(Solver::Property::Double, StepId, stepDescriptions, QStringList(), StepDefaultValue, true)
+                                << Solver::Property(Solver::Property::List, NonGatingIntegrationMethodId, nonGatingIntegrationMethodDescriptions, nonGatingIntegrationMethodListValues, NonGatingIntegrationMethodDefaultValue, false);
+}
+
+//==============================================================================
+
+QMap<QString, bool> RushLarsenSolverPlugin::solverPropertiesVisibility(const QMap<QString, QString> &pSolverPropertiesValues) const
+{
+    Q_UNUSED(pSolverPropertiesValues);
+
+    // We don't handle this interface...
+
+    return QMap<QString, bool>();
+}
+
+//==============================================================================
+
+}   // namespace RushLarsenSolver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
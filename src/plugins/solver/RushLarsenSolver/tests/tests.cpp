@@ -0,0 +1,178 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Rush-Larsen solver tests
+//==============================================================================
+
+#include "../../solvertestsutils.h"
+
+//==============================================================================
+
+#include "rushlarsensolver.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+static int computeMixedRates(double VOI, double *CONSTANTS, double *RATES,
+                             double *STATES, double *ALGEBRAIC)
+{
+    Q_UNUSED(VOI);
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // A gate with constant steady state and time constant, i.e.
+    // y = 0.5+(y0-0.5)*exp(-t/0.1), and a state which rate is not affine in it
+
+    RATES[0] = (0.5-STATES[0])/0.1;
+    RATES[1] = -STATES[1]*STATES[1];
+
+    return 0;
+}
+
+//==============================================================================
+
+static OpenCOR::Solver::Solver::Properties solverProperties(const double &pStep,
+                                                           const QString &pMethod)
+{
+    // Return the properties of our solver
+
+    OpenCOR::Solver::Solver::Properties res;
+
+    res.insert(OpenCOR::RushLarsenSolver::StepId, pStep);
+    res.insert(OpenCOR::RushLarsenSolver::NonGatingIntegrationMethodId, pMethod);
+
+    return res;
+}
+
+//==============================================================================
+
+void Tests::gatingStatesTests()
+{
+    // Check that we detect the gating states of the Hodgkin-Huxley model, as
+    // well as its membrane potential which rate is affine in it
+
+    OpenCOR::RushLarsenSolver::RushLarsenSolver hodgkinHuxleySolver;
+    double constants[1];
+    double rates[OpenCOR::HodgkinHuxleyStatesCount];
+    double states[OpenCOR::HodgkinHuxleyStatesCount];
+    double algebraic[1];
+
+    OpenCOR::initializeHodgkinHuxleyStates(states);
+    OpenCOR::initializeSolver(hodgkinHuxleySolver,
+                              solverProperties(0.01, OpenCOR::RushLarsenSolver::ForwardEulerMethod),
+                              OpenCOR::HodgkinHuxleyStatesCount, constants,
+                              rates, states, algebraic,
+                              OpenCOR::computeHodgkinHuxleyRates);
+
+    QCOMPARE(hodgkinHuxleySolver.gatingStatesCount(), 4);
+
+    // Check that we don't consider a state which rate is not affine in it as a
+    // gating state
+
+    OpenCOR::RushLarsenSolver::RushLarsenSolver mixedSolver;
+    double mixedStates[2] = { 0.0, 1.0 };
+
+    OpenCOR::initializeSolver(mixedSolver,
+                              solverProperties(0.01, OpenCOR::RushLarsenSolver::ForwardEulerMethod),
+                              2, constants, rates, mixedStates, algebraic,
+                              computeMixedRates);
+
+    QCOMPARE(mixedSolver.gatingStatesCount(), 1);
+    QVERIFY(mixedSolver.isGatingState(0));
+    QVERIFY(!mixedSolver.isGatingState(1));
+}
+
+//==============================================================================
+
+void Tests::exactGatingTests()
+{
+    // Check that a gate with a constant steady state and time constant is
+    // integrated exactly, even with a step ten times its time constant
+
+    OpenCOR::RushLarsenSolver::RushLarsenSolver solver;
+    double constants[1];
+    double rates[2];
+    double states[2] = { 0.0, 1.0 };
+    double algebraic[1];
+
+    OpenCOR::initializeSolver(solver,
+                              solverProperties(1.0, OpenCOR::RushLarsenSolver::ForwardEulerMethod),
+                              2, constants, rates, states, algebraic,
+                              computeMixedRates);
+
+    double voi = 0.0;
+
+    solver.solve(voi, 1.0);
+
+    QVERIFY(qAbs(states[0]-(0.5-0.5*qExp(-10.0))) < 1.0e-12);
+}
+
+//==============================================================================
+
+void Tests::stabilityTests()
+{
+    // Check that we can simulate the Hodgkin-Huxley model with a step for
+    // which the forward Euler method blows up (i.e. 0.1 ms or more) and still
+    // get an action potential
+
+    foreach (const QString &method, QStringList() << OpenCOR::RushLarsenSolver::ForwardEulerMethod
+                                                  << OpenCOR::RushLarsenSolver::SecondOrderRungeKuttaMethod) {
+        OpenCOR::RushLarsenSolver::RushLarsenSolver solver;
+        double constants[1];
+        double rates[OpenCOR::HodgkinHuxleyStatesCount];
+        double states[OpenCOR::HodgkinHuxleyStatesCount];
+        double algebraic[1];
+
+        OpenCOR::initializeHodgkinHuxleyStates(states);
+        OpenCOR::initializeSolver(solver, solverProperties(0.25, method),
+                                  OpenCOR::HodgkinHuxleyStatesCount, constants,
+                                  rates, states, algebraic,
+                                  OpenCOR::computeHodgkinHuxleyRates);
+
+        double voi = 0.0;
+        double minimumV = 0.0;
+
+        for (int i = 1; i <= 200; ++i) {
+            solver.solve(voi, 0.25*i);
+
+            QVERIFY(qIsFinite(states[0]));
+
+            minimumV = qMin(minimumV, states[0]);
+        }
+
+        QVERIFY((minimumV < -90.0) && (minimumV > -110.0));
+        QVERIFY(qAbs(states[0]) < 5.0);
+    }
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -100,6 +100,8 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
     double realStep = mStep;
     double realHalfStep = 0.5*realStep;
 
+    startEventDetection(pVoi);
+
     while (pVoi != pVoiEnd) {
         // Check that the time step is correct
 
@@ -108,9 +110,13 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
             realHalfStep = 0.5*realStep;
         }
 
+        // Keep track of our states, in case an event occurs during our step
+
+        startEventStep();
+
         // Compute f(t_n, Y_n)
 
-        mComputeRates(pVoi, mConstants, mRates, mStates, mAlgebraic);
+        computeRates(pVoi, mStates);
 
         // Compute k1 and therefore Yk1
 
@@ -119,19 +125,41 @@ void SecondOrderRungeKuttaSolver::solve(double &pVoi,
 
         // Compute f(t_n + h / 2, Y_n + k1 / 2)
 
-        mComputeRates(pVoi+realHalfStep, mConstants, mRates, mYk1, mAlgebraic);
+        computeRates(pVoi+realHalfStep, mYk1);
 
         // Compute Y_n+1
 
         for (int i = 0; i < mRatesStatesCount; ++i)
             mStates[i] += realStep*mRates[i];
 
-        // Advance through time
+        // Check whether an event occurred during our step, in which case we
+        // redo our step so that it ends just after that event
+
+        EventStatus eventStatus = checkForEvent(pVoi, realStep);
 
-        if (realStep != mStep)
+        if (eventStatus == EventLocated) {
+            realHalfStep = 0.5*realStep;
+
+            continue;
+        }
+
+        // Advance through time, restarting from the event we have just
+        // reached, if any
+
+        ++mNbOfSteps;
+
+        if (eventStatus == EventReached) {
+            pVoi += realStep;
+
+            voiStart = pVoi;
+            stepNumber = 0;
+            realStep = mStep;
+            realHalfStep = 0.5*realStep;
+        } else if (realStep != mStep) {
             pVoi = pVoiEnd;
-        else
+        } else {
             pVoi = voiStart+(++stepNumber)*mStep;
+        }
     }
 }
 
@@ -0,0 +1,109 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Solver tests utilities
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "solverinterface.h"
+
+//==============================================================================
+
+#include <QtMath>
+
+//==============================================================================
+
+namespace OpenCOR {
+
+//==============================================================================
+
+static const int HodgkinHuxleyStatesCount = 4;
+
+//==============================================================================
+
+inline int computeHodgkinHuxleyRates(double VOI, double *CONSTANTS,
+                                     double *RATES, double *STATES,
+                                     double *ALGEBRAIC)
+{
+    Q_UNUSED(CONSTANTS);
+    Q_UNUSED(ALGEBRAIC);
+
+    // The Hodgkin-Huxley squid axon model (1952), with a stimulus at t = 10 ms
+
+    double V = STATES[0];
+    double m = STATES[1];
+    double h = STATES[2];
+    double n = STATES[3];
+
+    double iStim = ((VOI >= 10.0) && (VOI <= 10.5))?-20.0:0.0;
+    double alphaM = 0.1*(V+25.0)/(qExp(0.1*(V+25.0))-1.0);
+    double betaM = 4.0*qExp(V/18.0);
+    double alphaH = 0.07*qExp(0.05*V);
+    double betaH = 1.0/(qExp(0.1*(V+30.0))+1.0);
+    double alphaN = 0.01*(V+10.0)/(qExp(0.1*(V+10.0))-1.0);
+    double betaN = 0.125*qExp(V/80.0);
+
+    RATES[0] = iStim-120.0*m*m*m*h*(V+115.0)-36.0*n*n*n*n*(V-12.0)-0.3*(V+10.613);
+    RATES[1] = alphaM*(1.0-m)-betaM*m;
+    RATES[2] = alphaH*(1.0-h)-betaH*h;
+    RATES[3] = alphaN*(1.0-n)-betaN*n;
+
+    return 0;
+}
+
+//==============================================================================
+
+inline void initializeHodgkinHuxleyStates(double *pStates)
+{
+    // Initialise the given states to the resting state of the Hodgkin-Huxley
+    // model
+
+    pStates[0] = 0.0;
+    pStates[1] = 0.05;
+    pStates[2] = 0.6;
+    pStates[3] = 0.325;
+}
+
+//==============================================================================
+
+inline void initializeSolver(Solver::OdeSolver &pSolver,
+                             const Solver::Solver::Properties &pProperties,
+                             const int &pRatesStatesCount, double *pConstants,
+                             double *pRates, double *pStates,
+                             double *pAlgebraic,
+                             Solver::OdeSolver::ComputeRatesFunction pComputeRates)
+{
+    // Set the properties of the given solver and initialise it, starting from
+    // a VOI of zero
+
+    pSolver.setProperties(pProperties);
+    pSolver.initialize(0.0, pRatesStatesCount, pConstants, pRates, pStates,
+                       pAlgebraic, pComputeRates);
+}
+
+//==============================================================================
+
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
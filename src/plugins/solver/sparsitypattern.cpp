@@ -0,0 +1,243 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Sparsity pattern
+//==============================================================================
+
+#include "sparsitypattern.h"
+
+//==============================================================================
+
+#include <QPair>
+#include <QtMath>
+
+//==============================================================================
+
+#include <algorithm>
+#include <limits>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Solver {
+
+//==============================================================================
+
+SparsityPattern::SparsityPattern(const int &pSize) :
+    mSize(pSize),
+    mDependencies(QList<QSet<int>>())
+{
+    // Start with no dependencies at all
+
+    for (int i = 0; i < pSize; ++i)
+        mDependencies << QSet<int>();
+}
+
+//==============================================================================
+
+void SparsityPattern::addDependencies(ComputeFunction pCompute,
+                                      const double &pVoi, double *pVariables,
+                                      void *pUserData)
+{
+    // Determine which of our results depend on which of the given variables,
+    // by perturbing each of those variables in turn and checking which of our
+    // results are affected by it
+    // Note #1: a dependency may be missed if it happens to vanish for the
+    //          current value of our variables (e.g. the dependency of y*z on y
+    //          when z is zero), in which case a solver will simply need a few
+    //          more iterations to converge...
+    // Note #2: computing our results may have side effects (e.g. on the
+    //          algebraic variables of a model), hence we compute them one last
+    //          time once all our variables have been restored...
+
+    double *results = new double[mSize];
+    double *perturbedResults = new double[mSize];
+    double increment = qSqrt(std::numeric_limits<double>::epsilon());
+
+    pCompute(pVoi, pVariables, results, pUserData);
+
+    for (int j = 0; j < mSize; ++j) {
+        double variable = pVariables[j];
+
+        pVariables[j] += increment*qMax(qAbs(variable), 1.0);
+
+        pCompute(pVoi, pVariables, perturbedResults, pUserData);
+
+        pVariables[j] = variable;
+
+        for (int i = 0; i < mSize; ++i) {
+            if (perturbedResults[i] != results[i])
+                mDependencies[i] << j;
+        }
+    }
+
+    pCompute(pVoi, pVariables, results, pUserData);
+
+    delete[] results;
+    delete[] perturbedResults;
+}
+
+//==============================================================================
+
+void SparsityPattern::halfBandwidths(const QVector<int> &pOrdering,
+                                     int &pUpperHalfBandwidth,
+                                     int &pLowerHalfBandwidth) const
+{
+    // Determine the half-bandwidths of our pattern once reordered using the
+    // given ordering, which lists our variables in their new order
+
+    QVector<int> positions = QVector<int>(mSize);
+
+    for (int i = 0; i < mSize; ++i)
+        positions[pOrdering[i]] = i;
+
+    pUpperHalfBandwidth = 0;
+    pLowerHalfBandwidth = 0;
+
+    for (int i = 0; i < mSize; ++i) {
+        foreach (int j, mDependencies[i]) {
+            int distance = positions[j]-positions[i];
+
+            pUpperHalfBandwidth = qMax(pUpperHalfBandwidth, distance);
+            pLowerHalfBandwidth = qMax(pLowerHalfBandwidth, -distance);
+        }
+    }
+}
+
+//==============================================================================
+
+QVector<int> SparsityPattern::identityOrdering() const
+{
+    // Return an ordering that keeps our variables in their original order
+
+    QVector<int> res = QVector<int>(mSize);
+
+    for (int i = 0; i < mSize; ++i)
+        res[i] = i;
+
+    return res;
+}
+
+//==============================================================================
+
+QVector<int> SparsityPattern::bandwidthReducingOrdering() const
+{
+    // Return an ordering that reduces the bandwidth of our pattern, using the
+    // reverse Cuthill-McKee algorithm on its symmetric version, i.e. a
+    // breadth-first traversal of the graph of our variables, starting from a
+    // variable with as few neighbours as possible and visiting the neighbours
+    // of a variable by increasing number of neighbours, which order we then
+    // reverse
+
+    QList<QSet<int>> neighbours = QList<QSet<int>>();
+
+    for (int i = 0; i < mSize; ++i)
+        neighbours << QSet<int>();
+
+    for (int i = 0; i < mSize; ++i) {
+        foreach (int j, mDependencies[i]) {
+            if (i != j) {
+                neighbours[i] << j;
+                neighbours[j] << i;
+            }
+        }
+    }
+
+    // Sort our variables by increasing number of neighbours, so that we can
+    // start each traversal (we need one per connected component of our graph)
+    // from an unvisited variable with as few neighbours as possible
+
+    QList<QPair<int, int>> variables = QList<QPair<int, int>>();
+
+    for (int i = 0; i < mSize; ++i)
+        variables << QPair<int, int>(neighbours[i].count(), i);
+
+    std::sort(variables.begin(), variables.end());
+
+    // Traverse our graph, using our ordering as our queue
+
+    QVector<bool> visited = QVector<bool>(mSize, false);
+    QVector<int> res = QVector<int>();
+
+    res.reserve(mSize);
+
+    for (int i = 0; i < mSize; ++i) {
+        int variable = variables[i].second;
+
+        if (visited[variable])
+            continue;
+
+        visited[variable] = true;
+
+        res << variable;
+
+        for (int j = res.count()-1; j < res.count(); ++j) {
+            QList<QPair<int, int>> unvisitedNeighbours = QList<QPair<int, int>>();
+
+            foreach (int neighbour, neighbours[res[j]]) {
+                if (!visited[neighbour]) {
+                    visited[neighbour] = true;
+
+                    unvisitedNeighbours << QPair<int, int>(neighbours[neighbour].count(), neighbour);
+                }
+            }
+
+            std::sort(unvisitedNeighbours.begin(), unvisitedNeighbours.end());
+
+            for (int k = 0, kMax = unvisitedNeighbours.count(); k < kMax; ++k)
+                res << unvisitedNeighbours[k].second;
+        }
+    }
+
+    std::reverse(res.begin(), res.end());
+
+    return res;
+}
+
+//==============================================================================
+
+void reorderValues(const QVector<int> &pOrdering, const double *pValues,
+                   double *pReorderedValues)
+{
+    // Reorder the given values using the given ordering
+
+    for (int i = 0, iMax = pOrdering.count(); i < iMax; ++i)
+        pReorderedValues[i] = pValues[pOrdering[i]];
+}
+
+//==============================================================================
+
+void restoreValues(const QVector<int> &pOrdering,
+                   const double *pReorderedValues, double *pValues)
+{
+    // Restore the original order of the given values, which were reordered
+    // using the given ordering
+
+    for (int i = 0, iMax = pOrdering.count(); i < iMax; ++i)
+        pValues[pOrdering[i]] = pReorderedValues[i];
+}
+
+//==============================================================================
+
+}   // namespace Solver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
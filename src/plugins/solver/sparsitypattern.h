@@ -0,0 +1,76 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Sparsity pattern
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QList>
+#include <QSet>
+#include <QVector>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Solver {
+
+//==============================================================================
+
+class SparsityPattern
+{
+public:
+    typedef void (*ComputeFunction)(const double &pVoi, double *pVariables,
+                                    double *pResults, void *pUserData);
+
+    explicit SparsityPattern(const int &pSize);
+
+    void addDependencies(ComputeFunction pCompute, const double &pVoi,
+                         double *pVariables, void *pUserData);
+
+    void halfBandwidths(const QVector<int> &pOrdering,
+                        int &pUpperHalfBandwidth,
+                        int &pLowerHalfBandwidth) const;
+
+    QVector<int> identityOrdering() const;
+    QVector<int> bandwidthReducingOrdering() const;
+
+private:
+    int mSize;
+
+    QList<QSet<int>> mDependencies;
+};
+
+//==============================================================================
+
+void reorderValues(const QVector<int> &pOrdering, const double *pValues,
+                   double *pReorderedValues);
+void restoreValues(const QVector<int> &pOrdering,
+                   const double *pReorderedValues, double *pValues);
+
+//==============================================================================
+
+}   // namespace Solver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,761 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Threaded N_Vector
+//==============================================================================
+
+#include "threadednvector.h"
+
+//==============================================================================
+
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVector>
+#include <QtMath>
+
+//==============================================================================
+
+#include <cstdlib>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Solver {
+
+//==============================================================================
+
+// Our threaded N_Vector is a serial N_Vector which content has been extended
+// with a number of threads and which most expensive operations have been
+// replaced with ones that split the vector into chunks that get processed in
+// parallel
+// Note #1: the content of our threaded N_Vector starts with that of a serial
+//          N_Vector, meaning that it can be used anywhere a serial N_Vector is
+//          expected (e.g. N_VGetArrayPointer_Serial() or SUNDIALS' dense and
+//          banded linear solvers)...
+// Note #2: using a thread only pays off if it has enough work to do, hence we
+//          only split a vector into chunks of at least minimumChunkSize()
+//          elements and revert to the serial operation otherwise...
+
+struct ThreadedNVectorContent
+{
+    long int length;
+    booleantype own_data;
+    realtype *data;
+
+    int nbOfThreads;
+};
+
+//==============================================================================
+
+enum OperationType {
+    LinearSum,
+    Const,
+    Prod,
+    Div,
+    Scale,
+    Abs,
+    Inv,
+    AddConst,
+    DotProd,
+    MaxNorm,
+    WrmsNorm,
+    WrmsNormMask,
+    Min,
+    WL2Norm,
+    L1Norm
+};
+
+//==============================================================================
+
+struct Operation
+{
+    OperationType type;
+
+    double a;
+    double b;
+
+    double *x;
+    double *y;
+    double *z;
+};
+
+//==============================================================================
+
+static double computeChunk(const Operation &pOperation, const long &pStart,
+                           const long &pEnd)
+{
+    // Carry out the given operation on the given chunk and return its partial
+    // result, if any
+
+    double *x = pOperation.x;
+    double *y = pOperation.y;
+    double *z = pOperation.z;
+    double res = 0.0;
+
+    switch (pOperation.type) {
+    case LinearSum:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = pOperation.a*x[i]+pOperation.b*y[i];
+
+        break;
+    case Const:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = pOperation.a;
+
+        break;
+    case Prod:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = x[i]*y[i];
+
+        break;
+    case Div:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = x[i]/y[i];
+
+        break;
+    case Scale:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = pOperation.a*x[i];
+
+        break;
+    case Abs:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = qAbs(x[i]);
+
+        break;
+    case Inv:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = 1.0/x[i];
+
+        break;
+    case AddConst:
+        for (long i = pStart; i < pEnd; ++i)
+            z[i] = x[i]+pOperation.a;
+
+        break;
+    case DotProd:
+        for (long i = pStart; i < pEnd; ++i)
+            res += x[i]*y[i];
+
+        break;
+    case MaxNorm:
+        for (long i = pStart; i < pEnd; ++i)
+            res = qMax(res, qAbs(x[i]));
+
+        break;
+    case WrmsNorm:
+    case WL2Norm:
+        for (long i = pStart; i < pEnd; ++i) {
+            double prod = x[i]*y[i];
+
+            res += prod*prod;
+        }
+
+        break;
+    case WrmsNormMask:
+        // Note: z is our id vector here...
+
+        for (long i = pStart; i < pEnd; ++i) {
+            if (z[i] > 0.0) {
+                double prod = x[i]*y[i];
+
+                res += prod*prod;
+            }
+        }
+
+        break;
+    case Min:
+        res = x[pStart];
+
+        for (long i = pStart+1; i < pEnd; ++i)
+            res = qMin(res, x[i]);
+
+        break;
+    case L1Norm:
+        for (long i = pStart; i < pEnd; ++i)
+            res += qAbs(x[i]);
+
+        break;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+class ChunkRunnable : public QRunnable
+{
+public:
+    explicit ChunkRunnable(const Operation &pOperation, const long &pStart,
+                           const long &pEnd, double *pResult,
+                           QSemaphore *pSemaphore) :
+        mOperation(pOperation),
+        mStart(pStart),
+        mEnd(pEnd),
+        mResult(pResult),
+        mSemaphore(pSemaphore)
+    {
+    }
+
+    virtual void run()
+    {
+        // Process our chunk and let people know that we are done
+
+        *mResult = computeChunk(mOperation, mStart, mEnd);
+
+        mSemaphore->release();
+    }
+
+private:
+    Operation mOperation;
+
+    long mStart;
+    long mEnd;
+
+    double *mResult;
+
+    QSemaphore *mSemaphore;
+};
+
+//==============================================================================
+
+static QThreadPool * threadPool()
+{
+    // Return our thread pool
+    // Note: we don't use the global thread pool since it may be busy with
+    //       something else, something that would then delay our solver...
+
+    static QThreadPool threadPool;
+
+    return &threadPool;
+}
+
+//==============================================================================
+
+class RatesBlocksRunnable : public QRunnable
+{
+public:
+    explicit RatesBlocksRunnable(const QList<OdeSolver::ComputeRatesFunction> &pComputeRatesBlocks,
+                                 const double &pVoi, double *pConstants,
+                                 double *pRates, double *pStates,
+                                 double *pAlgebraic, QSemaphore *pSemaphore) :
+        mComputeRatesBlocks(pComputeRatesBlocks),
+        mVoi(pVoi),
+        mConstants(pConstants),
+        mRates(pRates),
+        mStates(pStates),
+        mAlgebraic(pAlgebraic),
+        mSemaphore(pSemaphore)
+    {
+    }
+
+    virtual void run()
+    {
+        // Compute our blocks of rates and let people know that we are done
+
+        foreach (OdeSolver::ComputeRatesFunction computeRatesBlock, mComputeRatesBlocks)
+            computeRatesBlock(mVoi, mConstants, mRates, mStates, mAlgebraic);
+
+        mSemaphore->release();
+    }
+
+private:
+    QList<OdeSolver::ComputeRatesFunction> mComputeRatesBlocks;
+
+    double mVoi;
+
+    double *mConstants;
+    double *mRates;
+    double *mStates;
+    double *mAlgebraic;
+
+    QSemaphore *mSemaphore;
+};
+
+//==============================================================================
+
+static long measuredMinimumChunkSize()
+{
+    // Measure how long it takes to hand an (empty) chunk over to our thread
+    // pool and to carry out a linear sum on a given number of elements, and
+    // deduce from it the number of elements for which both take the same time
+
+    static const long Size = 65536;
+    static const int NbOfRuns = 16;
+    static const long MinimumSize = 256;
+    static const long MaximumSize = 65536;
+
+    QVector<double> x = QVector<double>(Size, 1.0);
+    QVector<double> y = QVector<double>(Size, 2.0);
+    QVector<double> z = QVector<double>(Size);
+    Operation operation;
+
+    operation.type = LinearSum;
+    operation.a = 3.0;
+    operation.b = 5.0;
+    operation.x = x.data();
+    operation.y = y.data();
+    operation.z = z.data();
+
+    // Hand an empty chunk over to our thread pool, first to make sure that it
+    // has a thread ready and then to time it
+
+    QThreadPool *pool = threadPool();
+    QSemaphore semaphore;
+    double result;
+    QElapsedTimer timer;
+
+    pool->start(new ChunkRunnable(operation, 0, 0, &result, &semaphore));
+
+    semaphore.acquire();
+
+    timer.start();
+
+    for (int i = 0; i < NbOfRuns; ++i) {
+        pool->start(new ChunkRunnable(operation, 0, 0, &result, &semaphore));
+
+        semaphore.acquire();
+    }
+
+    qint64 handOverTime = timer.nsecsElapsed();
+
+    // Carry out our linear sum ourselves and time it
+
+    timer.restart();
+
+    for (int i = 0; i < NbOfRuns; ++i)
+        computeChunk(operation, 0, Size);
+
+    qint64 computeTime = qMax(timer.nsecsElapsed(), qint64(1));
+
+    return qBound(MinimumSize, long(double(Size)*handOverTime/computeTime),
+                  MaximumSize);
+}
+
+//==============================================================================
+
+static long minimumChunkSize()
+{
+    // Return the minimum number of elements that a chunk must have for it to
+    // be worth processing it in a thread
+    // Note: this depends on the machine we are running on, hence we measure it
+    //       the first time we need it...
+
+    static const long res = measuredMinimumChunkSize();
+
+    return res;
+}
+
+//==============================================================================
+
+static int nbOfChunks(N_Vector pVector)
+{
+    // Return the number of chunks into which the given vector should be split
+
+    ThreadedNVectorContent *content = static_cast<ThreadedNVectorContent *>(pVector->content);
+
+    if (content->nbOfThreads <= 1)
+        return 1;
+
+    return int(qMin(long(content->nbOfThreads), content->length/minimumChunkSize()));
+}
+
+//==============================================================================
+
+static double compute(const int &pNbOfChunks, const long &pLength,
+                      const Operation &pOperation)
+{
+    // Split our vector into chunks, process all of them but the first one using
+    // our thread pool, the first one ourselves, and combine their results
+
+    QThreadPool *pool = threadPool();
+
+    if (pool->maxThreadCount() < pNbOfChunks-1)
+        pool->setMaxThreadCount(pNbOfChunks-1);
+
+    QVector<double> results = QVector<double>(pNbOfChunks);
+    QSemaphore semaphore;
+
+    for (int i = 1; i < pNbOfChunks; ++i) {
+        pool->start(new ChunkRunnable(pOperation, i*pLength/pNbOfChunks,
+                                      (i+1)*pLength/pNbOfChunks,
+                                      results.data()+i, &semaphore));
+    }
+
+    results[0] = computeChunk(pOperation, 0, pLength/pNbOfChunks);
+
+    semaphore.acquire(pNbOfChunks-1);
+
+    double res = results[0];
+
+    for (int i = 1; i < pNbOfChunks; ++i) {
+        if (pOperation.type == MaxNorm)
+            res = qMax(res, results[i]);
+        else if (pOperation.type == Min)
+            res = qMin(res, results[i]);
+        else
+            res += results[i];
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+static double compute(N_Vector pVector, const OperationType &pType,
+                      const double &pA, const double &pB, N_Vector pX,
+                      N_Vector pY, N_Vector pZ)
+{
+    // Carry out the given operation on the given vectors
+
+    Operation operation;
+
+    operation.type = pType;
+    operation.a = pA;
+    operation.b = pB;
+    operation.x = pX?NV_DATA_S(pX):0;
+    operation.y = pY?NV_DATA_S(pY):0;
+    operation.z = pZ?NV_DATA_S(pZ):0;
+
+    return compute(nbOfChunks(pVector), NV_LENGTH_S(pVector), operation);
+}
+
+//==============================================================================
+
+static N_Vector threadedNVector(N_Vector pVector, const int &pNbOfThreads);
+
+//==============================================================================
+
+static N_Vector cloneEmpty(N_Vector pVector)
+{
+    // Clone the given vector, without its data
+
+    return threadedNVector(N_VCloneEmpty_Serial(pVector),
+                           static_cast<ThreadedNVectorContent *>(pVector->content)->nbOfThreads);
+}
+
+//==============================================================================
+
+static N_Vector clone(N_Vector pVector)
+{
+    // Clone the given vector, with its data
+
+    return threadedNVector(N_VClone_Serial(pVector),
+                           static_cast<ThreadedNVectorContent *>(pVector->content)->nbOfThreads);
+}
+
+//==============================================================================
+
+static void linearSum(realtype pA, N_Vector pX, realtype pB, N_Vector pY,
+                      N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VLinearSum_Serial(pA, pX, pB, pY, pZ);
+    else
+        compute(pZ, LinearSum, pA, pB, pX, pY, pZ);
+}
+
+//==============================================================================
+
+static void constant(realtype pC, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VConst_Serial(pC, pZ);
+    else
+        compute(pZ, Const, pC, 0.0, 0, 0, pZ);
+}
+
+//==============================================================================
+
+static void product(N_Vector pX, N_Vector pY, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VProd_Serial(pX, pY, pZ);
+    else
+        compute(pZ, Prod, 0.0, 0.0, pX, pY, pZ);
+}
+
+//==============================================================================
+
+static void divide(N_Vector pX, N_Vector pY, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VDiv_Serial(pX, pY, pZ);
+    else
+        compute(pZ, Div, 0.0, 0.0, pX, pY, pZ);
+}
+
+//==============================================================================
+
+static void scale(realtype pC, N_Vector pX, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VScale_Serial(pC, pX, pZ);
+    else
+        compute(pZ, Scale, pC, 0.0, pX, 0, pZ);
+}
+
+//==============================================================================
+
+static void absolute(N_Vector pX, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VAbs_Serial(pX, pZ);
+    else
+        compute(pZ, Abs, 0.0, 0.0, pX, 0, pZ);
+}
+
+//==============================================================================
+
+static void inverse(N_Vector pX, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VInv_Serial(pX, pZ);
+    else
+        compute(pZ, Inv, 0.0, 0.0, pX, 0, pZ);
+}
+
+//==============================================================================
+
+static void addConst(N_Vector pX, realtype pB, N_Vector pZ)
+{
+    if (nbOfChunks(pZ) <= 1)
+        N_VAddConst_Serial(pX, pB, pZ);
+    else
+        compute(pZ, AddConst, pB, 0.0, pX, 0, pZ);
+}
+
+//==============================================================================
+
+static realtype dotProd(N_Vector pX, N_Vector pY)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VDotProd_Serial(pX, pY);
+    else
+        return compute(pX, DotProd, 0.0, 0.0, pX, pY, 0);
+}
+
+//==============================================================================
+
+static realtype maxNorm(N_Vector pX)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VMaxNorm_Serial(pX);
+    else
+        return compute(pX, MaxNorm, 0.0, 0.0, pX, 0, 0);
+}
+
+//==============================================================================
+
+static realtype wrmsNorm(N_Vector pX, N_Vector pW)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VWrmsNorm_Serial(pX, pW);
+    else
+        return qSqrt(compute(pX, WrmsNorm, 0.0, 0.0, pX, pW, 0)/NV_LENGTH_S(pX));
+}
+
+//==============================================================================
+
+static realtype wrmsNormMask(N_Vector pX, N_Vector pW, N_Vector pId)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VWrmsNormMask_Serial(pX, pW, pId);
+    else
+        return qSqrt(compute(pX, WrmsNormMask, 0.0, 0.0, pX, pW, pId)/NV_LENGTH_S(pX));
+}
+
+//==============================================================================
+
+static realtype minimum(N_Vector pX)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VMin_Serial(pX);
+    else
+        return compute(pX, Min, 0.0, 0.0, pX, 0, 0);
+}
+
+//==============================================================================
+
+static realtype wl2Norm(N_Vector pX, N_Vector pW)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VWL2Norm_Serial(pX, pW);
+    else
+        return qSqrt(compute(pX, WL2Norm, 0.0, 0.0, pX, pW, 0));
+}
+
+//==============================================================================
+
+static realtype l1Norm(N_Vector pX)
+{
+    if (nbOfChunks(pX) <= 1)
+        return N_VL1Norm_Serial(pX);
+    else
+        return compute(pX, L1Norm, 0.0, 0.0, pX, 0, 0);
+}
+
+//==============================================================================
+
+static N_Vector threadedNVector(N_Vector pVector, const int &pNbOfThreads)
+{
+    // Turn the given serial vector into a threaded one, i.e. extend its content
+    // and replace some of its operations
+
+    if (!pVector)
+        return 0;
+
+    void *content = realloc(pVector->content, sizeof(ThreadedNVectorContent));
+
+    if (!content) {
+        N_VDestroy_Serial(pVector);
+
+        return 0;
+    }
+
+    pVector->content = content;
+
+    static_cast<ThreadedNVectorContent *>(content)->nbOfThreads = pNbOfThreads;
+
+    N_Vector_Ops ops = pVector->ops;
+
+    ops->nvclone = clone;
+    ops->nvcloneempty = cloneEmpty;
+    ops->nvlinearsum = linearSum;
+    ops->nvconst = constant;
+    ops->nvprod = product;
+    ops->nvdiv = divide;
+    ops->nvscale = scale;
+    ops->nvabs = absolute;
+    ops->nvinv = inverse;
+    ops->nvaddconst = addConst;
+    ops->nvdotprod = dotProd;
+    ops->nvmaxnorm = maxNorm;
+    ops->nvwrmsnorm = wrmsNorm;
+    ops->nvwrmsnormmask = wrmsNormMask;
+    ops->nvmin = minimum;
+    ops->nvwl2norm = wl2Norm;
+    ops->nvl1norm = l1Norm;
+
+    return pVector;
+}
+
+//==============================================================================
+
+N_Vector newNVector(const long &pLength, const int &pNbOfThreads)
+{
+    // Create and return a vector of the given length, which is threaded if more
+    // than one thread is requested
+
+    N_Vector res = N_VNew_Serial(pLength);
+
+    return (pNbOfThreads > 1)?threadedNVector(res, pNbOfThreads):res;
+}
+
+//==============================================================================
+
+N_Vector makeNVector(const long &pLength, double *pData,
+                     const int &pNbOfThreads)
+{
+    // Create and return a vector of the given length that uses the given data,
+    // and which is threaded if more than one thread is requested
+
+    N_Vector res = N_VMake_Serial(pLength, pData);
+
+    return (pNbOfThreads > 1)?threadedNVector(res, pNbOfThreads):res;
+}
+
+//==============================================================================
+
+int nVectorNbOfThreads(N_Vector pVector)
+{
+    // Return the number of threads used by the given vector
+
+    if (pVector->ops->nvclone == clone)
+        return static_cast<ThreadedNVectorContent *>(pVector->content)->nbOfThreads;
+    else
+        return 1;
+}
+
+//==============================================================================
+
+int nVectorNbOfChunks(N_Vector pVector)
+{
+    // Return the number of chunks into which the operations on the given vector
+    // get split
+
+    if (pVector->ops->nvclone == clone)
+        return qMax(nbOfChunks(pVector), 1);
+    else
+        return 1;
+}
+
+//==============================================================================
+
+void computeRatesBlocks(const QList<OdeSolver::ComputeRatesFunction> &pComputeRatesBlocks,
+                        const int &pNbOfThreads, double pVoi, double *pConstants,
+                        double *pRates, double *pStates, double *pAlgebraic)
+{
+    // Compute our rates by splitting the given blocks between the given number
+    // of threads, computing all of them but the first one using our thread
+    // pool, and the first one ourselves
+    // Note: the blocks are independent of one another, i.e. they neither use
+    //       nor compute the same rates and algebraic variables, so they can
+    //       safely share the same arrays...
+
+    int nbOfBlocks = pComputeRatesBlocks.count();
+    int nbOfThreads = qMin(pNbOfThreads, nbOfBlocks);
+
+    if (nbOfThreads <= 1) {
+        foreach (OdeSolver::ComputeRatesFunction computeRatesBlock, pComputeRatesBlocks)
+            computeRatesBlock(pVoi, pConstants, pRates, pStates, pAlgebraic);
+
+        return;
+    }
+
+    QThreadPool *pool = threadPool();
+
+    if (pool->maxThreadCount() < nbOfThreads-1)
+        pool->setMaxThreadCount(nbOfThreads-1);
+
+    QSemaphore semaphore;
+
+    for (int i = 1; i < nbOfThreads; ++i) {
+        pool->start(new RatesBlocksRunnable(pComputeRatesBlocks.mid(i*nbOfBlocks/nbOfThreads,
+                                                                    (i+1)*nbOfBlocks/nbOfThreads-i*nbOfBlocks/nbOfThreads),
+                                            pVoi, pConstants, pRates, pStates,
+                                            pAlgebraic, &semaphore));
+    }
+
+    for (int i = 0, iMax = nbOfBlocks/nbOfThreads; i < iMax; ++i)
+        pComputeRatesBlocks[i](pVoi, pConstants, pRates, pStates, pAlgebraic);
+
+    semaphore.acquire(nbOfThreads-1);
+}
+
+//==============================================================================
+
+}   // namespace Solver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,58 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Threaded N_Vector
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "solverinterface.h"
+
+//==============================================================================
+
+#include "nvector/nvector_serial.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace Solver {
+
+//==============================================================================
+
+N_Vector newNVector(const long &pLength, const int &pNbOfThreads);
+N_Vector makeNVector(const long &pLength, double *pData,
+                     const int &pNbOfThreads);
+
+int nVectorNbOfThreads(N_Vector pVector);
+int nVectorNbOfChunks(N_Vector pVector);
+
+void computeRatesBlocks(const QList<OdeSolver::ComputeRatesFunction> &pComputeRatesBlocks,
+                        const int &pNbOfThreads, double pVoi, double *pConstants,
+                        double *pRates, double *pStates, double *pAlgebraic);
+
+//==============================================================================
+
+}   // namespace Solver
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -64,6 +64,20 @@ namespace Solver {
 
 //==============================================================================
 
+static const qint64 ModelEvaluationTimingRate = 64;
+
+//==============================================================================
+
+void addStatistics(Statistics &pStatistics, const Statistics &pOtherStatistics)
+{
+    // Add the given other statistics to the given statistics
+
+    foreach (const Statistic &statistic, pOtherStatistics.keys())
+        pStatistics[statistic] += pOtherStatistics.value(statistic);
+}
+
+//==============================================================================
+
 Solver::Solver() :
     mProperties(Properties())
 {
@@ -80,6 +94,15 @@ void Solver::setProperties(const Properties &pProperties)
 
 //==============================================================================
 
+Statistics Solver::statistics() const
+{
+    // By default, we don't have any statistics
+
+    return Statistics();
+}
+
+//==============================================================================
+
 void Solver::emitError(const QString &pErrorMessage)
 {
     // Let people know that an error occured, but first reformat the error a
@@ -108,16 +131,103 @@ VoiSolver::VoiSolver() :
     mConstants(0),
     mStates(0),
     mRates(0),
-    mAlgebraic(0)
+    mAlgebraic(0),
+    mNbOfSteps(0),
+    mNbOfModelEvaluations(0),
+    mNbOfTimedModelEvaluations(0),
+    mModelTime(0)
+{
+}
+
+//==============================================================================
+
+Statistics VoiSolver::statistics() const
+{
+    // Return the number of steps we took (if we keep track of them), the number
+    // of times our model was evaluated and an estimate of the time (in
+    // nanoseconds) that was spent doing so
+
+    Statistics res = Statistics();
+
+    if (mNbOfSteps)
+        res.insert(NbOfSteps, mNbOfSteps);
+
+    if (mNbOfModelEvaluations) {
+        res.insert(NbOfRhsEvaluations, mNbOfModelEvaluations);
+        res.insert(ModelTime, mNbOfTimedModelEvaluations?
+                                  qint64(double(mModelTime)*mNbOfModelEvaluations/mNbOfTimedModelEvaluations):
+                                  0);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+bool VoiSolver::startModelEvaluation() const
+{
+    // Keep track of the fact that our model is about to be evaluated, and time
+    // that evaluation if it is one of those we sample
+    // Note: timing every single evaluation would noticeably slow down the
+    //       simulation of small models, hence we only time one evaluation out
+    //       of ModelEvaluationTimingRate and extrapolate from there...
+
+    if (mNbOfModelEvaluations++ % ModelEvaluationTimingRate)
+        return false;
+
+    mModelEvaluationTimer.start();
+
+    return true;
+}
+
+//==============================================================================
+
+void VoiSolver::stopModelEvaluation(const bool &pTimed) const
 {
+    // Our model has been evaluated, so keep track of the time it took, if it
+    // was timed
+
+    if (pTimed) {
+        mModelTime += mModelEvaluationTimer.nsecsElapsed();
+
+        ++mNbOfTimedModelEvaluations;
+    }
 }
 
 //==============================================================================
 
 OdeSolver::OdeSolver() :
     VoiSolver(),
-    mComputeRates(0)
+    mComputeRates(0),
+    mComputeRatesBlocks(QList<ComputeRatesFunction>()),
+    mSensitivityParameters(QList<int>()),
+    mConstantsCount(0),
+    mSensitivities(0),
+    mComputeComputedConstants(0),
+    mCondVarCount(0),
+    mComputeRootInformation(0),
+    mEventRates(0),
+    mEventStates(0),
+    mEventInterpolatedStates(0),
+    mCondVar(0),
+    mNewCondVar(0),
+    mEventCondVar(0),
+    mEventPending(false)
+{
+}
+
+//==============================================================================
+
+OdeSolver::~OdeSolver()
 {
+    // Delete some internal objects
+
+    delete[] mEventRates;
+    delete[] mEventStates;
+    delete[] mEventInterpolatedStates;
+    delete[] mCondVar;
+    delete[] mNewCondVar;
+    delete[] mEventCondVar;
 }
 
 //==============================================================================
@@ -139,6 +249,253 @@ void OdeSolver::initialize(const double &pVoiStart,
     mAlgebraic = pAlgebraic;
 
     mComputeRates = pComputeRates;
+
+    // Create the arrays that we need to detect events, if any
+
+    delete[] mEventRates;
+    delete[] mEventStates;
+    delete[] mEventInterpolatedStates;
+    delete[] mCondVar;
+    delete[] mNewCondVar;
+    delete[] mEventCondVar;
+
+    if (mCondVarCount) {
+        mEventRates = new double[pRatesStatesCount];
+        mEventStates = new double[pRatesStatesCount];
+        mEventInterpolatedStates = new double[pRatesStatesCount];
+        mCondVar = new double[mCondVarCount];
+        mNewCondVar = new double[mCondVarCount];
+        mEventCondVar = new double[mCondVarCount];
+    } else {
+        mEventRates = mEventStates = mEventInterpolatedStates = 0;
+        mCondVar = mNewCondVar = mEventCondVar = 0;
+    }
+
+    mEventPending = false;
+}
+
+//==============================================================================
+
+bool OdeSolver::supportsSensitivities() const
+{
+    // By default, an ODE solver cannot compute the sensitivities of its states
+
+    return false;
+}
+
+//==============================================================================
+
+void OdeSolver::setSensitivityParameters(const QList<int> &pSensitivityParameters,
+                                         const int &pConstantsCount,
+                                         double *pSensitivities,
+                                         ComputeComputedConstantsFunction pComputeComputedConstants)
+{
+    // Keep track of the constants with respect to which we want to compute the
+    // sensitivities of our states, of the number of constants (so that they can
+    // be saved and restored), of where those sensitivities are to be stored,
+    // and of how to recompute our computed constants (since some of them may
+    // depend on those constants)
+    // Note #1: the sensitivities of our states with respect to the i-th
+    //          constant are stored from pSensitivities[i*mRatesStatesCount]
+    //          on...
+    // Note #2: this method must be called before initialize() and is only of
+    //          use to solvers that support sensitivities...
+
+    mSensitivityParameters = pSensitivityParameters;
+    mConstantsCount = pConstantsCount;
+    mSensitivities = pSensitivities;
+    mComputeComputedConstants = pComputeComputedConstants;
+}
+
+//==============================================================================
+
+void OdeSolver::setComputeRatesBlocks(const QList<ComputeRatesFunction> &pComputeRatesBlocks)
+{
+    // Keep track of the functions that compute independent blocks of our
+    // rates, i.e. blocks that can be computed in parallel
+    // Note: like setSensitivityParameters(), this method must be called before
+    //       initialize() and is only of use to solvers that can compute our
+    //       rates in parallel...
+
+    mComputeRatesBlocks = pComputeRatesBlocks;
+}
+
+//==============================================================================
+
+void OdeSolver::setRootInformation(const int &pCondVarCount,
+                                   ComputeRootInformationFunction pComputeRootInformation)
+{
+    // Keep track of the number of conditions of our model and of how to
+    // compute them, so that we can stop at their roots, i.e. at the events
+    // (e.g. the start and end of a stimulus) of our model
+    // Note: like setSensitivityParameters(), this method must be called before
+    //       initialize()...
+
+    mCondVarCount = pComputeRootInformation?pCondVarCount:0;
+    mComputeRootInformation = pComputeRootInformation;
+}
+
+//==============================================================================
+
+void OdeSolver::computeRootInformation(const double &pVoi, double *pStates,
+                                       double *pCondVar) const
+{
+    // Compute the conditions of our model using the given states
+    // Note: computing our conditions may require computing our rates and
+    //       algebraic variables, hence we use our own rates array so as not to
+    //       interfere with our solver...
+
+    mComputeRootInformation(pVoi, mConstants, mEventRates, pStates,
+                            mAlgebraic, pCondVar);
+}
+
+//==============================================================================
+
+void OdeSolver::computeRates(const double &pVoi, double *pStates,
+                             double *pRates) const
+{
+    // Compute our rates (or the given rates) using the given states, keeping
+    // track of the evaluation of our model
+
+    bool timed = startModelEvaluation();
+
+    mComputeRates(pVoi, mConstants, pRates?pRates:mRates, pStates, mAlgebraic);
+
+    stopModelEvaluation(timed);
+}
+
+//==============================================================================
+
+void OdeSolver::startEventDetection(const double &pVoi) const
+{
+    // Compute the conditions of our model at the start of our integration, so
+    // that we can later tell whether one of them changed sign during a step
+
+    if (!mCondVarCount)
+        return;
+
+    computeRootInformation(pVoi, mStates, mCondVar);
+
+    mEventPending = false;
+}
+
+//==============================================================================
+
+void OdeSolver::startEventStep() const
+{
+    // Keep track of our states at the start of a step, in case an event occurs
+    // during that step
+
+    if (mCondVarCount)
+        memcpy(mEventStates, mStates, size_t(mRatesStatesCount*SizeOfDouble));
+}
+
+//==============================================================================
+
+OdeSolver::EventStatus OdeSolver::checkForEvent(const double &pVoi,
+                                                double &pStep) const
+{
+    // Check whether an event occurred during the step that we have just taken
+    // Note: if it did, then we go back to the start of our step and shorten
+    //       it so that it ends just after the event, i.e. so that the solver
+    //       only integrates across the discontinuity by a tiny amount. The
+    //       solver is then expected to redo its step, after which we let it
+    //       know that the event has been reached, so that it can restart its
+    //       stepping from there. The step must end after the event rather than
+    //       before it since a condition may depend on our states (e.g. V < -40)
+    //       and, therefore, only change sign once our states have crossed the
+    //       event...
+
+    if (!mCondVarCount)
+        return NoEvent;
+
+    if (mEventPending) {
+        computeRootInformation(pVoi+pStep, mStates, mCondVar);
+
+        mEventPending = false;
+
+        return EventReached;
+    }
+
+    computeRootInformation(pVoi+pStep, mStates, mNewCondVar);
+
+    // Locate the earliest event, if any, by bracketing the first root of each
+    // condition that changed sign during our step
+    // Note: we use a linear interpolation of our states over our step (which
+    //       is consistent with the accuracy of a fixed-step solver) and the
+    //       Illinois variant of the regula falsi method...
+
+    static const double EventTolerance = 1.0e-9;
+    static const int MaximumNumberOfIterations = 100;
+
+    double eventRightFraction = 1.0;
+    bool eventFound = false;
+
+    for (int i = 0; i < mCondVarCount; ++i) {
+        if ((mCondVar[i] < 0.0) == (mNewCondVar[i] < 0.0))
+            continue;
+
+        double leftFraction = 0.0;
+        double rightFraction = 1.0;
+        double leftCondVar = mCondVar[i];
+        double rightCondVar = mNewCondVar[i];
+        int side = 0;
+
+        for (int j = 0;    (j < MaximumNumberOfIterations)
+                        && (rightFraction-leftFraction > EventTolerance); ++j) {
+            double fraction = (leftFraction*rightCondVar-rightFraction*leftCondVar)/(rightCondVar-leftCondVar);
+
+            if ((fraction <= leftFraction) || (fraction >= rightFraction))
+                fraction = 0.5*(leftFraction+rightFraction);
+
+            for (int k = 0; k < mRatesStatesCount; ++k)
+                mEventInterpolatedStates[k] = mEventStates[k]+fraction*(mStates[k]-mEventStates[k]);
+
+            computeRootInformation(pVoi+fraction*pStep,
+                                   mEventInterpolatedStates, mEventCondVar);
+
+            if ((mEventCondVar[i] < 0.0) == (leftCondVar < 0.0)) {
+                leftFraction = fraction;
+                leftCondVar = mEventCondVar[i];
+
+                if (side == -1)
+                    rightCondVar *= 0.5;
+
+                side = -1;
+            } else {
+                rightFraction = fraction;
+                rightCondVar = mEventCondVar[i];
+
+                if (side == 1)
+                    leftCondVar *= 0.5;
+
+                side = 1;
+            }
+        }
+
+        if (!eventFound || (rightFraction < eventRightFraction)) {
+            eventRightFraction = rightFraction;
+
+            eventFound = true;
+        }
+    }
+
+    // Keep our step if no event occurred during it, or go back to the start of
+    // our step and shorten it
+
+    if (!eventFound) {
+        memcpy(mCondVar, mNewCondVar, size_t(mCondVarCount*SizeOfDouble));
+
+        return NoEvent;
+    }
+
+    memcpy(mStates, mEventStates, size_t(mRatesStatesCount*SizeOfDouble));
+
+    mEventPending = true;
+
+    pStep *= eventRightFraction;
+
+    return EventLocated;
 }
 
 //==============================================================================
@@ -205,6 +562,7 @@ void DaeSolver::initialize(const double &pVoiStart, const double &pVoiEnd,
 //==============================================================================
 
 NlaSolver::NlaSolver() :
+    mNbOfSolves(0),
     mComputeSystem(0),
     mParameters(0),
     mSize(0),
@@ -218,6 +576,11 @@ void NlaSolver::initialize(ComputeSystemFunction pComputeSystem,
                            double *pParameters, int pSize, void *pUserData)
 {
     // Initialise ourselves
+    // Note: we get initialised before every solve (see doNonLinearSolve()),
+    //       hence we can use this opportunity to keep track of the number of
+    //       times we are asked to solve our system...
+
+    ++mNbOfSolves;
 
     mComputeSystem = pComputeSystem;
 
@@ -228,6 +591,20 @@ void NlaSolver::initialize(ComputeSystemFunction pComputeSystem,
 
 //==============================================================================
 
+Statistics NlaSolver::statistics() const
+{
+    // Return the number of times we were asked to solve our system
+
+    Statistics res = Statistics();
+
+    if (mNbOfSolves)
+        res.insert(NbOfNlaSolves, mNbOfSolves);
+
+    return res;
+}
+
+//==============================================================================
+
 NlaSolver * nlaSolver(const QString &pRuntimeAddress)
 {
     // Return the runtime's NLA solver
@@ -28,7 +28,9 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QElapsedTimer>
 #include <QList>
+#include <QMap>
 #include <QVariant>
 
 //==============================================================================
@@ -51,6 +53,22 @@ enum {
 
 //==============================================================================
 
+enum Statistic {
+    NbOfSteps,
+    NbOfRhsEvaluations,
+    NbOfJacobianEvaluations,
+    NbOfNewtonIterations,
+    NbOfErrorTestFailures,
+    NbOfNlaSolves,
+    ModelTime
+};
+
+typedef QMap<Statistic, qint64> Statistics;
+
+void addStatistics(Statistics &pStatistics, const Statistics &pOtherStatistics);
+
+//==============================================================================
+
 class Solver : public QObject
 {
     Q_OBJECT
@@ -62,6 +80,8 @@ public:
 
     void setProperties(const Properties &pProperties);
 
+    virtual Statistics statistics() const;
+
     void emitError(const QString &pErrorMessage);
 
 protected:
@@ -80,6 +100,11 @@ public:
 
     virtual void solve(double &pVoi, const double &pVoiEnd) const = 0;
 
+    virtual Statistics statistics() const;
+
+    bool startModelEvaluation() const;
+    void stopModelEvaluation(const bool &pTimed) const;
+
 protected:
     int mRatesStatesCount;
 
@@ -87,6 +112,15 @@ protected:
     double *mStates;
     double *mRates;
     double *mAlgebraic;
+
+    mutable qint64 mNbOfSteps;
+
+private:
+    mutable qint64 mNbOfModelEvaluations;
+    mutable qint64 mNbOfTimedModelEvaluations;
+    mutable qint64 mModelTime;
+
+    mutable QElapsedTimer mModelEvaluationTimer;
 };
 
 //==============================================================================
@@ -95,16 +129,66 @@ class OdeSolver : public VoiSolver
 {
 public:
     typedef int (*ComputeRatesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
+    typedef int (*ComputeComputedConstantsFunction)(double *CONSTANTS, double *RATES, double *STATES);
+    typedef int (*ComputeRootInformationFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *CONDVAR);
 
     explicit OdeSolver();
+    ~OdeSolver();
 
     virtual void initialize(const double &pVoiStart,
                             const int &pRatesStatesCount, double *pConstants,
                             double *pRates, double *pStates, double *pAlgebraic,
                             ComputeRatesFunction pComputeRates);
 
+    virtual bool supportsSensitivities() const;
+
+    void setSensitivityParameters(const QList<int> &pSensitivityParameters,
+                                  const int &pConstantsCount,
+                                  double *pSensitivities,
+                                  ComputeComputedConstantsFunction pComputeComputedConstants);
+
+    void setComputeRatesBlocks(const QList<ComputeRatesFunction> &pComputeRatesBlocks);
+
+    void setRootInformation(const int &pCondVarCount,
+                            ComputeRootInformationFunction pComputeRootInformation);
+
+    void computeRootInformation(const double &pVoi, double *pStates,
+                                double *pCondVar) const;
+
 protected:
+    enum EventStatus {
+        NoEvent,
+        EventLocated,
+        EventReached
+    };
+
     ComputeRatesFunction mComputeRates;
+    QList<ComputeRatesFunction> mComputeRatesBlocks;
+
+    QList<int> mSensitivityParameters;
+    int mConstantsCount;
+    double *mSensitivities;
+    ComputeComputedConstantsFunction mComputeComputedConstants;
+
+    int mCondVarCount;
+    ComputeRootInformationFunction mComputeRootInformation;
+
+    void computeRates(const double &pVoi, double *pStates,
+                      double *pRates = 0) const;
+
+    void startEventDetection(const double &pVoi) const;
+    void startEventStep() const;
+    EventStatus checkForEvent(const double &pVoi, double &pStep) const;
+
+private:
+    double *mEventRates;
+    double *mEventStates;
+    double *mEventInterpolatedStates;
+    double *mCondVar;
+    double *mNewCondVar;
+    double *mEventCondVar;
+
+    mutable bool mEventPending;
 };
 
 //==============================================================================
@@ -153,7 +237,11 @@ public:
 
     virtual void solve() const = 0;
 
+    virtual Statistics statistics() const;
+
 private:
+    qint64 mNbOfSolves;
+
     ComputeSystemFunction mComputeSystem;
 
     double *mParameters;
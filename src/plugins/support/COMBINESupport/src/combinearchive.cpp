@@ -26,13 +26,15 @@ limitations under the License.
 //==============================================================================
 
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QTemporaryDir>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
 
 //==============================================================================
 
-#include <QZipReader>
 #include <QZipWriter>
 
 //==============================================================================
@@ -91,6 +93,60 @@ bool CombineArchiveFile::isMaster() const
 
 //==============================================================================
 
+CombineArchiveFileExtractor::CombineArchiveFileExtractor(const QString &pCombineArchiveFileName,
+                                                         const ZIPSupport::QZipReader::EntryLocation &pEntryLocation,
+                                                         const QString &pFileName,
+                                                         bool &pResult) :
+    mCombineArchiveFileName(pCombineArchiveFileName),
+    mEntryLocation(pEntryLocation),
+    mFileName(pFileName),
+    mResult(pResult)
+{
+}
+
+//==============================================================================
+
+void CombineArchiveFileExtractor::run()
+{
+    // Extract our file from our COMBINE archive
+    // Note: the location of our file in our COMBINE archive was determined by
+    //       CombineArchive::extractFiles(), so all we need to do is to open our
+    //       COMBINE archive (we may be running alongside other extractors) and
+    //       extract our file from there, i.e. no need to scan the central
+    //       directory of our COMBINE archive again...
+
+    mResult = OpenCOR::ZIPSupport::QZipReader::extractFile(mCombineArchiveFileName,
+                                                           mEntryLocation,
+                                                           mFileName);
+}
+
+//==============================================================================
+
+CombineArchiveFileCompressor::CombineArchiveFileCompressor(const QString &pFileName,
+                                                           const QString &pCompressedFileName,
+                                                           uint &pCrc,
+                                                           qint64 &pUncompressedSize,
+                                                           bool &pResult) :
+    mFileName(pFileName),
+    mCompressedFileName(pCompressedFileName),
+    mCrc(pCrc),
+    mUncompressedSize(pUncompressedSize),
+    mResult(pResult)
+{
+}
+
+//==============================================================================
+
+void CombineArchiveFileCompressor::run()
+{
+    // Compress our file
+
+    mResult = OpenCOR::ZIPSupport::QZipWriter::compressFile(mFileName, mCompressedFileName,
+                                                            mCrc, mUncompressedSize);
+}
+
+//==============================================================================
+
 static const auto CellmlFormat      = QStringLiteral("http://identifiers.org/combine.specifications/cellml");
 static const auto Cellml_1_0_Format = QStringLiteral("http://identifiers.org/combine.specifications/cellml.1.0");
 static const auto Cellml_1_1_Format = QStringLiteral("http://identifiers.org/combine.specifications/cellml.1.1");
@@ -150,6 +206,9 @@ void CombineArchive::reset()
 
     mLoadingNeeded = true;
 
+    mEntries.clear();
+    mExtractedEntries.clear();
+
     mFiles.clear();
     mIssues.clear();
 }
@@ -160,6 +219,24 @@ static const auto ManifestFileName = QStringLiteral("manifest.xml");
 
 //==============================================================================
 
+static QString entryName(const QString &pLocation)
+{
+    // Return the name of the ZIP entry that corresponds to the given location
+    // (see QZipReader::fileInfoList())
+
+    QString res = QDir::fromNativeSeparators(pLocation);
+
+    while (res.startsWith('.') || res.startsWith('/'))
+        res.remove(0, 1);
+
+    while (res.endsWith('/'))
+        res.chop(1);
+
+    return res;
+}
+
+//==============================================================================
+
 bool CombineArchive::load()
 {
     // Check whether we are already loaded and without an issue
@@ -208,11 +285,18 @@ bool CombineArchive::load()
         return false;
     }
 
-    // Our file is effectively a ZIP file, so extract all of our contents
+    // Our file is effectively a ZIP file, so keep track of its entries
+    // Note: entries only get extracted when they are first needed (see
+    //       extractFiles())...
 
     zipReader.device()->reset();
 
-    if (!zipReader.extractAll(mDirName)) {
+    foreach (const OpenCOR::ZIPSupport::QZipReader::FileInfo &fileInfo, zipReader.fileInfoList()) {
+        if (fileInfo.isFile)
+            mEntries << fileInfo.filePath;
+    }
+
+    if (zipReader.status() != OpenCOR::ZIPSupport::QZipReader::NoError) {
         mIssues << CombineArchiveIssue(CombineArchiveIssue::Error,
                                        QObject::tr("the contents of the archive could not be extracted"));
 
@@ -224,6 +308,71 @@ bool CombineArchive::load()
 
 //==============================================================================
 
+bool CombineArchive::extractFiles(const QStringList &pLocations)
+{
+    // Determine which of the given files have yet to be extracted, making sure
+    // that they are all in our archive
+
+    QStringList locations = QStringList();
+
+    foreach (const QString &location, pLocations) {
+        QString name = entryName(location);
+
+        if (!mExtractedEntries.contains(name) && !locations.contains(location)) {
+            if (!mEntries.contains(name))
+                return false;
+
+            locations << location;
+        }
+    }
+
+    if (locations.isEmpty())
+        return true;
+
+    // Determine where our files are in our archive, scanning its central
+    // directory only once for all of them
+
+    OpenCOR::ZIPSupport::QZipReader zipReader(mFileName);
+    QHash<QString, OpenCOR::ZIPSupport::QZipReader::EntryLocation> entryLocations = zipReader.entryLocations();
+
+    zipReader.close();
+
+    // Extract our files in parallel, after having created the sub-folder(s) in
+    // which they are, if necessary
+
+    QThreadPool threadPool;
+    QVector<bool> results = QVector<bool>(locations.count());
+    static QDir dir;
+
+    for (int i = 0, iMax = locations.count(); i < iMax; ++i) {
+        QString fileName = mDirName+QDir::separator()+locations[i];
+
+        if (!dir.mkpath(QFileInfo(fileName).path()))
+            return false;
+
+        threadPool.start(new CombineArchiveFileExtractor(mFileName,
+                                                         entryLocations.value(entryName(locations[i])),
+                                                         fileName, results[i]));
+    }
+
+    threadPool.waitForDone();
+
+    // Keep track of the files that got extracted
+
+    bool res = true;
+
+    for (int i = 0, iMax = locations.count(); i < iMax; ++i) {
+        if (results[i])
+            mExtractedEntries << entryName(locations[i]);
+        else
+            res = false;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
 bool CombineArchive::save(const QString &pFileName)
 {
     // Make sure that we are properly loaded and have no issue
@@ -270,32 +419,66 @@ bool CombineArchive::save(const QString &pFileName)
         fileList += "/>\n";
     }
 
-    // Save ourselves to either the given file, which name is given, or to our
-    // current file
-
-    OpenCOR::ZIPSupport::QZipWriter zipWriter(pFileName.isEmpty()?mFileName:pFileName);
+    // Make sure that all of our files have been extracted and compress them in
+    // parallel, each to its own temporary file
 
-    zipWriter.addFile(ManifestFileName,
-                       "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
-                       "<omexManifest xmlns=\"http://identifiers.org/combine.specifications/omex-manifest\">\n"
-                       "    <content location=\".\" format=\""+OmexFormat.toUtf8()+"\"/>\n"
-                      +fileList
-                      +"</omexManifest>\n");
+    QStringList locations = QStringList();
 
     foreach (const CombineArchiveFile &file, mFiles) {
-        if (file.location().compare(".")) {
-            QByteArray combineArchiveFileContents;
+        if (file.location().compare("."))
+            locations << file.location();
+    }
 
-            if (!Core::readFileContentsFromFile(mDirName+QDir::separator()+file.location(),
-                                                combineArchiveFileContents)) {
-                return false;
-            }
+    if (!extractFiles(locations))
+        return false;
+
+    int locationsCount = locations.count();
+    QThreadPool threadPool;
+    QStringList compressedFileNames = QStringList();
+    QVector<uint> crcs = QVector<uint>(locationsCount);
+    QVector<qint64> uncompressedSizes = QVector<qint64>(locationsCount);
+    QVector<bool> results = QVector<bool>(locationsCount);
+
+    for (int i = 0; i < locationsCount; ++i) {
+        compressedFileNames << Core::temporaryFileName();
+
+        threadPool.start(new CombineArchiveFileCompressor(mDirName+QDir::separator()+locations[i],
+                                                          compressedFileNames[i],
+                                                          crcs[i], uncompressedSizes[i],
+                                                          results[i]));
+    }
+
+    threadPool.waitForDone();
+
+    bool res = !results.contains(false);
+
+    // Save ourselves to either the given file, which name is given, or to our
+    // current file, copying over the compressed version of our files
+
+    if (res) {
+        OpenCOR::ZIPSupport::QZipWriter zipWriter(pFileName.isEmpty()?mFileName:pFileName);
 
-            zipWriter.addFile(file.location(), combineArchiveFileContents);
+        zipWriter.addFile(ManifestFileName,
+                           "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                           "<omexManifest xmlns=\"http://identifiers.org/combine.specifications/omex-manifest\">\n"
+                           "    <content location=\".\" format=\""+OmexFormat.toUtf8()+"\"/>\n"
+                          +fileList
+                          +"</omexManifest>\n");
+
+        for (int i = 0; i < locationsCount; ++i) {
+            zipWriter.addCompressedFile(locations[i], compressedFileNames[i],
+                                        crcs[i], uncompressedSizes[i]);
         }
+
+        res = zipWriter.status() == OpenCOR::ZIPSupport::QZipWriter::NoError;
     }
 
-    return true;
+    // Delete our compressed files
+
+    foreach (const QString &compressedFileName, compressedFileNames)
+        QFile::remove(compressedFileName);
+
+    return res;
 }
 
 //==============================================================================
@@ -318,7 +501,7 @@ bool CombineArchive::isValid()
 
     QString manifestFileName = mDirName+QDir::separator()+ManifestFileName;
 
-    if (!QFile::exists(manifestFileName)) {
+    if (!extractFiles(QStringList() << ManifestFileName)) {
         mIssues << CombineArchiveIssue(CombineArchiveIssue::Error,
                                        QObject::tr("the archive does not have a manifest"));
 
@@ -341,7 +524,9 @@ bool CombineArchive::isValid()
     }
 
     // Retrieve the COMBINE archive files from the manifest, making sure that
-    // they have been physically extracted
+    // they are in our archive
+    // Note: they will only get extracted when needed (see masterFiles() and
+    //       location())...
 
     QDomDocument domDocument;
 
@@ -354,7 +539,7 @@ bool CombineArchive::isValid()
         QString location = childElement.attribute("location");
         QString fileName = mDirName+QDir::separator()+location;
 
-        if (!QFile::exists(fileName)) {
+        if (location.compare(".") && !mEntries.contains(entryName(location))) {
             mIssues << CombineArchiveIssue(CombineArchiveIssue::Error,
                                            QObject::tr("<strong>%1</strong> could not be found").arg(location));
 
@@ -402,9 +587,13 @@ bool CombineArchive::isValid()
 
 //==============================================================================
 
-QString CombineArchive::location(const CombineArchiveFile &pFile) const
+QString CombineArchive::location(const CombineArchiveFile &pFile)
 {
-    // Return the (full) location of the given file
+    // Make sure that the given file has been extracted and return its (full)
+    // location
+
+    if (!extractFiles(QStringList() << pFile.location()))
+        return QString();
 
     return mDirName+QDir::separator()+pFile.location();
 }
@@ -418,6 +607,18 @@ CombineArchiveFiles CombineArchive::masterFiles()
     if (!load())
         return CombineArchiveFiles();
 
+    // Make sure that all of our entries have been extracted
+    // Note: our master files may reference other files in our archive (e.g. a
+    //       SED-ML file referencing a CellML file, which may itself import
+    //       other CellML files, or a data file), and those are accessed using
+    //       their relative path rather than through location(). Those files
+    //       may be of a format we don't know about or may not even be listed
+    //       in our manifest, hence we extract all of our entries (in
+    //       parallel)...
+
+    if (!extractFiles(mEntries.toList()))
+        return CombineArchiveFiles();
+
     // Return a list of our master files
 
     CombineArchiveFiles res = CombineArchiveFiles();
@@ -472,6 +673,8 @@ bool CombineArchive::addFile(const QString &pFileName, const QString &pLocation,
     if (!QFile::copy(pFileName, destFileName))
         return false;
 
+    mExtractedEntries << entryName(pLocation);
+
     return true;
 }
 
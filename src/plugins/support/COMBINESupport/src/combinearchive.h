@@ -31,6 +31,12 @@ limitations under the License.
 //==============================================================================
 
 #include <QObject>
+#include <QRunnable>
+#include <QSet>
+
+//==============================================================================
+
+#include <QZipReader>
 
 //==============================================================================
 
@@ -80,6 +86,48 @@ typedef QList<CombineArchiveFile> CombineArchiveFiles;
 
 //==============================================================================
 
+class CombineArchiveFileExtractor : public QRunnable
+{
+public:
+    explicit CombineArchiveFileExtractor(const QString &pCombineArchiveFileName,
+                                         const ZIPSupport::QZipReader::EntryLocation &pEntryLocation,
+                                         const QString &pFileName,
+                                         bool &pResult);
+
+    virtual void run();
+
+private:
+    QString mCombineArchiveFileName;
+    ZIPSupport::QZipReader::EntryLocation mEntryLocation;
+    QString mFileName;
+
+    bool &mResult;
+};
+
+//==============================================================================
+
+class CombineArchiveFileCompressor : public QRunnable
+{
+public:
+    explicit CombineArchiveFileCompressor(const QString &pFileName,
+                                          const QString &pCompressedFileName,
+                                          uint &pCrc, qint64 &pUncompressedSize,
+                                          bool &pResult);
+
+    virtual void run();
+
+private:
+    QString mFileName;
+    QString mCompressedFileName;
+
+    uint &mCrc;
+    qint64 &mUncompressedSize;
+
+    bool &mResult;
+};
+
+//==============================================================================
+
 class COMBINESUPPORT_EXPORT CombineArchive : public StandardSupport::StandardFile
 {
     Q_OBJECT
@@ -93,7 +141,7 @@ public:
 
     bool isValid();
 
-    QString location(const CombineArchiveFile &pFile) const;
+    QString location(const CombineArchiveFile &pFile);
 
     CombineArchiveFiles masterFiles();
 
@@ -109,10 +157,15 @@ private:
     bool mNew;
     bool mLoadingNeeded;
 
+    QSet<QString> mEntries;
+    QSet<QString> mExtractedEntries;
+
     CombineArchiveFiles mFiles;
     CombineArchiveIssues mIssues;
 
     virtual void reset();
+
+    bool extractFiles(const QStringList &pLocations);
 };
 
 //==============================================================================
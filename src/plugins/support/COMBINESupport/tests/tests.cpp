@@ -36,6 +36,7 @@ limitations under the License.
 
 #include <QXmlSchema>
 #include <QZipReader>
+#include <QZipWriter>
 
 //==============================================================================
 
@@ -238,6 +239,60 @@ void Tests::loadingErrorTests()
 
 //==============================================================================
 
+void Tests::masterFilesTests()
+{
+    // Create a COMBINE archive which master file is a CellML file that imports
+    // a CellML file listed under a format we don't know about and that uses a
+    // data file that is not listed in the manifest
+
+    QString fileName = OpenCOR::Core::temporaryFileName();
+
+    {
+        OpenCOR::ZIPSupport::QZipWriter zipWriter(fileName);
+
+        zipWriter.addFile("manifest.xml",
+                          "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                          "<omexManifest xmlns=\"http://identifiers.org/combine.specifications/omex-manifest\">\n"
+                          "    <content location=\".\" format=\"http://identifiers.org/combine.specifications/omex\"/>\n"
+                          "    <content location=\"model.cellml\" format=\"http://identifiers.org/combine.specifications/cellml\" master=\"true\"/>\n"
+                          "    <content location=\"imports/imported.cellml\" format=\"http://identifiers.org/combine.specifications/cellml.2.0\"/>\n"
+                          "</omexManifest>\n");
+        zipWriter.addFile("model.cellml", "<model name=\"model\"/>\n");
+        zipWriter.addFile("imports/imported.cellml", "<model name=\"imported\"/>\n");
+        zipWriter.addFile("data/data.csv", "t,x\n0,1\n");
+
+        QVERIFY(zipWriter.status() == OpenCOR::ZIPSupport::QZipWriter::NoError);
+    }
+
+    // Retrieve our master file and make sure that the files it references can
+    // be accessed using their path relative to it
+
+    OpenCOR::COMBINESupport::CombineArchive combineArchive(fileName);
+
+    QVERIFY(combineArchive.load());
+    QVERIFY(combineArchive.isValid());
+
+    OpenCOR::COMBINESupport::CombineArchiveFiles masterFiles = combineArchive.masterFiles();
+
+    QCOMPARE(masterFiles.count(), 1);
+    QCOMPARE(masterFiles.first().location(), QString("model.cellml"));
+    QCOMPARE(masterFiles.first().format(), OpenCOR::COMBINESupport::CombineArchiveFile::Cellml);
+
+    QDir masterDir = QFileInfo(masterFiles.first().fileName()).dir();
+
+    QVERIFY(QFile::exists(masterFiles.first().fileName()));
+    QCOMPARE(OpenCOR::fileContents(masterDir.filePath("imports/imported.cellml")),
+             QStringList() << "<model name=\"imported\"/>" << QString());
+    QCOMPARE(OpenCOR::fileContents(masterDir.filePath("data/data.csv")),
+             QStringList() << "t,x" << "0,1" << QString());
+
+    // Clean up after ourselves
+
+    QFile::remove(fileName);
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(Tests)
 
 //==============================================================================
@@ -51,6 +51,7 @@ private Q_SLOTS:
 
     void basicTests();
     void loadingErrorTests();
+    void masterFilesTests();
 };
 
 //==============================================================================
@@ -33,8 +33,12 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QHash>
+#include <QPair>
 #include <QRegularExpression>
 #include <QStringList>
+#include <QThread>
+#include <QVector>
 
 //==============================================================================
 
@@ -335,6 +339,16 @@ CellmlFileRuntime::ComputeOdeRatesFunction CellmlFileRuntime::computeOdeRates()
 
 //==============================================================================
 
+QList<CellmlFileRuntime::ComputeOdeRatesFunction> CellmlFileRuntime::computeOdeRatesBlocks() const
+{
+    // Return the computeOdeRates functions for the blocks of our rates that can
+    // be computed in parallel, if any
+
+    return mComputeOdeRatesBlocks;
+}
+
+//==============================================================================
+
 CellmlFileRuntime::ComputeOdeVariablesFunction CellmlFileRuntime::computeOdeVariables() const
 {
     // Return the computeOdeVariables function
@@ -344,6 +358,15 @@ CellmlFileRuntime::ComputeOdeVariablesFunction CellmlFileRuntime::computeOdeVari
 
 //==============================================================================
 
+CellmlFileRuntime::ComputeOdeRootInformationFunction CellmlFileRuntime::computeOdeRootInformation() const
+{
+    // Return the computeOdeRootInformation function
+
+    return mComputeOdeRootInformation;
+}
+
+//==============================================================================
+
 CellmlFileRuntime::ComputeDaeEssentialVariablesFunction CellmlFileRuntime::computeDaeEssentialVariables() const
 {
     // Return the computeDaeEssentialVariables function
@@ -438,7 +461,9 @@ void CellmlFileRuntime::resetFunctions()
     mComputeComputedConstants = 0;
 
     mComputeOdeRates = 0;
+    mComputeOdeRatesBlocks.clear();
     mComputeOdeVariables = 0;
+    mComputeOdeRootInformation = 0;
 
     mComputeDaeEssentialVariables = 0;
     mComputeDaeResiduals = 0;
@@ -590,6 +615,142 @@ void CellmlFileRuntime::retrieveDaeCodeInformation(iface::cellml_api::Model *pMo
 
 //==============================================================================
 
+QString variableName(iface::cellml_services::ComputationTarget *pComputationTarget)
+{
+    // Return the name used in the model code for the given computation target,
+    // if any
+
+    QString array = QString();
+
+    if (pComputationTarget->degree()) {
+        array = "RATES";
+    } else {
+        switch (pComputationTarget->type()) {
+        case iface::cellml_services::CONSTANT:
+            array = "CONSTANTS";
+
+            break;
+        case iface::cellml_services::STATE_VARIABLE:
+        case iface::cellml_services::PSEUDOSTATE_VARIABLE:
+            array = "STATES";
+
+            break;
+        case iface::cellml_services::ALGEBRAIC:
+            array = "ALGEBRAIC";
+
+            break;
+        default:
+            return QString();
+        }
+    }
+
+    return QString("%1[%2]").arg(array).arg(pComputationTarget->assignedIndex());
+}
+
+//==============================================================================
+
+QString CellmlFileRuntime::odeRootInformation(iface::cellml_api::Model *pModel)
+{
+    // Retrieve the root information of our ODE model, i.e. the code that
+    // computes the conditions (e.g. of its piecewise statements) whose roots
+    // are the events of our model
+    // Note: only the IDA code generator keeps track of the conditions of a
+    //       model, so we use it and then map the variables used in its root
+    //       information to those used in our ODE code. If anything goes wrong,
+    //       then we consider that our model has no conditions, in which case
+    //       our ODE solvers will behave as if they didn't know about events...
+
+    mCondVarCount = 0;
+
+    ObjRef<iface::cellml_services::CodeGeneratorBootstrap> codeGeneratorBootstrap = CreateCodeGeneratorBootstrap();
+    ObjRef<iface::cellml_services::IDACodeGenerator> codeGenerator = codeGeneratorBootstrap->createIDACodeGenerator();
+    ObjRef<iface::cellml_services::IDACodeInformation> codeInformation;
+
+    try {
+        codeInformation = codeGenerator->generateIDACode(pModel);
+    } catch (...) {
+        return QString();
+    }
+
+    if (   !QString::fromStdWString(codeInformation->errorMessage()).isEmpty()
+        ||  (codeInformation->constraintLevel() != iface::cellml_services::CORRECTLY_CONSTRAINED)
+        || !codeInformation->conditionVariableCount()) {
+        return QString();
+    }
+
+    // Map the variables used in our DAE code to those used in our ODE code
+
+    typedef QPair<iface::cellml_api::CellMLVariable *, int> Variable;
+
+    QMap<Variable, QString> odeVariables = QMap<Variable, QString>();
+    ObjRef<iface::cellml_services::ComputationTargetIterator> odeComputationTargetIter = mOdeCodeInformation->iterateTargets();
+
+    for (ObjRef<iface::cellml_services::ComputationTarget> computationTarget = odeComputationTargetIter->nextComputationTarget();
+         computationTarget; computationTarget = odeComputationTargetIter->nextComputationTarget()) {
+        ObjRef<iface::cellml_api::CellMLVariable> variable = computationTarget->variable();
+
+        odeVariables.insert(Variable(variable, int(computationTarget->degree())),
+                            variableName(computationTarget));
+    }
+
+    QMap<QString, QString> variables = QMap<QString, QString>();
+    ObjRef<iface::cellml_services::ComputationTargetIterator> daeComputationTargetIter = codeInformation->iterateTargets();
+
+    for (ObjRef<iface::cellml_services::ComputationTarget> computationTarget = daeComputationTargetIter->nextComputationTarget();
+         computationTarget; computationTarget = daeComputationTargetIter->nextComputationTarget()) {
+        ObjRef<iface::cellml_api::CellMLVariable> variable = computationTarget->variable();
+        QString daeVariable = variableName(computationTarget);
+        QString odeVariable = odeVariables.value(Variable(variable, int(computationTarget->degree())));
+
+        if (!daeVariable.isEmpty() && !odeVariable.isEmpty())
+            variables.insert(daeVariable, odeVariable);
+    }
+
+    // Use our mapping to convert our DAE root information to an ODE one
+    // Note: we give up if our DAE root information relies on an NLA system, on
+    //       old rates/states, or on a variable that we couldn't map...
+
+    static const QRegularExpression VariableRegEx = QRegularExpression("\\b(CONSTANTS|RATES|OLDRATES|STATES|OLDSTATES|ALGEBRAIC)\\[\\d+\\]");
+
+    QString daeRootInformation = cleanCode(codeInformation->rootInformationString());
+
+    if (daeRootInformation.contains("rootfind_"))
+        return QString();
+
+    QString res = QString();
+    QRegularExpressionMatchIterator matchIter = VariableRegEx.globalMatch(daeRootInformation);
+    int position = 0;
+
+    while (matchIter.hasNext()) {
+        QRegularExpressionMatch match = matchIter.next();
+        QString odeVariable = variables.value(match.captured());
+
+        if (odeVariable.isEmpty())
+            return QString();
+
+        res += daeRootInformation.mid(position, match.capturedStart()-position)+odeVariable;
+
+        position = match.capturedEnd();
+    }
+
+    res += daeRootInformation.mid(position);
+
+    // Our root information may need some up-to-date rates and/or algebraic
+    // variables, in which case we must compute them first
+
+    if (res.contains("RATES[") || res.contains("ALGEBRAIC[")) {
+        res = cleanCode(mOdeCodeInformation->ratesString())+"\n"
+             +cleanCode(mOdeCodeInformation->variablesString())+"\n"
+             +res;
+    }
+
+    mCondVarCount = codeInformation->conditionVariableCount();
+
+    return res;
+}
+
+//==============================================================================
+
 QString CellmlFileRuntime::functionCode(const QString &pFunctionSignature,
                                         const QString &pFunctionBody,
                                         const bool &pHasDefines)
@@ -703,6 +864,141 @@ QString CellmlFileRuntime::cleanCode(const std::wstring &pCode)
 
 //==============================================================================
 
+static int groupStatement(QVector<int> &pGroupStatements, int pStatement)
+{
+    // Return the statement that represents the group to which the given
+    // statement belongs, flattening our groups as we go
+
+    while (pGroupStatements[pStatement] != pStatement) {
+        pGroupStatements[pStatement] = pGroupStatements[pGroupStatements[pStatement]];
+
+        pStatement = pGroupStatements[pStatement];
+    }
+
+    return pStatement;
+}
+
+//==============================================================================
+
+QStringList CellmlFileRuntime::independentBlocks(const QString &pCode,
+                                                 const int &pMaximumNbOfBlocks,
+                                                 const int &pMinimumNbOfStatementsPerBlock)
+{
+    // Split the given code into at most the given number of blocks that can be
+    // executed in parallel, i.e. blocks which statements neither use nor
+    // compute a variable that is computed by a statement in another block
+    // Note #1: we can only do this if all our statements are of the form
+    //          "ALGEBRAIC[i] = ...;" or "RATES[i] = ...;", which is not the
+    //          case if, for example, an NLA system needs to be solved, in which
+    //          case we return the given code as a single block...
+    // Note #2: the statements of a block are in the same order as in the given
+    //          code...
+
+    static const QRegularExpression StatementRegEx = QRegularExpression("^((ALGEBRAIC|RATES)\\[\\d+\\]) = [^;]*;$");
+    static const QRegularExpression VariableRegEx = QRegularExpression("(ALGEBRAIC|RATES)\\[\\d+\\]");
+
+    QStringList statements = pCode.split("\n", QString::SkipEmptyParts);
+    int nbOfStatements = statements.count();
+    int nbOfBlocks = qMin(pMaximumNbOfBlocks, nbOfStatements/qMax(pMinimumNbOfStatementsPerBlock, 1));
+
+    if (nbOfBlocks < 2)
+        return QStringList() << pCode;
+
+    // Determine which statement computes which variable and which variables
+    // each statement uses
+
+    QHash<QString, int> computingStatements = QHash<QString, int>();
+    QList<QStringList> statementsVariables = QList<QStringList>();
+
+    for (int i = 0; i < nbOfStatements; ++i) {
+        QRegularExpressionMatch match = StatementRegEx.match(statements[i].trimmed());
+
+        if (!match.hasMatch() || computingStatements.contains(match.captured(1)))
+            return QStringList() << pCode;
+
+        computingStatements.insert(match.captured(1), i);
+
+        QStringList statementVariables = QStringList();
+        QRegularExpressionMatchIterator variablesIterator = VariableRegEx.globalMatch(statements[i]);
+
+        while (variablesIterator.hasNext())
+            statementVariables << variablesIterator.next().captured(0);
+
+        statementsVariables << statementVariables;
+    }
+
+    // Group together the statements that use and/or compute the same computed
+    // variable
+
+    QVector<int> groupStatements = QVector<int>(nbOfStatements);
+
+    for (int i = 0; i < nbOfStatements; ++i)
+        groupStatements[i] = i;
+
+    for (int i = 0; i < nbOfStatements; ++i) {
+        foreach (const QString &variable, statementsVariables[i]) {
+            int computingStatement = computingStatements.value(variable, -1);
+
+            if (computingStatement != -1)
+                groupStatements[groupStatement(groupStatements, i)] = groupStatement(groupStatements, computingStatement);
+        }
+    }
+
+    QHash<int, int> groupSizes = QHash<int, int>();
+
+    for (int i = 0; i < nbOfStatements; ++i)
+        ++groupSizes[groupStatement(groupStatements, i)];
+
+    if (groupSizes.count() < 2)
+        return QStringList() << pCode;
+
+    // Distribute our groups between our blocks, starting with our largest
+    // groups and always adding a group to our smallest block, so that our
+    // blocks end up with similar numbers of statements
+
+    QList<QPair<int, int>> groups = QList<QPair<int, int>>();
+
+    foreach (int group, groupSizes.keys())
+        groups << qMakePair(groupSizes.value(group), group);
+
+    std::sort(groups.begin(), groups.end());
+
+    nbOfBlocks = qMin(nbOfBlocks, groups.count());
+
+    QVector<int> blockSizes = QVector<int>(nbOfBlocks);
+    QHash<int, int> groupBlocks = QHash<int, int>();
+
+    for (int i = groups.count()-1; i >= 0; --i) {
+        int smallestBlock = 0;
+
+        for (int j = 1; j < nbOfBlocks; ++j) {
+            if (blockSizes[j] < blockSizes[smallestBlock])
+                smallestBlock = j;
+        }
+
+        groupBlocks.insert(groups[i].second, smallestBlock);
+
+        blockSizes[smallestBlock] += groups[i].first;
+    }
+
+    // Generate our blocks
+
+    QStringList res = QStringList();
+
+    for (int i = 0; i < nbOfBlocks; ++i)
+        res << QString();
+
+    for (int i = 0; i < nbOfStatements; ++i) {
+        QString &block = res[groupBlocks.value(groupStatement(groupStatements, i))];
+
+        block += (block.isEmpty()?QString():"\n")+statements[i];
+    }
+
+    return res;
+}
+
+//==============================================================================
+
 void CellmlFileRuntime::update()
 {
     // Reset the runtime's properties
@@ -758,10 +1054,13 @@ void CellmlFileRuntime::update()
 
     // Retrieve the number of constants, states/rates, algebraic and conditional
     // variables in the model
-    // Note: this is to avoid having to go through the ODE/DAE code information
-    //       an unnecessary number of times when we want to retrieve either of
-    //       those numbers (e.g. see
-    //       SingleCellViewSimulationResults::addPoint())...
+    // Note #1: the number of conditional variables of an ODE model is only
+    //          known once we have retrieved its root information (see
+    //          odeRootInformation())...
+    // Note #2: this is to avoid having to go through the ODE/DAE code
+    //          information an unnecessary number of times when we want to
+    //          retrieve either of those numbers (e.g. see
+    //          SingleCellViewSimulationResults::addPoint())...
 
     if (mModelType == CellmlFileRuntime::Ode) {
         mConstantsCount   = mOdeCodeInformation->constantIndexCount();
@@ -997,13 +1296,38 @@ void CellmlFileRuntime::update()
     modelCode += "\n";
 
     // Retrieve the body of the remaining functions
+    // Note: for ODE models, we also split our rates into blocks that can be
+    //       computed in parallel, if possible, so that a solver can use several
+    //       threads to compute our rates, although it only pays off if those
+    //       blocks have enough to compute...
+
+    static const int MinimumNbOfStatementsPerOdeRatesBlock = 256;
+
+    QStringList odeRatesBlocks = QStringList();
 
     if (mModelType == CellmlFileRuntime::Ode) {
+        QString odeRates = cleanCode(mOdeCodeInformation->ratesString());
+
         modelCode += functionCode("int computeOdeRates(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
-                                  cleanCode(mOdeCodeInformation->ratesString()));
+                                  odeRates);
         modelCode += "\n";
+
+        odeRatesBlocks = independentBlocks(odeRates, QThread::idealThreadCount(),
+                                           MinimumNbOfStatementsPerOdeRatesBlock);
+
+        if (odeRatesBlocks.count() > 1) {
+            for (int i = 0, iMax = odeRatesBlocks.count(); i < iMax; ++i) {
+                modelCode += functionCode(QString("int computeOdeRatesBlock%1(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)").arg(i),
+                                          odeRatesBlocks[i]);
+                modelCode += "\n";
+            }
+        }
+
         modelCode += functionCode("int computeOdeVariables(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC)",
                                   cleanCode(genericCodeInformation->variablesString()));
+        modelCode += "\n";
+        modelCode += functionCode("int computeOdeRootInformation(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *CONDVAR)",
+                                  odeRootInformation(model));
     } else {
         modelCode += functionCode("int computeDaeEssentialVariables(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR)",
                                   cleanCode(mDaeCodeInformation->essentialVariablesString()));
@@ -1051,6 +1375,12 @@ void CellmlFileRuntime::update()
         if (mModelType == CellmlFileRuntime::Ode) {
             mComputeOdeRates     = (ComputeOdeRatesFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeRates");
             mComputeOdeVariables = (ComputeOdeVariablesFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeVariables");
+            mComputeOdeRootInformation = (ComputeOdeRootInformationFunction) (intptr_t) mCompilerEngine->getFunction("computeOdeRootInformation");
+
+            if (odeRatesBlocks.count() > 1) {
+                for (int i = 0, iMax = odeRatesBlocks.count(); i < iMax; ++i)
+                    mComputeOdeRatesBlocks << (ComputeOdeRatesFunction) (intptr_t) mCompilerEngine->getFunction(QString("computeOdeRatesBlock%1").arg(i));
+            }
         } else {
             mComputeDaeEssentialVariables = (ComputeDaeEssentialVariablesFunction) (intptr_t) mCompilerEngine->getFunction("computeDaeEssentialVariables");
             mComputeDaeResiduals          = (ComputeDaeResidualsFunction) (intptr_t) mCompilerEngine->getFunction("computeDaeResiduals");
@@ -1067,7 +1397,9 @@ void CellmlFileRuntime::update()
         if (mModelType == CellmlFileRuntime::Ode) {
             functionsOk =    functionsOk
                           && mComputeOdeRates
-                          && mComputeOdeVariables;
+                          && !mComputeOdeRatesBlocks.contains(0)
+                          && mComputeOdeVariables
+                          && mComputeOdeRootInformation;
         } else {
             functionsOk =    functionsOk
                           && mComputeDaeEssentialVariables
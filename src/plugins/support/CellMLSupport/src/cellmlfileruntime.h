@@ -122,6 +122,7 @@ public:
 
     typedef int (*ComputeOdeRatesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
     typedef int (*ComputeOdeVariablesFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC);
+    typedef int (*ComputeOdeRootInformationFunction)(double VOI, double *CONSTANTS, double *RATES, double *STATES, double *ALGEBRAIC, double *CONDVAR);
 
     typedef int (*ComputeDaeEssentialVariablesFunction)(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR);
     typedef int (*ComputeDaeResidualsFunction)(double VOI, double *CONSTANTS, double *RATES, double *OLDRATES, double *STATES, double *OLDSTATES, double *ALGEBRAIC, double *CONDVAR, double *resid);
@@ -155,7 +156,9 @@ public:
     ComputeComputedConstantsFunction computeComputedConstants() const;
 
     ComputeOdeRatesFunction computeOdeRates() const;
+    QList<ComputeOdeRatesFunction> computeOdeRatesBlocks() const;
     ComputeOdeVariablesFunction computeOdeVariables() const;
+    ComputeOdeRootInformationFunction computeOdeRootInformation() const;
 
     ComputeDaeEssentialVariablesFunction computeDaeEssentialVariables() const;
     ComputeDaeResidualsFunction computeDaeResiduals() const;
@@ -171,6 +174,10 @@ public:
 
     CellmlFileRuntimeParameter * variableOfIntegration() const;
 
+    static QStringList independentBlocks(const QString &pCode,
+                                         const int &pMaximumNbOfBlocks,
+                                         const int &pMinimumNbOfStatementsPerBlock);
+
 private:
     CellmlFile *mCellmlFile;
 
@@ -197,7 +204,9 @@ private:
     ComputeComputedConstantsFunction mComputeComputedConstants;
 
     ComputeOdeRatesFunction mComputeOdeRates;
+    QList<ComputeOdeRatesFunction> mComputeOdeRatesBlocks;
     ComputeOdeVariablesFunction mComputeOdeVariables;
+    ComputeOdeRootInformationFunction mComputeOdeRootInformation;
 
     ComputeDaeEssentialVariablesFunction mComputeDaeEssentialVariables;
     ComputeDaeResidualsFunction mComputeDaeResiduals;
@@ -220,6 +229,8 @@ private:
     void retrieveOdeCodeInformation(iface::cellml_api::Model *pModel);
     void retrieveDaeCodeInformation(iface::cellml_api::Model *pModel);
 
+    QString odeRootInformation(iface::cellml_api::Model *pModel);
+
     QString cleanCode(const std::wstring &pCode);
 
     QString functionCode(const QString &pFunctionSignature,
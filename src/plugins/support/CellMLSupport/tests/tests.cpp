@@ -120,6 +120,74 @@ void Tests::runtimeTests()
 
 //==============================================================================
 
+void Tests::independentBlocksTests()
+{
+    // Split some code with two independent groups of statements, which share a
+    // constant and a state, into blocks
+
+    QString code = "ALGEBRAIC[0] = CONSTANTS[0]*STATES[0];\n"
+                   "ALGEBRAIC[1] = CONSTANTS[0]+STATES[1];\n"
+                   "RATES[0] = ALGEBRAIC[0]-STATES[0];\n"
+                   "ALGEBRAIC[2] = ALGEBRAIC[1]*STATES[0];\n"
+                   "RATES[1] = ALGEBRAIC[2]/CONSTANTS[1];\n"
+                   "RATES[2] = ALGEBRAIC[0]+RATES[0];";
+
+    QStringList blocks = OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(code, 4, 1);
+
+    QCOMPARE(blocks.count(), 2);
+
+    if (blocks[0].startsWith("ALGEBRAIC[1]"))
+        blocks.swap(0, 1);
+
+    QCOMPARE(blocks[0], QString("ALGEBRAIC[0] = CONSTANTS[0]*STATES[0];\n"
+                                "RATES[0] = ALGEBRAIC[0]-STATES[0];\n"
+                                "RATES[2] = ALGEBRAIC[0]+RATES[0];"));
+    QCOMPARE(blocks[1], QString("ALGEBRAIC[1] = CONSTANTS[0]+STATES[1];\n"
+                                "ALGEBRAIC[2] = ALGEBRAIC[1]*STATES[0];\n"
+                                "RATES[1] = ALGEBRAIC[2]/CONSTANTS[1];"));
+
+    // Our code cannot be split if we only want one block or if the blocks
+    // would have too few statements
+
+    QCOMPARE(OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(code, 1, 1),
+             QStringList() << code);
+    QCOMPARE(OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(code, 4, 4),
+             QStringList() << code);
+
+    // Linking our two groups of statements means that our code cannot be split
+    // anymore
+
+    QString linkedCode = code+"\nALGEBRAIC[3] = ALGEBRAIC[0]*ALGEBRAIC[1];";
+
+    QCOMPARE(OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(linkedCode, 4, 1),
+             QStringList() << linkedCode);
+
+    // Code that solves an NLA system cannot be split either
+
+    QString nlaCode = code+"\nrootfind_0(VOI, CONSTANTS, RATES, STATES, ALGEBRAIC, pret);";
+
+    QCOMPARE(OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(nlaCode, 4, 1),
+             QStringList() << nlaCode);
+
+    // Independent groups get distributed between our blocks so that they have
+    // similar numbers of statements
+
+    QString manyGroupsCode = QString();
+
+    for (int i = 0; i < 8; ++i)
+        manyGroupsCode += QString("%1RATES[%2] = CONSTANTS[0]*STATES[%2];").arg(i?"\n":"").arg(i);
+
+    blocks = OpenCOR::CellMLSupport::CellmlFileRuntime::independentBlocks(manyGroupsCode, 3, 2);
+
+    QCOMPARE(blocks.count(), 3);
+    QCOMPARE(blocks[0].split("\n").count()+blocks[1].split("\n").count()+blocks[2].split("\n").count(), 8);
+
+    foreach (const QString &block, blocks)
+        QVERIFY(block.split("\n").count() >= 2);
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(Tests)
 
 //==============================================================================
@@ -38,6 +38,7 @@ private:
 
 private Q_SLOTS:
     void runtimeTests();
+    void independentBlocksTests();
 };
 
 //==============================================================================
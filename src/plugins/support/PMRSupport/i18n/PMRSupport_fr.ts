@@ -15,14 +15,6 @@
         <source>&lt;strong&gt;Note:&lt;/strong&gt; you might want to email &lt;a href=&quot;mailto: help@physiomeproject.org&quot;&gt;help@physiomeproject.org&lt;/a&gt; and ask why this is the case.</source>
         <translation>&lt;strong&gt;Note :&lt;/strong&gt; vous pourriez vouloir envoyer un message à &lt;a href=&quot;mailto: help@physiomeproject.org&quot;&gt;help@physiomeproject.org&lt;/a&gt; et demander pourquoi c&apos;est le cas.</translation>
     </message>
-    <message>
-        <source>Error %1: %2.</source>
-        <translation>Erreur %1 : %2.</translation>
-    </message>
-    <message>
-        <source>An error occurred while trying to clone the workspace.</source>
-        <translation>Une erreur s&apos;est produite lors du clonage de l&apos;espace de travail.</translation>
-    </message>
     <message>
         <source>The workspace for &lt;a href=&quot;%1&quot;&gt;%2&lt;/a&gt; is not a Git repository.</source>
         <translation>L&apos;espace de travail pour &lt;a href=&quot;%1&quot;&gt;%2&lt;/a&gt; n&apos;est pas un répertoire Git.</translation>
@@ -36,4 +28,23 @@
         <translation>Aucune information pour un fichier d&apos;exposition n&apos;a pu être trouvée pour &lt;a href=&quot;%1&quot;&gt;%2&lt;/a&gt;.</translation>
     </message>
 </context>
+<context>
+    <name>OpenCOR::PMRSupport::PmrWorkspaceCloner</name>
+    <message>
+        <source>Error %1: %2.</source>
+        <translation>Erreur %1 : %2.</translation>
+    </message>
+    <message>
+        <source>An error occurred while trying to clone the workspace.</source>
+        <translation>Une erreur s&apos;est produite lors du clonage de l&apos;espace de travail.</translation>
+    </message>
+    <message>
+        <source>The directory contains a clone of another workspace.</source>
+        <translation>Le répertoire contient un clone d&apos;un autre espace de travail.</translation>
+    </message>
+    <message>
+        <source>The clone of the workspace has local commits and cannot be updated.</source>
+        <translation>Le clone de l&apos;espace de travail a des commits locaux et ne peut pas être mis à jour.</translation>
+    </message>
+</context>
 </TS>
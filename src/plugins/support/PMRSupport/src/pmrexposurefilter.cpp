@@ -0,0 +1,240 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR exposure filter
+//==============================================================================
+
+#include "pmrexposurefilter.h"
+
+//==============================================================================
+
+#include <QRegularExpression>
+#include <QSet>
+
+//==============================================================================
+
+#include <algorithm>
+#include <iterator>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace PMRSupport {
+
+//==============================================================================
+
+PmrExposureFilter::PmrExposureFilter() :
+    mExposureNames(QStringList()),
+    mLowerCaseExposureNames(QStringList()),
+    mExposureTrigrams(QHash<QString, QIntList>()),
+    mExposureDisplayed(QBoolList()),
+    mFilter(QString()),
+    mLiteralFilter(false),
+    mNumberOfFilteredExposures(0),
+    mNumberOfCheckedExposures(0)
+{
+}
+
+//==============================================================================
+
+void PmrExposureFilter::setExposureNames(const QStringList &pExposureNames)
+{
+    // Keep track of the given exposure names, as well as of their lower-case
+    // version and of a trigram index of it, which we use to filter them
+    // Note: our exposures are all initially displayed...
+
+    mExposureNames = pExposureNames;
+
+    mLowerCaseExposureNames.clear();
+    mExposureTrigrams.clear();
+    mExposureDisplayed.clear();
+
+    for (int i = 0, iMax = mExposureNames.count(); i < iMax; ++i) {
+        QString lowerCaseExposureName = mExposureNames[i].toLower();
+
+        mLowerCaseExposureNames << lowerCaseExposureName;
+        mExposureDisplayed << true;
+
+        QSet<QString> trigrams = QSet<QString>();
+
+        for (int j = 0, jMax = lowerCaseExposureName.size()-2; j < jMax; ++j)
+            trigrams << lowerCaseExposureName.mid(j, 3);
+
+        foreach (const QString &trigram, trigrams)
+            mExposureTrigrams[trigram] << i;
+    }
+
+    mFilter = QString();
+    mLiteralFilter = false;
+
+    mNumberOfFilteredExposures = mExposureNames.count();
+    mNumberOfCheckedExposures = 0;
+}
+
+//==============================================================================
+
+static bool sortTrigramExposures(const QIntList *pExposures1,
+                                 const QIntList *pExposures2)
+{
+    // Determine which of the two lists of exposures is the shortest
+
+    return pExposures1->count() < pExposures2->count();
+}
+
+//==============================================================================
+
+QIntList PmrExposureFilter::trigramCandidates(const QString &pFilter) const
+{
+    // Retrieve the exposures that contain all the trigrams of the given
+    // (lower-case) filter, by intersecting the (sorted) lists of exposures of
+    // those trigrams, starting with the shortest one
+
+    QList<const QIntList *> trigramExposures = QList<const QIntList *>();
+
+    for (int i = 0, iMax = pFilter.size()-2; i < iMax; ++i) {
+        QHash<QString, QIntList>::ConstIterator iter = mExposureTrigrams.constFind(pFilter.mid(i, 3));
+
+        if (iter == mExposureTrigrams.constEnd())
+            return QIntList();
+
+        trigramExposures << &iter.value();
+    }
+
+    if (trigramExposures.isEmpty())
+        return QIntList();
+
+    std::sort(trigramExposures.begin(), trigramExposures.end(),
+              sortTrigramExposures);
+
+    QIntList res = *trigramExposures.first();
+
+    for (int i = 1, iMax = trigramExposures.count(); (i < iMax) && !res.isEmpty(); ++i) {
+        QIntList intersection = QIntList();
+
+        std::set_intersection(res.constBegin(), res.constEnd(),
+                              trigramExposures[i]->constBegin(), trigramExposures[i]->constEnd(),
+                              std::back_inserter(intersection));
+
+        res = intersection;
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+QBoolList PmrExposureFilter::filter(const QString &pFilter)
+{
+    // Determine which exposures match the given filter
+    // Note: a filter that doesn't contain any special character is matched
+    //       literally, which means that we can narrow down the exposures to
+    //       check using either the exposures that matched the previous filter,
+    //       if the given filter extends it, or our trigram index. We favour
+    //       the former unless the previous filter was too short to use our
+    //       trigram index while the given one isn't. Otherwise, the filter is a
+    //       regular expression that we check against all our exposures...
+
+    static const QRegularExpression SpecialCharactersRegEx = QRegularExpression("[\\\\^$.|?*+()\\[\\]{}]");
+
+    int nbOfExposures = mExposureNames.count();
+    QBoolList exposureDisplayed = QBoolList();
+
+    for (int i = 0; i < nbOfExposures; ++i)
+        exposureDisplayed << false;
+
+    mNumberOfFilteredExposures = 0;
+
+    if (pFilter.contains(SpecialCharactersRegEx)) {
+        QRegularExpression filterRegEx = QRegularExpression(pFilter, QRegularExpression::CaseInsensitiveOption);
+
+        for (int i = 0; i < nbOfExposures; ++i) {
+            if (mExposureNames[i].contains(filterRegEx)) {
+                exposureDisplayed[i] = true;
+
+                ++mNumberOfFilteredExposures;
+            }
+        }
+
+        mNumberOfCheckedExposures = nbOfExposures;
+
+        mFilter = QString();
+        mLiteralFilter = false;
+    } else {
+        QString filter = pFilter.toLower();
+        QIntList candidates = QIntList();
+
+        if (   mLiteralFilter && filter.contains(mFilter)
+            && ((mFilter.size() >= 3) || (filter.size() < 3))) {
+            for (int i = 0; i < nbOfExposures; ++i) {
+                if (mExposureDisplayed[i])
+                    candidates << i;
+            }
+        } else if (filter.size() >= 3) {
+            candidates = trigramCandidates(filter);
+        } else {
+            for (int i = 0; i < nbOfExposures; ++i)
+                candidates << i;
+        }
+
+        foreach (int candidate, candidates) {
+            if (mLowerCaseExposureNames[candidate].contains(filter)) {
+                exposureDisplayed[candidate] = true;
+
+                ++mNumberOfFilteredExposures;
+            }
+        }
+
+        mNumberOfCheckedExposures = candidates.count();
+
+        mFilter = filter;
+        mLiteralFilter = true;
+    }
+
+    mExposureDisplayed = exposureDisplayed;
+
+    return exposureDisplayed;
+}
+
+//==============================================================================
+
+int PmrExposureFilter::numberOfFilteredExposures() const
+{
+    // Return the number of exposures that matched our last filter
+
+    return mNumberOfFilteredExposures;
+}
+
+//==============================================================================
+
+int PmrExposureFilter::numberOfCheckedExposures() const
+{
+    // Return the number of exposures that we had to check against our last
+    // filter
+
+    return mNumberOfCheckedExposures;
+}
+
+//==============================================================================
+
+}   // namespace PMRSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
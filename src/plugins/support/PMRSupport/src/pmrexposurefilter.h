@@ -0,0 +1,76 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR exposure filter
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "corecliutils.h"
+#include "pmrsupportglobal.h"
+
+//==============================================================================
+
+#include <QHash>
+#include <QStringList>
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace PMRSupport {
+
+//==============================================================================
+
+class PMRSUPPORT_EXPORT PmrExposureFilter
+{
+public:
+    explicit PmrExposureFilter();
+
+    void setExposureNames(const QStringList &pExposureNames);
+
+    QBoolList filter(const QString &pFilter);
+
+    int numberOfFilteredExposures() const;
+    int numberOfCheckedExposures() const;
+
+    QIntList trigramCandidates(const QString &pFilter) const;
+
+private:
+    QStringList mExposureNames;
+    QStringList mLowerCaseExposureNames;
+    QHash<QString, QIntList> mExposureTrigrams;
+    QBoolList mExposureDisplayed;
+
+    QString mFilter;
+    bool mLiteralFilter;
+
+    int mNumberOfFilteredExposures;
+    int mNumberOfCheckedExposures;
+};
+
+//==============================================================================
+
+}   // namespace PMRSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
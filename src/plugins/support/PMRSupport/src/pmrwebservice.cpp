@@ -23,6 +23,7 @@ limitations under the License.
 #include "corecliutils.h"
 #include "coreguiutils.h"
 #include "pmrwebservice.h"
+#include "pmrworkspacecloner.h"
 
 //==============================================================================
 
@@ -30,16 +31,20 @@ limitations under the License.
 
 //==============================================================================
 
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMainWindow>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QStandardPaths>
 
 //==============================================================================
 
-#include "git2.h"
 #include "zlib.h"
 
 //==============================================================================
@@ -54,7 +59,11 @@ PmrWebService::PmrWebService() :
     mWorkspaces(QMap<QString, QString>()),
     mExposureUrls(QMap<QString, QString>()),
     mExposureNames(QMap<QString, QString>()),
-    mExposureFileNames(QMap<QString, QString>())
+    mExposureFileNames(QMap<QString, QString>()),
+    mExposuresListUrl(DefExposuresListUrl),
+    mExposuresListETag(QByteArray()),
+    mExposuresListLastModified(QByteArray()),
+    mCachedExposuresListUsed(false)
 {
     // Create a network access manager so that we can then retrieve various
     // things from the PMR
@@ -69,6 +78,11 @@ PmrWebService::PmrWebService() :
             this, SLOT(finished(QNetworkReply *)));
     connect(mNetworkAccessManager, SIGNAL(sslErrors(QNetworkReply *, const QList<QSslError> &)),
             this, SLOT(sslErrors(QNetworkReply *, const QList<QSslError> &)));
+
+    // Determine where we keep our list of exposures, so that it can be shown
+    // straightaway (and even when offline) the next time it is requested
+
+    mExposuresListFileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"PmrExposures.dat";
 }
 
 //==============================================================================
@@ -79,6 +93,17 @@ PmrWebService::~PmrWebService()
 
 //==============================================================================
 
+void PmrWebService::setExposuresListUrl(const QString &pExposuresListUrl)
+{
+    // Set the URL we use to retrieve the list of exposures
+    // Note: this is mainly so that we can test things against a stand-in
+    //       server...
+
+    mExposuresListUrl = pExposuresListUrl;
+}
+
+//==============================================================================
+
 static const char *PmrRequestProperty = "PmrRequest";
 static const char *ActionProperty     = "Action";
 static const char *NameProperty       = "Name";
@@ -105,7 +130,18 @@ void PmrWebService::sendPmrRequest(const PmrRequest &pPmrRequest,
 
         switch (pPmrRequest) {
         case ExposuresList:
-            networkRequest.setUrl(QUrl("https://models.physiomeproject.org/exposure"));
+            networkRequest.setUrl(QUrl(mExposuresListUrl));
+
+            // Only retrieve the list of exposures if it has changed since we
+            // last retrieved it
+
+            if (mCachedExposuresListUsed) {
+                if (!mExposuresListETag.isEmpty())
+                    networkRequest.setRawHeader("If-None-Match", mExposuresListETag);
+
+                if (!mExposuresListLastModified.isEmpty())
+                    networkRequest.setRawHeader("If-Modified-Since", mExposuresListLastModified);
+            }
 
             break;
         case ExposureInformation:
@@ -143,29 +179,20 @@ QString PmrWebService::informationNoteMessage() const
 void PmrWebService::doCloneWorkspace(const QString &pWorkspace,
                                      const QString &pDirName)
 {
-   // Clone the workspace
-
-   git_libgit2_init();
+    // Clone the workspace (or fetch what is new in it, if the directory
+    // already contains a clone of it) using a worker, so that we don't block
+    // the GUI thread while doing so
 
-   git_repository *gitRepository = 0;
-   QByteArray workspaceByteArray = pWorkspace.toUtf8();
-   QByteArray dirNameByteArray = pDirName.toUtf8();
-
-   int res = git_clone(&gitRepository, workspaceByteArray.constData(),
-                       dirNameByteArray.constData(), 0);
+    emit busy(true);
 
-   if (res) {
-       const git_error *gitError = giterr_last();
+    PmrWorkspaceCloner *workspaceCloner = new PmrWorkspaceCloner(pWorkspace, pDirName);
 
-       emit warning(gitError?
-                        tr("Error %1: %2.").arg(QString::number(gitError->klass),
-                                                Core::formatMessage(gitError->message)):
-                        tr("An error occurred while trying to clone the workspace."));
-   } else if (gitRepository) {
-       git_repository_free(gitRepository);
-   }
+    connect(workspaceCloner, SIGNAL(progress(const double &)),
+            this, SIGNAL(progress(const double &)));
+    connect(workspaceCloner, SIGNAL(done(const QString &)),
+            this, SLOT(workspaceCloned(const QString &)));
 
-   git_libgit2_shutdown();
+    workspaceCloner->start();
 }
 
 //==============================================================================
@@ -184,6 +211,134 @@ void PmrWebService::doShowExposureFiles(const QString &pExposureUrl)
 
 //==============================================================================
 
+static QByteArray uncompress(const QByteArray &pCompressedData)
+{
+    // Uncompress the given (gzip) data
+
+    QByteArray res = QByteArray();
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(z_stream));
+
+    if (inflateInit2(&stream, MAX_WBITS+16) == Z_OK) {
+        static const int BufferSize = 32768;
+
+        Bytef buffer[BufferSize];
+
+        stream.next_in = (Bytef *) pCompressedData.data();
+        stream.avail_in = pCompressedData.size();
+
+        do {
+            stream.next_out = buffer;
+            stream.avail_out = BufferSize;
+
+            inflate(&stream, Z_NO_FLUSH);
+
+            if (!stream.msg)
+                res += QByteArray::fromRawData((char *) buffer, BufferSize-stream.avail_out);
+            else
+                res = QByteArray();
+        } while (!stream.avail_out);
+
+        inflateEnd(&stream);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+void PmrWebService::exposures(const QVariantMap &pCollectionMap,
+                              PmrExposures &pExposures)
+{
+    // Retrieve the list of exposures from the given collection
+    // Note: we populate the given list of exposures rather than return one
+    //       since a copy of a list of exposures would end up with dangling
+    //       pointers once the original list has deleted its exposures...
+
+    foreach (const QVariant &linksVariant, pCollectionMap["links"].toList()) {
+        QVariantMap linksMap = linksVariant.toMap();
+
+        if (!linksMap["rel"].toString().compare("bookmark")) {
+            QString exposureUrl = linksMap["href"].toString().trimmed();
+            QString exposureName = linksMap["prompt"].toString().simplified();
+
+            if (   !exposureUrl.isEmpty()
+                && !exposureName.isEmpty()) {
+                mExposureNames.insert(exposureUrl, exposureName);
+
+                pExposures.add(exposureUrl, exposureName);
+            }
+        }
+    }
+
+    std::sort(pExposures.begin(), pExposures.end(), PmrExposure::compare);
+}
+
+//==============================================================================
+
+static const quint32 ExposuresListMagicNumber = 0x4f435045;   // i.e. "OCPE"
+static const quint32 ExposuresListVersion = 1;
+
+//==============================================================================
+
+bool PmrWebService::loadCachedExposuresList(QByteArray &pCompressedData)
+{
+    // Load our cached list of exposures, if any, along with what we need to
+    // check whether it has changed on the PMR
+
+    QFile file(mExposuresListFileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magicNumber;
+    quint32 version;
+    QByteArray eTag;
+    QByteArray lastModified;
+
+    stream >> magicNumber >> version;
+
+    if ((magicNumber != ExposuresListMagicNumber) || (version != ExposuresListVersion))
+        return false;
+
+    stream >> eTag >> lastModified >> pCompressedData;
+
+    if ((stream.status() != QDataStream::Ok) || pCompressedData.isEmpty())
+        return false;
+
+    mExposuresListETag = eTag;
+    mExposuresListLastModified = lastModified;
+
+    return true;
+}
+
+//==============================================================================
+
+void PmrWebService::saveCachedExposuresList(const QByteArray &pCompressedData,
+                                            const QByteArray &pETag,
+                                            const QByteArray &pLastModified) const
+{
+    // Keep track of the given list of exposures, along with what we need to
+    // check whether it has changed on the PMR
+
+    if (!QDir().mkpath(QFileInfo(mExposuresListFileName).absolutePath()))
+        return;
+
+    QFile file(mExposuresListFileName);
+
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+        return;
+
+    QDataStream stream(&file);
+
+    stream << ExposuresListMagicNumber << ExposuresListVersion
+           << pETag << pLastModified << pCompressedData;
+}
+
+//==============================================================================
+
 bool sortExposureFiles(const QString &pExposureFile1,
                        const QString &pExposureFile2)
 {
@@ -207,39 +362,18 @@ void PmrWebService::finished(QNetworkReply *pNetworkReply)
     QString workspaceUrl = QString();
     QStringList exposureFileUrls = QStringList();
     QString exposureUrl = QString();
+    bool exposuresListModified = false;
 
     if (pNetworkReply) {
-        if (pNetworkReply->error() == QNetworkReply::NoError) {
+        if (   (pmrRequest == ExposuresList)
+            && (pNetworkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)) {
+            // Our list of exposures hasn't changed, so nothing to do since we
+            // are already using it
+        } else if (pNetworkReply->error() == QNetworkReply::NoError) {
             // Retrieve and uncompress our JSON data
 
             QByteArray compressedData = pNetworkReply->readAll();
-            QByteArray uncompressedData = QByteArray();
-            z_stream stream;
-
-            memset(&stream, 0, sizeof(z_stream));
-
-            if (inflateInit2(&stream, MAX_WBITS+16) == Z_OK) {
-                static const int BufferSize = 32768;
-
-                Bytef buffer[BufferSize];
-
-                stream.next_in = (Bytef *) compressedData.data();
-                stream.avail_in = compressedData.size();
-
-                do {
-                    stream.next_out = buffer;
-                    stream.avail_out = BufferSize;
-
-                    inflate(&stream, Z_NO_FLUSH);
-
-                    if (!stream.msg)
-                        uncompressedData += QByteArray::fromRawData((char *) buffer, BufferSize-stream.avail_out);
-                    else
-                        uncompressedData = QByteArray();
-                } while (!stream.avail_out);
-
-                inflateEnd(&stream);
-            }
+            QByteArray uncompressedData = uncompress(compressedData);
 
             // Parse our uncompressed JSON data
 
@@ -255,26 +389,19 @@ void PmrWebService::finished(QNetworkReply *pNetworkReply)
 
                 switch (pmrRequest) {
                 case ExposuresList:
-                    // Retrieve the list of exposures
+                    // Retrieve the list of exposures and keep track of it,
+                    // along with what we need to check whether it has changed
+                    // the next time we retrieve it
 
-                    foreach (const QVariant &linksVariant, collectionMap["links"].toList()) {
-                        QVariantMap linksMap = linksVariant.toMap();
+                    mExposureNames.clear();
 
-                        if (!linksMap["rel"].toString().compare("bookmark")) {
-                            QString exposureUrl = linksMap["href"].toString().trimmed();
-                            QString exposureName = linksMap["prompt"].toString().simplified();
+                    this->exposures(collectionMap, exposures);
 
-                            if (   !exposureUrl.isEmpty()
-                                && !exposureName.isEmpty()) {
-                                mExposureNames.insert(exposureUrl, exposureName);
+                    exposuresListModified = true;
 
-                                exposures.add(exposureUrl, exposureName);
-                            }
-                        }
-                    }
-
-                    std::sort(exposures.begin(), exposures.end(),
-                              PmrExposure::compare);
+                    saveCachedExposuresList(compressedData,
+                                            pNetworkReply->rawHeader("ETag"),
+                                            pNetworkReply->rawHeader("Last-Modified"));
 
                     break;
                 case ExposureInformation:
@@ -450,9 +577,13 @@ void PmrWebService::finished(QNetworkReply *pNetworkReply)
 
     switch (pmrRequest) {
     case ExposuresList:
-        // Respond with a list of exposures
+        // Respond with a list of exposures, unless we have already responded
+        // with our cached list of exposures and we have nothing better to
+        // respond with (i.e. our list of exposures hasn't changed or we
+        // couldn't retrieve it)
 
-        emit exposuresList(exposures, errorMessage, internetConnectionAvailable);
+        if (!mCachedExposuresListUsed || exposuresListModified)
+            emit exposuresList(exposures, errorMessage, internetConnectionAvailable);
 
         break;
     case ExposureInformation:
@@ -503,6 +634,19 @@ void PmrWebService::sslErrors(QNetworkReply *pNetworkReply,
 
 //==============================================================================
 
+void PmrWebService::workspaceCloned(const QString &pErrorMessage)
+{
+    // Let the user know if something went wrong with the cloning of the
+    // workspace and show ourselves as not busy anymore
+
+    if (!pErrorMessage.isEmpty())
+        emit warning(pErrorMessage);
+
+    emit busy(false);
+}
+
+//==============================================================================
+
 void PmrWebService::requestExposuresList(void)
 {
     // Get the list of exposures from the PMR after making sure that our
@@ -513,6 +657,23 @@ void PmrWebService::requestExposuresList(void)
     mExposureNames.clear();
     mExposureFileNames.clear();
 
+    // Respond straightaway with our cached list of exposures, if any, and then
+    // check with the PMR whether it has changed
+
+    QByteArray compressedData;
+
+    mCachedExposuresListUsed = loadCachedExposuresList(compressedData);
+
+    if (mCachedExposuresListUsed) {
+        QJsonDocument jsonDocument = QJsonDocument::fromJson(uncompress(compressedData));
+        PmrExposures exposures = PmrExposures();
+
+        this->exposures(jsonDocument.object().toVariantMap()["collection"].toMap(),
+                        exposures);
+
+        emit exposuresList(exposures, QString(), true);
+    }
+
     sendPmrRequest(ExposuresList);
 }
 
@@ -525,11 +686,7 @@ void PmrWebService::cloneWorkspace(const QString &pUrl, const QString &pDirName)
     QString workspace = mWorkspaces.value(pUrl);
 
     if (!workspace.isEmpty()) {
-        emit busy(true);
-
         doCloneWorkspace(workspace, pDirName);
-
-        emit busy(false);
     } else {
         // To clone the workspace associated with the given exposure, we first
         // need to retrieve some information about the exposure itself
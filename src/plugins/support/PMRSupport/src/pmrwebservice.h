@@ -44,6 +44,10 @@ namespace PMRSupport {
 
 //==============================================================================
 
+static const auto DefExposuresListUrl = QStringLiteral("https://models.physiomeproject.org/exposure");
+
+//==============================================================================
+
 class PMRSUPPORT_EXPORT PmrWebService : public QObject
 {
     Q_OBJECT
@@ -52,6 +56,8 @@ public:
     explicit PmrWebService();
     ~PmrWebService();
 
+    void setExposuresListUrl(const QString &pExposuresListUrl);
+
     void cloneWorkspace(const QString &pUrl, const QString &pDirName);
     void requestExposuresList(void);
     void requestExposureFiles(const QString &pUrl);
@@ -79,8 +85,22 @@ private:
     QMap<QString, QString> mExposureNames;
     QMap<QString, QString> mExposureFileNames;
 
+    QString mExposuresListUrl;
+    QString mExposuresListFileName;
+    QByteArray mExposuresListETag;
+    QByteArray mExposuresListLastModified;
+    bool mCachedExposuresListUsed;
+
     QString informationNoteMessage() const;
 
+    void exposures(const QVariantMap &pCollectionMap,
+                   PmrExposures &pExposures);
+
+    bool loadCachedExposuresList(QByteArray &pCompressedData);
+    void saveCachedExposuresList(const QByteArray &pCompressedData,
+                                 const QByteArray &pETag,
+                                 const QByteArray &pLastModified) const;
+
     void doCloneWorkspace(const QString &pWorkspace, const QString &pDirName);
     void doShowExposureFiles(const QString &pExposureUrl);
 
@@ -91,6 +111,7 @@ private:
 
 Q_SIGNALS:
     void busy(const bool &pBusy);
+    void progress(const double &pProgress);
 
     void warning(const QString &pMessage);
     void information(const QString &pMessage);
@@ -108,6 +129,8 @@ private Q_SLOTS:
     void sslErrors(QNetworkReply *pNetworkReply,
                    const QList<QSslError> &pSslErrors);
 
+    void workspaceCloned(const QString &pErrorMessage);
+
 };
 
 //==============================================================================
@@ -0,0 +1,277 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR workspace cloner
+//==============================================================================
+
+#include "corecliutils.h"
+#include "pmrworkspacecloner.h"
+
+//==============================================================================
+
+#include <QThread>
+
+//==============================================================================
+
+#include "git2.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace PMRSupport {
+
+//==============================================================================
+
+static int transferProgressCallback(const git_transfer_progress *pStats,
+                                    void *pPayload)
+{
+    // Let our workspace cloner know about the progress of the transfer, which
+    // includes both the objects to receive and the deltas to resolve
+
+    static_cast<PmrWorkspaceCloner *>(pPayload)->transferProgress(pStats->received_objects+pStats->indexed_deltas,
+                                                                  pStats->total_objects+pStats->total_deltas);
+
+    return 0;
+}
+
+//==============================================================================
+
+PmrWorkspaceCloner::PmrWorkspaceCloner(const QString &pWorkspace,
+                                       const QString &pDirName) :
+    mWorkspace(pWorkspace),
+    mDirName(pDirName),
+    mProgress(-1)
+{
+    // Create our thread
+
+    mThread = new QThread();
+
+    // Move ourselves to our thread
+
+    moveToThread(mThread);
+
+    // Create a few connections
+
+    connect(mThread, SIGNAL(started()),
+            this, SLOT(started()));
+
+    connect(mThread, SIGNAL(finished()),
+            mThread, SLOT(deleteLater()));
+    connect(mThread, SIGNAL(finished()),
+            this, SLOT(deleteLater()));
+}
+
+//==============================================================================
+
+void PmrWorkspaceCloner::start()
+{
+    // Start the cloning
+
+    mThread->start();
+}
+
+//==============================================================================
+
+void PmrWorkspaceCloner::transferProgress(const unsigned int &pDone,
+                                          const unsigned int &pTotal)
+{
+    // Let people know about our progress, but only if it has changed by at
+    // least one percent
+    // Note: libgit2 calls us for every chunk of data it receives, so we would
+    //       otherwise flood the GUI thread with progress updates...
+
+    if (!pTotal)
+        return;
+
+    int newProgress = int(100ULL*pDone/pTotal);
+
+    if (newProgress != mProgress) {
+        mProgress = newProgress;
+
+        emit progress(0.01*newProgress);
+    }
+}
+
+//==============================================================================
+
+QString PmrWorkspaceCloner::gitErrorMessage() const
+{
+    // Return the last libgit2 error, if any
+
+    const git_error *gitError = giterr_last();
+
+    return gitError?
+               tr("Error %1: %2.").arg(QString::number(gitError->klass),
+                                       Core::formatMessage(gitError->message)):
+               tr("An error occurred while trying to clone the workspace.");
+}
+
+//==============================================================================
+
+QString PmrWorkspaceCloner::cloneWorkspace()
+{
+    // Clone the workspace, keeping track of the transfer progress
+
+    git_clone_options cloneOptions = GIT_CLONE_OPTIONS_INIT;
+
+    cloneOptions.fetch_opts.callbacks.transfer_progress = transferProgressCallback;
+    cloneOptions.fetch_opts.callbacks.payload = this;
+
+    git_repository *gitRepository = 0;
+    QByteArray workspaceByteArray = mWorkspace.toUtf8();
+    QByteArray dirNameByteArray = mDirName.toUtf8();
+
+    if (git_clone(&gitRepository, workspaceByteArray.constData(),
+                  dirNameByteArray.constData(), &cloneOptions)) {
+        return gitErrorMessage();
+    }
+
+    git_repository_free(gitRepository);
+
+    return QString();
+}
+
+//==============================================================================
+
+QString PmrWorkspaceCloner::fetchWorkspace(git_repository *pGitRepository)
+{
+    // Make sure that our existing clone is a clone of our workspace
+
+    git_remote *gitRemote = 0;
+
+    if (git_remote_lookup(&gitRemote, pGitRepository, "origin"))
+        return gitErrorMessage();
+
+    if (QString::fromUtf8(git_remote_url(gitRemote)) != mWorkspace) {
+        git_remote_free(gitRemote);
+
+        return tr("The directory contains a clone of another workspace.");
+    }
+
+    // Fetch whatever is new in the workspace, keeping track of the transfer
+    // progress
+
+    git_fetch_options fetchOptions = GIT_FETCH_OPTIONS_INIT;
+
+    fetchOptions.callbacks.transfer_progress = transferProgressCallback;
+    fetchOptions.callbacks.payload = this;
+
+    int res = git_remote_fetch(gitRemote, 0, &fetchOptions, 0);
+
+    git_remote_free(gitRemote);
+
+    if (res)
+        return gitErrorMessage();
+
+    // Retrieve our current branch and the commit it should now point to, i.e.
+    // the one of its upstream branch
+
+    git_reference *gitHead = 0;
+    git_reference *gitUpstream = 0;
+
+    if (   git_repository_head(&gitHead, pGitRepository)
+        || git_branch_upstream(&gitUpstream, gitHead)) {
+        git_reference_free(gitHead);
+
+        return gitErrorMessage();
+    }
+
+    const git_oid *gitUpstreamOid = git_reference_target(gitUpstream);
+    git_annotated_commit *gitUpstreamCommit = 0;
+    git_merge_analysis_t gitMergeAnalysis = GIT_MERGE_ANALYSIS_NONE;
+    git_merge_preference_t gitMergePreference = GIT_MERGE_PREFERENCE_NONE;
+
+    res =    git_annotated_commit_lookup(&gitUpstreamCommit, pGitRepository, gitUpstreamOid)
+          || git_merge_analysis(&gitMergeAnalysis, &gitMergePreference, pGitRepository,
+                                const_cast<const git_annotated_commit **>(&gitUpstreamCommit), 1);
+
+    git_annotated_commit_free(gitUpstreamCommit);
+
+    QString errorMessage = QString();
+
+    if (res) {
+        errorMessage = gitErrorMessage();
+    } else if (gitMergeAnalysis & GIT_MERGE_ANALYSIS_FASTFORWARD) {
+        // Our clone can be fast-forwarded, so check out the upstream commit
+        // and have our current branch point to it
+        // Note: we use a safe checkout, so that local changes are never
+        //       overwritten...
+
+        git_object *gitUpstreamObject = 0;
+        git_reference *gitNewHead = 0;
+        git_checkout_options checkoutOptions = GIT_CHECKOUT_OPTIONS_INIT;
+
+        checkoutOptions.checkout_strategy = GIT_CHECKOUT_SAFE;
+
+        if (   git_object_lookup(&gitUpstreamObject, pGitRepository, gitUpstreamOid, GIT_OBJ_COMMIT)
+            || git_checkout_tree(pGitRepository, gitUpstreamObject, &checkoutOptions)
+            || git_reference_set_target(&gitNewHead, gitHead, gitUpstreamOid, "pull: fast-forward")) {
+            errorMessage = gitErrorMessage();
+        }
+
+        git_reference_free(gitNewHead);
+        git_object_free(gitUpstreamObject);
+    } else if (!(gitMergeAnalysis & GIT_MERGE_ANALYSIS_UP_TO_DATE)) {
+        errorMessage = tr("The clone of the workspace has local commits and cannot be updated.");
+    }
+
+    git_reference_free(gitUpstream);
+    git_reference_free(gitHead);
+
+    return errorMessage;
+}
+
+//==============================================================================
+
+void PmrWorkspaceCloner::started()
+{
+    // Either fetch what is new in the workspace, if our directory already
+    // contains a clone of it, or clone it from scratch
+
+    git_libgit2_init();
+
+    git_repository *gitRepository = 0;
+    QByteArray dirNameByteArray = mDirName.toUtf8();
+    QString errorMessage = QString();
+
+    if (!git_repository_open(&gitRepository, dirNameByteArray.constData())) {
+        errorMessage = fetchWorkspace(gitRepository);
+
+        git_repository_free(gitRepository);
+    } else {
+        errorMessage = cloneWorkspace();
+    }
+
+    git_libgit2_shutdown();
+
+    // Let people know that we are done and stop our thread
+
+    emit done(errorMessage);
+
+    mThread->quit();
+}
+
+//==============================================================================
+
+}   // namespace PMRSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,89 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR workspace cloner
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "pmrsupportglobal.h"
+
+//==============================================================================
+
+#include <QObject>
+
+//==============================================================================
+
+class QThread;
+
+//==============================================================================
+
+struct git_repository;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace PMRSupport {
+
+//==============================================================================
+
+class PMRSUPPORT_EXPORT PmrWorkspaceCloner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PmrWorkspaceCloner(const QString &pWorkspace,
+                                const QString &pDirName);
+
+    void start();
+
+    void transferProgress(const unsigned int &pDone,
+                          const unsigned int &pTotal);
+
+private:
+    QThread *mThread;
+
+    QString mWorkspace;
+    QString mDirName;
+
+    int mProgress;
+
+    QString gitErrorMessage() const;
+
+    QString cloneWorkspace();
+    QString fetchWorkspace(git_repository *pGitRepository);
+
+Q_SIGNALS:
+    void progress(const double &pProgress);
+    void done(const QString &pErrorMessage);
+
+private Q_SLOTS:
+    void started();
+};
+
+//==============================================================================
+
+}   // namespace PMRSupport
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,587 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR support tests
+//==============================================================================
+
+#include "../../../../tests/src/testsutils.h"
+
+//==============================================================================
+
+#include "corecliutils.h"
+#include "pmrexposurefilter.h"
+#include "pmrwebservice.h"
+#include "pmrworkspacecloner.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <QTcpSocket>
+
+//==============================================================================
+
+#include "git2.h"
+#include "zlib.h"
+
+//==============================================================================
+
+static const auto FileName = QStringLiteral("file.txt");
+
+//==============================================================================
+
+static bool commitFile(git_repository *pGitRepository,
+                       const QByteArray &pContents, git_oid &pCommitOid)
+{
+    // Commit a new version of our file straight into the given (bare)
+    // repository, using its current HEAD, if any, as the parent commit
+
+    git_oid blobOid;
+    git_oid treeOid;
+    git_oid parentOid;
+    git_treebuilder *treeBuilder = 0;
+    git_tree *tree = 0;
+    git_commit *parent = 0;
+    git_signature *signature = 0;
+
+    bool res =    !git_blob_create_frombuffer(&blobOid, pGitRepository, pContents.constData(), pContents.size())
+               && !git_treebuilder_new(&treeBuilder, pGitRepository, 0)
+               && !git_treebuilder_insert(0, treeBuilder, FileName.toUtf8().constData(), &blobOid, GIT_FILEMODE_BLOB)
+               && !git_treebuilder_write(&treeOid, treeBuilder)
+               && !git_tree_lookup(&tree, pGitRepository, &treeOid)
+               && !git_signature_now(&signature, "OpenCOR", "team@opencor.ws");
+
+    if (res && !git_reference_name_to_id(&parentOid, pGitRepository, "HEAD"))
+        res = !git_commit_lookup(&parent, pGitRepository, &parentOid);
+
+    if (res) {
+        const git_commit *parents[] = { parent };
+
+        res = !git_commit_create(&pCommitOid, pGitRepository, "HEAD",
+                                 signature, signature, 0, pContents.constData(),
+                                 tree, parent?1:0, parents);
+    }
+
+    git_signature_free(signature);
+    git_commit_free(parent);
+    git_tree_free(tree);
+    git_treebuilder_free(treeBuilder);
+
+    return res;
+}
+
+//==============================================================================
+
+static QString cloneWorkspace(const QString &pWorkspace,
+                              const QString &pDirName)
+{
+    // Clone/fetch the given workspace and wait for it to be done
+    // Note: our workspace cloner emits done() from its own thread, hence we
+    //       quit our event loop through a queued connection rather than rely
+    //       on QSignalSpy::wait()...
+
+    OpenCOR::PMRSupport::PmrWorkspaceCloner *workspaceCloner = new OpenCOR::PMRSupport::PmrWorkspaceCloner(pWorkspace, pDirName);
+    QSignalSpy doneSpy(workspaceCloner, SIGNAL(done(const QString &)));
+    QEventLoop eventLoop;
+
+    QObject::connect(workspaceCloner, SIGNAL(done(const QString &)),
+                     &eventLoop, SLOT(quit()));
+
+    QTimer::singleShot(60000, &eventLoop, SLOT(quit()));
+
+    workspaceCloner->start();
+
+    eventLoop.exec();
+
+    if (doneSpy.isEmpty())
+        return "Timeout";
+
+    return doneSpy.first().first().toString();
+}
+
+//==============================================================================
+
+static bool headIs(const QString &pDirName, const git_oid &pCommitOid)
+{
+    // Check whether the HEAD of the given repository is the given commit
+
+    git_repository *gitRepository = 0;
+    git_oid headOid;
+    QByteArray dirNameByteArray = pDirName.toUtf8();
+
+    bool res =    !git_repository_open(&gitRepository, dirNameByteArray.constData())
+               && !git_reference_name_to_id(&headOid, gitRepository, "HEAD")
+               && !git_oid_cmp(&headOid, &pCommitOid);
+
+    git_repository_free(gitRepository);
+
+    return res;
+}
+
+//==============================================================================
+
+static QByteArray compress(const QByteArray &pData)
+{
+    // Compress the given data using gzip, as the PMR does
+
+    QByteArray res = QByteArray();
+    z_stream stream;
+
+    memset(&stream, 0, sizeof(z_stream));
+
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS+16,
+                     8, Z_DEFAULT_STRATEGY) == Z_OK) {
+        res.resize(deflateBound(&stream, pData.size()));
+
+        stream.next_in = (Bytef *) pData.data();
+        stream.avail_in = pData.size();
+        stream.next_out = (Bytef *) res.data();
+        stream.avail_out = res.size();
+
+        if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+            res.resize(res.size()-stream.avail_out);
+        else
+            res = QByteArray();
+
+        deflateEnd(&stream);
+    }
+
+    return res;
+}
+
+//==============================================================================
+
+PmrServer::PmrServer(QObject *pParent) :
+    QTcpServer(pParent),
+    mExposureNames(QStringList()),
+    mETag(QByteArray()),
+    mNumberOfRequests(0),
+    mNumberOfNotModifiedReplies(0)
+{
+    // Listen to local connections
+
+    connect(this, SIGNAL(newConnection()),
+            this, SLOT(acceptConnection()));
+
+    listen(QHostAddress::LocalHost);
+}
+
+//==============================================================================
+
+QString PmrServer::url() const
+{
+    // Return the URL to use to retrieve the list of exposures from our server
+
+    return QString("http://127.0.0.1:%1/exposure").arg(serverPort());
+}
+
+//==============================================================================
+
+void PmrServer::setExposureNames(const QStringList &pExposureNames,
+                                 const QByteArray &pETag)
+{
+    // Set the list of exposures that we serve and its ETag
+
+    mExposureNames = pExposureNames;
+    mETag = pETag;
+}
+
+//==============================================================================
+
+int PmrServer::numberOfRequests() const
+{
+    // Return the number of requests that we have received
+
+    return mNumberOfRequests;
+}
+
+//==============================================================================
+
+int PmrServer::numberOfNotModifiedReplies() const
+{
+    // Return the number of times that we have replied that our list of
+    // exposures hasn't changed
+
+    return mNumberOfNotModifiedReplies;
+}
+
+//==============================================================================
+
+void PmrServer::acceptConnection()
+{
+    // Reply to our new connection's request, once we have received it
+
+    while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+
+        connect(socket, SIGNAL(readyRead()),
+                this, SLOT(replyToRequest()));
+        connect(socket, SIGNAL(disconnected()),
+                socket, SLOT(deleteLater()));
+    }
+}
+
+//==============================================================================
+
+void PmrServer::replyToRequest()
+{
+    // Make sure that we have received the whole request, i.e. its request line
+    // and its headers
+
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray request = socket->peek(socket->bytesAvailable());
+
+    if (!request.contains("\r\n\r\n"))
+        return;
+
+    socket->readAll();
+
+    ++mNumberOfRequests;
+
+    // Retrieve the ETag, if any, of the list of exposures that we are asked
+    // about
+
+    QByteArray eTag = QByteArray();
+
+    foreach (const QByteArray &header, request.left(request.indexOf("\r\n\r\n")).split('\n')) {
+        if (header.toLower().startsWith("if-none-match:"))
+            eTag = header.mid(header.indexOf(':')+1).trimmed();
+    }
+
+    // Reply that our list of exposures hasn't changed, if it is the one we
+    // are asked about, or reply with it (compressed) otherwise
+
+    if (!eTag.isEmpty() && (eTag == mETag)) {
+        ++mNumberOfNotModifiedReplies;
+
+        socket->write("HTTP/1.1 304 Not Modified\r\n"
+                      "ETag: "+mETag+"\r\n"
+                      "Connection: close\r\n"
+                      "\r\n");
+    } else {
+        QStringList links = QStringList();
+
+        for (int i = 0, iMax = mExposureNames.count(); i < iMax; ++i) {
+            links << QString("{\"rel\": \"bookmark\", \"href\": \"%1/%2\", \"prompt\": \"%3\"}").arg(url())
+                                                                                                .arg(i+1)
+                                                                                                .arg(mExposureNames[i]);
+        }
+
+        QByteArray data = compress(QString("{\"collection\": {\"links\": [%1]}}").arg(links.join(", ")).toUtf8());
+
+        socket->write("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: application/vnd.physiome.pmr2.json.1\r\n"
+                      "Content-Length: "+QByteArray::number(data.size())+"\r\n"
+                      "ETag: "+mETag+"\r\n"
+                      "Connection: close\r\n"
+                      "\r\n"+data);
+    }
+
+    socket->disconnectFromHost();
+}
+
+//==============================================================================
+
+ExposuresListReceiver::ExposuresListReceiver(QObject *pParent) :
+    QObject(pParent),
+    mExposuresLists(QList<QStringList>())
+{
+}
+
+//==============================================================================
+
+QList<QStringList> ExposuresListReceiver::exposuresLists() const
+{
+    // Return the name of the exposures of the lists that we have received
+
+    return mExposuresLists;
+}
+
+//==============================================================================
+
+void ExposuresListReceiver::exposuresList(const OpenCOR::PMRSupport::PmrExposures &pExposures,
+                                          const QString &pErrorMessage,
+                                          const bool &pInternetConnectionAvailable)
+{
+    Q_UNUSED(pErrorMessage);
+    Q_UNUSED(pInternetConnectionAvailable);
+
+    // Keep track of the name of the exposures that we have received
+    // Note: we don't use foreach since it would copy our list of exposures,
+    //       which would then delete them upon being destroyed...
+
+    QStringList exposureNames = QStringList();
+
+    for (int i = 0, iMax = pExposures.count(); i < iMax; ++i)
+        exposureNames << pExposures[i]->name();
+
+    mExposuresLists << exposureNames;
+}
+
+//==============================================================================
+
+static QList<QStringList> requestExposuresList(const QString &pUrl)
+{
+    // Request the list of exposures from the given URL using a new web
+    // service, i.e. as if we had just started OpenCOR, and wait for it to be
+    // done with it, i.e. for it not to be busy anymore
+    // Note: our web service emits exposuresList() with a list of exposures
+    //       that it owns, hence we connect it to a receiver that keeps track of
+    //       their name rather than use a QSignalSpy...
+
+    OpenCOR::PMRSupport::PmrWebService webService;
+    ExposuresListReceiver receiver;
+    QSignalSpy busySpy(&webService, SIGNAL(busy(const bool &)));
+
+    QObject::connect(&webService, &OpenCOR::PMRSupport::PmrWebService::exposuresList,
+                     &receiver, &ExposuresListReceiver::exposuresList);
+
+    webService.setExposuresListUrl(pUrl);
+    webService.requestExposuresList();
+
+    while (busySpy.isEmpty() || busySpy.last().first().toBool()) {
+        if (!busySpy.wait(10000))
+            return QList<QStringList>() << (QStringList() << "Timeout");
+    }
+
+    return receiver.exposuresLists();
+}
+
+//==============================================================================
+
+void Tests::initTestCase()
+{
+    // Initialise libgit2
+
+    git_libgit2_init();
+
+    // Make sure that we don't use (and therefore mess up) the user's cached
+    // list of exposures
+
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+//==============================================================================
+
+void Tests::cleanupTestCase()
+{
+    // Shut down libgit2
+
+    git_libgit2_shutdown();
+}
+
+//==============================================================================
+
+void Tests::cloneTests()
+{
+    // Create a bare repository, which is to act as our workspace, and commit a
+    // first version of our file to it
+
+    QTemporaryDir temporaryDir;
+    QString workspace = temporaryDir.path()+"/workspace.git";
+    QString dirName = temporaryDir.path()+"/clone";
+    QByteArray workspaceByteArray = workspace.toUtf8();
+    git_repository *gitRepository = 0;
+    git_oid commitOid;
+
+    QVERIFY(!git_repository_init(&gitRepository, workspaceByteArray.constData(), 1));
+    QVERIFY(commitFile(gitRepository, "Version 1", commitOid));
+
+    // Clone our workspace and check that we have our first version of our file
+
+    QCOMPARE(cloneWorkspace(workspace, dirName), QString());
+    QCOMPARE(OpenCOR::rawFileContents(dirName+"/"+FileName), QByteArray("Version 1"));
+    QVERIFY(headIs(dirName, commitOid));
+
+    // Commit a second version of our file to our workspace and update our
+    // clone, which should only fetch what is new and fast-forward our clone
+
+    QVERIFY(commitFile(gitRepository, "Version 2", commitOid));
+
+    QCOMPARE(cloneWorkspace(workspace, dirName), QString());
+    QCOMPARE(OpenCOR::rawFileContents(dirName+"/"+FileName), QByteArray("Version 2"));
+    QVERIFY(headIs(dirName, commitOid));
+
+    // Updating an up-to-date clone should leave it as it is
+
+    QCOMPARE(cloneWorkspace(workspace, dirName), QString());
+    QVERIFY(headIs(dirName, commitOid));
+
+    // Our clone cannot be updated from another workspace
+
+    QVERIFY(!cloneWorkspace(temporaryDir.path()+"/another.git", dirName).isEmpty());
+
+    git_repository_free(gitRepository);
+}
+
+//==============================================================================
+
+void Tests::filterTests()
+{
+    // Index the name of some exposures
+
+    OpenCOR::PMRSupport::PmrExposureFilter exposureFilter;
+    QBoolList exposureDisplayed = QBoolList() << true << true << true << true << true;
+
+    exposureFilter.setExposureNames(QStringList() << "Hodgkin-Huxley squid axon 1952"
+                                                  << "Noble 1962 cardiac Purkinje fibres"
+                                                  << "van der Pol oscillator"
+                                                  << "Beeler-Reuter 1977 ventricular model"
+                                                  << "Noble 1998 guinea-pig ventricular model");
+
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 5);
+
+    // Our trigram index should give us the exposures that contain all the
+    // trigrams of a (lower-case) filter, and none if one of them is unknown or
+    // if the filter is too short to have any
+
+    QCOMPARE(exposureFilter.trigramCandidates("ventricular"), QIntList() << 3 << 4);
+    QCOMPARE(exposureFilter.trigramCandidates("noble 19"), QIntList() << 1 << 4);
+    QCOMPARE(exposureFilter.trigramCandidates("pol"), QIntList() << 2);
+    QCOMPARE(exposureFilter.trigramCandidates("nobel"), QIntList());
+    QCOMPARE(exposureFilter.trigramCandidates("no"), QIntList());
+
+    // An empty filter should match all our exposures, as should a filter that
+    // is too short to use our trigram index, albeit only those that contain it
+
+    QCOMPARE(exposureFilter.filter(QString()), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 5);
+
+    exposureDisplayed = QBoolList() << false << true << false << false << true;
+
+    QCOMPARE(exposureFilter.filter("No"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 2);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 5);
+
+    // A filter that is long enough to use our trigram index should only have
+    // its trigram candidates checked, and a filter that extends it only the
+    // exposures that matched it
+
+    QCOMPARE(exposureFilter.filter("Nob"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+
+    QCOMPARE(exposureFilter.filter("Noble 19"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+
+    exposureDisplayed = QBoolList() << false << false << false << false << true;
+
+    QCOMPARE(exposureFilter.filter("NOBLE 199"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 1);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+
+    QCOMPARE(exposureFilter.filter("noble 1998 g"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 1);
+
+    // A filter that doesn't extend the previous one should use our trigram
+    // index again, and no exposures need to be checked if one of its trigrams
+    // is unknown
+
+    exposureDisplayed = QBoolList() << false << false << false << true << true;
+
+    QCOMPARE(exposureFilter.filter("Ventricular"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 2);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+
+    exposureDisplayed = QBoolList() << false << false << false << false << false;
+
+    QCOMPARE(exposureFilter.filter("ventricular axon"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 0);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+
+    QCOMPARE(exposureFilter.filter("purkinje squid"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 0);
+
+    // A filter with special characters is a (case-insensitive) regular
+    // expression, which is checked against all our exposures, and the filter
+    // that follows it cannot be narrowed down using it
+
+    exposureDisplayed = QBoolList() << false << false << false << false << true;
+
+    QCOMPARE(exposureFilter.filter("^noble.*model$"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 1);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 5);
+
+    exposureDisplayed = QBoolList() << false << false << false << true << true;
+
+    QCOMPARE(exposureFilter.filter("model"), exposureDisplayed);
+    QCOMPARE(exposureFilter.numberOfFilteredExposures(), 2);
+    QCOMPARE(exposureFilter.numberOfCheckedExposures(), 2);
+}
+
+//==============================================================================
+
+void Tests::exposuresListCacheTests()
+{
+    // Our web service only sends requests if it thinks that an Internet
+    // connection is available, even to our stand-in server
+
+    if (!OpenCOR::Core::internetConnectionAvailable())
+        QSKIP("no Internet connection available");
+
+    // Start without any cached list of exposures
+
+    QFile::remove(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)+QDir::separator()+"PmrExposures.dat");
+
+    // Retrieve our list of exposures, which can only come from our server
+
+    PmrServer server;
+    QStringList exposureNames1 = QStringList() << "Hodgkin-Huxley squid axon 1952"
+                                               << "Noble 1962 cardiac Purkinje fibres";
+    QStringList exposureNames2 = QStringList() << exposureNames1
+                                               << "van der Pol oscillator";
+
+    server.setExposureNames(exposureNames1, "\"1\"");
+
+    QCOMPARE(requestExposuresList(server.url()), QList<QStringList>() << exposureNames1);
+    QCOMPARE(server.numberOfRequests(), 1);
+    QCOMPARE(server.numberOfNotModifiedReplies(), 0);
+
+    // Retrieve our list of exposures again, which should now come from our
+    // cache, with our server telling us that it hasn't changed
+
+    QCOMPARE(requestExposuresList(server.url()), QList<QStringList>() << exposureNames1);
+    QCOMPARE(server.numberOfRequests(), 2);
+    QCOMPARE(server.numberOfNotModifiedReplies(), 1);
+
+    // Update our list of exposures on our server and retrieve it, which should
+    // give us our cached list followed by the updated one
+
+    server.setExposureNames(exposureNames2, "\"2\"");
+
+    QCOMPARE(requestExposuresList(server.url()), QList<QStringList>() << exposureNames1 << exposureNames2);
+    QCOMPARE(server.numberOfRequests(), 3);
+    QCOMPARE(server.numberOfNotModifiedReplies(), 1);
+
+    // Our cache should now contain our updated list of exposures
+
+    QCOMPARE(requestExposuresList(server.url()), QList<QStringList>() << exposureNames2);
+    QCOMPARE(server.numberOfRequests(), 4);
+    QCOMPARE(server.numberOfNotModifiedReplies(), 2);
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================
@@ -0,0 +1,101 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// PMR support tests
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "pmrexposure.h"
+
+//==============================================================================
+
+#include <QObject>
+#include <QStringList>
+#include <QTcpServer>
+
+//==============================================================================
+
+class PmrServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit PmrServer(QObject *pParent = 0);
+
+    QString url() const;
+
+    void setExposureNames(const QStringList &pExposureNames,
+                          const QByteArray &pETag);
+
+    int numberOfRequests() const;
+    int numberOfNotModifiedReplies() const;
+
+private:
+    QStringList mExposureNames;
+    QByteArray mETag;
+
+    int mNumberOfRequests;
+    int mNumberOfNotModifiedReplies;
+
+private Q_SLOTS:
+    void acceptConnection();
+    void replyToRequest();
+};
+
+//==============================================================================
+
+class ExposuresListReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExposuresListReceiver(QObject *pParent = 0);
+
+    QList<QStringList> exposuresLists() const;
+
+public Q_SLOTS:
+    void exposuresList(const OpenCOR::PMRSupport::PmrExposures &pExposures,
+                       const QString &pErrorMessage,
+                       const bool &pInternetConnectionAvailable);
+
+private:
+    QList<QStringList> mExposuresLists;
+};
+
+//==============================================================================
+
+class Tests : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void cloneTests();
+    void filterTests();
+    void exposuresListCacheTests();
+};
+
+//==============================================================================
+// End of file
+//==============================================================================
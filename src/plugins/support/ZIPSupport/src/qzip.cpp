@@ -46,6 +46,8 @@
 
 //---OPENCOR--- BEGIN
 #include <QRegularExpression>
+
+#include <climits>
 //---OPENCOR--- END
 // Zip standard version for archives handled by this API
 // (actually, the only basic support of this version is implemented but it is enough for now)
@@ -87,6 +89,19 @@ static inline void writeUShort(uchar *data, ushort i)
     data[1] = (i>>8) & 0xff;
 }
 
+//---OPENCOR--- BEGIN
+static inline quint64 readULongLong(const uchar *data)
+{
+    return quint64(readUInt(data)) + (quint64(readUInt(data + 4)) << 32);
+}
+
+static inline void writeULongLong(uchar *data, quint64 i)
+{
+    writeUInt(data, uint(i & 0xffffffff));
+    writeUInt(data + 4, uint(i >> 32));
+}
+
+//---OPENCOR--- END
 static inline void copyUInt(uchar *dest, const uchar *src)
 {
     dest[0] = src[0];
@@ -191,6 +206,112 @@ static int deflate (Bytef *dest, ulong *destLen, const Bytef *source, ulong sour
     return err;
 }
 
+//---OPENCOR--- BEGIN
+// Size of the chunks in which we stream data in and out of an archive, so that
+// large entries never need to be held in memory in one go
+static const qint64 ChunkSize = 65536;
+
+static bool copyDevice(QIODevice *source, qint64 size, QIODevice *destination,
+                       uint *crc)
+{
+    QByteArray buffer(int(ChunkSize), 0);
+    if (crc)
+        *crc = ::crc32(0, 0, 0);
+    while (size > 0) {
+        const qint64 read = source->read(buffer.data(), qMin(ChunkSize, size));
+        if (read <= 0)
+            return false;
+        if (crc)
+            *crc = ::crc32(*crc, (const Bytef *)buffer.constData(), uInt(read));
+        if (destination->write(buffer.constData(), read) != read)
+            return false;
+        size -= read;
+    }
+    return true;
+}
+
+static bool inflateDevice(QIODevice *source, qint64 compressedSize,
+                          QIODevice *destination, uint *crc)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    QByteArray in(int(ChunkSize), 0);
+    QByteArray out(int(ChunkSize), 0);
+    int res = Z_OK;
+    *crc = ::crc32(0, 0, 0);
+    // note: we keep inflating once all our input has been read, since zlib may
+    //       still hold some output (e.g. the end of a match), and only give up
+    //       when it tells us that it cannot make any more progress
+    while (res != Z_STREAM_END) {
+        if (!stream.avail_in && compressedSize > 0) {
+            const qint64 read = source->read(in.data(), qMin(ChunkSize, compressedSize));
+            if (read <= 0)
+                break;
+            compressedSize -= read;
+            stream.next_in = (Bytef *)in.data();
+            stream.avail_in = uInt(read);
+        }
+        stream.next_out = (Bytef *)out.data();
+        stream.avail_out = uInt(ChunkSize);
+        res = ::inflate(&stream, Z_NO_FLUSH);
+        if (res != Z_OK && res != Z_STREAM_END)
+            break;
+        const qint64 produced = ChunkSize - stream.avail_out;
+        *crc = ::crc32(*crc, (const Bytef *)out.constData(), uInt(produced));
+        if (destination->write(out.constData(), produced) != produced) {
+            res = Z_ERRNO;
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return res == Z_STREAM_END;
+}
+
+static bool deflateDevice(QIODevice *source, QIODevice *destination, uint *crc,
+                          qint64 *uncompressedSize, qint64 *compressedSize)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    QByteArray in(int(ChunkSize), 0);
+    QByteArray out(int(ChunkSize), 0);
+    int flush = Z_NO_FLUSH;
+    int res = Z_OK;
+    *crc = ::crc32(0, 0, 0);
+    *uncompressedSize = 0;
+    *compressedSize = 0;
+    do {
+        const qint64 read = source->read(in.data(), ChunkSize);
+        if (read < 0)
+            break;
+        *crc = ::crc32(*crc, (const Bytef *)in.constData(), uInt(read));
+        *uncompressedSize += read;
+        flush = (read < ChunkSize || source->atEnd()) ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = (Bytef *)in.data();
+        stream.avail_in = uInt(read);
+        do {
+            stream.next_out = (Bytef *)out.data();
+            stream.avail_out = uInt(ChunkSize);
+            res = ::deflate(&stream, flush);
+            if (res == Z_STREAM_ERROR)
+                break;
+            const qint64 produced = ChunkSize - stream.avail_out;
+            if (destination->write(out.constData(), produced) != produced) {
+                res = Z_ERRNO;
+                break;
+            }
+            *compressedSize += produced;
+        } while (!stream.avail_out);
+    } while (flush != Z_FINISH && res != Z_STREAM_ERROR && res != Z_ERRNO);
+    deflateEnd(&stream);
+    return res == Z_STREAM_END;
+}
+//---OPENCOR--- END
 
 namespace WindowsFileAttributes {
 enum {
@@ -472,12 +593,49 @@ namespace OpenCOR {
 namespace ZIPSupport {
 //---OPENCOR--- END
 
+//---OPENCOR--- BEGIN
+// ZIP64 structures, see section 4.3.14 and 4.3.15 of APPNOTE.TXT
+struct Zip64EndOfDirectory
+{
+    uchar signature[4]; // 0x06064b50
+    uchar record_size[8];
+    uchar version_made[2];
+    uchar version_needed[2];
+    uchar this_disk[4];
+    uchar start_of_directory_disk[4];
+    uchar num_dir_entries_this_disk[8];
+    uchar num_dir_entries[8];
+    uchar directory_size[8];
+    uchar dir_start_offset[8];
+};
+
+struct Zip64EndOfDirectoryLocator
+{
+    uchar signature[4]; // 0x07064b50
+    uchar start_of_directory_disk[4];
+    uchar zip64_eod_offset[8];
+    uchar num_disks[4];
+};
+
+// ZIP specification version needed for ZIP64 extensions
+#define ZIP64_VERSION 45
+
+// ZIP64 extended information extra field header ID
+#define ZIP64_EXTRA_FIELD_ID 0x0001
+
+//---OPENCOR--- END
 struct FileHeader
 {
     CentralFileHeader h;
     QByteArray file_name;
     QByteArray extra_field;
     QByteArray file_comment;
+//---OPENCOR--- BEGIN
+    // Actual sizes and offset, which may come from a ZIP64 extra field
+    quint64 compressed_size64;
+    quint64 uncompressed_size64;
+    quint64 offset_local_header64;
+//---OPENCOR--- END
 };
 /*---OPENCOR---
 Q_DECLARE_TYPEINFO(FileHeader, Q_MOVABLE_TYPE);
@@ -511,7 +669,12 @@ public:
     bool dirtyFileTree;
     QVector<FileHeader> fileHeaders;
     QByteArray comment;
+/*---OPENCOR---
     uint start_of_directory;
+*/
+//---OPENCOR--- BEGIN
+    qint64 start_of_directory;
+//---OPENCOR--- END
 };
 
 QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
@@ -568,7 +731,12 @@ QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
     const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
     fileInfo.filePath = inUtf8 ? QString::fromUtf8(header.file_name) : QString::fromLocal8Bit(header.file_name);
     fileInfo.crc = readUInt(header.h.crc_32);
+/*---OPENCOR---
     fileInfo.size = readUInt(header.h.uncompressed_size);
+*/
+//---OPENCOR--- BEGIN
+    fileInfo.size = header.uncompressed_size64;
+//---OPENCOR--- END
     fileInfo.lastModified = readMSDosDate(header.h.last_mod_file);
 
     // fix the file path, if broken (convert separators, eat leading and trailing ones)
@@ -590,6 +758,13 @@ public:
     }
 
     void scanFiles();
+//---OPENCOR--- BEGIN
+    int fileHeaderIndex(const QString &fileName);
+    qint64 dataOffset(const FileHeader &header, int &compressionMethod);
+
+    QHash<QString, int> fileHeaderIndexes;
+    QList<uchar *> mappedData;
+//---OPENCOR--- END
 
     QZipReader::Status status;
 };
@@ -612,6 +787,10 @@ public:
     enum EntryType { Directory, File, Symlink };
 
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+//---OPENCOR--- BEGIN
+    void addCompressedEntry(const QString &fileName, QIODevice *compressedData,
+                            qint64 compressedSize, uint crc, qint64 uncompressedSize);
+//---OPENCOR--- END
 };
 
 LocalFileHeader CentralFileHeader::toLocalHeader() const
@@ -630,6 +809,110 @@ LocalFileHeader CentralFileHeader::toLocalHeader() const
     return h;
 }
 
+//---OPENCOR--- BEGIN
+static void readZip64ExtraField(FileHeader &header)
+{
+    // Retrieve our sizes and offset, using the ZIP64 extended information extra
+    // field for those that don't fit in their 32-bit field
+    header.uncompressed_size64 = readUInt(header.h.uncompressed_size);
+    header.compressed_size64 = readUInt(header.h.compressed_size);
+    header.offset_local_header64 = readUInt(header.h.offset_local_header);
+
+    const uchar *extra = (const uchar *)header.extra_field.constData();
+    int remaining = header.extra_field.size();
+    while (remaining >= 4) {
+        const ushort id = readUShort(extra);
+        int size = readUShort(extra + 2);
+        extra += 4;
+        remaining -= 4;
+        if (size > remaining)
+            break;
+        if (id == ZIP64_EXTRA_FIELD_ID) {
+            if (header.uncompressed_size64 == 0xffffffff && size >= 8) {
+                header.uncompressed_size64 = readULongLong(extra);
+                extra += 8;
+                size -= 8;
+            }
+            if (header.compressed_size64 == 0xffffffff && size >= 8) {
+                header.compressed_size64 = readULongLong(extra);
+                extra += 8;
+                size -= 8;
+            }
+            if (header.offset_local_header64 == 0xffffffff && size >= 8)
+                header.offset_local_header64 = readULongLong(extra);
+            break;
+        }
+        extra += size;
+        remaining -= size;
+    }
+}
+
+static void writeZip64ExtraField(FileHeader &header, quint64 uncompressedSize,
+                                 quint64 compressedSize, quint64 offset)
+{
+    // Set our sizes and offset, using a ZIP64 extended information extra field
+    // for those that don't fit in their 32-bit field
+    header.uncompressed_size64 = uncompressedSize;
+    header.compressed_size64 = compressedSize;
+    header.offset_local_header64 = offset;
+
+    QByteArray data;
+    uchar value[8];
+    if (uncompressedSize >= 0xffffffff || compressedSize >= 0xffffffff) {
+        // Note: if either size needs ZIP64, then both sizes are stored since
+        //       this is what the local header requires...
+        writeUInt(header.h.uncompressed_size, 0xffffffff);
+        writeUInt(header.h.compressed_size, 0xffffffff);
+        writeULongLong(value, uncompressedSize);
+        data.append((const char *)value, 8);
+        writeULongLong(value, compressedSize);
+        data.append((const char *)value, 8);
+    } else {
+        writeUInt(header.h.uncompressed_size, uint(uncompressedSize));
+        writeUInt(header.h.compressed_size, uint(compressedSize));
+    }
+    if (offset >= 0xffffffff) {
+        writeUInt(header.h.offset_local_header, 0xffffffff);
+        writeULongLong(value, offset);
+        data.append((const char *)value, 8);
+    } else {
+        writeUInt(header.h.offset_local_header, uint(offset));
+    }
+
+    header.extra_field.clear();
+    if (!data.isEmpty()) {
+        writeUShort(value, ZIP64_EXTRA_FIELD_ID);
+        writeUShort(value + 2, data.size());
+        header.extra_field.append((const char *)value, 4);
+        header.extra_field.append(data);
+        writeUShort(header.h.version_needed, ZIP64_VERSION);
+    }
+    writeUShort(header.h.extra_field_length, header.extra_field.size());
+}
+
+static void writeLocalFileHeader(QIODevice *device, const FileHeader &header)
+{
+    // Write the local header of the given file, which only needs a ZIP64 extra
+    // field (with both sizes) if its sizes don't fit in their 32-bit field
+    LocalFileHeader h = header.h.toLocalHeader();
+    QByteArray extra_field;
+    if (readUInt(header.h.uncompressed_size) == 0xffffffff) {
+        uchar value[8];
+        writeUShort(value, ZIP64_EXTRA_FIELD_ID);
+        writeUShort(value + 2, 16);
+        extra_field.append((const char *)value, 4);
+        writeULongLong(value, header.uncompressed_size64);
+        extra_field.append((const char *)value, 8);
+        writeULongLong(value, header.compressed_size64);
+        extra_field.append((const char *)value, 8);
+    }
+    writeUShort(h.extra_field_length, extra_field.size());
+    device->write((const char *)&h, sizeof(LocalFileHeader));
+    device->write(header.file_name);
+    device->write(extra_field);
+}
+//---OPENCOR--- END
+
 void QZipReaderPrivate::scanFiles()
 {
     if (!dirtyFileTree)
@@ -657,11 +940,23 @@ void QZipReaderPrivate::scanFiles()
 
     // find EndOfDirectory header
     int i = 0;
+/*---OPENCOR---
     int start_of_directory = -1;
     int num_dir_entries = 0;
+*/
+//---OPENCOR--- BEGIN
+    qint64 start_of_directory = -1;
+    qint64 num_dir_entries = 0;
+    qint64 pos = -1;
+//---OPENCOR--- END
     EndOfDirectory eod;
     while (start_of_directory == -1) {
+/*---OPENCOR---
         const int pos = device->size() - int(sizeof(EndOfDirectory)) - i;
+*/
+//---OPENCOR--- BEGIN
+        pos = device->size() - qint64(sizeof(EndOfDirectory)) - i;
+//---OPENCOR--- END
         if (pos < 0 || i > 65535) {
 /*---OPENCOR---
             qWarning() << "QZip: EndOfDirectory not found";
@@ -679,7 +974,12 @@ void QZipReaderPrivate::scanFiles()
     // have the eod
     start_of_directory = readUInt(eod.dir_start_offset);
     num_dir_entries = readUShort(eod.num_dir_entries);
+/*---OPENCOR---
     ZDEBUG("start_of_directory at %d, num_dir_entries=%d", start_of_directory, num_dir_entries);
+*/
+//---OPENCOR--- BEGIN
+    ZDEBUG("start_of_directory at %lld, num_dir_entries=%lld", start_of_directory, num_dir_entries);
+//---OPENCOR--- END
     int comment_length = readUShort(eod.comment_length);
 /*---OPENCOR---
     if (comment_length != i)
@@ -687,6 +987,25 @@ void QZipReaderPrivate::scanFiles()
 */
     comment = device->read(qMin(comment_length, i));
 
+//---OPENCOR--- BEGIN
+    // check for a ZIP64 end of directory record, which locator is right before
+    // the end of directory record
+    if (   (num_dir_entries == 0xffff || start_of_directory == 0xffffffff)
+        && pos >= qint64(sizeof(Zip64EndOfDirectoryLocator))) {
+        Zip64EndOfDirectoryLocator locator;
+        device->seek(pos - sizeof(Zip64EndOfDirectoryLocator));
+        if (   device->read((char *)&locator, sizeof(Zip64EndOfDirectoryLocator)) == sizeof(Zip64EndOfDirectoryLocator)
+            && readUInt(locator.signature) == 0x07064b50) {
+            Zip64EndOfDirectory eod64;
+            device->seek(readULongLong(locator.zip64_eod_offset));
+            if (   device->read((char *)&eod64, sizeof(Zip64EndOfDirectory)) == sizeof(Zip64EndOfDirectory)
+                && readUInt(eod64.signature) == 0x06064b50) {
+                start_of_directory = readULongLong(eod64.dir_start_offset);
+                num_dir_entries = readULongLong(eod64.num_dir_entries);
+            }
+        }
+    }
+//---OPENCOR--- END
 
     device->seek(start_of_directory);
     for (i = 0; i < num_dir_entries; ++i) {
@@ -731,6 +1050,9 @@ void QZipReaderPrivate::scanFiles()
         }
 
         ZDEBUG("found file '%s'", header.file_name.data());
+//---OPENCOR--- BEGIN
+        readZip64ExtraField(header);
+//---OPENCOR--- END
         fileHeaders.append(header);
     }
 }
@@ -841,19 +1163,249 @@ void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
         break;
     }
     writeUInt(header.h.external_file_attributes, mode << 16);
+/*---OPENCOR---
     writeUInt(header.h.offset_local_header, start_of_directory);
+*/
+//---OPENCOR--- BEGIN
+    writeZip64ExtraField(header, contents.length(), data.length(), start_of_directory);
+//---OPENCOR--- END
 
 
     fileHeaders.append(header);
 
+/*---OPENCOR---
     LocalFileHeader h = header.h.toLocalHeader();
     device->write((const char *)&h, sizeof(LocalFileHeader));
     device->write(header.file_name);
+*/
+//---OPENCOR--- BEGIN
+    writeLocalFileHeader(device, header);
+//---OPENCOR--- END
     device->write(data);
     start_of_directory = device->pos();
     dirtyFileTree = true;
 }
 
+//---OPENCOR--- BEGIN
+void QZipWriterPrivate::addCompressedEntry(const QString &fileName, QIODevice *compressedData,
+                                           qint64 compressedSize, uint crc, qint64 uncompressedSize)
+{
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = QZipWriter::FileOpenError;
+        return;
+    }
+    device->seek(start_of_directory);
+
+    FileHeader header;
+    memset(&header.h, 0, sizeof(CentralFileHeader));
+    writeUInt(header.h.signature, 0x02014b50);
+
+    writeUShort(header.h.version_needed, ZIP_VERSION);
+    writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
+    writeUShort(header.h.compression_method, CompressionMethodDeflated);
+    writeUInt(header.h.crc_32, crc);
+    writeUShort(header.h.general_purpose_bits, Utf8Names);
+
+    header.file_name = fileName.toUtf8().left(0xffff);
+    writeUShort(header.h.file_name_length, header.file_name.length());
+    writeUShort(header.h.version_made, HostUnix << 8);
+    writeUInt(header.h.external_file_attributes, (permissionsToMode(permissions) | UnixFileAttributes::File) << 16);
+    writeZip64ExtraField(header, uncompressedSize, compressedSize, start_of_directory);
+
+    fileHeaders.append(header);
+
+    writeLocalFileHeader(device, header);
+    if (!copyDevice(compressedData, compressedSize, device, 0))
+        status = QZipWriter::FileWriteError;
+    start_of_directory = device->pos();
+    dirtyFileTree = true;
+}
+//---OPENCOR--- END
+
+//---OPENCOR--- BEGIN
+int QZipReaderPrivate::fileHeaderIndex(const QString &fileName)
+{
+    // Look up the given file in an index of our file headers, which we build
+    // the first time around, rather than searching them every time
+    scanFiles();
+    if (fileHeaderIndexes.isEmpty()) {
+        for (int i = fileHeaders.size() - 1; i >= 0; --i)
+            fileHeaderIndexes.insert(fillFileInfo(i).filePath, i);
+    }
+    return fileHeaderIndexes.value(fileName, -1);
+}
+
+static qint64 localDataOffset(QIODevice *device, qint64 localHeaderOffset, int &compressionMethod)
+{
+    // Position the device at the start of the data that follows the local
+    // file header at the given offset and return that position, or -1 if the
+    // local file header cannot be read
+    LocalFileHeader lh;
+    if (   !device->seek(localHeaderOffset)
+        || device->read((char *)&lh, sizeof(LocalFileHeader)) != sizeof(LocalFileHeader)
+        || readUInt(lh.signature) != 0x04034b50) {
+        return -1;
+    }
+
+    compressionMethod = readUShort(lh.compression_method);
+    const qint64 offset = device->pos() + readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
+    if (!device->seek(offset))
+        return -1;
+    return offset;
+}
+
+static bool isReadableEntry(const FileHeader &header)
+{
+    return    readUShort(header.h.version_needed) <= ZIP64_VERSION
+           && (readUShort(header.h.general_purpose_bits) & Encrypted) == 0;
+}
+
+static bool extractData(QIODevice *device, int compressionMethod, qint64 compressedSize,
+                        qint64 uncompressedSize, uint crc, const QString &destinationFileName)
+{
+    // Extract the data at the current position of the device to the given
+    // file, and check its CRC
+    QFile f(destinationFileName);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+
+    uint crc_32;
+    bool res;
+    if (compressionMethod == CompressionMethodStored)
+        res = copyDevice(device, uncompressedSize, &f, &crc_32);
+    else if (compressionMethod == CompressionMethodDeflated)
+        res = inflateDevice(device, compressedSize, &f, &crc_32);
+    else
+        res = false;
+    f.close();
+
+    if (!res || crc_32 != crc) {
+        f.remove();
+        return false;
+    }
+    return true;
+}
+
+qint64 QZipReaderPrivate::dataOffset(const FileHeader &header, int &compressionMethod)
+{
+    // Position our device at the start of the data of the given file and
+    // return that position, or -1 if its data cannot be read
+    if (!isReadableEntry(header))
+        return -1;
+
+    return localDataOffset(device, header.offset_local_header64, compressionMethod);
+}
+
+class QZipEntryDevice : public QIODevice
+{
+public:
+    QZipEntryDevice(QIODevice *archive, qint64 offset, qint64 compressedSize,
+                    qint64 uncompressedSize, bool deflated)
+        : archive(archive), offset(offset), compressedLeft(compressedSize),
+          uncompressedSize(uncompressedSize), deflated(deflated), finished(false)
+    {
+        memset(&stream, 0, sizeof(z_stream));
+        if (deflated && inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            finished = true;
+        else
+            in.resize(int(ChunkSize));
+        open(QIODevice::ReadOnly);
+    }
+
+    ~QZipEntryDevice()
+    {
+        if (deflated)
+            inflateEnd(&stream);
+    }
+
+    bool isSequential() const Q_DECL_OVERRIDE
+    {
+        return true;
+    }
+
+    qint64 size() const Q_DECL_OVERRIDE
+    {
+        return uncompressedSize;
+    }
+
+    bool atEnd() const Q_DECL_OVERRIDE
+    {
+        return (finished || (!deflated && !compressedLeft)) && QIODevice::atEnd();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        // note: we always seek our archive before reading from it, since it
+        //       may be shared with other devices and with the zip reader
+        if (!deflated) {
+            const qint64 size = qMin(maxSize, compressedLeft);
+            if (!size)
+                return -1;
+            if (!archive->seek(offset))
+                return -1;
+            const qint64 read = archive->read(data, size);
+            if (read <= 0)
+                return -1;
+            offset += read;
+            compressedLeft -= read;
+            return read;
+        }
+
+        if (finished)
+            return -1;
+        stream.next_out = (Bytef *)data;
+        stream.avail_out = uInt(qMin(maxSize, qint64(UINT_MAX)));
+        const uInt avail_out = stream.avail_out;
+        // note: like in inflateDevice(), we keep inflating once all of our
+        //       input has been read, until zlib tells us that it is done or
+        //       that it cannot make any more progress
+        while (stream.avail_out && !finished) {
+            if (!stream.avail_in && compressedLeft) {
+                const qint64 size = qMin(ChunkSize, compressedLeft);
+                if (!archive->seek(offset))
+                    break;
+                const qint64 read = archive->read(in.data(), size);
+                if (read <= 0)
+                    break;
+                offset += read;
+                compressedLeft -= read;
+                stream.next_in = (Bytef *)in.data();
+                stream.avail_in = uInt(read);
+            }
+            const int res = ::inflate(&stream, Z_NO_FLUSH);
+            if (res == Z_STREAM_END)
+                finished = true;
+            else if (res != Z_OK)
+                break;
+        }
+        const qint64 produced = avail_out - stream.avail_out;
+        if (!produced) {
+            finished = true;
+            return -1;
+        }
+        return produced;
+    }
+
+    qint64 writeData(const char *data, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+private:
+    QIODevice *archive;
+    qint64 offset;
+    qint64 compressedLeft;
+    qint64 uncompressedSize;
+    bool deflated;
+    bool finished;
+    z_stream stream;
+    QByteArray in;
+};
+//---OPENCOR--- END
+
 //////////////////////////////  Reader
 
 /*!
@@ -1042,7 +1594,12 @@ QByteArray QZipReader::fileData(const QString &fileName) const
     FileHeader header = d->fileHeaders.at(i);
 
     ushort version_needed = readUShort(header.h.version_needed);
+/*---OPENCOR---
     if (version_needed > ZIP_VERSION) {
+*/
+//---OPENCOR--- BEGIN
+    if (version_needed > ZIP64_VERSION) {
+//---OPENCOR--- END
 /*---OPENCOR---
         qWarning("QZip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
 */
@@ -1050,9 +1607,20 @@ QByteArray QZipReader::fileData(const QString &fileName) const
     }
 
     ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
+/*---OPENCOR---
     int compressed_size = readUInt(header.h.compressed_size);
     int uncompressed_size = readUInt(header.h.uncompressed_size);
     int start = readUInt(header.h.offset_local_header);
+*/
+//---OPENCOR--- BEGIN
+    // a QByteArray cannot hold more than 2 GB, so use extractFile() or
+    // openFile() for bigger entries
+    if (header.compressed_size64 > INT_MAX || header.uncompressed_size64 > INT_MAX)
+        return QByteArray();
+    int compressed_size = int(header.compressed_size64);
+    int uncompressed_size = int(header.uncompressed_size64);
+    qint64 start = header.offset_local_header64;
+//---OPENCOR--- END
     //qDebug("uncompressing file %d: local header at %d", i, start);
 
     d->device->seek(start);
@@ -1189,6 +1757,150 @@ bool QZipReader::extractAll(const QString &destinationDir) const
     return true;
 }
 
+//---OPENCOR--- BEGIN
+/*!
+    Extracts the file \a fileName, as listed by fileInfoList(), from the zip
+    archive to \a destinationFileName on the local filesystem, streaming its
+    contents in chunks rather than holding them in memory, and checking their
+    CRC.
+*/
+bool QZipReader::extractFile(const QString &fileName, const QString &destinationFileName) const
+{
+    const int i = d->fileHeaderIndex(fileName);
+    if (i == -1)
+        return false;
+
+    const FileHeader &header = d->fileHeaders.at(i);
+    int compression_method;
+    if (d->dataOffset(header, compression_method) == -1)
+        return false;
+
+    return extractData(d->device, compression_method, header.compressed_size64,
+                       header.uncompressed_size64, readUInt(header.h.crc_32),
+                       destinationFileName);
+}
+
+/*!
+    Returns the location of the data of each file, as listed by fileInfoList(),
+    in the zip archive, keyed by the file's path. Files whose data cannot be
+    read (e.g. encrypted files) get an invalid location.
+    This allows several files to be extracted using extractFile() with a
+    location, possibly in parallel, without each of them having to scan the
+    central directory of the zip archive again.
+*/
+QHash<QString, QZipReader::EntryLocation> QZipReader::entryLocations() const
+{
+    d->scanFiles();
+    QHash<QString, EntryLocation> res;
+    for (int i = d->fileHeaders.size() - 1; i >= 0; --i) {
+        const FileInfo fileInfo = d->fillFileInfo(i);
+        if (!fileInfo.isFile)
+            continue;
+
+        const FileHeader &header = d->fileHeaders.at(i);
+        EntryLocation entryLocation;
+        if (isReadableEntry(header)) {
+            entryLocation.offset = header.offset_local_header64;
+            entryLocation.compressedSize = header.compressed_size64;
+            entryLocation.uncompressedSize = header.uncompressed_size64;
+            entryLocation.crc = readUInt(header.h.crc_32);
+        }
+        res.insert(fileInfo.filePath, entryLocation);
+    }
+    return res;
+}
+
+/*!
+    Extracts the file at \a entryLocation, as returned by entryLocations(), from
+    the zip archive \a zipFileName to \a destinationFileName on the local
+    filesystem, streaming its contents in chunks and checking their CRC.
+    The zip archive is opened for the duration of the extraction, so several
+    files can be extracted from it in parallel.
+*/
+bool QZipReader::extractFile(const QString &zipFileName, const EntryLocation &entryLocation,
+                             const QString &destinationFileName)
+{
+    if (!entryLocation.isValid())
+        return false;
+
+    QFile zipFile(zipFileName);
+    if (!zipFile.open(QIODevice::ReadOnly))
+        return false;
+
+    int compression_method;
+    if (localDataOffset(&zipFile, entryLocation.offset, compression_method) == -1)
+        return false;
+
+    return extractData(&zipFile, compression_method, entryLocation.compressedSize,
+                       entryLocation.uncompressedSize, entryLocation.crc,
+                       destinationFileName);
+}
+
+/*!
+    Returns a read-only view of the contents of the file \a fileName, as listed
+    by fileInfoList(), and sets \a size to its size. The view is a memory
+    mapping of the zip archive itself, so no data gets copied, and it remains
+    valid until the archive is closed.
+    Returns 0 if the file is not stored (i.e. it is compressed) or if the zip
+    archive is not a file.
+*/
+const uchar * QZipReader::mapFile(const QString &fileName, qint64 &size) const
+{
+    QFile *f = qobject_cast<QFile*> (d->device);
+    if (f == 0)
+        return 0;
+
+    const int i = d->fileHeaderIndex(fileName);
+    if (i == -1)
+        return 0;
+
+    const FileHeader &header = d->fileHeaders.at(i);
+    int compression_method;
+    const qint64 offset = d->dataOffset(header, compression_method);
+    if (offset == -1 || compression_method != CompressionMethodStored)
+        return 0;
+
+    size = header.uncompressed_size64;
+    if (!size) {
+        static const uchar empty = 0;
+        return &empty;
+    }
+
+    uchar *data = f->map(offset, size);
+    if (data)
+        d->mappedData.append(data);
+    return data;
+}
+
+/*!
+    Returns a new sequential, read-only device from which the contents of the
+    file \a fileName, as listed by fileInfoList(), can be read, inflating it on
+    the fly if needed. The caller takes ownership of the device, which must not
+    be used once the archive has been closed.
+    Returns 0 if the file cannot be found or uses an unsupported compression
+    method.
+*/
+QIODevice * QZipReader::openFile(const QString &fileName) const
+{
+    const int i = d->fileHeaderIndex(fileName);
+    if (i == -1)
+        return 0;
+
+    const FileHeader &header = d->fileHeaders.at(i);
+    int compression_method;
+    const qint64 offset = d->dataOffset(header, compression_method);
+    if (   offset == -1
+        || (   compression_method != CompressionMethodStored
+            && compression_method != CompressionMethodDeflated)) {
+        return 0;
+    }
+
+    return new QZipEntryDevice(d->device, offset, header.compressed_size64,
+                               header.uncompressed_size64,
+                               compression_method == CompressionMethodDeflated);
+}
+//---OPENCOR--- END
+
 /*!
     \enum QZipReader::Status
 
@@ -1215,6 +1927,14 @@ QZipReader::Status QZipReader::status() const
 */
 void QZipReader::close()
 {
+//---OPENCOR--- BEGIN
+    QFile *f = qobject_cast<QFile*> (d->device);
+    if (f) {
+        foreach (uchar *data, d->mappedData)
+            f->unmap(data);
+    }
+    d->mappedData.clear();
+//---OPENCOR--- END
     d->device->close();
 }
 
@@ -1422,6 +2142,43 @@ void QZipWriter::addFile(const QString &fileName, QIODevice *device)
         device->close();
 }
 
+//---OPENCOR--- BEGIN
+/*!
+    Compresses the local file \a fileName into \a compressedFileName as a raw
+    deflate stream, streaming its contents in chunks. The CRC and size of the
+    original file are returned in \a crc and \a uncompressedSize. This can be
+    done from any thread, so that several files can be compressed in parallel
+    before being added to an archive using addCompressedFile().
+*/
+bool QZipWriter::compressFile(const QString &fileName, const QString &compressedFileName,
+                              uint &crc, qint64 &uncompressedSize)
+{
+    QFile source(fileName);
+    QFile destination(compressedFileName);
+    if (!source.open(QIODevice::ReadOnly) || !destination.open(QIODevice::WriteOnly))
+        return false;
+    qint64 compressedSize;
+    return deflateDevice(&source, &destination, &crc, &uncompressedSize, &compressedSize);
+}
+
+/*!
+    Add a file to the archive using the raw deflate stream found in
+    \a compressedFileName (see compressFile()) as its contents, copying it in
+    chunks.
+*/
+void QZipWriter::addCompressedFile(const QString &fileName, const QString &compressedFileName,
+                                   uint crc, qint64 uncompressedSize)
+{
+    QFile compressedFile(compressedFileName);
+    if (!compressedFile.open(QIODevice::ReadOnly)) {
+        d->status = FileOpenError;
+        return;
+    }
+    d->addCompressedEntry(QDir::fromNativeSeparators(fileName), &compressedFile,
+                          compressedFile.size(), crc, uncompressedSize);
+}
+//---OPENCOR--- END
+
 /*!
     Create a new directory in the archive with the specified \a dirName and
     the \a permissions;
@@ -1465,17 +2222,55 @@ void QZipWriter::close()
         d->device->write(header.extra_field);
         d->device->write(header.file_comment);
     }
+/*---OPENCOR---
     int dir_size = d->device->pos() - d->start_of_directory;
+*/
+//---OPENCOR--- BEGIN
+    qint64 dir_size = d->device->pos() - d->start_of_directory;
+    // write a ZIP64 end of directory record and its locator, if needed
+    const bool zip64 =    d->fileHeaders.size() >= 0xffff
+                       || dir_size >= 0xffffffff
+                       || d->start_of_directory >= 0xffffffff;
+    if (zip64) {
+        const qint64 eod64_offset = d->device->pos();
+        Zip64EndOfDirectory eod64;
+        memset(&eod64, 0, sizeof(Zip64EndOfDirectory));
+        writeUInt(eod64.signature, 0x06064b50);
+        writeULongLong(eod64.record_size, sizeof(Zip64EndOfDirectory) - 12);
+        writeUShort(eod64.version_made, (HostUnix << 8) | ZIP64_VERSION);
+        writeUShort(eod64.version_needed, ZIP64_VERSION);
+        writeULongLong(eod64.num_dir_entries_this_disk, d->fileHeaders.size());
+        writeULongLong(eod64.num_dir_entries, d->fileHeaders.size());
+        writeULongLong(eod64.directory_size, dir_size);
+        writeULongLong(eod64.dir_start_offset, d->start_of_directory);
+        d->device->write((const char *)&eod64, sizeof(Zip64EndOfDirectory));
+
+        Zip64EndOfDirectoryLocator locator;
+        memset(&locator, 0, sizeof(Zip64EndOfDirectoryLocator));
+        writeUInt(locator.signature, 0x07064b50);
+        writeULongLong(locator.zip64_eod_offset, eod64_offset);
+        writeUInt(locator.num_disks, 1);
+        d->device->write((const char *)&locator, sizeof(Zip64EndOfDirectoryLocator));
+    }
+//---OPENCOR--- END
     // write end of directory
     EndOfDirectory eod;
     memset(&eod, 0, sizeof(EndOfDirectory));
     writeUInt(eod.signature, 0x06054b50);
     //uchar this_disk[2];
     //uchar start_of_directory_disk[2];
+/*---OPENCOR---
     writeUShort(eod.num_dir_entries_this_disk, d->fileHeaders.size());
     writeUShort(eod.num_dir_entries, d->fileHeaders.size());
     writeUInt(eod.directory_size, dir_size);
     writeUInt(eod.dir_start_offset, d->start_of_directory);
+*/
+//---OPENCOR--- BEGIN
+    writeUShort(eod.num_dir_entries_this_disk, qMin(d->fileHeaders.size(), 0xffff));
+    writeUShort(eod.num_dir_entries, qMin(d->fileHeaders.size(), 0xffff));
+    writeUInt(eod.directory_size, uint(qMin(dir_size, qint64(0xffffffff))));
+    writeUInt(eod.dir_start_offset, uint(qMin(d->start_of_directory, qint64(0xffffffff))));
+//---OPENCOR--- END
     writeUShort(eod.comment_length, d->comment.length());
 
     d->device->write((const char *)&eod, sizeof(EndOfDirectory));
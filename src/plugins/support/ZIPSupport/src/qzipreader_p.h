@@ -51,6 +51,9 @@
 
 #include <QtCore/qdatetime.h>
 #include <QtCore/qfile.h>
+//---OPENCOR--- BEGIN
+#include <QtCore/qhash.h>
+//---OPENCOR--- END
 #include <QtCore/qstring.h>
 
 //---OPENCOR--- BEGIN
@@ -105,6 +108,30 @@ public:
     FileInfo entryInfoAt(int index) const;
     QByteArray fileData(const QString &fileName) const;
     bool extractAll(const QString &destinationDir) const;
+//---OPENCOR--- BEGIN
+    bool extractFile(const QString &fileName, const QString &destinationFileName) const;
+
+    struct EntryLocation
+    {
+        EntryLocation() Q_DECL_NOTHROW
+            : offset(-1), compressedSize(0), uncompressedSize(0), crc(0)
+        {}
+
+        bool isValid() const Q_DECL_NOTHROW { return offset != -1; }
+
+        qint64 offset;
+        qint64 compressedSize;
+        qint64 uncompressedSize;
+        uint crc;
+    };
+
+    QHash<QString, EntryLocation> entryLocations() const;
+    static bool extractFile(const QString &zipFileName, const EntryLocation &entryLocation,
+                            const QString &destinationFileName);
+
+    const uchar * mapFile(const QString &fileName, qint64 &size) const;
+    QIODevice * openFile(const QString &fileName) const;
+//---OPENCOR--- END
 
     enum Status {
         NoError,
@@ -105,6 +105,14 @@ public:
     void addFile(const QString &fileName, const QByteArray &data);
 
     void addFile(const QString &fileName, QIODevice *device);
+//---OPENCOR--- BEGIN
+
+    static bool compressFile(const QString &fileName, const QString &compressedFileName,
+                             uint &crc, qint64 &uncompressedSize);
+
+    void addCompressedFile(const QString &fileName, const QString &compressedFileName,
+                           uint crc, qint64 uncompressedSize);
+//---OPENCOR--- END
 
     void addDirectory(const QString &dirName);
 
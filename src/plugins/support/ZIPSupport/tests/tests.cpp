@@ -106,6 +106,217 @@ void Tests::uncompressTests()
 
 //==============================================================================
 
+void Tests::streamingTests()
+{
+    // Compress our data file on its own and add it, as well as ourselves, to a
+    // new ZIP file
+
+    QTemporaryDir temporaryDir;
+    QString fileName = temporaryDir.path()+QDir::separator()+"streaming.zip";
+    QString compressedFileName = temporaryDir.path()+QDir::separator()+"data.deflate";
+    uint crc;
+    qint64 uncompressedSize;
+
+    QVERIFY(OpenCOR::ZIPSupport::QZipWriter::compressFile(TxtFileName, compressedFileName,
+                                                          crc, uncompressedSize));
+    QCOMPARE(uncompressedSize, QFileInfo(TxtFileName).size());
+
+    OpenCOR::ZIPSupport::QZipWriter *zipWriter = new OpenCOR::ZIPSupport::QZipWriter(fileName);
+
+    zipWriter->addCompressedFile(TxtFileName, compressedFileName, crc, uncompressedSize);
+    zipWriter->addFile(CppFileName, OpenCOR::rawFileContents(CppFileName));
+
+    QCOMPARE(zipWriter->status(), OpenCOR::ZIPSupport::QZipWriter::NoError);
+
+    delete zipWriter;
+
+    // Extract both files, one at a time, and make sure that their contents is
+    // what we expect
+
+    OpenCOR::ZIPSupport::QZipReader zipReader(fileName);
+    QString txtFileName = temporaryDir.path()+QDir::separator()+"data.txt";
+    QString cppFileName = temporaryDir.path()+QDir::separator()+CppFileName;
+
+    QVERIFY(zipReader.extractFile(TxtFileName, txtFileName));
+    QVERIFY(zipReader.extractFile(CppFileName, cppFileName));
+    QVERIFY(!zipReader.extractFile("nonexistent.txt", txtFileName+".bak"));
+
+    QCOMPARE(OpenCOR::fileContents(txtFileName),
+             OpenCOR::fileContents(TxtFileName));
+    QCOMPARE(OpenCOR::fileContents(cppFileName),
+             OpenCOR::fileContents(CppFileName));
+
+    // Do the same using the location of our files in our ZIP file, as if we
+    // were extracting them in parallel
+
+    QHash<QString, OpenCOR::ZIPSupport::QZipReader::EntryLocation> entryLocations = zipReader.entryLocations();
+
+    QCOMPARE(entryLocations.count(), 2);
+    QVERIFY(entryLocations.value(TxtFileName).isValid());
+    QVERIFY(!entryLocations.value("nonexistent.txt").isValid());
+
+    QString txtLocationFileName = temporaryDir.path()+QDir::separator()+"dataLocation.txt";
+    QString cppLocationFileName = temporaryDir.path()+QDir::separator()+"location.cpp";
+
+    QVERIFY(OpenCOR::ZIPSupport::QZipReader::extractFile(fileName, entryLocations.value(TxtFileName),
+                                                         txtLocationFileName));
+    QVERIFY(OpenCOR::ZIPSupport::QZipReader::extractFile(fileName, entryLocations.value(CppFileName),
+                                                         cppLocationFileName));
+    QVERIFY(!OpenCOR::ZIPSupport::QZipReader::extractFile(fileName, entryLocations.value("nonexistent.txt"),
+                                                          txtLocationFileName+".bak"));
+
+    QCOMPARE(OpenCOR::fileContents(txtLocationFileName),
+             OpenCOR::fileContents(TxtFileName));
+    QCOMPARE(OpenCOR::fileContents(cppLocationFileName),
+             OpenCOR::fileContents(CppFileName));
+}
+
+//==============================================================================
+
+void Tests::entryAccessTests()
+{
+    // Create a ZIP file with both a compressed and a stored version of our data
+    // file
+
+    QTemporaryDir temporaryDir;
+    QString fileName = temporaryDir.path()+QDir::separator()+"access.zip";
+    QByteArray txtFileContents = OpenCOR::rawFileContents(TxtFileName);
+    OpenCOR::ZIPSupport::QZipWriter *zipWriter = new OpenCOR::ZIPSupport::QZipWriter(fileName);
+
+    zipWriter->setCompressionPolicy(OpenCOR::ZIPSupport::QZipWriter::AlwaysCompress);
+    zipWriter->addFile("compressed.txt", txtFileContents);
+
+    zipWriter->setCompressionPolicy(OpenCOR::ZIPSupport::QZipWriter::NeverCompress);
+    zipWriter->addFile("stored.txt", txtFileContents);
+
+    delete zipWriter;
+
+    // Read both files through a device
+
+    OpenCOR::ZIPSupport::QZipReader zipReader(fileName);
+
+    foreach (const QString &entryName, QStringList() << "compressed.txt" << "stored.txt") {
+        QIODevice *device = zipReader.openFile(entryName);
+
+        QVERIFY(device);
+        QCOMPARE(device->size(), qint64(txtFileContents.size()));
+        QCOMPARE(device->readAll(), txtFileContents);
+
+        delete device;
+    }
+
+    QVERIFY(!zipReader.openFile("nonexistent.txt"));
+
+    // Only our stored file can be mapped
+
+    qint64 size;
+    const uchar *data = zipReader.mapFile("stored.txt", size);
+
+    QVERIFY(data);
+    QCOMPARE(QByteArray((const char *) data, int(size)), txtFileContents);
+    QVERIFY(!zipReader.mapFile("compressed.txt", size));
+}
+
+//==============================================================================
+
+void Tests::zip64Tests()
+{
+    // Create a ZIP file with more entries than a standard end of central
+    // directory record can account for, meaning that ZIP64 records must be
+    // used
+
+    static const int EntriesCount = 70000;
+
+    QTemporaryDir temporaryDir;
+    QString fileName = temporaryDir.path()+QDir::separator()+"zip64.zip";
+    OpenCOR::ZIPSupport::QZipWriter *zipWriter = new OpenCOR::ZIPSupport::QZipWriter(fileName);
+
+    zipWriter->setCompressionPolicy(OpenCOR::ZIPSupport::QZipWriter::NeverCompress);
+
+    for (int i = 0; i < EntriesCount; ++i)
+        zipWriter->addFile(QString("%1.txt").arg(i), QByteArray::number(i));
+
+    QCOMPARE(zipWriter->status(), OpenCOR::ZIPSupport::QZipWriter::NoError);
+
+    delete zipWriter;
+
+    // Make sure that we can read all of our entries back
+
+    OpenCOR::ZIPSupport::QZipReader zipReader(fileName);
+
+    QCOMPARE(zipReader.status(), OpenCOR::ZIPSupport::QZipReader::NoError);
+    QCOMPARE(zipReader.count(), EntriesCount);
+
+    foreach (int i, QList<int>() << 0 << 0xfffe << 0xffff << EntriesCount-1) {
+        QString entryName = QString("%1.txt").arg(i);
+
+        QCOMPARE(zipReader.entryInfoAt(i).filePath, entryName);
+        QCOMPARE(zipReader.fileData(entryName), QByteArray::number(i));
+    }
+}
+
+//==============================================================================
+
+void Tests::largeEntryTests()
+{
+    // Create a ZIP file with an entry which inflated size is many times the
+    // size of the chunks in which we (de)compress things, both by compressing
+    // it in memory and by streaming it
+
+    QTemporaryDir temporaryDir;
+    QString fileName = temporaryDir.path()+QDir::separator()+"large.zip";
+    QString largeFileName = temporaryDir.path()+QDir::separator()+"large.txt";
+    QString compressedFileName = temporaryDir.path()+QDir::separator()+"large.deflate";
+    QByteArray largeFileContents;
+
+    for (int i = 0; i < 200000; ++i)
+        largeFileContents += QByteArray::number(i%1000)+"\n";
+
+    QFile largeFile(largeFileName);
+
+    QVERIFY(largeFile.open(QIODevice::WriteOnly));
+    QCOMPARE(largeFile.write(largeFileContents), qint64(largeFileContents.size()));
+
+    largeFile.close();
+
+    uint crc;
+    qint64 uncompressedSize;
+
+    QVERIFY(OpenCOR::ZIPSupport::QZipWriter::compressFile(largeFileName, compressedFileName,
+                                                          crc, uncompressedSize));
+    QCOMPARE(uncompressedSize, qint64(largeFileContents.size()));
+
+    OpenCOR::ZIPSupport::QZipWriter *zipWriter = new OpenCOR::ZIPSupport::QZipWriter(fileName);
+
+    zipWriter->setCompressionPolicy(OpenCOR::ZIPSupport::QZipWriter::AlwaysCompress);
+    zipWriter->addFile("inMemory.txt", largeFileContents);
+    zipWriter->addCompressedFile("streamed.txt", compressedFileName, crc, uncompressedSize);
+
+    QCOMPARE(zipWriter->status(), OpenCOR::ZIPSupport::QZipWriter::NoError);
+
+    delete zipWriter;
+
+    // Extract our entries and read them through a device, and make sure that
+    // we get all of their contents
+
+    OpenCOR::ZIPSupport::QZipReader zipReader(fileName);
+    QString extractedFileName = temporaryDir.path()+QDir::separator()+"extracted.txt";
+
+    foreach (const QString &entryName, QStringList() << "inMemory.txt" << "streamed.txt") {
+        QVERIFY(zipReader.extractFile(entryName, extractedFileName));
+        QCOMPARE(OpenCOR::rawFileContents(extractedFileName), largeFileContents);
+
+        QIODevice *device = zipReader.openFile(entryName);
+
+        QVERIFY(device);
+        QCOMPARE(device->readAll(), largeFileContents);
+
+        delete device;
+    }
+}
+
+//==============================================================================
+
 QTEST_GUILESS_MAIN(Tests)
 
 //==============================================================================
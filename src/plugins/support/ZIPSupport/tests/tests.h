@@ -42,6 +42,10 @@ private Q_SLOTS:
 
     void compressTests();
     void uncompressTests();
+    void streamingTests();
+    void entryAccessTests();
+    void zip64Tests();
+    void largeEntryTests();
 };
 
 //==============================================================================
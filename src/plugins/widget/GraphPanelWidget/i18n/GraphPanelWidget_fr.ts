@@ -34,6 +34,30 @@
         <source>Copy the contents of the graph panel to the clipboard</source>
         <translation>Copier le contenu du panneau graphique dans le presse-papier</translation>
     </message>
+    <message>
+        <source>Export To...</source>
+        <translation>Exporter Vers...</translation>
+    </message>
+    <message>
+        <source>Export the contents of the graph panel to a PDF, PNG or SVG file</source>
+        <translation>Exporter le contenu du panneau graphique vers un fichier PDF, PNG ou SVG</translation>
+    </message>
+    <message>
+        <source>Export To</source>
+        <translation>Exporter Vers</translation>
+    </message>
+    <message>
+        <source>The graph panel could not be exported to &lt;strong&gt;%1&lt;/strong&gt;.</source>
+        <translation>Le panneau graphique n&apos;a pas pu être exporté vers &lt;strong&gt;%1&lt;/strong&gt;.</translation>
+    </message>
+    <message>
+        <source>Data Cursor</source>
+        <translation>Curseur de Données</translation>
+    </message>
+    <message>
+        <source>Show the nearest data point of the graphs under the mouse</source>
+        <translation>Afficher le point de données le plus proche des graphes sous la souris</translation>
+    </message>
     <message>
         <source>Custom Axes...</source>
         <translation>Axes Personnalisés...</translation>
@@ -0,0 +1,187 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Graph panel plot layer renderer
+//==============================================================================
+
+#include "graphpanelplotlayerrenderer.h"
+
+//==============================================================================
+
+#include <QPainter>
+#include <QThread>
+
+//==============================================================================
+
+#include "qwt_plot_curve.h"
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace GraphPanelWidget {
+
+//==============================================================================
+
+GraphPanelPlotLayerRenderer::GraphPanelPlotLayerRenderer() :
+    mHasJob(false),
+    mSignature(QByteArray()),
+    mSize(QSize()),
+    mDevicePixelRatio(1.0),
+    mMapX(QwtScaleMap()),
+    mMapY(QwtScaleMap()),
+    mSamples(QList<QVector<QPointF>>()),
+    mPens(QList<QPen>()),
+    mAntialiased(QList<bool>())
+{
+    // Create our thread
+
+    mThread = new QThread();
+
+    // Move ourselves to our thread
+
+    moveToThread(mThread);
+
+    // Create a few connections
+    // Note: renderRequested() is emitted from the GUI thread, so
+    //       renderLatestJob() will be called (asynchronously) in our thread...
+
+    connect(mThread, SIGNAL(finished()),
+            mThread, SLOT(deleteLater()));
+    connect(mThread, SIGNAL(finished()),
+            this, SLOT(deleteLater()));
+
+    connect(this, SIGNAL(renderRequested()),
+            this, SLOT(renderLatestJob()));
+
+    // Start our thread
+
+    mThread->start();
+}
+
+//==============================================================================
+
+void GraphPanelPlotLayerRenderer::stop()
+{
+    // Stop our thread and wait for it to be done
+
+    mThread->quit();
+    mThread->wait();
+}
+
+//==============================================================================
+
+void GraphPanelPlotLayerRenderer::render(const QByteArray &pSignature,
+                                         const QSize &pSize,
+                                         const qreal &pDevicePixelRatio,
+                                         const QwtScaleMap &pMapX,
+                                         const QwtScaleMap &pMapY,
+                                         const QList<QVector<QPointF>> &pSamples,
+                                         const QList<QPen> &pPens,
+                                         const QList<bool> &pAntialiased)
+{
+    // Keep track of the given job, replacing any job that hasn't been started
+    // yet, and let our thread know that there is a job to render
+    // Note: this means that, if several jobs are requested while we are busy
+    //       rendering, then only the latest one will get rendered...
+
+    mJobMutex.lock();
+        mHasJob = true;
+
+        mSignature = pSignature;
+        mSize = pSize;
+        mDevicePixelRatio = pDevicePixelRatio;
+        mMapX = pMapX;
+        mMapY = pMapY;
+        mSamples = pSamples;
+        mPens = pPens;
+        mAntialiased = pAntialiased;
+    mJobMutex.unlock();
+
+    emit renderRequested();
+}
+
+//==============================================================================
+
+void GraphPanelPlotLayerRenderer::renderLatestJob()
+{
+    // Retrieve our latest job, if any
+
+    mJobMutex.lock();
+        if (!mHasJob) {
+            mJobMutex.unlock();
+
+            return;
+        }
+
+        mHasJob = false;
+
+        QByteArray signature = mSignature;
+        QSize size = mSize;
+        qreal devicePixelRatio = mDevicePixelRatio;
+        QwtScaleMap mapX = mMapX;
+        QwtScaleMap mapY = mMapY;
+        QList<QVector<QPointF>> samples = mSamples;
+        QList<QPen> pens = mPens;
+        QList<bool> antialiased = mAntialiased;
+
+        mSamples.clear();
+    mJobMutex.unlock();
+
+    // Render our graphs into a transparent image, using our own curves since
+    // the original ones belong to (and can be modified by) the GUI thread
+
+    QImage image = QImage(size*devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    QRectF rect = QRectF(QPointF(0.0, 0.0), size);
+
+    for (int i = 0, iMax = samples.count(); i < iMax; ++i) {
+        QwtPlotCurve curve;
+
+        curve.setSamples(samples[i]);
+        curve.setPen(pens[i]);
+
+        painter.save();
+
+        painter.setRenderHint(QPainter::Antialiasing, antialiased[i]);
+        painter.setRenderHint(QPainter::HighQualityAntialiasing, antialiased[i]);
+
+        curve.draw(&painter, mapX, mapY, rect);
+
+        painter.restore();
+    }
+
+    painter.end();
+
+    // Let people know that our image has been rendered
+
+    emit rendered(signature, image);
+}
+
+//==============================================================================
+
+}   // namespace GraphPanelWidget
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
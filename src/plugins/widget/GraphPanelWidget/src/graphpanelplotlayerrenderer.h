@@ -0,0 +1,99 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Graph panel plot layer renderer
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPen>
+#include <QPointF>
+#include <QVector>
+
+//==============================================================================
+
+#include "qwt_scale_map.h"
+
+//==============================================================================
+
+class QThread;
+
+//==============================================================================
+
+namespace OpenCOR {
+namespace GraphPanelWidget {
+
+//==============================================================================
+
+class GraphPanelPlotLayerRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GraphPanelPlotLayerRenderer();
+
+    void stop();
+
+    void render(const QByteArray &pSignature, const QSize &pSize,
+                const qreal &pDevicePixelRatio, const QwtScaleMap &pMapX,
+                const QwtScaleMap &pMapY,
+                const QList<QVector<QPointF>> &pSamples,
+                const QList<QPen> &pPens,
+                const QList<bool> &pAntialiased);
+
+private:
+    QThread *mThread;
+
+    QMutex mJobMutex;
+
+    bool mHasJob;
+
+    QByteArray mSignature;
+    QSize mSize;
+    qreal mDevicePixelRatio;
+    QwtScaleMap mMapX;
+    QwtScaleMap mMapY;
+    QList<QVector<QPointF>> mSamples;
+    QList<QPen> mPens;
+    QList<bool> mAntialiased;
+
+Q_SIGNALS:
+    void renderRequested();
+
+    void rendered(const QByteArray &pSignature, const QImage &pImage);
+
+private Q_SLOTS:
+    void renderLatestJob();
+};
+
+//==============================================================================
+
+}   // namespace GraphPanelWidget
+}   // namespace OpenCOR
+
+//==============================================================================
+// End of file
+//==============================================================================
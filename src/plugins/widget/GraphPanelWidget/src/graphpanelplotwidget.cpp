@@ -21,6 +21,7 @@ limitations under the License.
 //==============================================================================
 
 #include "coreguiutils.h"
+#include "graphpanelplotlayerrenderer.h"
 #include "graphpanelplotwidget.h"
 #include "graphpanelwidgetcustomaxeswindow.h"
 #include "i18ninterface.h"
@@ -29,10 +30,15 @@ limitations under the License.
 
 #include <QApplication>
 #include <QClipboard>
+#include <QDataStream>
 #include <QDesktopWidget>
+#include <QFileInfo>
+#include <QImageWriter>
 #include <QMenu>
 #include <QMessageBox>
 #include <QPaintEvent>
+#include <QPdfWriter>
+#include <QSvgGenerator>
 
 //==============================================================================
 
@@ -45,6 +51,8 @@ limitations under the License.
 #include "qwt_plot_directpainter.h"
 #include "qwt_plot_grid.h"
 #include "qwt_plot_layout.h"
+#include "qwt_plot_renderer.h"
+#include "qwt_point_data.h"
 #include "qwt_scale_engine.h"
 #include "qwt_scale_widget.h"
 
@@ -60,7 +68,14 @@ GraphPanelPlotGraph::GraphPanelPlotGraph(void *pParameterX, void *pParameterY) :
     mSelected(true),
     mFileName(QString()),
     mParameterX(pParameterX),
-    mParameterY(pParameterY)
+    mParameterY(pParameterY),
+    mIndexedSize(0),
+    mLastIndexedSample(QPointF()),
+    mSortedX(true),
+    mGridSize(0),
+    mCellWidth(1.0),
+    mCellHeight(1.0),
+    mGrid(QHash<quint64, QVector<qulonglong>>())
 {
     // Customise ourselves a bit
 
@@ -152,11 +167,375 @@ void GraphPanelPlotGraph::setParameterY(void *pParameterY)
 
 //==============================================================================
 
+void GraphPanelPlotGraph::resetIndex()
+{
+    // Reset our spatial index
+
+    mIndexedSize = 0;
+    mLastIndexedSample = QPointF();
+
+    mSortedX = true;
+
+    mGridSize = 0;
+
+    mGrid.clear();
+}
+
+//==============================================================================
+
+static bool sameSamples(const QPointF &pSample1, const QPointF &pSample2)
+{
+    // Return whether the two given samples are the same, NaN values included
+
+    return    (   (pSample1.x() == pSample2.x())
+               || (qIsNaN(pSample1.x()) && qIsNaN(pSample2.x())))
+           && (   (pSample1.y() == pSample2.y())
+               || (qIsNaN(pSample1.y()) && qIsNaN(pSample2.y())));
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::updateIndex()
+{
+    // Reset our spatial index if our data has been replaced (rather than
+    // appended to) since we last indexed it
+    // Note: our data is typically set using setRawSamples() with an ever
+    //       increasing size, so our data is considered to have been replaced
+    //       if it got smaller or if its last indexed sample has changed...
+
+    qulonglong size = dataSize();
+
+    if (   (size < mIndexedSize)
+        || (mIndexedSize && !sameSamples(sample(mIndexedSize-1), mLastIndexedSample))) {
+        resetIndex();
+    }
+
+    if (size == mIndexedSize)
+        return;
+
+    // Check whether our new samples keep our X values sorted, in which case a
+    // binary search on them is all we need, otherwise we need a grid
+
+    if (mSortedX) {
+        double prevX = mIndexedSize?mLastIndexedSample.x():-qInf();
+
+        for (qulonglong i = mIndexedSize; i < size; ++i) {
+            double x = sample(i).x();
+
+            if (qIsNaN(x) || (x < prevX)) {
+                mSortedX = false;
+
+                break;
+            }
+
+            prevX = x;
+        }
+    }
+
+    // Update our grid, if needed, rebuilding it (with more appropriate cells)
+    // every time our number of samples has doubled since we last built it, so
+    // that the cost of building it remains amortised
+
+    if (!mSortedX) {
+        if (size >= 2*mGridSize) {
+            mIndexedSize = size;
+
+            buildGrid();
+        } else {
+            for (qulonglong i = mIndexedSize; i < size; ++i)
+                addToGrid(i);
+        }
+    }
+
+    mIndexedSize = size;
+    mLastIndexedSample = sample(size-1);
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::cell(const QPointF &pPoint, int &pCellX,
+                               int &pCellY) const
+{
+    // Return the cell in which the given point is to be found
+
+    static const double MaxCell = 1.0e9;
+
+    pCellX = int(qBound(-MaxCell, floor(pPoint.x()/mCellWidth), MaxCell));
+    pCellY = int(qBound(-MaxCell, floor(pPoint.y()/mCellHeight), MaxCell));
+}
+
+//==============================================================================
+
+static quint64 cellKey(const int &pCellX, const int &pCellY)
+{
+    // Return the key for the given cell
+
+    return (quint64(quint32(pCellX)) << 32) | quint32(pCellY);
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::buildGrid()
+{
+    // Build our grid so that, on average, a cell contains a few samples
+
+    static const double SamplesPerCell = 8.0;
+
+    QRectF rect = boundingRect();
+    double nbOfCells = qMax(1.0, sqrt(mIndexedSize/SamplesPerCell));
+
+    mCellWidth  = (rect.width() > 0.0)?rect.width()/nbOfCells:1.0;
+    mCellHeight = (rect.height() > 0.0)?rect.height()/nbOfCells:1.0;
+
+    mGridSize = mIndexedSize;
+
+    mGrid.clear();
+
+    for (qulonglong i = 0; i < mIndexedSize; ++i)
+        addToGrid(i);
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::addToGrid(const qulonglong &pIndex)
+{
+    // Add the given sample to our grid, if it has finite coordinates
+
+    QPointF point = sample(pIndex);
+
+    if (!qIsFinite(point.x()) || !qIsFinite(point.y()))
+        return;
+
+    int cellX;
+    int cellY;
+
+    cell(point, cellX, cellY);
+
+    mGrid[cellKey(cellX, cellY)] << pIndex;
+}
+
+//==============================================================================
+
+void GraphPanelPlotGraph::checkSample(const qulonglong &pIndex,
+                                      const QwtScaleMap &pCanvasMapX,
+                                      const QwtScaleMap &pCanvasMapY,
+                                      const QPointF &pPoint,
+                                      qulonglong &pBestIndex,
+                                      double &pBestDistance) const
+{
+    // Check whether the given sample is closer (in pixels) to the given point
+    // than our best sample so far
+
+    QPointF point = sample(pIndex);
+    double dX = pCanvasMapX.transform(point.x())-pPoint.x();
+    double dY = pCanvasMapY.transform(point.y())-pPoint.y();
+    double distance = sqrt(dX*dX+dY*dY);
+
+    if (distance < pBestDistance) {
+        pBestIndex = pIndex;
+        pBestDistance = distance;
+    }
+}
+
+//==============================================================================
+
+bool GraphPanelPlotGraph::nearestSample(const QwtScaleMap &pCanvasMapX,
+                                        const QwtScaleMap &pCanvasMapY,
+                                        const QPointF &pPoint,
+                                        const double &pMaxDistance,
+                                        qulonglong &pIndex, double &pDistance)
+{
+    // Make sure that our spatial index is up to date
+
+    updateIndex();
+
+    if (!mIndexedSize)
+        return false;
+
+    // Look for the sample that is the nearest (in pixels) to the given point
+    // (in canvas coordinates), but no further than the given distance
+
+    qulonglong bestIndex = 0;
+    double bestDistance = pMaxDistance;
+
+    if (mSortedX) {
+        // Our X values are sorted, so look for the first sample which X value
+        // is not smaller than that of the given point and then check the
+        // samples on either side of it, for as long as their X value is close
+        // enough to that of the given point
+
+        double x = pCanvasMapX.invTransform(pPoint.x());
+        qulonglong low = 0;
+        qulonglong high = mIndexedSize;
+
+        while (low < high) {
+            qulonglong middle = low+(high-low)/2;
+
+            if (sample(middle).x() < x)
+                low = middle+1;
+            else
+                high = middle;
+        }
+
+        for (qulonglong i = low; i < mIndexedSize; ++i) {
+            if (qAbs(pCanvasMapX.transform(sample(i).x())-pPoint.x()) >= bestDistance)
+                break;
+
+            checkSample(i, pCanvasMapX, pCanvasMapY, pPoint, bestIndex, bestDistance);
+        }
+
+        for (qulonglong i = low; i > 0; --i) {
+            if (qAbs(pCanvasMapX.transform(sample(i-1).x())-pPoint.x()) >= bestDistance)
+                break;
+
+            checkSample(i-1, pCanvasMapX, pCanvasMapY, pPoint, bestIndex, bestDistance);
+        }
+    } else {
+        // Our X values are not sorted (e.g. we are a phase plot), so check the
+        // cells of our grid that are within the given distance of the given
+        // point, either ring after ring around the cell in which the given
+        // point is, until the remaining rings cannot contain a closer sample,
+        // or, if our cells are so small on the screen that there would be more
+        // cells to check than we have non-empty cells, by going through our
+        // non-empty cells
+
+        int pointCellX;
+        int pointCellY;
+
+        cell(QPointF(pCanvasMapX.invTransform(pPoint.x()),
+                     pCanvasMapY.invTransform(pPoint.y())),
+             pointCellX, pointCellY);
+
+        double cellWidth = qAbs(pCanvasMapX.transform(mCellWidth)-pCanvasMapX.transform(0.0));
+        double cellHeight = qAbs(pCanvasMapY.transform(mCellHeight)-pCanvasMapY.transform(0.0));
+        double cellSize = qMin(cellWidth, cellHeight);
+        double maxRing = cellSize?ceil(pMaxDistance/cellSize)+1.0:qInf();
+
+        if ((2.0*maxRing+1.0)*(2.0*maxRing+1.0) > mGrid.count()) {
+            int cellRange = int(qMin(maxRing, 2.0e9));
+
+            for (QHash<quint64, QVector<qulonglong>>::const_iterator iter = mGrid.constBegin(),
+                                                                     iterEnd = mGrid.constEnd();
+                 iter != iterEnd; ++iter) {
+                int cellX = int(quint32(iter.key() >> 32));
+                int cellY = int(quint32(iter.key()));
+
+                if (   (qAbs(qint64(cellX)-pointCellX) <= cellRange)
+                    && (qAbs(qint64(cellY)-pointCellY) <= cellRange)) {
+                    foreach (const qulonglong &sampleIndex, iter.value())
+                        checkSample(sampleIndex, pCanvasMapX, pCanvasMapY, pPoint, bestIndex, bestDistance);
+                }
+            }
+        } else {
+            for (int ring = 0; (ring-1)*cellSize < bestDistance; ++ring) {
+                for (int cellX = pointCellX-ring; cellX <= pointCellX+ring; ++cellX) {
+                    bool borderColumn = (cellX == pointCellX-ring) || (cellX == pointCellX+ring);
+
+                    for (int cellY = pointCellY-ring; cellY <= pointCellY+ring;
+                         cellY += borderColumn?1:2*ring) {
+                        QHash<quint64, QVector<qulonglong>>::const_iterator cellSamples = mGrid.constFind(cellKey(cellX, cellY));
+
+                        if (cellSamples != mGrid.constEnd()) {
+                            foreach (const qulonglong &sampleIndex, cellSamples.value())
+                                checkSample(sampleIndex, pCanvasMapX, pCanvasMapY, pPoint, bestIndex, bestDistance);
+                        }
+
+                        if (!ring)
+                            break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Return the nearest sample, if any
+
+    if (bestDistance < pMaxDistance) {
+        pIndex = bestIndex;
+        pDistance = bestDistance;
+
+        return true;
+    } else {
+        return false;
+    }
+}
+
+//==============================================================================
+
+QVector<QPointF> GraphPanelPlotGraph::decimatedSamples(const QwtScaleMap &pMapX) const
+{
+    // Decimate our samples using a min/max approach, i.e. consecutive samples
+    // that fall within the same pixel column get replaced with the first,
+    // minimum, maximum and last of them (in their original order), which
+    // renders the same as all of them
+
+    QVector<QPointF> res = QVector<QPointF>();
+    qulonglong size = dataSize();
+    qulonglong i = 0;
+
+    while (i < size) {
+        QPointF firstSample = sample(i);
+
+        if (!qIsFinite(firstSample.x()) || !qIsFinite(firstSample.y())) {
+            res << firstSample;
+
+            ++i;
+
+            continue;
+        }
+
+        double column = floor(pMapX.transform(firstSample.x()));
+        qulonglong firstIndex = i;
+        qulonglong minIndex = i;
+        qulonglong maxIndex = i;
+        double minY = firstSample.y();
+        double maxY = firstSample.y();
+
+        for (++i; i < size; ++i) {
+            QPointF nextSample = sample(i);
+
+            if (   !qIsFinite(nextSample.x()) || !qIsFinite(nextSample.y())
+                || (floor(pMapX.transform(nextSample.x())) != column)) {
+                break;
+            }
+
+            if (nextSample.y() < minY) {
+                minIndex = i;
+                minY = nextSample.y();
+            }
+
+            if (nextSample.y() > maxY) {
+                maxIndex = i;
+                maxY = nextSample.y();
+            }
+        }
+
+        qulonglong lastIndex = i-1;
+        qulonglong indexes[4] = { firstIndex,
+                                  qMin(minIndex, maxIndex),
+                                  qMax(minIndex, maxIndex),
+                                  lastIndex };
+
+        for (int j = 0; j < 4; ++j) {
+            if (!j || (indexes[j] != indexes[j-1]))
+                res << sample(indexes[j]);
+        }
+    }
+
+    return res;
+}
+
+//==============================================================================
+
 GraphPanelPlotOverlayWidget::GraphPanelPlotOverlayWidget(GraphPanelPlotWidget *pParent) :
     QWidget(pParent),
     mOwner(pParent),
     mOriginPoint(QPoint()),
-    mPoint(QPoint())
+    mPoint(QPoint()),
+    mShowDataCursor(false),
+    mDataCursorPoint(QPoint()),
+    mDataCursorText(QString()),
+    mDataCursorColor(QColor())
 {
     setAttribute(Qt::WA_NoSystemBackground);
     setAttribute(Qt::WA_TransparentForMouseEvents);
@@ -191,10 +570,13 @@ void GraphPanelPlotOverlayWidget::paintEvent(QPaintEvent *pEvent)
 
     pEvent->accept();
 
-    // Check whether an action is to be carried out
+    // Check whether an action is to be carried out or whether our data cursor
+    // is to be shown
 
-    if (mOwner->action() == GraphPanelPlotWidget::None)
+    if (   (mOwner->action() == GraphPanelPlotWidget::None)
+        && !mShowDataCursor) {
         return;
+    }
 
     // Paint the overlay, if any is needed
 
@@ -258,8 +640,26 @@ void GraphPanelPlotOverlayWidget::paintEvent(QPaintEvent *pEvent)
 
         break;
     }
+    case GraphPanelPlotWidget::None: {
+        // Draw our data cursor, i.e. a circle around the nearest sample and its
+        // information, using the colour of its graph
+
+        QColor penColor = mDataCursorColor;
+
+        penColor.setAlphaF(0.69);
+
+        painter.setPen(penColor);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        painter.drawEllipse(mDataCursorPoint, 4, 4);
+
+        drawText(&painter, mDataCursorText, mDataCursorPoint,
+                 penColor, Qt::white, BottomRight);
+
+        break;
+    }
     default:
-        // Either no action or not an action we know how to handle
+        // Not an action we know how to handle
 
         ;
     }
@@ -291,6 +691,42 @@ void GraphPanelPlotOverlayWidget::setPoint(const QPoint &pPoint)
 
 //==============================================================================
 
+void GraphPanelPlotOverlayWidget::setDataCursor(const QPoint &pPoint,
+                                                const QString &pText,
+                                                const QColor &pColor)
+{
+    // Show our data cursor at the given point (in canvas coordinates) with the
+    // given text and colour, if it has changed
+
+    if (   mShowDataCursor && (pPoint == mDataCursorPoint)
+        && !pText.compare(mDataCursorText) && (pColor == mDataCursorColor)) {
+        return;
+    }
+
+    mShowDataCursor = true;
+
+    mDataCursorPoint = pPoint;
+    mDataCursorText = pText;
+    mDataCursorColor = pColor;
+
+    update();
+}
+
+//==============================================================================
+
+void GraphPanelPlotOverlayWidget::resetDataCursor()
+{
+    // Hide our data cursor, if it is shown
+
+    if (mShowDataCursor) {
+        mShowDataCursor = false;
+
+        update();
+    }
+}
+
+//==============================================================================
+
 QRect GraphPanelPlotOverlayWidget::zoomRegion() const
 {
     // Return the region to be zoomed based on mOriginPoint and mPoint
@@ -332,8 +768,7 @@ void GraphPanelPlotOverlayWidget::drawCoordinates(QPainter *pPainter,
                                                   const Location &pLocation,
                                                   const bool &pCanMoveLocation)
 {
-    // Retrieve the size of coordinates as they will appear on the screen,
-    // which means using the same font as the one used for the axes
+    // Draw the coordinates of the given point
     // Note: normally, pPoint would be a QPointF, but we want the coordinates to
     //       be drawn relative to something (see paintEvent()) and the only way
     //       to guarantee that everything will be painted as expected is to use
@@ -344,12 +779,30 @@ void GraphPanelPlotOverlayWidget::drawCoordinates(QPainter *pPainter,
     //       between the coordinates and pPoint, but it could happen that we
     //       have either no gap or one of two pixels...
 
+    QPointF point = mOwner->canvasPoint(pPoint, false);
+
+    drawText(pPainter, QString("X: %1\nY: %2").arg(QLocale().toString(point.x(), 'g', 15),
+                                                   QLocale().toString(point.y(), 'g', 15)),
+             pPoint, pBackgroundColor, pForegroundColor, pLocation,
+             pCanMoveLocation);
+}
+
+//==============================================================================
+
+void GraphPanelPlotOverlayWidget::drawText(QPainter *pPainter,
+                                           const QString &pText,
+                                           const QPoint &pPoint,
+                                           const QColor &pBackgroundColor,
+                                           const QColor &pForegroundColor,
+                                           const Location &pLocation,
+                                           const bool &pCanMoveLocation)
+{
+    // Retrieve the size of the given text as it will appear on the screen,
+    // which means using the same font as the one used for the axes
+
     pPainter->setFont(mOwner->axisFont(QwtPlot::xBottom));
 
-    QPointF point = mOwner->canvasPoint(pPoint, false);
-    QString coordinates = QString("X: %1\nY: %2").arg(QLocale().toString(point.x(), 'g', 15),
-                                                      QLocale().toString(point.y(), 'g', 15));
-    QRect coordinatesRect = pPainter->boundingRect(qApp->desktop()->availableGeometry(), 0, coordinates);
+    QRect coordinatesRect = pPainter->boundingRect(qApp->desktop()->availableGeometry(), 0, pText);
 
     // Determine where the coordinates and its background should be drawn
 
@@ -412,7 +865,7 @@ void GraphPanelPlotOverlayWidget::drawCoordinates(QPainter *pPainter,
 
     pPainter->setPen(pen);
 
-    pPainter->drawText(coordinatesRect, coordinates);
+    pPainter->drawText(coordinatesRect, pText);
 }
 
 //==============================================================================
@@ -466,6 +919,15 @@ GraphPanelPlotWidget::GraphPanelPlotWidget(const GraphPanelPlotWidgets &pNeighbo
                                            QWidget *pParent) :
     QwtPlot(pParent),
     Core::CommonWidget(),
+    mDrawingCanvas(false),
+    mExporting(false),
+    mLayerImage(QImage()),
+    mLayerSignature(QByteArray()),
+    mLayerMapX(QwtScaleMap()),
+    mLayerMapY(QwtScaleMap()),
+    mRequestedLayerSignature(QByteArray()),
+    mRequestedLayerMapX(QwtScaleMap()),
+    mRequestedLayerMapY(QwtScaleMap()),
     mGraphs(GraphPanelPlotGraphs()),
     mAction(None),
     mOriginPoint(QPoint()),
@@ -486,6 +948,14 @@ GraphPanelPlotWidget::GraphPanelPlotWidget(const GraphPanelPlotWidgets &pNeighbo
 
     mDirectPainter->setAttribute(QwtPlotDirectPainter::CopyBackingStore, true);
 
+    // Get ourselves a layer renderer, so that our graphs can be rendered in a
+    // thread of their own, should they be big enough
+
+    mLayerRenderer = new GraphPanelPlotLayerRenderer();
+
+    connect(mLayerRenderer, SIGNAL(rendered(const QByteArray &, const QImage &)),
+            this, SLOT(layerRendered(const QByteArray &, const QImage &)));
+
     // Speedup painting on X11 systems
     // Note: this can only be done on X11 systems...
 
@@ -523,6 +993,8 @@ GraphPanelPlotWidget::GraphPanelPlotWidget(const GraphPanelPlotWidgets &pNeighbo
     mContextMenu = new QMenu(this);
 
     mCopyToClipboardAction = Core::newAction(this);
+    mExportToAction = Core::newAction(this);
+    mDataCursorAction = Core::newAction(true, this);
     mCustomAxesAction = Core::newAction(this);
     mZoomInAction = Core::newAction(this);
     mZoomOutAction = Core::newAction(this);
@@ -530,6 +1002,10 @@ GraphPanelPlotWidget::GraphPanelPlotWidget(const GraphPanelPlotWidgets &pNeighbo
 
     connect(mCopyToClipboardAction, SIGNAL(triggered(bool)),
             this, SLOT(copyToClipboard()));
+    connect(mExportToAction, SIGNAL(triggered(bool)),
+            this, SLOT(exportTo()));
+    connect(mDataCursorAction, SIGNAL(toggled(bool)),
+            this, SLOT(toggleDataCursor(const bool &)));
     connect(mCustomAxesAction, SIGNAL(triggered(bool)),
             this, SLOT(customAxes()));
     connect(mZoomInAction, SIGNAL(triggered(bool)),
@@ -540,6 +1016,9 @@ GraphPanelPlotWidget::GraphPanelPlotWidget(const GraphPanelPlotWidgets &pNeighbo
             this, SLOT(resetZoom()));
 
     mContextMenu->addAction(mCopyToClipboardAction);
+    mContextMenu->addAction(mExportToAction);
+    mContextMenu->addSeparator();
+    mContextMenu->addAction(mDataCursorAction);
 
     if (pSynchronizeXAxisAction && pSynchronizeYAxisAction) {
         mContextMenu->addSeparator();
@@ -575,6 +1054,8 @@ GraphPanelPlotWidget::~GraphPanelPlotWidget()
 
     delete mDirectPainter;
 
+    mLayerRenderer->stop();
+
     foreach (GraphPanelPlotGraph *graph, mGraphs)
         delete graph;
 }
@@ -587,6 +1068,10 @@ void GraphPanelPlotWidget::retranslateUi()
 
     I18nInterface::retranslateAction(mCopyToClipboardAction, tr("Copy to Clipboard"),
                                      tr("Copy the contents of the graph panel to the clipboard"));
+    I18nInterface::retranslateAction(mExportToAction, tr("Export To..."),
+                                     tr("Export the contents of the graph panel to a PDF, PNG or SVG file"));
+    I18nInterface::retranslateAction(mDataCursorAction, tr("Data Cursor"),
+                                     tr("Show the nearest data point of the graphs under the mouse"));
     I18nInterface::retranslateAction(mCustomAxesAction, tr("Custom Axes..."),
                                      tr("Specify custom axes for the graph panel"));
     I18nInterface::retranslateAction(mZoomInAction, tr("Zoom In"),
@@ -606,6 +1091,194 @@ void GraphPanelPlotWidget::retranslateUi()
 
 //==============================================================================
 
+void GraphPanelPlotWidget::drawCanvas(QPainter *pPainter)
+{
+    // Draw our canvas, keeping track of the fact that we are doing so (so that
+    // drawItems() knows that it can use our layer for our graphs)
+
+    mDrawingCanvas = true;
+
+    QwtPlot::drawCanvas(pPainter);
+
+    mDrawingCanvas = false;
+}
+
+//==============================================================================
+
+static const qulonglong MinNbOfLayerSamples = 100000;
+
+//==============================================================================
+
+void GraphPanelPlotWidget::drawNonGraphItems(QPainter *pPainter,
+                                             const QRectF &pCanvasRect,
+                                             const QwtScaleMap pMaps[axisCnt]) const
+{
+    // Draw all our items, except our graphs, the same way QwtPlot does
+
+    foreach (QwtPlotItem *item, itemList()) {
+        if (item->isVisible() && !dynamic_cast<GraphPanelPlotGraph *>(item)) {
+            pPainter->save();
+
+            pPainter->setRenderHint(QPainter::Antialiasing,
+                                    item->testRenderHint(QwtPlotItem::RenderAntialiased));
+            pPainter->setRenderHint(QPainter::HighQualityAntialiasing,
+                                    item->testRenderHint(QwtPlotItem::RenderAntialiased));
+
+            item->draw(pPainter, pMaps[item->xAxis()], pMaps[item->yAxis()],
+                       pCanvasRect);
+
+            pPainter->restore();
+        }
+    }
+}
+
+//==============================================================================
+
+void GraphPanelPlotWidget::drawItems(QPainter *pPainter,
+                                     const QRectF &pCanvasRect,
+                                     const QwtScaleMap pMaps[axisCnt]) const
+{
+    // Determine the graphs to draw and how many samples they have
+
+    GraphPanelPlotGraphs graphs = GraphPanelPlotGraphs();
+    qulonglong nbOfSamples = 0;
+
+    foreach (GraphPanelPlotGraph *graph, mGraphs) {
+        if (graph->isVisible()) {
+            graphs << graph;
+
+            nbOfSamples += graph->dataSize();
+        }
+    }
+
+    if (mExporting) {
+        // We are being exported, so draw our graphs using decimated samples,
+        // so that huge graphs don't result in huge (vector) files
+        // Note: our maps are in device coordinates, so the decimation
+        //       automatically takes the export resolution into account...
+
+        drawNonGraphItems(pPainter, pCanvasRect, pMaps);
+
+        foreach (GraphPanelPlotGraph *graph, graphs) {
+            QwtPlotCurve curve;
+
+            curve.setSamples(graph->decimatedSamples(pMaps[graph->xAxis()]));
+            curve.setPen(graph->pen());
+            curve.setStyle(graph->style());
+
+            pPainter->save();
+
+            pPainter->setRenderHint(QPainter::Antialiasing,
+                                    graph->testRenderHint(QwtPlotItem::RenderAntialiased));
+            pPainter->setRenderHint(QPainter::HighQualityAntialiasing,
+                                    graph->testRenderHint(QwtPlotItem::RenderAntialiased));
+
+            curve.draw(pPainter, pMaps[graph->xAxis()], pMaps[graph->yAxis()],
+                       pCanvasRect);
+
+            pPainter->restore();
+        }
+
+        return;
+    }
+
+    // Use the default drawing if we are not drawing our canvas (e.g. we are
+    // being rendered by a QwtPlotRenderer object) or if our graphs are small
+    // enough to be drawn straightaway
+
+    if (!mDrawingCanvas || (nbOfSamples < MinNbOfLayerSamples)) {
+        QwtPlot::drawItems(pPainter, pCanvasRect, pMaps);
+
+        return;
+    }
+
+    // Draw all our items, except our graphs
+
+    drawNonGraphItems(pPainter, pCanvasRect, pMaps);
+
+    // Determine the signature of the layer that our graphs would currently
+    // result in, i.e. one that is based on our size, our axes and the data of
+    // our graphs
+    // Note: the data of a graph is normally set using raw samples, so we use
+    //       the address of those raw samples rather than that of the data
+    //       object itself, which gets recreated every time new samples are
+    //       added...
+
+    const QwtScaleMap &mapX = pMaps[QwtPlot::xBottom];
+    const QwtScaleMap &mapY = pMaps[QwtPlot::yLeft];
+    QByteArray signature = QByteArray();
+    QDataStream signatureStream(&signature, QIODevice::WriteOnly);
+    qreal devicePixelRatio = canvas()->devicePixelRatio();
+
+    signatureStream << pCanvasRect << devicePixelRatio
+                    << mapX.s1() << mapX.s2() << mapX.p1() << mapX.p2()
+                    << mapY.s1() << mapY.s2() << mapY.p1() << mapY.p2();
+
+    foreach (GraphPanelPlotGraph *graph, graphs) {
+        QwtCPointerData *data = dynamic_cast<QwtCPointerData *>(graph->data());
+        qulonglong dataSize = graph->dataSize();
+
+        signatureStream << quintptr(graph)
+                        << quintptr(data?data->xData():0)
+                        << quintptr(data?data->yData():0)
+                        << dataSize
+                        << (dataSize?graph->sample(dataSize-1):QPointF())
+                        << graph->pen()
+                        << graph->testRenderHint(QwtPlotItem::RenderAntialiased);
+    }
+
+    // Draw our layer, if it is up to date, or request a new one and, in the
+    // meantime, draw our current layer (if any) mapped to our current axes
+
+    if (signature == mLayerSignature) {
+        pPainter->drawImage(QPointF(0.0, 0.0), mLayerImage);
+    } else {
+        if (signature != mRequestedLayerSignature) {
+            // Take a snapshot of our graphs (since they may be modified while
+            // being rendered) and ask our layer renderer to render them
+            // Note: rather than copying all the samples of our graphs, we copy
+            //       their decimated samples, which render the same, but whose
+            //       number depends on the width of our layer (in device
+            //       pixels) rather than on the number of samples...
+
+            QwtScaleMap decimationMapX = mapX;
+
+            decimationMapX.setPaintInterval(devicePixelRatio*mapX.p1(),
+                                            devicePixelRatio*mapX.p2());
+
+            QList<QVector<QPointF>> samples = QList<QVector<QPointF>>();
+            QList<QPen> pens = QList<QPen>();
+            QList<bool> antialiased = QList<bool>();
+
+            foreach (GraphPanelPlotGraph *graph, graphs) {
+                samples << graph->decimatedSamples(decimationMapX);
+                pens << graph->pen();
+                antialiased << graph->testRenderHint(QwtPlotItem::RenderAntialiased);
+            }
+
+            mRequestedLayerSignature = signature;
+            mRequestedLayerMapX = mapX;
+            mRequestedLayerMapY = mapY;
+
+            mLayerRenderer->render(signature, pCanvasRect.size().toSize(),
+                                   devicePixelRatio, mapX, mapY,
+                                   samples, pens, antialiased);
+        }
+
+        if (!mLayerImage.isNull()) {
+            QSizeF layerSize = QSizeF(mLayerImage.size())/mLayerImage.devicePixelRatio();
+
+            pPainter->drawImage(QRectF(QPointF(mapX.transform(mLayerMapX.invTransform(0.0)),
+                                               mapY.transform(mLayerMapY.invTransform(0.0))),
+                                       QPointF(mapX.transform(mLayerMapX.invTransform(layerSize.width())),
+                                               mapY.transform(mLayerMapY.invTransform(layerSize.height())))).normalized(),
+                                mLayerImage);
+        }
+    }
+}
+
+//==============================================================================
+
 bool GraphPanelPlotWidget::eventFilter(QObject *pObject, QEvent *pEvent)
 {
     // Default handling of the event
@@ -1112,6 +1785,83 @@ static const double BigScalingOutFactor = 1.0/BigScalingInFactor;
 
 //==============================================================================
 
+static const double MaxDataCursorDistance = 16.0;
+
+//==============================================================================
+
+void GraphPanelPlotWidget::updateDataCursor(const QPoint &pPoint)
+{
+    // Make sure that the given point is over our canvas
+
+    QRectF canvasRect = plotLayout()->canvasRect();
+
+    if (!canvasRect.contains(pPoint)) {
+        mOverlayWidget->resetDataCursor();
+
+        return;
+    }
+
+    // Look for the sample that is the nearest to the given point amongst our
+    // visible graphs
+    // Note: each graph has its own spatial index, so we don't need to go
+    //       through all of their samples...
+
+    QPointF point = pPoint-canvasRect.topLeft();
+    QwtScaleMap canvasMapX = canvasMap(QwtPlot::xBottom);
+    QwtScaleMap canvasMapY = canvasMap(QwtPlot::yLeft);
+    GraphPanelPlotGraph *nearestGraph = 0;
+    qulonglong nearestIndex = 0;
+    double nearestDistance = MaxDataCursorDistance;
+
+    foreach (GraphPanelPlotGraph *graph, mGraphs) {
+        qulonglong index;
+        double distance;
+
+        if (   graph->isValid() && graph->isSelected() && graph->isVisible()
+            && graph->nearestSample(canvasMapX, canvasMapY, point,
+                                    nearestDistance, index, distance)) {
+            nearestGraph = graph;
+            nearestIndex = index;
+            nearestDistance = distance;
+        }
+    }
+
+    // Show our data cursor for the nearest sample, if any
+
+    if (nearestGraph) {
+        QPointF sample = nearestGraph->sample(nearestIndex);
+        QString text = QString("X: %1\nY: %2").arg(QLocale().toString(sample.x(), 'g', 15),
+                                                   QLocale().toString(sample.y(), 'g', 15));
+        QString title = nearestGraph->title().text();
+
+        if (!title.isEmpty())
+            text += "\n"+title;
+
+        text += "\n"+QFileInfo(nearestGraph->fileName()).fileName();
+
+        mOverlayWidget->setDataCursor(QPoint(qRound(canvasMapX.transform(sample.x())),
+                                             qRound(canvasMapY.transform(sample.y()))),
+                                      text, nearestGraph->pen().color());
+    } else {
+        mOverlayWidget->resetDataCursor();
+    }
+}
+
+//==============================================================================
+
+void GraphPanelPlotWidget::leaveEvent(QEvent *pEvent)
+{
+    // Default handling of the event
+
+    QwtPlot::leaveEvent(pEvent);
+
+    // Hide our data cursor
+
+    mOverlayWidget->resetDataCursor();
+}
+
+//==============================================================================
+
 void GraphPanelPlotWidget::mouseMoveEvent(QMouseEvent *pEvent)
 {
     // Default handling of the event
@@ -1122,9 +1872,12 @@ void GraphPanelPlotWidget::mouseMoveEvent(QMouseEvent *pEvent)
 
     switch (mAction) {
     case None:
-        // No action, so do nothing
+        // No action, so update our data cursor, if needed
 
-        ;
+        if (mDataCursorAction->isChecked())
+            updateDataCursor(pEvent->pos());
+
+        break;
     case Pan: {
         // Determine the X/Y shifts for our panning
 
@@ -1212,6 +1965,10 @@ void GraphPanelPlotWidget::mousePressEvent(QMouseEvent *pEvent)
         return;
     }
 
+    // Hide our data cursor while carrying out an action
+
+    mOverlayWidget->resetDataCursor();
+
     // Check which action to can carry out
 
     if (   (pEvent->button() == Qt::LeftButton)
@@ -1507,6 +2264,172 @@ void GraphPanelPlotWidget::copyToClipboard()
 
 //==============================================================================
 
+bool GraphPanelPlotWidget::exportTo(const QString &pFileName,
+                                    const QSizeF &pSize, const int &pResolution)
+{
+    // Export ourselves
+
+    return exportPlots(GraphPanelPlotWidgets() << this, pFileName, pSize,
+                       pResolution);
+}
+
+//==============================================================================
+
+bool GraphPanelPlotWidget::exportPlots(const GraphPanelPlotWidgets &pPlots,
+                                       const QString &pFileName,
+                                       const QSizeF &pSize,
+                                       const int &pResolution)
+{
+    // Make sure that we have something to export
+
+    if (pPlots.isEmpty() || pSize.isEmpty() || (pResolution <= 0))
+        return false;
+
+    // Determine the size, in dots, of our export, knowing that the given size
+    // is in millimetres
+
+    QSize size = (pSize*pResolution/25.4).toSize();
+
+    // Create the paint device to which we want to export our plots, based on
+    // the extension of the given file name
+
+    QString format = QFileInfo(pFileName).suffix().toLower();
+    QPdfWriter *pdfWriter = 0;
+    QSvgGenerator *svgGenerator = 0;
+    QImage *image = 0;
+    QPaintDevice *paintDevice = 0;
+
+    if (!format.compare("pdf")) {
+        pdfWriter = new QPdfWriter(pFileName);
+
+        pdfWriter->setResolution(pResolution);
+        pdfWriter->setPageSizeMM(pSize);
+        pdfWriter->setPageMargins(QMarginsF());
+
+        paintDevice = pdfWriter;
+    } else if (!format.compare("svg")) {
+        svgGenerator = new QSvgGenerator();
+
+        svgGenerator->setFileName(pFileName);
+        svgGenerator->setResolution(pResolution);
+        svgGenerator->setSize(size);
+        svgGenerator->setViewBox(QRect(QPoint(0, 0), size));
+
+        paintDevice = svgGenerator;
+    } else if (QImageWriter::supportedImageFormats().contains(format.toUtf8())) {
+        image = new QImage(size, QImage::Format_ARGB32);
+
+        image->setDotsPerMeterX(qRound(1000.0*pResolution/25.4));
+        image->setDotsPerMeterY(qRound(1000.0*pResolution/25.4));
+        image->fill(Qt::white);
+
+        paintDevice = image;
+    } else {
+        return false;
+    }
+
+    // Render our plots, one below the other, using a QwtPlotRenderer object,
+    // which means that our plots don't need to be visible
+
+    QPainter painter;
+    bool res = painter.begin(paintDevice);
+
+    if (res) {
+        QwtPlotRenderer renderer;
+        double plotHeight = double(size.height())/pPlots.count();
+
+        renderer.setDiscardFlag(QwtPlotRenderer::DiscardCanvasFrame);
+
+        for (int i = 0, iMax = pPlots.count(); i < iMax; ++i) {
+            GraphPanelPlotWidget *plot = pPlots[i];
+
+            plot->mExporting = true;
+
+            renderer.render(plot, &painter,
+                            QRectF(0.0, i*plotHeight, size.width(), plotHeight));
+
+            plot->mExporting = false;
+        }
+
+        res = painter.end();
+
+        if (image)
+            res = image->save(pFileName) && res;
+    }
+
+    // Clean up things
+
+    delete pdfWriter;
+    delete svgGenerator;
+    delete image;
+
+    return res;
+}
+
+//==============================================================================
+
+void GraphPanelPlotWidget::exportTo()
+{
+    // Ask for the file to which we should export ourselves
+
+    static const QStringList Filters = QStringList() << "PDF (*.pdf)"
+                                                     << "PNG (*.png)"
+                                                     << "SVG (*.svg)";
+
+    QString fileName = Core::getSaveFileName(tr("Export To"), QString(),
+                                             Filters);
+
+    if (fileName.isEmpty())
+        return;
+
+    // Export ourselves using our current size on the screen
+
+    if (!exportTo(fileName, QSizeF(25.4*width()/logicalDpiX(),
+                                   25.4*height()/logicalDpiY()))) {
+        QMessageBox::warning(Core::mainWindow(), tr("Export To"),
+                             tr("The graph panel could not be exported to <strong>%1</strong>.").arg(fileName));
+    }
+}
+
+//==============================================================================
+
+void GraphPanelPlotWidget::toggleDataCursor(const bool &pDataCursor)
+{
+    // Track the mouse (without any button pressed) only when we need to show
+    // our data cursor
+
+    setMouseTracking(pDataCursor);
+    canvas()->setMouseTracking(pDataCursor);
+
+    if (pDataCursor)
+        updateDataCursor(mapFromGlobal(QCursor::pos()));
+    else
+        mOverlayWidget->resetDataCursor();
+}
+
+//==============================================================================
+
+void GraphPanelPlotWidget::layerRendered(const QByteArray &pSignature,
+                                         const QImage &pImage)
+{
+    // Make sure that the given layer is the one we requested last (i.e. that
+    // our axes or graphs haven't changed since we requested it)
+
+    if (pSignature != mRequestedLayerSignature)
+        return;
+
+    // Keep track of our new layer and redraw our canvas using it
+
+    mLayerImage = pImage;
+    mLayerSignature = pSignature;
+    mLayerMapX = mRequestedLayerMapX;
+    mLayerMapY = mRequestedLayerMapY;
+
+    qobject_cast<QwtPlotCanvas *>(canvas())->replot();
+}
+
+//==============================================================================
+
 void GraphPanelPlotWidget::customAxes()
 {
     // Specify custom axes for the graph panel
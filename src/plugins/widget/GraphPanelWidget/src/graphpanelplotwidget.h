@@ -32,15 +32,24 @@ limitations under the License.
 #include "qwt_plot.h"
 #include "qwt_plot_curve.h"
 #include "qwt_scale_draw.h"
+#include "qwt_scale_map.h"
 #include "qwt_text.h"
 
 //==============================================================================
 
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QVector>
+
+//==============================================================================
+
 class QMenu;
 
 //==============================================================================
 
 class QwtPlotDirectPainter;
+class QwtScaleMap;
 
 //==============================================================================
 
@@ -55,6 +64,8 @@ static const double DefMaxAxis = 1000.0;
 static const QRectF DefPlotRect = QRectF(DefMinAxis, DefMinAxis,
                                          DefMaxAxis, DefMaxAxis);
 
+static const int DefExportResolution = 300;
+
 //==============================================================================
 
 class GRAPHPANELWIDGET_EXPORT GraphPanelPlotGraph : public QwtPlotCurve
@@ -76,6 +87,13 @@ public:
     void * parameterY() const;
     void setParameterY(void *pParameterY);
 
+    bool nearestSample(const QwtScaleMap &pCanvasMapX,
+                       const QwtScaleMap &pCanvasMapY, const QPointF &pPoint,
+                       const double &pMaxDistance, qulonglong &pIndex,
+                       double &pDistance);
+
+    QVector<QPointF> decimatedSamples(const QwtScaleMap &pMapX) const;
+
 private:
     bool mSelected;
 
@@ -83,6 +101,28 @@ private:
 
     void *mParameterX;
     void *mParameterY;
+
+    qulonglong mIndexedSize;
+    QPointF mLastIndexedSample;
+
+    bool mSortedX;
+
+    qulonglong mGridSize;
+    double mCellWidth;
+    double mCellHeight;
+    QHash<quint64, QVector<qulonglong>> mGrid;
+
+    void resetIndex();
+    void updateIndex();
+
+    void cell(const QPointF &pPoint, int &pCellX, int &pCellY) const;
+
+    void buildGrid();
+    void addToGrid(const qulonglong &pIndex);
+
+    void checkSample(const qulonglong &pIndex, const QwtScaleMap &pCanvasMapX,
+                     const QwtScaleMap &pCanvasMapY, const QPointF &pPoint,
+                     qulonglong &pBestIndex, double &pBestDistance) const;
 };
 
 //==============================================================================
@@ -91,6 +131,7 @@ typedef QList<GraphPanelPlotGraph *> GraphPanelPlotGraphs;
 
 //==============================================================================
 
+class GraphPanelPlotLayerRenderer;
 class GraphPanelPlotWidget;
 
 //==============================================================================
@@ -103,6 +144,10 @@ public:
     void setOriginPoint(const QPoint &pOriginPoint);
     void setPoint(const QPoint &pPoint);
 
+    void setDataCursor(const QPoint &pPoint, const QString &pText,
+                       const QColor &pColor);
+    void resetDataCursor();
+
     QRect zoomRegion() const;
 
 protected:
@@ -121,6 +166,11 @@ private:
     QPoint mOriginPoint;
     QPoint mPoint;
 
+    bool mShowDataCursor;
+    QPoint mDataCursorPoint;
+    QString mDataCursorText;
+    QColor mDataCursorColor;
+
     QPoint optimisedPoint(const QPoint &pPoint) const;
 
     void drawCoordinates(QPainter *pPainter, const QPoint &pPoint,
@@ -128,6 +178,10 @@ private:
                          const QColor &pForegroundColor,
                          const Location &pLocation,
                          const bool &pCanMoveLocation = true);
+    void drawText(QPainter *pPainter, const QString &pText,
+                  const QPoint &pPoint, const QColor &pBackgroundColor,
+                  const QColor &pForegroundColor, const Location &pLocation,
+                  const bool &pCanMoveLocation = true);
 };
 
 //==============================================================================
@@ -195,8 +249,19 @@ public:
                             const bool &pForceAlignment = false);
     void forceAlignWithNeighbors();
 
+    bool exportTo(const QString &pFileName, const QSizeF &pSize,
+                  const int &pResolution = DefExportResolution);
+
+    static bool exportPlots(const GraphPanelPlotWidgets &pPlots,
+                            const QString &pFileName, const QSizeF &pSize,
+                            const int &pResolution = DefExportResolution);
+
 protected:
+    virtual void drawCanvas(QPainter *pPainter);
+    virtual void drawItems(QPainter *pPainter, const QRectF &pCanvasRect,
+                           const QwtScaleMap pMaps[axisCnt]) const;
     virtual bool eventFilter(QObject *pObject, QEvent *pEvent);
+    virtual void leaveEvent(QEvent *pEvent);
     virtual void mouseMoveEvent(QMouseEvent *pEvent);
     virtual void mousePressEvent(QMouseEvent *pEvent);
     virtual void mouseReleaseEvent(QMouseEvent *pEvent);
@@ -214,6 +279,20 @@ private:
 
     QwtPlotDirectPainter *mDirectPainter;
 
+    GraphPanelPlotLayerRenderer *mLayerRenderer;
+
+    bool mDrawingCanvas;
+    bool mExporting;
+
+    QImage mLayerImage;
+    QByteArray mLayerSignature;
+    QwtScaleMap mLayerMapX;
+    QwtScaleMap mLayerMapY;
+
+    mutable QByteArray mRequestedLayerSignature;
+    mutable QwtScaleMap mRequestedLayerMapX;
+    mutable QwtScaleMap mRequestedLayerMapY;
+
     GraphPanelPlotGraphs mGraphs;
 
     Action mAction;
@@ -234,6 +313,8 @@ private:
     QMenu *mContextMenu;
 
     QAction *mCopyToClipboardAction;
+    QAction *mExportToAction;
+    QAction *mDataCursorAction;
     QAction *mSynchronizeXAxisAction;
     QAction *mSynchronizeYAxisAction;
     QAction *mCustomAxesAction;
@@ -248,6 +329,9 @@ private:
 
     void handleMouseDoubleClickEvent(QMouseEvent *pEvent);
 
+    void drawNonGraphItems(QPainter *pPainter, const QRectF &pCanvasRect,
+                           const QwtScaleMap pMaps[axisCnt]) const;
+
     void checkAxisValues(double &pMin, double &pMax);
     void checkAxesValues(double &pMinX, double &pMaxX,
                          double &pMinY, double &pMaxY);
@@ -281,12 +365,18 @@ private:
     QPointF canvasPoint(const QPoint &pPoint,
                         const bool pNeedOffset = true) const;
 
+    void updateDataCursor(const QPoint &pPoint);
+
 Q_SIGNALS:
     void axesChanged(const double &pMinX, const double &pMaxX,
                      const double &pMinY, const double &pMaxY);
 
 private Q_SLOTS:
     void copyToClipboard();
+    void exportTo();
+    void toggleDataCursor(const bool &pDataCursor);
+
+    void layerRendered(const QByteArray &pSignature, const QImage &pImage);
     void customAxes();
     void zoomIn();
     void zoomOut();
@@ -286,6 +286,22 @@ void GraphPanelsWidget::setActiveGraphPanel(GraphPanelWidget *pGraphPanel)
 
 //==============================================================================
 
+bool GraphPanelsWidget::exportTo(const QString &pFileName, const QSizeF &pSize,
+                                 const int &pResolution)
+{
+    // Export all our graph panels, one below the other
+
+    GraphPanelPlotWidgets plots = GraphPanelPlotWidgets();
+
+    foreach (GraphPanelWidget *graphPanel, mGraphPanels)
+        plots << graphPanel->plot();
+
+    return GraphPanelPlotWidget::exportPlots(plots, pFileName, pSize,
+                                             pResolution);
+}
+
+//==============================================================================
+
 void GraphPanelsWidget::updateGraphPanels(OpenCOR::GraphPanelWidget::GraphPanelWidget *pGraphPanel)
 {
     // Keep track of the newly activated graph panel
@@ -60,6 +60,9 @@ public:
 
     void setActiveGraphPanel(GraphPanelWidget *pGraphPanel);
 
+    bool exportTo(const QString &pFileName, const QSizeF &pSize,
+                  const int &pResolution = DefExportResolution);
+
 private:
     QIntList mSplitterSizes;
 
@@ -0,0 +1,167 @@
+/*******************************************************************************
+
+Copyright The University of Auckland
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*******************************************************************************/
+
+//==============================================================================
+// Graph panel widget tests
+//==============================================================================
+
+#include "../../../../tests/src/testsutils.h"
+
+//==============================================================================
+
+#include "graphpanelplotwidget.h"
+#include "tests.h"
+
+//==============================================================================
+
+#include <QtTest/QtTest>
+
+//==============================================================================
+
+#include <math.h>
+
+//==============================================================================
+
+static QwtScaleMap mapX(const double &pMinX, const double &pMaxX,
+                        const double &pWidth)
+{
+    // Return an X map that maps the given X range to the given number of
+    // pixel columns
+
+    QwtScaleMap res;
+
+    res.setScaleInterval(pMinX, pMaxX);
+    res.setPaintInterval(0.0, pWidth);
+
+    return res;
+}
+
+//==============================================================================
+
+void Tests::decimatedSamplesTests()
+{
+    // Decimate a few samples, one X unit per pixel column, and check that we
+    // get the first, minimum, maximum and last samples of each pixel column
+    // (in their original order), and that non-finite samples are kept as is
+    // and split a pixel column in two
+
+    static const double NaN = qQNaN();
+
+    OpenCOR::GraphPanelWidget::GraphPanelPlotGraph graph;
+    QVector<QPointF> samples = QVector<QPointF>() << QPointF(0.0, 1.0) << QPointF(0.2, 5.0) << QPointF(0.4, -3.0) << QPointF(0.6, 2.0) << QPointF(0.8, 0.0)
+                                                  << QPointF(1.0, 4.0) << QPointF(1.5, 4.0)
+                                                  << QPointF(2.5, 7.0)
+                                                  << QPointF(3.2, NaN)
+                                                  << QPointF(3.4, 1.0) << QPointF(3.6, 2.0)
+                                                  << QPointF(10.0, 3.0);
+    QVector<QPointF> expectedSamples = QVector<QPointF>() << QPointF(0.0, 1.0) << QPointF(0.2, 5.0) << QPointF(0.4, -3.0) << QPointF(0.8, 0.0)
+                                                          << QPointF(1.0, 4.0) << QPointF(1.5, 4.0)
+                                                          << QPointF(2.5, 7.0)
+                                                          << QPointF(3.2, NaN)
+                                                          << QPointF(3.4, 1.0) << QPointF(3.6, 2.0)
+                                                          << QPointF(10.0, 3.0);
+
+    graph.setSamples(samples);
+
+    QVector<QPointF> decimatedSamples = graph.decimatedSamples(mapX(0.0, 10.0, 10.0));
+
+    QCOMPARE(decimatedSamples.count(), expectedSamples.count());
+
+    for (int i = 0, iMax = expectedSamples.count(); i < iMax; ++i) {
+        QCOMPARE(decimatedSamples[i].x(), expectedSamples[i].x());
+
+        if (qIsNaN(expectedSamples[i].y()))
+            QVERIFY(qIsNaN(decimatedSamples[i].y()));
+        else
+            QCOMPARE(decimatedSamples[i].y(), expectedSamples[i].y());
+    }
+
+    // Decimate a lot of samples and check that, for each pixel column, we keep
+    // at most four samples, which include its first, minimum, maximum and last
+    // samples, and that we keep our end points
+
+    static const int NbOfSamples = 100000;
+    static const int NbOfColumns = 100;
+
+    samples.clear();
+
+    for (int i = 0; i < NbOfSamples; ++i) {
+        double x = double(i)/NbOfSamples;
+
+        samples << QPointF(x, sin(1000.0*x)+0.1*sin(123456.0*x));
+    }
+
+    graph.setSamples(samples);
+
+    QwtScaleMap map = mapX(0.0, 1.0, NbOfColumns);
+
+    decimatedSamples = graph.decimatedSamples(map);
+
+    QVERIFY(decimatedSamples.count() <= 4*NbOfColumns);
+    QCOMPARE(decimatedSamples.first(), samples.first());
+    QCOMPARE(decimatedSamples.last(), samples.last());
+
+    for (int i = 0, j = 0; i < NbOfSamples; ) {
+        // Determine the first, minimum, maximum and last samples of our
+        // current pixel column
+
+        double column = floor(map.transform(samples[i].x()));
+        QPointF firstSample = samples[i];
+        QPointF lastSample = samples[i];
+        double minY = samples[i].y();
+        double maxY = samples[i].y();
+
+        for (; (i < NbOfSamples) && (floor(map.transform(samples[i].x())) == column); ++i) {
+            lastSample = samples[i];
+            minY = qMin(minY, samples[i].y());
+            maxY = qMax(maxY, samples[i].y());
+        }
+
+        // Check that the decimated samples of our current pixel column start
+        // and end with its first and last samples, and include its minimum and
+        // maximum samples
+
+        QVector<QPointF> columnSamples = QVector<QPointF>();
+
+        for (; (j < decimatedSamples.count()) && (floor(map.transform(decimatedSamples[j].x())) == column); ++j)
+            columnSamples << decimatedSamples[j];
+
+        QVERIFY(!columnSamples.isEmpty() && (columnSamples.count() <= 4));
+        QCOMPARE(columnSamples.first(), firstSample);
+        QCOMPARE(columnSamples.last(), lastSample);
+
+        double columnMinY = columnSamples.first().y();
+        double columnMaxY = columnSamples.first().y();
+
+        foreach (const QPointF &columnSample, columnSamples) {
+            columnMinY = qMin(columnMinY, columnSample.y());
+            columnMaxY = qMax(columnMaxY, columnSample.y());
+        }
+
+        QCOMPARE(columnMinY, minY);
+        QCOMPARE(columnMaxY, maxY);
+    }
+}
+
+//==============================================================================
+
+QTEST_GUILESS_MAIN(Tests)
+
+//==============================================================================
+// End of file
+//==============================================================================